@@ -14,16 +14,19 @@
 extern const int ROTATION_SERVO_HOME_POSITION;     // Home position (degrees)
 extern const int ROTATION_SERVO_ACTIVE_POSITION;   // Position when activated (degrees)
 
+// Rotation servo motion profile and calibrated speed model
+extern const float ROTATION_SERVO_RAMP_VELOCITY_DEG_PER_SEC;  // Commanded ramp rate (degrees/sec)
+extern const float ROTATION_SERVO_MODEL_SPEED_DEG_PER_SEC;    // Measured loaded slew rate (degrees/sec)
+extern const unsigned long ROTATION_SERVO_MODEL_LATENCY_MS;   // Command-to-motion latency (ms)
+
 //* ************************************************************************
 //* ************************ MOTOR CONFIGURATION **************************
 //* ************************************************************************
 // Motor step calculations and travel distances
 extern const int CUT_MOTOR_STEPS_PER_INCH;  // 4x increase from 38
 extern const int FEED_MOTOR_STEPS_PER_INCH; // Steps per inch for feed motor
-extern const float CUT_TRAVEL_DISTANCE; // inches
-extern const float FEED_TRAVEL_DISTANCE; // inches
-extern const float CUT_MOTOR_INCREMENTAL_MOVE_INCHES; // Inches for incremental reverse
-extern const float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES; // Max inches for incremental reverse before error
+extern const float CUT_TRAVEL_DISTANCE; // inches (default job profile)
+extern const float FEED_TRAVEL_DISTANCE; // inches (default and longest job profile feed stroke)
 
 // Motor homing direction constants
 extern const int CUT_HOMING_DIRECTION;
@@ -38,6 +41,8 @@ extern const float CUT_MOTOR_NORMAL_ACCELERATION; // Acceleration for the cuttin
 
 // Return Stroke (Returning State / End of Cutting State)
 extern const float CUT_MOTOR_RETURN_SPEED;     // Speed for returning after a cut (steps/sec)
+extern const unsigned long CUT_MOTOR_FORWARD_PLANNING_MS; // Steps queued ahead during the RETURNING_YES_2x4 return; bounds the home switch overshoot
+extern const unsigned long CUT_MOTOR_DEFAULT_FORWARD_PLANNING_MS; // Steps queued ahead for every other cut motor move
 
 // Homing Operation (Homing State)
 extern const float CUT_MOTOR_HOMING_SPEED;      // Speed for homing the cut motor (steps/sec)
@@ -60,15 +65,141 @@ extern const float FEED_MOTOR_HOMING_SPEED;     // Speed for homing the feed mot
 //* ************************ TIMING CONFIGURATION *************************
 //* ************************************************************************
 // Servo timing configuration
-extern const unsigned long ROTATION_SERVO_ACTIVE_HOLD_DURATION_MS; // Time servo stays active
+extern const unsigned long ROTATION_SERVO_RELEASE_DWELL_MS; // Time at active position for piece release
 extern const unsigned long ROTATION_CLAMP_EXTEND_DURATION_MS; // Time clamp stays extended
 
 // Cut motor homing timeout
 extern const unsigned long CUT_HOME_TIMEOUT; // 5 seconds timeout
+extern const unsigned long FEED_HOME_TIMEOUT; // Each feed homing wait
 
 // Signal timing
 extern const unsigned long TA_SIGNAL_DURATION; // Duration for Transfer Arm signal (ms)
 
+//* ************************************************************************
+//* ******************** STROKE MONITOR CONFIGURATION ********************
+//* ************************************************************************
+// Cut stroke missed-step detection
+extern const int STROKE_MONITOR_WARMUP_STROKES;   // Strokes averaged before judging drift
+extern const float STROKE_MONITOR_EWMA_ALPHA;     // Baseline weight of each healthy stroke
+extern const float STROKE_DRIFT_WARNING_INCHES;   // Minimum switch drift for a warning
+extern const float STROKE_LOST_STEPS_INCHES;      // Minimum switch drift for lost steps
+extern const unsigned long STROKE_LATE_MARGIN_MS; // Minimum time past baseline for a late switch
+
+//* ************************************************************************
+//* ****************** CUT HOME RECOVERY CONFIGURATION *******************
+//* ************************************************************************
+// Cut motor home switch verification and in-line recovery
+extern const unsigned long CUT_HOME_VERIFY_SETTLE_MS;       // Wait after a stop before each switch read
+extern const int CUT_HOME_VERIFY_ATTEMPTS;                  // Switch reads before starting recovery
+extern const float CUT_HOME_RECOVERY_SEEK_SPEED;            // Seek and back-off speed (steps/sec)
+extern const float CUT_HOME_RECOVERY_REAPPROACH_SPEED;      // Final approach speed (steps/sec)
+extern const float CUT_HOME_RECOVERY_ACCELERATION;          // Ramp for recovery moves (steps/sec^2)
+extern const float CUT_HOME_RECOVERY_MAX_SEEK_INCHES;       // Furthest the seek may travel toward home
+extern const float CUT_HOME_RECOVERY_BACKOFF_INCHES;        // Move off the switch to prove it releases
+extern const unsigned long CUT_HOME_RECOVERY_TIMEOUT_MS;    // Whole recovery, from the start of the seek
+
+//* ************************************************************************
+//* ******************** ADAPTIVE CUT CONFIGURATION **********************
+//* ************************************************************************
+// Adaptive cut feed rate (starts at CUT_MOTOR_NORMAL_SPEED)
+extern const bool ADAPTIVE_CUT_MODE_ENABLED;          // Adaptive mode in the built-in profiles (each profile opts in)
+extern const float ADAPTIVE_CUT_MAX_SPEED;            // Upper bound for the learned cut speed (steps/sec)
+extern const float ADAPTIVE_CUT_RAISE_STEP;           // Increase after a clean streak (steps/sec)
+extern const float ADAPTIVE_CUT_BACKOFF_FACTOR;       // Multiplier applied on an anomaly
+extern const int ADAPTIVE_CUT_CLEAN_STROKES_TO_RAISE; // Clean strokes required before each raise
+extern const unsigned long ADAPTIVE_CUT_LOAD_LIMIT_MV; // Current sense peak treated as overload (mV)
+
+//* ************************************************************************
+//* ********************** JOB PROFILE CONFIGURATION *********************
+//* ************************************************************************
+// Limits for profile parameters entered from the network (defaults come from the constants above)
+extern const float JOB_PROFILE_MIN_CUT_SPEED;              // Slowest cut speed a profile may request (steps/sec)
+extern const float JOB_PROFILE_MAX_CUT_TRAVEL_INCHES;      // Longest cut stroke a profile may request
+extern const float JOB_PROFILE_MAX_FEED_OVERTRAVEL_INCHES; // Furthest a feed push may go past position 0
+extern const unsigned long JOB_PROFILE_MAX_HOLD_MS;        // Longest clamp hold / servo dwell
+
+//* ************************************************************************
+//* ********************* FAULT JOURNAL CONFIGURATION ********************
+//* ************************************************************************
+extern const unsigned long JOURNAL_SNAPSHOT_INTERVAL_MS;     // Snapshot rate into the RAM pre-fault ring
+extern const unsigned long JOURNAL_POST_FAULT_MS;            // Keep writing snapshots to flash after a fault
+extern const unsigned long JOURNAL_POST_FAULT_SNAPSHOT_MS;   // Snapshot rate during the post-fault window
+
+//* ************************************************************************
+//* ******************** FLIGHT RECORDER CONFIGURATION *******************
+//* ************************************************************************
+extern const unsigned long FLIGHT_RECORDER_SAMPLE_INTERVAL_US; // Cut motor / home switch sample period
+extern const unsigned long FLIGHT_RECORDER_POST_TRIGGER_MS;    // Keep recording this long after a home check fails
+
+//* ************************************************************************
+//* ********************* LOOP PROFILER CONFIGURATION ********************
+//* ************************************************************************
+extern const unsigned long LOOP_PROFILER_WINDOW_MS; // Stats window reported on serial and /loop
+extern const bool LOOP_PROFILER_SERIAL_REPORT;      // Print each window on serial (only while IDLE)
+
+//* ************************************************************************
+//* ******************* STATE INVARIANT CONFIGURATION ********************
+//* ************************************************************************
+extern const unsigned long STATE_INVARIANT_STUCK_MS;       // Longest stay in a state that does not wait for the operator
+extern const unsigned long STATE_INVARIANT_ERROR_GRACE_MS; // Motors must have stopped this long after entering ERROR
+
+//* ************************************************************************
+//* ******************** MEMORY MONITOR CONFIGURATION ********************
+//* ************************************************************************
+extern const unsigned long MEMORY_MONITOR_SAMPLE_MS;          // Heap and stack sample period
+extern const unsigned long MEMORY_MONITOR_TREND_INTERVAL_MS;  // One trend point (minimum) per interval
+extern const unsigned long MEMORY_WARNING_FREE_HEAP_BYTES;
+extern const unsigned long MEMORY_CRITICAL_FREE_HEAP_BYTES;
+extern const unsigned long MEMORY_WARNING_LARGEST_BLOCK_BYTES; // Fragmentation: largest single allocation possible
+extern const unsigned long MEMORY_CRITICAL_LARGEST_BLOCK_BYTES;
+extern const unsigned long MEMORY_WARNING_STACK_BYTES;        // Stack never used by a watched task
+
+//* ************************************************************************
+//* ******************* STEP PULSE CHECK CONFIGURATION *******************
+//* ************************************************************************
+extern const unsigned int STEP_PULSE_CUT_PCNT_UNIT;     // Pulse counter units clear of the ones the stepper engine uses
+extern const unsigned int STEP_PULSE_FEED_PCNT_UNIT;
+extern const unsigned long STEP_PULSE_TOLERANCE_STEPS;  // Largest commanded/emitted difference per move still counted as a match
+
+//* ************************************************************************
+//* *********************** WATCHDOG CONFIGURATION ***********************
+//* ************************************************************************
+extern const unsigned long WATCHDOG_CHECK_INTERVAL_MS;          // Supervisor task period
+extern const unsigned long WATCHDOG_CONTROL_TICK_DEADLINE_MS;   // Longest gap between loop() ticks
+extern const unsigned long WATCHDOG_BLOCKING_DEADLINE_MS;       // Same, inside a WatchdogBlockingScope (homing)
+extern const unsigned long WATCHDOG_MOTOR_ENGINE_DEADLINE_MS;   // A running motor must move within this
+extern const unsigned long WATCHDOG_NETWORK_DEADLINE_MS;        // Longer than one connect attempt plus the longest backoff
+extern const unsigned long WATCHDOG_LOGGING_DEADLINE_MS;        // Fault journal service, including a sector erase
+extern const unsigned long WATCHDOG_SAFE_STOP_SETTLE_MS;        // Clamps close before the restart
+extern const unsigned long WATCHDOG_TWDT_TIMEOUT_S;             // ESP32 task watchdog on the supervisor itself
+extern const int WATCHDOG_TASK_CORE;
+extern const unsigned long WATCHDOG_TASK_STACK_SIZE;            // Bytes
+extern const unsigned int WATCHDOG_TASK_PRIORITY;               // Above the network task
+
+//* ************************************************************************
+//* ********************** OTA UPDATE CONFIGURATION **********************
+//* ************************************************************************
+extern const unsigned long OTA_HEALTH_CHECK_TIMEOUT_MS; // A new image must home and reach IDLE within this
+extern const unsigned int OTA_HEALTH_CHECK_MAX_BOOTS;   // Roll back if a new image restarts more often than this
+extern const unsigned long OTA_WRITE_YIELD_MS;          // Pause after each received chunk
+
+//* ************************************************************************
+//* ************************ NETWORK CONFIGURATION ***********************
+//* ************************************************************************
+extern const int DIAGNOSTICS_SERVER_PORT; // HTTP status and job profile server
+extern const int DIAGNOSTICS_JOURNAL_DEFAULT_LIMIT; // Journal records served when no limit is given
+extern const int NETWORK_TASK_CORE;                       // Core for WiFi, OTA and the diagnostics server (loop runs on core 1)
+extern const unsigned long NETWORK_TASK_STACK_SIZE;       // Bytes
+extern const unsigned int NETWORK_TASK_PRIORITY;
+extern const unsigned long NETWORK_SERVICE_INTERVAL_MS;   // Delay between OTA / server polls
+extern const unsigned long NETWORK_CONNECT_TIMEOUT_MS;    // Give up on one connection attempt after this
+extern const unsigned long NETWORK_RECONNECT_MIN_MS;      // First retry delay, doubled after each failure
+extern const unsigned long NETWORK_RECONNECT_MAX_MS;      // Retry delay ceiling
+extern const char* const FIRMWARE_VERSION;                // Reported in mDNS TXT records and fleet beacons
+extern const unsigned char FLEET_BEACON_GROUP[4];         // Multicast group for status beacons
+extern const int FLEET_BEACON_PORT;
+extern const unsigned long FLEET_BEACON_INTERVAL_MS;      // Status beacon period
+
 //* ************************************************************************
 //* ************************ OPERATIONAL CONSTANTS ***********************
 //* ************************************************************************
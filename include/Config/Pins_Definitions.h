@@ -61,4 +61,10 @@ extern const int STATUS_LED_YELLOW;   // Warning/caution indication
 extern const int STATUS_LED_GREEN;    // Ready/operation OK indication
 extern const int STATUS_LED_BLUE;     // Process active indication
 
+//* ************************************************************************
+//* ************************ ANALOG INPUT PINS ****************************
+//* ************************************************************************
+// Optional analog inputs (-1 = not fitted)
+extern const int CUT_MOTOR_CURRENT_SENSE_PIN; // Cut motor driver current sense (ADC)
+
 #endif // PIN_DEFINITIONS_H 
\ No newline at end of file
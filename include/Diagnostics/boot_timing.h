@@ -0,0 +1,35 @@
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* *************************** BOOT TIMING ********************************
+//* ************************************************************************
+// millis() at each boot milestone. The control path (setup -> HOMING -> IDLE)
+// and the network path (WiFi -> OTA and diagnostics server) run in parallel,
+// so the summary printed on reaching IDLE shows whether the access point was
+// ever on the critical path.
+
+enum BootPhase : uint8_t {
+    BOOT_PHASE_SETUP_START,
+    BOOT_PHASE_IO_READY,            // Pins, outputs and switches configured
+    BOOT_PHASE_MOTORS_READY,        // Steppers and servo attached
+    BOOT_PHASE_SETUP_DONE,
+    BOOT_PHASE_HOMING_STARTED,
+    BOOT_PHASE_IDLE,                // First time IDLE is reached
+    BOOT_PHASE_WIFI_CONNECTED,      // First WiFi connection
+    BOOT_PHASE_NETWORK_READY,       // OTA and diagnostics server listening
+    BOOT_PHASE_COUNT
+};
+
+// Record the first time a phase is reached. Returns true on that first call.
+bool markBootPhase(BootPhase phase);
+
+// millis() when the phase was reached, 0 if not reached yet
+unsigned long getBootPhaseMs(BootPhase phase);
+
+void formatBootTiming(String& out);
+void printBootTiming();
+
+#endif // BOOT_TIMING_H
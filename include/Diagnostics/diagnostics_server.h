@@ -0,0 +1,51 @@
+#ifndef DIAGNOSTICS_SERVER_H
+#define DIAGNOSTICS_SERVER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ********************** DIAGNOSTICS SERVER HEADER ***********************
+//* ************************************************************************
+// Small HTTP server on the shop WiFi for machine status, job profile
+// selection, the fault journal and the flight recorder. Plain-text responses
+// (apart from the flight recorder blob) so it works from curl or a browser.
+// Endpoints that change what the machine does are POST only and need digest
+// auth as user "stage1" with the OTA password, e.g.
+//   curl --digest -u stage1:<password> -d index=1 http://<machine>/profile/select
+//
+//   GET /                       machine status and boot timing
+//   GET /profiles               list the job profiles
+//   POST /profile/select index=N
+//                               stage profile N (applied between cycles)
+//   POST /profile/save index=N&<field>=<value>...
+//                               edit fields of slot N and store it in NVS
+//   GET /journal?limit=N        newest N fault journal records (default 500)
+//   GET /loop                   loop timing and per-state execute cost
+//   GET /flightrecorder.bin     frozen cut-home flight recorder capture (404 while armed)
+//   GET /flightrecorder/trigger freeze a capture around now
+//   GET /flightrecorder/rearm   drop the frozen capture and record again
+//   GET /inputs.bin             frozen input edge trace (404 while recording)
+//   GET /inputs/freeze          freeze the input trace now
+//   GET /inputs/rearm           drop the frozen trace and record again
+//   GET /sequences              feed sequences in use, disassembled
+//   POST /sequence?name=<seq>   compiled sequence (multipart field, see
+//                               tools/seqc.py); IDLE only, used from its next
+//                               start
+//   POST /sequence/reset name=<seq>
+//                               go back to the built-in sequence (IDLE only)
+//   GET /memory                 heap, fragmentation, stack headroom and trend
+//   GET /homestop               cut motor overshoot past the home switch edge
+//   GET /steps                  commanded steps against counted step pulses
+//   GET /states.dot             state transition graph (Graphviz: dot -Tsvg)
+//   POST /update                compressed or delta firmware package (multipart
+//                               field, see tools/make_ota_package.py); needs
+//                               the write credential, IDLE or an error hold
+//                               only, restarts into the new image
+
+// Start the server (called by the network task after WiFi connects)
+void setupDiagnosticsServer();
+
+// Serve pending requests (called from the network task)
+void handleDiagnosticsServer();
+
+#endif // DIAGNOSTICS_SERVER_H
@@ -0,0 +1,88 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** LOOP PROFILER *******************************
+//* ************************************************************************
+// Cycle-counter timing of the main loop: loop-to-loop interval (jitter and
+// worst-case latency), loop body, common operations and each state's
+// execute(), plus OTA and the diagnostics server on the network task. Every
+// section keeps a count, average, max and a power-of-two microsecond
+// histogram. Stats roll over every LOOP_PROFILER_WINDOW_MS; the last complete
+// window is reported on serial and served at /loop by the diagnostics server.
+//
+// Build with -DLOOP_PROFILER=0 to compile it out: LoopProfileScope becomes an
+// empty object and the functions below become empty inlines.
+
+#ifndef LOOP_PROFILER
+#define LOOP_PROFILER 1
+#endif
+
+// Fixed sections; each SystemState gets its own section after these
+enum LoopProfileSection : uint8_t {
+    LOOP_SECTION_TICK_INTERVAL,     // Start of one loop() to the start of the next
+    LOOP_SECTION_TICK,              // Whole loop() body
+    LOOP_SECTION_OTA,               // handleOTA() on the network task
+    LOOP_SECTION_NETWORK,           // Diagnostics server on the network task
+    LOOP_SECTION_COMMON,            // StateManager::handleCommonOperations()
+    LOOP_SECTION_STATE_FIRST        // + SystemState: that state's execute()
+};
+
+// Histogram bucket b counts durations of [2^(b-1), 2^b) us; bucket 0 is < 1 us
+const uint8_t LOOP_PROFILER_BUCKETS = 16;
+
+#if LOOP_PROFILER
+
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include "esp_cpu.h"
+#endif
+
+static inline uint32_t readLoopProfilerCycles() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    return (uint32_t)esp_cpu_get_cycle_count();
+#else
+    return ESP.getCycleCount(); // Same CCOUNT register on IDF 4.x
+#endif
+}
+
+// Start the first window (call from setup)
+void beginLoopProfiler();
+
+// Mark the start of loop(): records the tick interval and rolls the window over
+void markLoopProfilerTick();
+
+void recordLoopProfileSection(uint8_t section, uint32_t cycles);
+
+// Append the last complete window as text
+void formatLoopProfile(String& out);
+void printLoopProfile();
+
+// Times the enclosing scope into one section
+class LoopProfileScope {
+public:
+    explicit LoopProfileScope(uint8_t section) : section(section), startCycles(readLoopProfilerCycles()) {}
+    ~LoopProfileScope() { recordLoopProfileSection(section, readLoopProfilerCycles() - startCycles); }
+
+private:
+    uint8_t section;
+    uint32_t startCycles;
+};
+
+#else
+
+inline void beginLoopProfiler() {}
+inline void markLoopProfilerTick() {}
+inline void formatLoopProfile(String& out) { out += "loop profiler compiled out (LOOP_PROFILER=0)\n"; }
+inline void printLoopProfile() {}
+
+class LoopProfileScope {
+public:
+    explicit LoopProfileScope(uint8_t) {}
+};
+
+#endif // LOOP_PROFILER
+
+#endif // LOOP_PROFILER_H
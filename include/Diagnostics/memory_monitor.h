@@ -0,0 +1,55 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** MEMORY MONITOR ******************************
+//* ************************************************************************
+// Watches heap and stack headroom over a long run:
+//   - free heap and largest free block, sampled every MEMORY_MONITOR_SAMPLE_MS,
+//     with the minimum of each kept per MEMORY_MONITOR_TREND_INTERVAL_MS for
+//     the last MEMORY_MONITOR_TREND_SAMPLES intervals
+//   - stack high-water mark of the loop, network and stepper tasks
+//   - heap allocations made from the loop (control) task after setup(), which
+//     should stay at zero
+// The level goes to WARNING or CRITICAL when a threshold in Config is crossed
+// and is reported on serial, the status page and GET /memory, and flashed on
+// the status LEDs (LED_NOTICE_*). No cycle starts at CRITICAL, from IDLE or
+// in continuous mode (mayStartCycle()).
+//
+// Allocation counting wraps malloc/calloc/realloc at link time, so it needs
+// -DMEMORY_ALLOC_TRACKING=1 together with
+// -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc (see platformio.ini).
+// Without them the allocation counts read zero. pio test -e native_alloc
+// checks the count stays at zero on the machine model.
+
+#ifndef MEMORY_ALLOC_TRACKING
+#define MEMORY_ALLOC_TRACKING 0
+#endif
+
+// Trend intervals kept (one hour at the default interval)
+const size_t MEMORY_MONITOR_TREND_SAMPLES = 60;
+
+enum MemoryLevel : uint8_t {
+    MEMORY_OK,
+    MEMORY_WARNING,             // Below a warning threshold - fix before the next shift
+    MEMORY_CRITICAL             // Close to exhaustion
+};
+
+// Start sampling and counting (call at the end of setup(), from the loop task)
+void beginMemoryMonitor();
+
+// Take a sample when one is due (called every tick)
+void serviceMemoryMonitor();
+
+MemoryLevel getMemoryLevel();
+const char* getMemoryLevelName(MemoryLevel level);
+
+// Heap allocations from the loop task since setup() finished
+uint32_t getControlAllocationCount();
+
+// Append the full report (current, minimums, trend, stacks, allocations)
+void formatMemoryReport(String& out);
+
+#endif // MEMORY_MONITOR_H
@@ -0,0 +1,25 @@
+#ifndef THROUGHPUT_COUNTER_H
+#define THROUGHPUT_COUNTER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ THROUGHPUT COUNTER ****************************
+//* ************************************************************************
+// Counts completed cuts (one per piece handed to the transfer arm) for the
+// fleet beacon and the status page. Parts per hour is the number of cuts in
+// the last 60 one-minute buckets, so it drops back to zero a full hour after
+// the machine stops.
+
+struct ThroughputStats {
+    uint32_t totalCuts;         // Since boot
+    uint32_t cutsLastHour;
+    uint32_t lastCycleMs;       // Time between the last two cuts (0 until two cuts)
+};
+
+// Record a finished cut (called from CUTTING when the cut stroke completes)
+void noteCutCompleted();
+
+ThroughputStats getThroughputStats();
+
+#endif // THROUGHPUT_COUNTER_H
@@ -3,8 +3,10 @@
 
 #include <Arduino.h>
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Events/event_queue.h"
 
 // Function declarations for standard error state functionality
 void handleStandardErrorState();
+void handleStandardErrorEvent(const MachineEvent& event);
 
 #endif // STANDARD_ERROR_H 
\ No newline at end of file
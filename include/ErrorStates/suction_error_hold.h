@@ -3,8 +3,9 @@
 
 #include <Arduino.h>
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Events/event_queue.h"
 
 // Function declarations for suction error hold state functionality
-void handleSuctionErrorHoldState();
+void handleSuctionErrorHoldEvent(const MachineEvent& event);
 
 #endif // SUCTION_ERROR_HOLD_H 
\ No newline at end of file
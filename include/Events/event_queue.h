@@ -0,0 +1,86 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** EVENT QUEUE *********************************
+//* ************************************************************************
+// Fixed-size queue of machine events. The StateManager posts switch edges,
+// sensor changes, motor completions and timer expiries as they happen, then
+// drains the queue once per tick, handing every event to the current state's
+// onEvent(). States that do not require polling do all their work there and
+// skip execute().
+// Posting is safe from timer callbacks and ISRs.
+
+enum EventType : uint8_t {
+    EVENT_NONE,
+    EVENT_STATE_ENTERED,    // source = SystemState entered
+    EVENT_SWITCH_ROSE,      // source = EventSwitch
+    EVENT_SWITCH_FELL,      // source = EventSwitch
+    EVENT_SENSOR_CHANGED,   // source = EventSensor, value = new level
+    EVENT_MOTOR_DONE,       // source = EventMotor, value = position (steps, clipped)
+    EVENT_TIMER_EXPIRED,    // source = EventTimer
+    EVENT_OTA_ENDED,        // An upload finished or failed without a restart
+    EVENT_TYPE_COUNT
+};
+
+enum EventSwitch : uint8_t {
+    EVENT_SWITCH_CUT_HOME,
+    EVENT_SWITCH_FEED_HOME,
+    EVENT_SWITCH_RELOAD,
+    EVENT_SWITCH_START_CYCLE,
+    EVENT_SWITCH_MANUAL_FEED
+};
+
+enum EventSensor : uint8_t {
+    EVENT_SENSOR_2X4_PRESENT,
+    EVENT_SENSOR_WOOD_SUCTION
+};
+
+enum EventMotor : uint8_t {
+    EVENT_MOTOR_CUT,
+    EVENT_MOTOR_FEED
+};
+
+enum EventTimer : uint8_t {
+    EVENT_TIMER_ROTATION_CLAMP,
+    EVENT_TIMER_TA_SIGNAL,
+    EVENT_TIMER_SERVO_RELEASE
+};
+
+struct MachineEvent {
+    uint32_t timestampUs;   // micros() when posted
+    uint8_t type;           // EventType
+    uint8_t source;         // Switch/sensor/motor/timer id, or SystemState
+    int16_t value;
+};
+
+// Queue depth and dispatch history length
+const size_t EVENT_QUEUE_SIZE = 32;
+const size_t EVENT_HISTORY_SIZE = 32;
+
+// Dispatch timing counters
+struct EventQueueStats {
+    uint32_t posted;
+    uint32_t dispatched;
+    uint32_t dropped;           // Posted while the queue was full
+    uint32_t maxDepth;
+    uint32_t maxLatencyUs;      // Longest post-to-dispatch time
+};
+
+// Post an event. Returns false (and counts a drop) if the queue is full.
+bool postEvent(EventType type, uint8_t source, int16_t value = 0);
+
+// Pop the oldest event. Records its dispatch latency in the stats and history.
+bool popEvent(MachineEvent& event);
+
+size_t getPendingEventCount();
+EventQueueStats getEventQueueStats();
+const char* getEventTypeName(uint8_t type);
+
+// Recently dispatched events, oldest first (latency = dispatch - post time)
+size_t copyEventHistory(MachineEvent* destination, uint32_t* latencyUs, size_t maxEntries);
+void printEventQueueStats();
+
+#endif // EVENT_QUEUE_H
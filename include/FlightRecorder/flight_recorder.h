@@ -0,0 +1,90 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************* FLIGHT RECORDER ******************************
+//* ************************************************************************
+// RAM ring of cut motor samples (position, speed, home switch) taken every
+// FLIGHT_RECORDER_SAMPLE_INTERVAL_US by an esp_timer, so it keeps recording
+// while the loop is blocked in a home check. A home-verification failure
+// triggers the recorder; it records FLIGHT_RECORDER_POST_TRIGGER_MS more and
+// then freezes, leaving the rest of the ring as the pre-trigger window.
+//
+// The frozen capture is kept until rearmFlightRecorder() so a later failure
+// cannot overwrite it. It is served as a binary blob (header followed by
+// samples, oldest first, little-endian) and decoded on a PC with
+// tools/decode_flight_recorder.py.
+
+// Samples held in RAM (pre + post trigger)
+const size_t FLIGHT_RECORDER_SAMPLES = 2048;
+
+const uint16_t FLIGHT_RECORDER_FORMAT_VERSION = 1;
+
+// What triggered the capture
+enum FlightRecorderTrigger : uint8_t {
+    FLIGHT_TRIGGER_NONE = 0,
+    FLIGHT_TRIGGER_CUTTING_HOME_CHECK,      // CUTTING step 4 return check
+    FLIGHT_TRIGGER_YES_2X4_HOME_CHECK,      // RETURNING_YES_2x4 step 1 check
+    FLIGHT_TRIGGER_NO_2X4_HOME_CHECK,       // RETURNING_NO_2x4 step 8 check
+    FLIGHT_TRIGGER_REAL_TIME_HOME_CHECK,    // Switch dropped out during the 30ms verification
+    FLIGHT_TRIGGER_MANUAL                   // Requested over the diagnostics server
+};
+
+// Sample flag bits
+const uint8_t FLIGHT_SAMPLE_HOME_RAW = 0x01;        // Raw cut home switch level HIGH
+const uint8_t FLIGHT_SAMPLE_HOME_DEBOUNCED = 0x02;  // Debounced cut home switch HIGH
+const uint8_t FLIGHT_SAMPLE_CUT_RUNNING = 0x04;
+const uint8_t FLIGHT_SAMPLE_FEED_RUNNING = 0x08;
+
+struct FlightRecorderSample {
+    uint32_t timeUs;            // esp_timer time (wraps every ~71 minutes)
+    int32_t cutPositionSteps;
+    int32_t cutSpeedMilliHz;    // Signed, negative toward home
+    uint8_t flags;              // FLIGHT_SAMPLE_* bits
+    uint8_t state;              // SystemState
+    uint16_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(FlightRecorderSample) == 16, "FlightRecorderSample must stay 16 bytes");
+
+struct FlightRecorderHeader {
+    char magic[4];              // "FREC"
+    uint16_t version;           // FLIGHT_RECORDER_FORMAT_VERSION
+    uint16_t headerSize;
+    uint16_t sampleSize;
+    uint8_t triggerReason;      // FlightRecorderTrigger
+    uint8_t triggerState;       // SystemState when triggered
+    uint32_t sampleCount;       // Samples following the header
+    uint32_t triggerIndex;      // First sample taken after the trigger
+    uint32_t sampleIntervalUs;
+    uint32_t triggerTimeUs;     // esp_timer time of the trigger
+    uint32_t triggerUptimeMs;   // millis() of the trigger, to match the serial log and journal
+    int32_t cutStepsPerInch;
+} __attribute__((packed));
+
+static_assert(sizeof(FlightRecorderHeader) == 36, "FlightRecorderHeader must stay 36 bytes");
+
+// Start sampling (call from setup after the motors are created)
+void beginFlightRecorder();
+
+// Freeze a window around now. Ignored while a capture is pending or frozen.
+// Returns true if this call started a capture.
+bool triggerFlightRecorder(FlightRecorderTrigger reason);
+
+// Drop the frozen capture and start recording again
+void rearmFlightRecorder();
+
+bool isFlightRecorderFrozen();
+
+// Size in bytes of the frozen blob (0 while recording)
+size_t getFlightRecorderCaptureSize();
+
+// Copy part of the frozen blob. Returns the number of bytes copied.
+size_t readFlightRecorderCapture(size_t offset, uint8_t* buffer, size_t length);
+
+const char* getFlightRecorderTriggerName(uint8_t reason);
+void printFlightRecorderStatus();
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,101 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* *************************** INPUT TRACE ********************************
+//* ************************************************************************
+// RAM ring of every edge on the switch and sensor inputs, timestamped in
+// microseconds from a CHANGE interrupt on each pin, interleaved with the
+// state changes. It shows the raw chatter the debounced reads and the
+// states never see (the 2x4 and suction sensors are not debounced at all).
+//
+// Entering ERROR or SUCTION_ERROR_HOLD freezes the ring, as does a request
+// over the diagnostics server. The frozen trace is kept until
+// rearmInputTrace(), served as a binary blob (header followed by events,
+// oldest first, little-endian) and replayed on a PC with
+// tools/replay_input_trace.py.
+
+// Events held in RAM; a chattering sensor can fill this in well under a second
+const size_t INPUT_TRACE_EVENTS = 4096;
+
+const uint16_t INPUT_TRACE_FORMAT_VERSION = 1;
+
+// Traced inputs (InputTraceEvent.source)
+enum InputTraceSource : uint8_t {
+    INPUT_TRACE_CUT_HOME,
+    INPUT_TRACE_FEED_HOME,
+    INPUT_TRACE_RELOAD,
+    INPUT_TRACE_START_CYCLE,
+    INPUT_TRACE_MANUAL_FEED,
+    INPUT_TRACE_2X4_SENSOR,
+    INPUT_TRACE_SUCTION_SENSOR,
+    INPUT_TRACE_INPUT_COUNT,
+    INPUT_TRACE_STATE = 0x80    // State change: level = new state, state = old state
+};
+
+// What froze the trace
+enum InputTraceFreeze : uint8_t {
+    INPUT_TRACE_FREEZE_NONE = 0,
+    INPUT_TRACE_FREEZE_ERROR,
+    INPUT_TRACE_FREEZE_SUCTION_ERROR,
+    INPUT_TRACE_FREEZE_MANUAL
+};
+
+struct InputTraceEvent {
+    uint32_t timeUs;            // esp_timer time (wraps every ~71 minutes)
+    uint8_t source;             // InputTraceSource
+    uint8_t level;              // Pin level after the edge (or new SystemState)
+    uint8_t state;              // SystemState at the edge (or old SystemState)
+    uint8_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(InputTraceEvent) == 8, "InputTraceEvent must stay 8 bytes");
+
+struct InputTraceHeader {
+    char magic[4];              // "ITRC"
+    uint16_t version;           // INPUT_TRACE_FORMAT_VERSION
+    uint16_t headerSize;
+    uint16_t eventSize;
+    uint8_t freezeReason;       // InputTraceFreeze
+    uint8_t freezeState;        // SystemState when frozen
+    uint32_t eventCount;        // Events following the header
+    uint32_t eventsLost;        // Older events overwritten since the last rearm
+    uint32_t freezeTimeUs;      // esp_timer time of the freeze
+    uint32_t freezeUptimeMs;    // millis() of the freeze, to match the serial log and journal
+    uint8_t levelsAtFreeze;     // Bit per InputTraceSource, pin level when frozen
+    uint8_t reserved[3];
+} __attribute__((packed));
+
+static_assert(sizeof(InputTraceHeader) == 32, "InputTraceHeader must stay 32 bytes");
+
+// Attach the edge interrupts (call from setup after the input pins are configured).
+// The cut home switch interrupt belongs to the cut home limit
+// (99_CUT_HOME_LIMIT_FUNCTIONS.h), which forwards its edges here.
+void beginInputTrace();
+
+// Record an edge seen by another module's pin interrupt (ISR context)
+void traceInputEdgeFromIsr(uint8_t source, uint8_t level);
+
+// Record a state change; freezes the trace on ERROR / SUCTION_ERROR_HOLD
+void noteInputTraceState(uint8_t fromState, uint8_t toState);
+
+// Freeze the ring now. Ignored while frozen. Returns true if this call froze it.
+bool freezeInputTrace(InputTraceFreeze reason);
+
+// Drop the frozen trace and start recording again
+void rearmInputTrace();
+
+bool isInputTraceFrozen();
+
+// Size in bytes of the frozen blob (0 while recording)
+size_t getInputTraceCaptureSize();
+
+// Copy part of the frozen blob. Returns the number of bytes copied.
+size_t readInputTraceCapture(size_t offset, uint8_t* buffer, size_t length);
+
+const char* getInputTraceFreezeName(uint8_t reason);
+void printInputTraceStatus();
+
+#endif // INPUT_TRACE_H
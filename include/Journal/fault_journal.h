@@ -0,0 +1,97 @@
+#ifndef FAULT_JOURNAL_H
+#define FAULT_JOURNAL_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** FAULT JOURNAL *******************************
+//* ************************************************************************
+// Persistent circular journal in the "journal" flash partition for post-mortem
+// of ERROR and SUCTION_ERROR_HOLD. Records are appended sector by sector and
+// the oldest sector is erased when the log wraps, so every sector sees the same
+// number of erases (wear leveling by rotation).
+//
+// Flash is only written at boot and around faults:
+//   - state transitions and periodic snapshots (inputs, outputs, motor
+//     positions) go to a RAM pre-fault ring
+//   - entering a fault state commits the ring plus a fault record to flash
+//     once both motors have stopped
+//   - snapshots keep going to flash for JOURNAL_POST_FAULT_MS after the fault,
+//     held in the ring while either motor runs and written when both stop
+// The journal survives reboot and is served by the diagnostics server.
+//
+// The journal partition is only in partitions.csv builds flashed over USB;
+// an OTA update cannot change the partition table, so a machine that has only
+// ever been updated over WiFi records to RAM only (see README.md).
+
+// Record types
+enum JournalRecordType : uint8_t {
+    JOURNAL_BOOT = 1,           // detail = esp_reset_reason()
+    JOURNAL_STATE_CHANGE,       // previousState -> state
+    JOURNAL_SNAPSHOT,           // Periodic inputs / outputs / positions
+    JOURNAL_FAULT               // Entered a fault state (state)
+};
+
+// Input bits
+const uint8_t JOURNAL_IN_CUT_HOME = 0x01;
+const uint8_t JOURNAL_IN_FEED_HOME = 0x02;
+const uint8_t JOURNAL_IN_RELOAD = 0x04;
+const uint8_t JOURNAL_IN_START = 0x08;
+const uint8_t JOURNAL_IN_MANUAL_FEED = 0x10;
+const uint8_t JOURNAL_IN_2X4_SENSOR = 0x20;     // Raw sensor level HIGH
+const uint8_t JOURNAL_IN_SUCTION_SENSOR = 0x40;  // Raw sensor level HIGH
+
+// Output bits
+const uint8_t JOURNAL_OUT_ROTATION_CLAMP = 0x01;
+const uint8_t JOURNAL_OUT_FEED_CLAMP = 0x02;
+const uint8_t JOURNAL_OUT_2X4_SECURE_CLAMP = 0x04;
+const uint8_t JOURNAL_OUT_TA_SIGNAL = 0x08;
+const uint8_t JOURNAL_OUT_CUT_RUNNING = 0x40;
+const uint8_t JOURNAL_OUT_FEED_RUNNING = 0x80;
+
+// One 32-byte flash record
+struct JournalRecord {
+    uint32_t sequence;          // Monotonic across reboots (assigned when written to flash)
+    uint32_t uptimeMs;
+    uint16_t bootCount;
+    uint8_t type;               // JournalRecordType
+    uint8_t state;              // SystemState
+    uint8_t previousState;
+    uint8_t inputs;             // JOURNAL_IN_* bits
+    uint8_t outputs;            // JOURNAL_OUT_* bits
+    uint8_t profileIndex;       // Active job profile
+    int32_t cutPositionSteps;
+    int32_t feedPositionSteps;
+    int16_t detail;             // Type-specific
+    uint32_t cutStrokes;        // Cut stroke count for correlating with the stroke monitor
+    uint16_t crc;               // CRC-16 of the bytes above
+} __attribute__((packed));
+
+static_assert(sizeof(JournalRecord) == 32, "JournalRecord must stay 32 bytes");
+
+// Records kept in RAM ahead of a fault
+const size_t JOURNAL_PRE_FAULT_RECORDS = 64;
+
+// Mount the partition, recover the write position and append a boot record
+void beginFaultJournal();
+
+// Record a state transition (called by the StateManager on every state entry)
+void journalStateChange(uint8_t fromState, uint8_t toState);
+
+// Take periodic snapshots and finish pending fault commits (called every tick)
+void serviceFaultJournal();
+
+// Visit stored records oldest first, limited to the newest maxRecords.
+// Returns the number of records visited.
+typedef void (*JournalRecordVisitor)(const JournalRecord& record, void* context);
+size_t forEachJournalRecord(size_t maxRecords, JournalRecordVisitor visitor, void* context);
+
+// Format one record as a text line (no trailing newline)
+void formatJournalRecord(const JournalRecord& record, char* buffer, size_t size);
+
+bool isFaultJournalMounted();
+uint32_t getJournalRecordCount();    // Records currently stored in flash
+uint32_t getJournalSectorErases();   // Sector erases since boot
+void printFaultJournalStatus();
+
+#endif // FAULT_JOURNAL_H
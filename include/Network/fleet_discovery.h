@@ -0,0 +1,27 @@
+#ifndef FLEET_DISCOVERY_H
+#define FLEET_DISCOVERY_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************* FLEET DISCOVERY ******************************
+//* ************************************************************************
+// Lets several stage-1 saws share a network without per-machine setup.
+//   - Identity: each controller is "stage1-xxyyzz" from the low three bytes
+//     of its MAC, used as the WiFi, mDNS and OTA hostname.
+//   - mDNS: _stage1._tcp and _http._tcp point at the diagnostics server; the
+//     _stage1 TXT records carry firmware version, state and cut counters.
+//   - Beacon: a one-line JSON status datagram to FLEET_BEACON_GROUP:
+//     FLEET_BEACON_PORT every FLEET_BEACON_INTERVAL_MS.
+// tools/fleet.py listens for the beacons and lists every machine.
+
+// Per-device hostname (valid before WiFi starts)
+const char* getDeviceName();
+
+// Advertise services and open the beacon socket (network task, after setupOTA)
+void beginFleetDiscovery();
+
+// Refresh TXT records and send the beacon when due (network task)
+void serviceFleetDiscovery();
+
+#endif // FLEET_DISCOVERY_H
@@ -0,0 +1,26 @@
+#ifndef NETWORK_TASK_H
+#define NETWORK_TASK_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** NETWORK TASK ********************************
+//* ************************************************************************
+// WiFi, OTA and the diagnostics server run in their own FreeRTOS task pinned
+// to NETWORK_TASK_CORE, away from the loop task, so setup() never waits on the
+// access point and homing starts straight after boot. A failed or dropped
+// connection is retried with an exponential backoff from
+// NETWORK_RECONNECT_MIN_MS up to NETWORK_RECONNECT_MAX_MS; the machine runs
+// normally without the network.
+//
+// Diagnostics server handlers therefore run on this task, not the loop task.
+
+// Create the task (call early in setup)
+void startNetworkTask();
+
+bool isNetworkConnected();
+
+// Times the connection dropped or an attempt failed since boot
+uint32_t getNetworkReconnectCount();
+
+#endif // NETWORK_TASK_H
@@ -0,0 +1,32 @@
+#ifndef OTA_HEALTH_CHECK_H
+#define OTA_HEALTH_CHECK_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************* OTA HEALTH CHECK *****************************
+//* ************************************************************************
+// An image written over OTA runs on probation. The first boots from it must
+// home the machine and reach IDLE within OTA_HEALTH_CHECK_TIMEOUT_MS; the
+// image is then marked valid. If it does not, or it restarts more than
+// OTA_HEALTH_CHECK_MAX_BOOTS times before getting there, the boot partition
+// is switched back to the image that installed it and the chip restarts.
+//
+// The probation record lives in NVS, so this works whether or not the
+// bootloader was built with app rollback; when it was, its pending-verify
+// state is honoured as well.
+
+// Record a freshly written image (called from the OTA end callback, after
+// the new partition has been set as the boot partition)
+void noteOtaImageInstalled();
+
+// Count this boot against the probation limit (call first thing in setup)
+void beginOtaHealthCheck();
+
+// Mark the image valid once homed in IDLE, or roll back on timeout (call every tick)
+void serviceOtaHealthCheck();
+
+// True while the running image is still on probation
+bool isOtaHealthCheckPending();
+
+#endif // OTA_HEALTH_CHECK_H
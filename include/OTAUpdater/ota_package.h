@@ -0,0 +1,60 @@
+#ifndef OTA_PACKAGE_H
+#define OTA_PACKAGE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* *************************** OTA PACKAGE ********************************
+//* ************************************************************************
+// Compressed and delta firmware updates, posted to /update on the
+// diagnostics server and applied into the inactive app slot while streaming.
+// Packages are built on a PC with tools/make_ota_package.py:
+//
+//   full  - the new image, zlib-compressed
+//   delta - zlib-compressed COPY/INSERT ops that rebuild the new image from
+//           the running one (COPY takes bytes from the running partition,
+//           INSERT carries literal bytes)
+//
+// The rebuilt image is checked against the SHA-256 in the package header
+// (and a delta's base against the running image) before it is made the
+// boot partition; it then boots on probation like any other OTA image.
+
+const uint16_t OTA_PACKAGE_FORMAT_VERSION = 1;
+
+enum OtaPackageType : uint8_t {
+    OTA_PACKAGE_FULL = 0,
+    OTA_PACKAGE_DELTA = 1
+};
+
+// Delta op codes (in the decompressed stream)
+const uint8_t OTA_DELTA_OP_COPY = 1;    // uint32 base offset, uint32 length
+const uint8_t OTA_DELTA_OP_INSERT = 2;  // uint32 length, then the bytes
+
+struct OtaPackageHeader {
+    char magic[4];              // "SPKG"
+    uint16_t version;           // OTA_PACKAGE_FORMAT_VERSION
+    uint16_t headerSize;
+    uint8_t type;               // OtaPackageType
+    uint8_t compression;        // 1 = zlib (the only one supported)
+    uint16_t reserved;
+    uint32_t imageSize;         // Bytes of the rebuilt image
+    uint32_t baseSize;          // Delta: bytes of the running image the ops copy from
+    uint8_t imageSha256[32];
+    uint8_t baseSha256[32];     // Delta: SHA-256 of the first baseSize bytes of the running image
+} __attribute__((packed));
+
+static_assert(sizeof(OtaPackageHeader) == 84, "OtaPackageHeader must stay 84 bytes");
+
+// Start applying a package. Fails (with a reason) outside the OTA-safe states.
+bool beginOtaPackage(const char** reason);
+
+// Feed the next part of the package as it arrives
+bool writeOtaPackage(const uint8_t* data, size_t length, const char** reason);
+
+// Verify the rebuilt image and make it the boot partition
+bool endOtaPackage(const char** reason);
+
+// Drop a partly written package
+void abortOtaPackage();
+
+#endif // OTA_PACKAGE_H
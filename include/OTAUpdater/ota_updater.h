@@ -2,13 +2,45 @@
 #define OTA_UPDATER_H
 
 #include <Arduino.h>
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
 
 //* ************************************************************************
 //* ************************* OTA UPDATER HEADER ***************************
 //* ************************************************************************
 // Declarations for Over-The-Air update functionality.
 
+// Start ArduinoOTA (called by the network task after WiFi connects)
 void setupOTA();
+
+// Poll for uploads - a no-op unless the machine is in an OTA-safe state
 void handleOTA();
 
+// Password for espota uploads, also required by the diagnostics server's
+// write endpoints (OTA_PASSWORD from the build environment)
+const char* getOtaPassword();
+
+// States in which an upload may start (motors stopped, no cycle running)
+bool isOtaAllowedInState(SystemState state);
+
+// True from the start of an upload until it fails or the machine restarts
+// into the new image
+bool isOtaUpdateInProgress();
+
+// Claim the upload flag for ArduinoOTA or an /update package. Fails if an
+// upload is already running or the machine is not in an OTA-safe state; the
+// state check and the claim are one step under the lock changeState() takes.
+bool tryClaimOtaUpdate();
+
+// Give the flag back after a failed or aborted upload; posts EVENT_OTA_ENDED
+// so IDLE looks at its inputs again. A successful upload keeps the flag
+// until the restart.
+void releaseOtaUpdate();
+
+// Bracket StateManager::changeState(). begin returns false (refuse the
+// transition) if an upload holds the flag and the transition would leave the
+// OTA-safe states for one that moves the motors; otherwise no upload can be
+// claimed until end is called, after currentState has been updated.
+bool beginOtaGuardedTransition(SystemState fromState, SystemState toState);
+void endOtaGuardedTransition();
+
 #endif // OTA_UPDATER_H 
\ No newline at end of file
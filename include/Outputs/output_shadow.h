@@ -0,0 +1,48 @@
+#ifndef OUTPUT_SHADOW_H
+#define OUTPUT_SHADOW_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ********************** OUTPUT SHADOW REGISTER **************************
+//* ************************************************************************
+// Shadow register for the digital outputs (clamps, LEDs, Transfer Arm signal).
+// Helpers record the desired level with setOutput(); flushOutputs() compares
+// desired vs. actual and drives only the changed bits through the GPIO
+// set/clear registers. Every flushed change is stored in a change log with a
+// microsecond timestamp.
+
+// One flushed output change
+struct OutputChangeLogEntry {
+    uint32_t timestampUs;   // micros() when the pin was driven
+    uint8_t pin;
+    uint8_t level;          // HIGH or LOW
+};
+
+// Number of entries kept in the change log ring
+const size_t OUTPUT_CHANGE_LOG_SIZE = 64;
+
+// Put a pin under shadow control (pinMode must already be OUTPUT).
+// The initial level is driven on the next flush.
+void registerShadowOutput(int pin, int initialLevel);
+
+// Set the desired level of a shadowed output (applied on the next flush)
+void setOutput(int pin, int level);
+int getOutput(int pin);
+
+// Drive changed outputs. The control loop flushes everything once per tick,
+// and before any blocking wait that depends on an output already being
+// applied. Other tasks pass the mask of the pins they own (see
+// getOutputMask()) so they never apply a half-updated set of clamp bits.
+const uint64_t ALL_OUTPUTS = ~(uint64_t)0;
+void flushOutputs(uint64_t mask = ALL_OUTPUTS);
+
+// Flush mask bit for a pin (0 for a pin outside GPIO 0-63)
+uint64_t getOutputMask(int pin);
+
+// Change log access
+uint32_t getOutputChangeCount();
+size_t copyOutputChangeLog(OutputChangeLogEntry* destination, size_t maxEntries); // Oldest first
+void printOutputChangeLog();
+
+#endif // OUTPUT_SHADOW_H
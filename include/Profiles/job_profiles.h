@@ -0,0 +1,63 @@
+#ifndef JOB_PROFILES_H
+#define JOB_PROFILES_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** JOB PROFILES ********************************
+//* ************************************************************************
+// Named material/job profiles holding the per-job motion parameters. Profiles
+// live in NVS and are edited from the diagnostics server or selected from the
+// start panel (reload switch ON + manual feed press steps to the next profile).
+//
+// The states read the active profile through getActiveJobProfile(). A new
+// selection or an edit of the active profile is only staged; the StateManager
+// swaps it in at a cycle boundary (entering IDLE or CUTTING, or while idle),
+// so a cycle never mixes parameters from two profiles.
+
+const uint8_t JOB_PROFILE_COUNT = 4;
+const size_t JOB_PROFILE_NAME_LENGTH = 16;
+
+struct JobProfile {
+    char name[JOB_PROFILE_NAME_LENGTH];
+    float cutSpeed;                          // Starting (minimum) cut speed, steps/sec
+    float cutTravelInches;                   // Cut stroke length
+    float feedTravelInches;                  // Feed retract position for each push (<= FEED_TRAVEL_DISTANCE)
+    float rotationClampEarlyOffsetInches;    // Clamp extends this far before the cut stroke ends
+    float rotationServoEarlyOffsetInches;    // Servo activates this far before the cut stroke ends
+    uint32_t rotationClampExtendMs;          // Rotation clamp hold time
+    uint32_t rotationServoReleaseDwellMs;    // Servo dwell at the active position before release
+    // Feed stroke plan
+    float firstCutPushInches[2];             // FEED_FIRST_CUT push targets (first and second run)
+    float firstCutParkOffsetInches;          // FEED_FIRST_CUT parks this far short of the feed travel
+    float noWoodRegripInches;                // RETURNING_NO_2x4 regrip position
+    // Added after the first stored layout; older blobs load with it off
+    bool adaptiveCut;                        // Let the adaptive controller raise the cut speed
+};
+
+// Load the profile table and the active selection from NVS (call once from setup)
+void beginJobProfiles();
+
+// Parameters of the profile in use for the current cycle
+const JobProfile& getActiveJobProfile();
+uint8_t getActiveJobProfileIndex();
+
+// Stored copy of a profile slot (nullptr for an invalid index)
+const JobProfile* getJobProfile(uint8_t index);
+
+// Stage a profile change; applied at the next cycle boundary
+bool requestJobProfile(uint8_t index);
+void requestNextJobProfile();
+bool isJobProfileChangePending();
+
+// Validate and store a profile slot. Editing the active slot stages a reload.
+// Returns false with a reason if a parameter is out of range.
+bool saveJobProfile(uint8_t index, const JobProfile& profile, const char** reason = nullptr);
+
+// Swap in the staged profile. Only called from the StateManager between cycles.
+// Returns true if the active profile changed.
+bool applyPendingJobProfile();
+
+void printJobProfile(uint8_t index);
+
+#endif // JOB_PROFILES_H
@@ -6,12 +6,16 @@
 //* ************************************************************************
 //* ************************** STARTUP STATE *******************************
 //* ************************************************************************
-// Handles the initial startup state, transitioning to HOMING.
+// Handles the initial startup state, transitioning to HOMING (or to ERROR
+// after a watchdog restart).
 
 class StartupState : public BaseState {
 public:
     void execute(StateManager& stateManager) override;
     SystemState getStateType() const override { return STARTUP; }
+
+private:
+    bool watchdogRestartChecked = false; // Only the first STARTUP after boot holds
 };
 
 #endif // STARTUP_STATE_H 
\ No newline at end of file
@@ -20,7 +20,6 @@ private:
     bool feedMotorHomed = false;
     bool feedMotorMoved = false;
     bool feedHomingPhaseInitiated = false;
-    unsigned long blinkTimer = 0;
 };
 
 #endif // HOMING_STATE_H 
\ No newline at end of file
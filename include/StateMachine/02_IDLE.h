@@ -10,14 +10,16 @@
 
 class IdleState : public BaseState {
 public:
-    void execute(StateManager& stateManager) override;
+    void execute(StateManager& stateManager) override {} // Event-driven, see onEvent()
     void onEnter(StateManager& stateManager) override;
+    void onEvent(StateManager& stateManager, const MachineEvent& event) override;
+    bool requiresPolling() const override { return false; } // Driven by switch edges, state entry and OTA end
     SystemState getStateType() const override { return IDLE; }
 
 private:
     void handleReloadModeLogic(StateManager& stateManager);
-    void checkFirstCutConditions(StateManager& stateManager);
-    void checkStartConditions(StateManager& stateManager);
+    void checkFirstCutConditions(StateManager& stateManager, bool manualFeedPressed);
+    void checkStartConditions(StateManager& stateManager, bool startCycleRose);
 };
 
 #endif // IDLE_STATE_H 
\ No newline at end of file
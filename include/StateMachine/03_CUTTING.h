@@ -2,6 +2,7 @@
 #define CUTTING_STATE_H
 
 #include "BaseState.h"
+#include "StateMachine/99_CUT_HOME_RECOVERY_FUNCTIONS.h"
 
 //* ************************************************************************
 //* ************************** CUTTING STATE *******************************
@@ -19,13 +20,12 @@ public:
 private:
     // Main cutting step tracking
     int cuttingStep = 0;
-    unsigned long stepStartTime = 0;
-    unsigned long signalStartTime = 0;
-    bool signalActive = false;
+    TimerHandle suctionCheckTimer = INVALID_TIMER_HANDLE; // Suction sensor settle wait (step 1)
+    bool suctionCheckDue = false;
     bool homePositionErrorDetected = false;
     bool rotationClampActivatedThisCycle = false;
     bool rotationServoActivatedThisCycle = false;
-    float cutMotorIncrementalMoveTotalInches = 0.0;
+    CutHomeRecovery cutHomeRecovery; // Non-blocking home check after the return (step 4)
     int cuttingSubStep8 = 0; // For feed motor homing sequence
     
     // Helper methods for different cutting phases
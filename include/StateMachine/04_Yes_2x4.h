@@ -2,6 +2,7 @@
 #define RETURNING_YES_2X4_STATE_H
 
 #include "BaseState.h"
+#include "StateMachine/99_CUT_HOME_RECOVERY_FUNCTIONS.h"
 
 //* ************************************************************************
 //* ************************ RETURNING YES 2X4 STATE **********************
@@ -20,6 +21,8 @@ private:
     // RETURNING_YES_2x4 sequence tracking
     int returningYes2x4SubStep = 0;
     int feedHomingSubStep = 0; // For feed motor homing sequence
+    CutHomeRecovery cutHomeRecovery; // Non-blocking home check after the return (step 1)
+    bool strokeLostSteps = false;    // Stroke monitor verdict for the current return
     
     // Helper methods for RETURNING_YES_2x4 sequence
     void handleReturningYes2x4Sequence(StateManager& stateManager);
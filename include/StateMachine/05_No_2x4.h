@@ -2,6 +2,7 @@
 #define RETURNING_NO_2X4_STATE_H
 
 #include "BaseState.h"
+#include "StateMachine/99_CUT_HOME_RECOVERY_FUNCTIONS.h"
 
 //* ************************************************************************
 //* ************************ RETURNING NO 2X4 STATE ***********************
@@ -20,8 +21,10 @@ private:
     // RETURNING_NO_2x4 sequence tracking
     int returningNo2x4Step = 0;
     int returningNo2x4HomingSubStep = 0; // For RETURNING_NO_2x4 feed motor homing sequence
-    unsigned long cylinderActionTime = 0;
+    TimerHandle cylinderTimer = INVALID_TIMER_HANDLE; // Clamp cylinder settle wait
+    bool cylinderSettled = false;
     bool waitingForCylinder = false;
+    CutHomeRecovery cutHomeRecovery; // Non-blocking home check before feed homing (step 8)
     
     // Helper methods for RETURNING_NO_2x4 sequence
     void handleReturningNo2x4Sequence(StateManager& stateManager);
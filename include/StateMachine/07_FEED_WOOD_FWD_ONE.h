@@ -2,6 +2,7 @@
 #define FEED_WOOD_FWD_ONE_STATE_H
 
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_SEQUENCE_FUNCTIONS.h"
 
 class StateManager; // Forward declaration
 
@@ -19,21 +20,8 @@ public:
     SystemState getStateType() const { return FEED_WOOD_FWD_ONE; }
 
 private:
-    enum FeedWoodFwdOneStep {
-        RETRACT_FEED_CLAMP,
-        MOVE_POSITION_MOTOR_TO_ZERO,
-        EXTEND_FEED_CLAMP_RETRACT_SECURE,
-        WAIT_200MS,
-        MOVE_TO_TRAVEL_DISTANCE,
-        CHECK_START_CYCLE_SWITCH
-    };
-
-    // Member to track the current step in the feed wood forward one sequence
-    FeedWoodFwdOneStep currentStep = RETRACT_FEED_CLAMP;
-    
-    void executeStep(StateManager& stateManager);
-    void advanceToNextStep(StateManager& stateManager);
-    unsigned long stepStartTime = 0;
+    // Steps come from the SEQUENCE_FEED_WOOD_FWD_ONE sequence (built-in or uploaded)
+    SequenceRunner sequence;
 };
 
 #endif // FEED_WOOD_FWD_ONE_STATE_H 
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define FEED_FIRST_CUT_STATE_H
 
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_SEQUENCE_FUNCTIONS.h"
 
 class StateManager; // Forward declaration
 
@@ -19,27 +20,8 @@ public:
     SystemState getStateType() const { return FEED_FIRST_CUT; }
 
 private:
-    enum FeedFirstCutStep {
-        RETRACT_FEED_CLAMP,
-        MOVE_TO_NEGATIVE_ONE,
-        EXTEND_FEED_CLAMP_RETRACT_SECURE,
-        WAIT_200MS,
-        MOVE_TO_TRAVEL_DISTANCE,
-        FIRST_RUN_COMPLETE,
-        RETRACT_FEED_CLAMP_SECOND,
-        MOVE_TO_NEGATIVE_TWO,
-        EXTEND_FEED_CLAMP_RETRACT_SECURE_SECOND,
-        WAIT_200MS_SECOND,
-        MOVE_TO_TRAVEL_DISTANCE_MINUS_2_75,
-        CHECK_START_CYCLE_SWITCH
-    };
-
-    // Member to track the current step in the feed first cut sequence
-    FeedFirstCutStep currentStep = RETRACT_FEED_CLAMP;
-    
-    void executeStep(StateManager& stateManager);
-    void advanceToNextStep(StateManager& stateManager);
-    unsigned long stepStartTime = 0;
+    // Steps come from the SEQUENCE_FEED_FIRST_CUT sequence (built-in or uploaded)
+    SequenceRunner sequence;
 };
 
 #endif // FEED_FIRST_CUT_STATE_H 
\ No newline at end of file
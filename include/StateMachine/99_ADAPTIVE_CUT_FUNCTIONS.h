@@ -0,0 +1,43 @@
+#ifndef ADAPTIVE_CUT_FUNCTIONS_H
+#define ADAPTIVE_CUT_FUNCTIONS_H
+
+#include <Arduino.h>
+#include "StateMachine/99_STROKE_MONITOR_FUNCTIONS.h"
+
+//* ************************************************************************
+//* ********************** ADAPTIVE CUT FEED RATE **************************
+//* ************************************************************************
+// Cycle-over-cycle cut speed controller. Starts at the active job profile's cut speed
+// and raises it after consecutive clean strokes; backs off when a load proxy
+// flags an anomaly:
+//   - stroke monitor verdict (drift warning / lost steps / missed switch)
+//   - optional motor current sense on an ADC pin, sampled during the cut stroke
+// The learned rate is stored in NVS per material profile, so each profile
+// restarts from the fastest rate it last cut cleanly. Profiles opt in with
+// JobProfile::adaptiveCut; without it the profile cut speed is used as is.
+
+// Load the learned rate for a profile (call at startup and when the profile changes)
+void beginAdaptiveCut(uint8_t profileIndex);
+
+// Cut speed to use for the next cutting pass (steps/sec)
+float getCutMotorCuttingSpeed();
+
+// Write a pending learned rate to NVS once both axes have stopped (called every tick)
+void serviceAdaptiveCut();
+
+// Runtime enable (disabled = fixed profile cut speed); reset from the profile on each load
+void setAdaptiveCutEnabled(bool enabled);
+bool isAdaptiveCutEnabled();
+
+// Sample the optional current sense input - call every tick of the cut stroke
+void sampleAdaptiveCutLoad();
+
+// Apply the outcome of a complete stroke (cut + return) and adjust the rate
+void recordAdaptiveCutOutcome(StrokeVerdict verdict);
+
+// Forget the learned rate of the active profile and restart from the minimum
+void resetAdaptiveCutRate();
+
+void printAdaptiveCutStatus();
+
+#endif // ADAPTIVE_CUT_FUNCTIONS_H
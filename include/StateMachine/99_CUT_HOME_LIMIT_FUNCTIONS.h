@@ -0,0 +1,50 @@
+#ifndef CUT_HOME_LIMIT_FUNCTIONS_H
+#define CUT_HOME_LIMIT_FUNCTIONS_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************** CUT HOME LIMIT ******************************
+//* ************************************************************************
+// Stops the cut motor on the home switch during the RETURNING_YES_2x4 return
+// from the switch's rising-edge interrupt instead of at loop rate. The
+// interrupt calls FastAccelStepper::forceStop(), which stops adding steps at
+// once; what is already queued still goes out, so the overshoot is bounded by
+// the cut motor's forward planning time (CUT_MOTOR_FORWARD_PLANNING_MS):
+// at most speed x planning time steps. The short planning time applies only
+// between beginCutReturnHomeLimit() and endCutReturnHomeLimit(); every other
+// cut motor move keeps the library default, which tolerates more loop jitter.
+//
+// Once the motor has stopped, serviceCutHomeLimit() records how far it ran
+// past the edge, re-zeroes it like the loop-rate stop did, and keeps a
+// histogram of overshoot steps for GET /homestop. The loop-rate check stays as
+// a fallback for a switch that was already made when the return started.
+//
+// The same interrupt records the position and time of every rising edge, in
+// any state, for the cut stroke monitor (takeCutHomeEdge()).
+
+// Histogram bucket b counts overshoots of [2^(b-1), 2^b) steps; bucket 0 is 0 steps
+const uint8_t CUT_HOME_LIMIT_BUCKETS = 12;
+
+// Attach the home switch interrupt (call from setup once the cut motor exists)
+void beginCutHomeLimit();
+
+// Arm the interrupt stop and shorten the forward planning for the
+// RETURNING_YES_2x4 return (call before queuing the return move)
+void beginCutReturnHomeLimit();
+
+// Disarm it and restore the default planning time (safe to call twice)
+void endCutReturnHomeLimit();
+
+// Finish a stop started by the interrupt, or stop at loop rate if the
+// interrupt could not (called every tick from the common operations)
+void serviceCutHomeLimit(bool switchHigh);
+
+// Latest rising edge since the last call: cut motor position and
+// esp_timer time at the interrupt. Returns false if there was none.
+bool takeCutHomeEdge(int32_t& position, int64_t& timeUs);
+
+// Append the overshoot distribution and the expected bound
+void formatCutHomeLimitReport(String& out);
+
+#endif // CUT_HOME_LIMIT_FUNCTIONS_H
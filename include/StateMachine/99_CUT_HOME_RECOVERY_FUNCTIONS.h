@@ -0,0 +1,71 @@
+#ifndef CUT_HOME_RECOVERY_FUNCTIONS_H
+#define CUT_HOME_RECOVERY_FUNCTIONS_H
+
+#include <Arduino.h>
+#include "FlightRecorder/flight_recorder.h"
+
+//* ************************************************************************
+//* ********************* CUT MOTOR HOME RECOVERY **************************
+//* ************************************************************************
+// Non-blocking verification of the cut motor home switch after a return
+// stroke, with in-line recovery when the switch is not made:
+//
+//   VERIFYING     read the switch CUT_HOME_VERIFY_ATTEMPTS times, one settle
+//                 period apart. HIGH on any read re-zeroes the motor: done.
+//   SEEKING       slow ramped move toward home, at most CUT_HOME_RECOVERY_MAX_SEEK_INCHES
+//   BACKING_OFF   once the switch is made and holds, move off it and check it
+//                 releases (a switch that stays HIGH is stuck, not homed)
+//   REAPPROACHING slower move back onto the switch, then re-verify and re-zero
+//
+// Call begin() once both motors have stopped, then update() every tick until
+// it returns CUT_HOME_HOMED or CUT_HOME_FAILED. The cut motor is left stopped
+// with the cutting speed configured either way.
+
+enum CutHomeRecoveryStatus {
+    CUT_HOME_IN_PROGRESS,
+    CUT_HOME_HOMED,             // Switch verified, position re-zeroed
+    CUT_HOME_FAILED             // Switch not found or stuck - caller decides (normally ERROR)
+};
+
+class CutHomeRecovery {
+public:
+    // Start verification. trigger is the flight recorder reason used if the
+    // first verification fails.
+    void begin(const char* context, FlightRecorderTrigger trigger);
+    CutHomeRecoveryStatus update();
+
+    bool isActive() const { return phase != PHASE_IDLE; }
+    bool didRecover() const { return recovered; }  // Homed only after a seek
+    const char* getFailureReason() const { return failureReason; }
+
+    // Stop the recovery move (state exit or external error)
+    void cancel();
+
+private:
+    enum Phase {
+        PHASE_IDLE,
+        PHASE_VERIFYING,
+        PHASE_SEEKING,
+        PHASE_SEEK_SETTLING,
+        PHASE_BACKING_OFF,
+        PHASE_BACKOFF_SETTLING,
+        PHASE_REAPPROACHING,
+        PHASE_REVERIFYING
+    };
+
+    Phase phase = PHASE_IDLE;
+    const char* context = "";
+    FlightRecorderTrigger trigger = FLIGHT_TRIGGER_NONE;
+    const char* failureReason = nullptr;
+    bool recovered = false;
+    int verifyAttempt = 0;
+    unsigned long phaseStartTime = 0;
+    unsigned long recoveryStartTime = 0;
+
+    void enterPhase(Phase next);
+    void startMove(float speed, long steps);
+    CutHomeRecoveryStatus finishHomed();
+    CutHomeRecoveryStatus fail(const char* reason);
+};
+
+#endif // CUT_HOME_RECOVERY_FUNCTIONS_H
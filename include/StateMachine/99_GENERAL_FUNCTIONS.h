@@ -5,6 +5,10 @@
 #include <ESP32Servo.h> // For Servo object
 #include <FastAccelStepper.h> // For FastAccelStepper objects
 #include <Bounce2.h> // <<< ADDED for Bounce type
+#include "StatusLeds/led_pattern_engine.h" // Status LEDs are driven by the pattern engine
+#include "Outputs/output_shadow.h" // Clamps, LEDs and signals are written through the shadow register
+#include "Timing/timer_wheel.h" // Timeouts are scheduled on the timer wheel
+#include "Profiles/job_profiles.h" // Motion parameters come from the active job profile
 
 //* ************************************************************************
 //* ************************* FUNCTIONS HEADER *****************************
@@ -24,8 +28,7 @@ enum SystemState {
   CUTTING,
   RETURNING_YES_2x4,
   RETURNING_NO_2x4,
-  RETURNING,
-  ERROR,
+  ERROR = 9,            // 8 was RETURNING (never entered); values are stored in journal records and traces
   ERROR_RESET,
   SUCTION_ERROR_HOLD
 };
@@ -61,11 +64,8 @@ extern const int ROTATION_SERVO_ACTIVE_POSITION;
 // Extern declarations for global variables from "Stage 1 Feb25.cpp"
 extern SystemState currentState;
 extern Servo rotationServo;
-extern unsigned long rotationServoActiveStartTime;
 extern bool rotationServoIsActiveAndTiming;
-extern unsigned long rotationClampExtendTime;
 extern bool rotationClampIsExtended;
-extern unsigned long signalTAStartTime; // For Transfer Arm signal
 extern bool signalTAActive; // For Transfer Arm signal
 
 // Extern declarations for motor objects
@@ -91,13 +91,11 @@ extern const float FEED_MOTOR_RETURN_ACCELERATION;
 extern const float FEED_MOTOR_HOMING_SPEED;
 
 // Additional constants
-extern const float CUT_MOTOR_INCREMENTAL_MOVE_INCHES;
-extern const float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES;
 extern const unsigned long CUT_HOME_TIMEOUT;
 extern const float ROTATION_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES;
 
 // Constants
-extern const unsigned long ROTATION_SERVO_ACTIVE_HOLD_DURATION_MS;
+extern const unsigned long ROTATION_SERVO_RELEASE_DWELL_MS;
 extern const unsigned long ROTATION_CLAMP_EXTEND_DURATION_MS;
 extern const unsigned long TA_SIGNAL_DURATION; // Duration for TA signal
 
@@ -117,16 +115,10 @@ extern bool cuttingCycleInProgress;
 extern bool continuousModeActive;
 extern bool startSwitchSafe;
 
-// Timers for LEDs/Errors
-extern unsigned long lastBlinkTime;
-extern unsigned long lastErrorBlinkTime;
+// Timers for Errors
 extern unsigned long errorStartTime;
 extern unsigned long feedMoveStartTime;
 
-// LED states for blinking
-extern bool blinkState;
-extern bool errorBlinkState;
-
 // Function Prototypes
 
 //* ************************************************************************
@@ -134,7 +126,6 @@ extern bool errorBlinkState;
 //* ************************************************************************
 // Contains functions related to signaling other stages or components.
 void sendSignalToTA(); // Signal to Transfer Arm
-void handleTASignalTiming(); // Handles timing for TA signal
 
 //* ************************************************************************
 //* ************************* CLAMP FUNCTIONS ******************************
@@ -146,25 +137,6 @@ void extend2x4SecureClamp();
 void retract2x4SecureClamp();
 void extendRotationClamp();
 void retractRotationClamp();
-void handleRotationClampRetract(); // Point 4
-
-//* ************************************************************************
-//* *************************** LED FUNCTIONS ******************************
-//* ************************************************************************
-// Contains functions for controlling LEDs.
-void turnRedLedOn();
-void turnRedLedOff();
-void turnYellowLedOn();
-void turnYellowLedOff();
-void turnGreenLedOn();
-void turnGreenLedOff();
-void turnBlueLedOn();
-void turnBlueLedOff();
-void allLedsOff();
-// Point 1: LED Blinking Logic
-void handleHomingLedBlink();
-void handleErrorLedBlink();
-void handleSuctionErrorLedBlink(unsigned long& lastBlinkTimeRef, bool& blinkStateRef);
 
 //* ************************************************************************
 //* *********************** MOTOR CONTROL FUNCTIONS ************************
@@ -183,9 +155,10 @@ void moveFeedMotorToPostCutHome();  // New function for post-cut positioning
 void moveFeedMotorToPosition(float targetPositionInches);
 void stopCutMotor();
 void stopFeedMotor();
-void homeCutMotorBlocking(Bounce& homingSwitch, unsigned long timeout);
-void homeFeedMotorBlocking(Bounce& homingSwitch);
+bool homeCutMotorBlocking(Bounce& homingSwitch, unsigned long timeout); // False on a timeout
+bool homeFeedMotorBlocking(Bounce& homingSwitch, unsigned long timeout); // False on a timeout
 void moveFeedMotorToInitialAfterHoming();
+bool waitForMotorStop(FastAccelStepper* motor, unsigned long timeout); // Stops it and returns false on a timeout
 // Point 3: Complex conditional logic
 bool checkAndRecalibrateCutMotorHome(int attempts);
 
@@ -203,9 +176,11 @@ void handleStartSwitchContinuousMode(); // Continuous mode from main loop
 //* ************************************************************************
 // Point 3: Complex conditional logic
 bool shouldStartCycle();
+bool mayStartCycle(); // Every cycle start, from IDLE or continuous mode; false at MEMORY_CRITICAL
 // Point 4
 void activateRotationServo();
 void handleRotationServoReturn();
+bool isRotationServoReleaseDue(); // Servo arrived at active position and release dwell elapsed
 
 //* ************************************************************************
 //* ************************* ERROR STATE FUNCTIONS ************************
@@ -0,0 +1,54 @@
+#ifndef INVARIANT_FUNCTIONS_H
+#define INVARIANT_FUNCTIONS_H
+
+#include <Arduino.h>
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+
+//* ************************************************************************
+//* ************************* STATE INVARIANTS *****************************
+//* ************************************************************************
+// Safety properties checked once per control tick, whatever the states or a
+// tuning change did:
+//   - the cut motor is never moving away from home while the feed motor is
+//     advancing the wood (a positive feed move with the feed clamp extended)
+//   - STATE_INVARIANT_ERROR_GRACE_MS after entering ERROR both motors have
+//     stopped and the wood is held by the feed or 2x4 secure clamp
+//   - no state other than IDLE and the operator-reset holds lasts longer
+//     than STATE_INVARIANT_STUCK_MS
+// A violation is reported on serial when it starts and counted; the checks
+// never change outputs. Build with -DSTATE_INVARIANT_CHECKS=0 to compile
+// them out.
+
+#ifndef STATE_INVARIANT_CHECKS
+#define STATE_INVARIANT_CHECKS 1
+#endif
+
+enum StateInvariant : uint8_t {
+    INVARIANT_CUT_WHILE_FEED_ADVANCING,
+    INVARIANT_MOTOR_RUNNING_IN_ERROR,
+    INVARIANT_WOOD_UNCLAMPED_IN_ERROR,
+    INVARIANT_STATE_STUCK,
+    INVARIANT_COUNT
+};
+
+#if STATE_INVARIANT_CHECKS
+
+// Check every invariant against the current state and outputs (called once per tick)
+void checkStateInvariants(SystemState state);
+
+// Violations since boot (each counted once when it starts)
+uint32_t getStateInvariantViolations(StateInvariant invariant);
+uint32_t getTotalStateInvariantViolations();
+
+const char* getStateInvariantName(uint8_t invariant);
+
+#else
+
+static inline void checkStateInvariants(SystemState) {}
+static inline uint32_t getStateInvariantViolations(StateInvariant) { return 0; }
+static inline uint32_t getTotalStateInvariantViolations() { return 0; }
+static inline const char* getStateInvariantName(uint8_t) { return "disabled"; }
+
+#endif // STATE_INVARIANT_CHECKS
+
+#endif // INVARIANT_FUNCTIONS_H
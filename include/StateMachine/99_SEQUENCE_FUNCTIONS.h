@@ -0,0 +1,157 @@
+#ifndef SEQUENCE_FUNCTIONS_H
+#define SEQUENCE_FUNCTIONS_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ SEQUENCE INTERPRETER **************************
+//* ************************************************************************
+// The feed sequences (FEED_FIRST_CUT, FEED_WOOD_FWD_ONE) are small bytecode
+// programs run by SequenceRunner instead of hand-written step enums. The
+// built-in programs are compiled into flash; a replacement can be uploaded
+// to the diagnostics server, is checked by validateSequence(), stored in NVS
+// and used from the next time the sequence starts. Programs are written in a
+// text form and compiled with tools/seqc.py (sources in tools/sequences/).
+//
+// Each instruction is 6 bytes: op, a, b (signed), c (unsigned):
+//   END          a = exit code (SEQUENCE_EXIT_*)
+//   MOVE_FEED    feed motor to param a (SEQUENCE_PARAM_*) + b/100 inch
+//   WAIT_FEED    until the feed motor stops; fail after c ms (0 = no limit)
+//   SET_OUTPUT   output a extended (b = 1) or retracted (b = 0)
+//   WAIT_MS      c ms
+//   WAIT_INPUT   until input a reads level b; fail after c ms (0 = no limit)
+//   BRANCH_INPUT jump to instruction c if input a reads level b
+//   JUMP         jump to instruction c
+// State transitions stay in the states: a program only ends with an exit
+// code, which its state maps to the next state.
+
+enum SequenceOp : uint8_t {
+    SEQUENCE_OP_END,
+    SEQUENCE_OP_MOVE_FEED,
+    SEQUENCE_OP_WAIT_FEED,
+    SEQUENCE_OP_SET_OUTPUT,
+    SEQUENCE_OP_WAIT_MS,
+    SEQUENCE_OP_WAIT_INPUT,
+    SEQUENCE_OP_BRANCH_INPUT,
+    SEQUENCE_OP_JUMP,
+    SEQUENCE_OP_COUNT
+};
+
+// Feed positions taken from the active job profile
+enum SequenceParam : uint8_t {
+    SEQUENCE_PARAM_ZERO,            // Literal: b/100 inch from home
+    SEQUENCE_PARAM_FEED_TRAVEL,
+    SEQUENCE_PARAM_FIRST_PUSH_1,
+    SEQUENCE_PARAM_FIRST_PUSH_2,
+    SEQUENCE_PARAM_FIRST_CUT_PARK,  // Feed travel minus the first-cut park offset
+    SEQUENCE_PARAM_NO_WOOD_REGRIP,
+    SEQUENCE_PARAM_COUNT
+};
+
+enum SequenceOutput : uint8_t {
+    SEQUENCE_OUTPUT_FEED_CLAMP,
+    SEQUENCE_OUTPUT_SECURE_CLAMP,
+    SEQUENCE_OUTPUT_ROTATION_CLAMP,
+    SEQUENCE_OUTPUT_COUNT
+};
+
+enum SequenceInput : uint8_t {
+    SEQUENCE_INPUT_START_SWITCH,    // Debounced
+    SEQUENCE_INPUT_2X4_SENSOR,
+    SEQUENCE_INPUT_SUCTION_SENSOR,
+    SEQUENCE_INPUT_FEED_HOME,       // Debounced
+    SEQUENCE_INPUT_CUT_HOME,        // Debounced
+    SEQUENCE_INPUT_COUNT
+};
+
+// Exit codes understood by the feed states
+enum SequenceExit : uint8_t {
+    SEQUENCE_EXIT_IDLE = 0,
+    SEQUENCE_EXIT_CUT = 1,
+    SEQUENCE_EXIT_COUNT
+};
+
+struct SequenceInstruction {
+    uint8_t op;
+    uint8_t a;
+    int16_t b;
+    uint16_t c;
+} __attribute__((packed));
+
+static_assert(sizeof(SequenceInstruction) == 6, "SequenceInstruction must stay 6 bytes");
+
+const size_t SEQUENCE_MAX_INSTRUCTIONS = 64;
+
+// Instructions run per update() before yielding, so a loop without a wait
+// cannot hang the control loop
+const uint8_t SEQUENCE_MAX_STEPS_PER_UPDATE = 16;
+
+struct SequenceProgram {
+    uint16_t length;
+    SequenceInstruction code[SEQUENCE_MAX_INSTRUCTIONS];
+};
+
+enum SequenceId : uint8_t {
+    SEQUENCE_FEED_FIRST_CUT,
+    SEQUENCE_FEED_WOOD_FWD_ONE,
+    SEQUENCE_COUNT
+};
+
+// Uploaded blob: "SEQ1", uint16 instruction count, then the instructions (little-endian)
+const size_t SEQUENCE_BLOB_HEADER_SIZE = 6;
+
+// Load uploaded replacements from NVS (call from setup)
+void beginSequences();
+
+// Copy of the program the next run of a sequence will use
+void getSequence(SequenceId id, SequenceProgram& program);
+bool isSequenceReplaced(SequenceId id);
+
+// Check, store and switch to an uploaded blob; used from the next start of the sequence
+bool installSequence(SequenceId id, const uint8_t* blob, size_t length, const char** reason);
+
+// Go back to the built-in program
+void resetSequence(SequenceId id);
+
+bool validateSequence(const SequenceProgram& program, const char** reason);
+const char* getSequenceName(SequenceId id);
+bool findSequenceByName(const char* name, SequenceId& id);
+
+// Append a disassembly (same syntax tools/seqc.py compiles)
+void formatSequence(SequenceId id, String& out);
+
+enum SequenceStatus {
+    SEQUENCE_RUNNING,
+    SEQUENCE_DONE,              // Ended; see getExitCode()
+    SEQUENCE_FAILED             // Wait timed out or a move was out of range
+};
+
+class SequenceRunner {
+public:
+    // Start from the first instruction of the current program for id
+    void begin(const char* context, SequenceId id);
+    SequenceStatus update();
+
+    bool isActive() const { return active; }
+    uint8_t getExitCode() const { return exitCode; }
+    const char* getFailureReason() const { return failureReason; }
+
+    // Stop the feed motor and drop the program (state exit or external error)
+    void cancel();
+
+private:
+    SequenceProgram program;    // Copied at begin() so an upload never changes a running sequence
+    const char* context = "";
+    bool active = false;
+    uint16_t pc = 0;
+    bool waiting = false;       // The instruction at pc is a wait that has started
+    unsigned long waitStartTime = 0;
+    uint8_t exitCode = SEQUENCE_EXIT_IDLE;
+    const char* failureReason = nullptr;
+
+    bool step(const SequenceInstruction& instruction, SequenceStatus& status);
+    bool holdWait(uint16_t timeoutMs, const char* timeoutReason, SequenceStatus& status);
+    SequenceStatus fail(const char* reason);
+};
+
+#endif // SEQUENCE_FUNCTIONS_H
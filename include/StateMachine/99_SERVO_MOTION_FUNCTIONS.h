@@ -0,0 +1,140 @@
+#ifndef SERVO_MOTION_FUNCTIONS_H
+#define SERVO_MOTION_FUNCTIONS_H
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+
+//* ************************************************************************
+//* ********************* SERVO MOTION CONTROLLER *************************
+//* ************************************************************************
+// Velocity-ramped motion controller for hobby servos with open-loop position
+// estimation. Works with any servo class exposing write(angle), which covers
+// both the ESP32Servo Servo used by the machine and the vendored ServoTemplate
+// in lib/ServoESP32.
+//
+// The servo has no position feedback, so arrival is estimated from a
+// calibrated speed model: a fixed command latency plus the travel distance
+// at the slower of the commanded ramp velocity and the servo's loaded slew rate.
+
+template <class ServoT>
+class ServoMotionController {
+public:
+    explicit ServoMotionController(ServoT& servo) : servo(servo) {}
+
+    // Ramp rate used when stepping the commanded angle (degrees/sec)
+    void setVelocity(float degreesPerSecond) { velocityDegPerSec = degreesPerSecond; }
+
+    // Calibrated physical slew rate (degrees/sec) and command latency (ms)
+    void setSpeedModel(float degreesPerSecond, unsigned long latencyMs) {
+        modelSpeedDegPerSec = degreesPerSecond;
+        modelLatencyMs = latencyMs;
+    }
+
+    // Start a ramped move. The first move after boot jumps straight to the
+    // target because the real servo position is unknown until commanded once.
+    void moveTo(int targetDegrees) {
+        unsigned long now = millis();
+        if (!positionKnown) {
+            servo.write(targetDegrees);
+            lastWrittenDeg = targetDegrees;
+            startDeg = targetDegrees;
+            commandDeg = targetDegrees;
+            targetDeg = targetDegrees;
+            moveStartMs = now;
+            travelTimeMs = modelLatencyMs + (unsigned long)(180.0f * 1000.0f / modelSpeedDegPerSec);
+            ramping = false;
+            arrived = false;
+            positionKnown = true;
+            return;
+        }
+
+        startDeg = getEstimatedPosition();
+        commandDeg = startDeg;
+        targetDeg = targetDegrees;
+        moveStartMs = now;
+        travelTimeMs = estimateTravelTimeMs((int)lroundf(startDeg), targetDegrees);
+        ramping = true;
+        arrived = false;
+    }
+
+    // Advance the ramp and arrival estimate - call once per loop tick
+    void update() {
+        if (!positionKnown) return;
+        unsigned long elapsed = millis() - moveStartMs;
+
+        if (ramping) {
+            float totalDelta = (float)targetDeg - startDeg;
+            float rampDelta = velocityDegPerSec * elapsed / 1000.0f;
+            if (rampDelta >= fabsf(totalDelta)) {
+                commandDeg = targetDeg;
+                ramping = false;
+            } else {
+                commandDeg = startDeg + (totalDelta > 0 ? rampDelta : -rampDelta);
+            }
+
+            int degreesToWrite = (int)lroundf(commandDeg);
+            if (degreesToWrite != lastWrittenDeg) {
+                servo.write(degreesToWrite);
+                lastWrittenDeg = degreesToWrite;
+            }
+        }
+
+        if (!arrived && elapsed >= travelTimeMs) {
+            arrived = true;
+            arrivalMs = moveStartMs + travelTimeMs;
+        }
+    }
+
+    // Time for the servo to physically travel between two angles
+    unsigned long estimateTravelTimeMs(int fromDegrees, int toDegrees) const {
+        float effectiveSpeed = min(velocityDegPerSec, modelSpeedDegPerSec);
+        float distance = fabsf((float)toDegrees - (float)fromDegrees);
+        return modelLatencyMs + (unsigned long)(distance * 1000.0f / effectiveSpeed);
+    }
+
+    // Estimated physical position from the speed model
+    float getEstimatedPosition() const {
+        if (arrived || !positionKnown) return targetDeg;
+        unsigned long elapsed = millis() - moveStartMs;
+        if (elapsed <= modelLatencyMs) return startDeg;
+        float effectiveSpeed = min(velocityDegPerSec, modelSpeedDegPerSec);
+        float totalDelta = (float)targetDeg - startDeg;
+        float travelled = effectiveSpeed * (elapsed - modelLatencyMs) / 1000.0f;
+        if (travelled >= fabsf(totalDelta)) return targetDeg;
+        return startDeg + (totalDelta > 0 ? travelled : -travelled);
+    }
+
+    bool isRamping() const { return ramping; }
+    bool hasArrived() const { return arrived; }
+    bool isAtPosition(int degrees) const { return arrived && targetDeg == degrees; }
+    unsigned long getArrivalTime() const { return arrivalMs; }
+    unsigned long getTravelTimeMs() const { return travelTimeMs; }
+    float getCommandedPosition() const { return commandDeg; }
+    int getTargetPosition() const { return targetDeg; }
+
+private:
+    ServoT& servo;
+
+    float velocityDegPerSec = 600.0f;
+    float modelSpeedDegPerSec = 400.0f;
+    unsigned long modelLatencyMs = 20;
+
+    bool positionKnown = false;
+    bool ramping = false;
+    bool arrived = false;
+    float startDeg = 0.0f;
+    float commandDeg = 0.0f;
+    int targetDeg = 0;
+    int lastWrittenDeg = -1;
+    unsigned long moveStartMs = 0;
+    unsigned long travelTimeMs = 0;
+    unsigned long arrivalMs = 0;
+};
+
+// Rotation servo controller instance (defined in 99_SERVO_MOTION_FUNCTIONS.cpp)
+extern ServoMotionController<Servo> rotationServoMotion;
+
+// Apply the configured velocity and speed model to the rotation servo controller
+void configureRotationServoMotion();
+
+#endif // SERVO_MOTION_FUNCTIONS_H
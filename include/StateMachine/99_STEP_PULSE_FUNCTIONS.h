@@ -0,0 +1,62 @@
+#ifndef STEP_PULSE_FUNCTIONS_H
+#define STEP_PULSE_FUNCTIONS_H
+
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+
+//* ************************************************************************
+//* ************************* STEP PULSE CHECK *****************************
+//* ************************************************************************
+// Independent check of the position FastAccelStepper reports. A PCNT unit
+// counts the pulses actually on each motor's STEP pin (up or down with the
+// DIR pin), so at the end of every move the pulse count must have changed by
+// exactly as much as getCurrentPosition(). A difference means steps the
+// library counted but never emitted, or the reverse.
+//
+// The counter wraps every STEP_PULSE_COUNTER_RANGE pulses, so moves are
+// compared modulo that range: any move length works as long as the
+// discrepancy itself stays under half the range.
+//
+// Code that re-references a motor with setCurrentPosition() while a move may
+// still be in flight (home switch stops) calls rebaseStepPulseCheck() straight
+// after, so the rest of that move is checked from the new position.
+
+enum StepPulseMotor : uint8_t {
+    STEP_PULSE_CUT,
+    STEP_PULSE_FEED,
+    STEP_PULSE_MOTOR_COUNT
+};
+
+// Pulse counter limits; the count resets to 0 at either one
+const int16_t STEP_PULSE_COUNTER_RANGE = 16384;
+
+struct StepPulseStats {
+    bool attached;              // Pulse counter running on this motor's STEP pin
+    uint32_t moves;             // Moves checked
+    uint32_t mismatchedMoves;   // Moves off by more than STEP_PULSE_TOLERANCE_STEPS
+    uint32_t rebases;           // Moves re-referenced mid-flight
+    int32_t lastDiscrepancy;    // Commanded minus emitted steps, last move
+    int32_t worstDiscrepancy;   // Largest magnitude seen
+    uint32_t lastMismatchMs;    // Uptime of the last mismatch (0 = none)
+};
+
+// Attach the pulse counters (call from setup once both motors exist)
+void beginStepPulseCheck();
+
+// Start and finish per-move checks (called every tick from the common
+// operations, before anything that re-zeroes a motor that has just stopped)
+void serviceStepPulseCheck();
+
+// Restart the check of a move in flight after setCurrentPosition()
+void rebaseStepPulseCheck(FastAccelStepper* motor);
+
+StepPulseStats getStepPulseStats(StepPulseMotor motor);
+const char* getStepPulseMotorName(StepPulseMotor motor);
+
+// Mismatched moves on both motors since boot
+uint32_t getStepPulseMismatchCount();
+
+// Append per-motor results and the live counter readings
+void formatStepPulseReport(String& out);
+
+#endif // STEP_PULSE_FUNCTIONS_H
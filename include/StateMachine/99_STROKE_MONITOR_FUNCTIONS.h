@@ -0,0 +1,62 @@
+#ifndef STROKE_MONITOR_FUNCTIONS_H
+#define STROKE_MONITOR_FUNCTIONS_H
+
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+
+//* ************************************************************************
+//* ********************** CUT STROKE MONITOR ******************************
+//* ************************************************************************
+// Online missed-step detector for the cut motor. Every return stroke records
+// where (in commanded steps) and when the home switch edge arrives. A healthy
+// carriage trips the switch at the same step count each stroke, so the
+// learned baseline of switch position and time-to-switch gives a per-stroke
+// drift signature:
+//   - switch earlier than baseline (positive drift): steps lost on the cut stroke
+//   - switch later than baseline (negative drift) or late in time: steps lost
+//     or a stall on the return
+// Only strokes judged healthy update the baseline.
+
+enum StrokeVerdict {
+    STROKE_NOT_MONITORED,   // No return stroke was being tracked
+    STROKE_LEARNING,        // Baseline still warming up
+    STROKE_OK,
+    STROKE_DRIFT_WARNING,   // Drift above the warning threshold
+    STROKE_LOST_STEPS,      // Drift above the lost-step threshold
+    STROKE_NO_SWITCH        // Return ended without a home switch edge
+};
+
+struct StrokeStats {
+    uint32_t strokes;               // Completed monitored strokes
+    uint32_t warnings;
+    uint32_t lostStepStrokes;
+    uint32_t missedSwitchStrokes;
+    float baselineSwitchSteps;      // Learned switch position (steps)
+    float switchStepsStdDev;
+    float baselineTimeMs;           // Learned time from return start to switch
+    float timeStdDevMs;
+    float lastDriftSteps;
+    float meanAbsDriftSteps;
+    float maxAbsDriftSteps;
+};
+
+// Start tracking a return stroke (call right after the cut motor is commanded home)
+void beginCutStrokeReturn(FastAccelStepper* cutMotor);
+
+// Record the home switch rising edge as captured by the switch interrupt
+// (position and esp_timer time); the first edge of a stroke counts
+void noteCutStrokeHomeSwitch(int32_t edgeSteps, int64_t edgeTimeUs);
+
+// Flag a return that is running late against the learned time-to-switch (called every tick)
+void updateCutStrokeMonitor();
+
+// Finish the stroke once the cut motor has stopped; evaluates and updates the baseline
+StrokeVerdict finishCutStrokeReturn();
+
+bool isCutStrokeReturnActive();
+StrokeVerdict getLastCutStrokeVerdict();
+StrokeStats getCutStrokeStats();
+const char* getStrokeVerdictName(StrokeVerdict verdict);
+void printCutStrokeStats();
+
+#endif // STROKE_MONITOR_FUNCTIONS_H
@@ -2,6 +2,7 @@
 #define BASE_STATE_H
 
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Events/event_queue.h"
 
 //* ************************************************************************
 //* ************************** BASE STATE **********************************
@@ -25,6 +26,13 @@ public:
     // Optional method for state exit actions
     virtual void onExit(StateManager& stateManager) {}
     
+    // Called for each event dispatched while this is the current state
+    virtual void onEvent(StateManager& stateManager, const MachineEvent& event) {}
+    
+    // States that only react to events return false; their execute() is
+    // then never called and onEvent() does all the work
+    virtual bool requiresPolling() const { return true; }
+    
     // Get the state type
     virtual SystemState getStateType() const = 0;
 };
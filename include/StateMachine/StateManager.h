@@ -6,6 +6,7 @@
 #include <FastAccelStepper.h>
 #include <ESP32Servo.h>
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Events/event_queue.h"
 
 //* ************************************************************************
 //* ************************* STATE MANAGER *******************************
@@ -60,44 +61,46 @@ public:
     void setStartSwitchSafe(bool value) { startSwitchSafe = value; }
     
     // Timer access methods
-    unsigned long getLastBlinkTime() const { return lastBlinkTime; }
-    void setLastBlinkTime(unsigned long value) { lastBlinkTime = value; }
-    
-    unsigned long getLastErrorBlinkTime() const { return lastErrorBlinkTime; }
-    void setLastErrorBlinkTime(unsigned long value) { lastErrorBlinkTime = value; }
-    
     unsigned long getErrorStartTime() const { return errorStartTime; }
     void setErrorStartTime(unsigned long value) { errorStartTime = value; }
     
-    // LED state access methods
-    bool getBlinkState() const { return blinkState; }
-    void setBlinkState(bool value) { blinkState = value; }
-    
-    bool getErrorBlinkState() const { return errorBlinkState; }
-    void setErrorBlinkState(bool value) { errorBlinkState = value; }
-    
     // Rotation servo timing access
-    unsigned long getRotationServoActiveStartTime() const { return rotationServoActiveStartTime; }
-    void setRotationServoActiveStartTime(unsigned long value) { rotationServoActiveStartTime = value; }
-    
     bool getRotationServoIsActiveAndTiming() const { return rotationServoIsActiveAndTiming; }
     void setRotationServoIsActiveAndTiming(bool value) { rotationServoIsActiveAndTiming = value; }
     
-    unsigned long getRotationClampExtendTime() const { return rotationClampExtendTime; }
-    void setRotationClampExtendTime(unsigned long value) { rotationClampExtendTime = value; }
-    
     bool getRotationClampIsExtended() const { return rotationClampIsExtended; }
     void setRotationClampIsExtended(bool value) { rotationClampIsExtended = value; }
     
     // Signal timing access
-    unsigned long getSignalTAStartTime() const { return signalTAStartTime; }
-    void setSignalTAStartTime(unsigned long value) { signalTAStartTime = value; }
-    
     bool getSignalTAActive() const { return signalTAActive; }
     void setSignalTAActive(bool value) { signalTAActive = value; }
 
 private:
     SystemState previousState;
+    SystemState ledStatusState; // State whose default LED status is currently applied
+    SystemState enteredState;   // State whose STATE_ENTERED event has been posted
+    
+    // Edge tracking for event generation
+    bool inputEventsPrimed;     // First tick only records levels
+    bool cutMotorWasRunning;
+    bool feedMotorWasRunning;
+    bool last2x4SensorLevel;
+    bool lastSuctionSensorLevel;
+    
+    // Post switch edges, sensor changes and motor completions for this tick
+    void postInputEvents();
+    
+    // Drain the event queue into the current state's event handler
+    void dispatchEvents();
+    
+    // Whether a state runs every tick or only through its event handler
+    bool stateRequiresPolling(SystemState state) const;
+    
+    // Swap in a staged job profile (only at a cycle boundary with both motors stopped)
+    bool applyJobProfileAtCycleBoundary();
+    
+    // Apply the default LED status for a state (states may refine it afterwards)
+    void applyLedStatusForState(SystemState state);
     
     // Print state changes
     void printStateChange();
@@ -112,4 +115,7 @@ private:
 // Global state manager instance
 extern StateManager stateManager;
 
+// Printable name of a state
+const char* getSystemStateName(SystemState state);
+
 #endif // STATE_MANAGER_H 
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef STATE_TRANSITIONS_H
+#define STATE_TRANSITIONS_H
+
+#include <Arduino.h>
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+
+//* ************************************************************************
+//* ************************ STATE TRANSITIONS *****************************
+//* ************************************************************************
+// Every transition the states make with changeState(), in one table. The
+// static_asserts below check the graph at compile time: each state can be
+// reached from STARTUP, each state can get back to IDLE, and no state is a
+// dead end. changeState() reports any transition missing from the table
+// (build with -DSTATE_TRANSITION_CHECKS=0 to compile that out), and
+// GET /states.dot on the diagnostics server draws the graph.
+//
+// Adding a changeState() call means adding its row here. Needs C++17
+// (-std=gnu++17 in platformio.ini).
+
+#ifndef STATE_TRANSITION_CHECKS
+#define STATE_TRANSITION_CHECKS 1
+#endif
+
+struct StateTransition {
+    SystemState from;
+    SystemState to;
+    const char* reason;         // Edge label in the graph
+};
+
+constexpr StateTransition STATE_TRANSITIONS[] = {
+    {STARTUP, HOMING, "boot / reset"},
+    {STARTUP, ERROR, "after a watchdog restart"},
+    {HOMING, IDLE, "homed"},
+    {HOMING, ERROR, "homing timed out"},
+    {IDLE, CUTTING, "start switch, 2x4 present"},
+    {IDLE, FEED_FIRST_CUT, "manual feed, 2x4 present"},
+    {IDLE, FEED_WOOD_FWD_ONE, "manual feed, no 2x4"},
+    {FEED_FIRST_CUT, CUTTING, "sequence exit cut"},
+    {FEED_FIRST_CUT, IDLE, "sequence exit idle"},
+    {FEED_FIRST_CUT, ERROR, "sequence failed"},
+    {FEED_WOOD_FWD_ONE, CUTTING, "sequence exit cut"},
+    {FEED_WOOD_FWD_ONE, IDLE, "sequence exit idle"},
+    {FEED_WOOD_FWD_ONE, ERROR, "sequence failed"},
+    {CUTTING, RETURNING_YES_2x4, "cut done, 2x4 present"},
+    {CUTTING, RETURNING_NO_2x4, "cut done, no 2x4"},
+    {CUTTING, SUCTION_ERROR_HOLD, "no suction"},
+    {CUTTING, ERROR, "cut home lost"},
+    {CUTTING, ERROR_RESET, "home error acknowledged"},
+    {CUTTING, IDLE, "cycle complete"},
+    {RETURNING_YES_2x4, CUTTING, "continuous mode"},
+    {RETURNING_YES_2x4, IDLE, "cycle complete"},
+    {RETURNING_YES_2x4, ERROR, "cut home lost"},
+    {RETURNING_NO_2x4, IDLE, "cycle complete"},
+    {ERROR, ERROR_RESET, "reload switch"},
+    {ERROR_RESET, STARTUP, "flags cleared"},
+    {SUCTION_ERROR_HOLD, HOMING, "start switch"},
+};
+
+constexpr size_t STATE_TRANSITION_COUNT = sizeof(STATE_TRANSITIONS) / sizeof(STATE_TRANSITIONS[0]);
+
+// Every SystemState in use (value 8 is a retired state)
+constexpr SystemState SYSTEM_STATES[] = {
+    STARTUP, HOMING, IDLE, FEED_FIRST_CUT, FEED_WOOD_FWD_ONE, CUTTING,
+    RETURNING_YES_2x4, RETURNING_NO_2x4, ERROR, ERROR_RESET, SUCTION_ERROR_HOLD
+};
+
+constexpr uint32_t stateBit(SystemState state) {
+    return 1UL << state;
+}
+
+static_assert(SUCTION_ERROR_HOLD < 32, "state sets are 32-bit masks");
+
+// Bit per destination state, indexed by source state (one lookup per changeState)
+struct StateTransitionMasks {
+    uint32_t allowed[SUCTION_ERROR_HOLD + 1] = {};
+};
+
+constexpr StateTransitionMasks buildStateTransitionMasks() {
+    StateTransitionMasks masks;
+    for (const StateTransition& transition : STATE_TRANSITIONS) {
+        masks.allowed[transition.from] |= stateBit(transition.to);
+    }
+    return masks;
+}
+
+constexpr StateTransitionMasks STATE_TRANSITION_MASKS = buildStateTransitionMasks();
+
+constexpr bool isStateTransitionDeclared(SystemState from, SystemState to) {
+    return (STATE_TRANSITION_MASKS.allowed[from] & stateBit(to)) != 0;
+}
+
+// States reachable from start by following the table forwards
+constexpr uint32_t statesReachableFrom(SystemState start) {
+    uint32_t reached = stateBit(start);
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (const StateTransition& transition : STATE_TRANSITIONS) {
+            if ((reached & stateBit(transition.from)) && !(reached & stateBit(transition.to))) {
+                reached |= stateBit(transition.to);
+                grew = true;
+            }
+        }
+    }
+    return reached;
+}
+
+constexpr uint32_t allSystemStates() {
+    uint32_t all = 0;
+    for (SystemState state : SYSTEM_STATES) all |= stateBit(state);
+    return all;
+}
+
+constexpr bool transitionsUseKnownStates() {
+    for (const StateTransition& transition : STATE_TRANSITIONS) {
+        if (!(allSystemStates() & stateBit(transition.from)) || !(allSystemStates() & stateBit(transition.to))) return false;
+        if (transition.from == transition.to) return false; // changeState() ignores these
+    }
+    return true;
+}
+
+constexpr bool transitionsAreUnique() {
+    for (size_t i = 0; i < STATE_TRANSITION_COUNT; i++) {
+        for (size_t j = i + 1; j < STATE_TRANSITION_COUNT; j++) {
+            if (STATE_TRANSITIONS[i].from == STATE_TRANSITIONS[j].from &&
+                STATE_TRANSITIONS[i].to == STATE_TRANSITIONS[j].to) return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool everyStateHasAnExit() {
+    for (SystemState state : SYSTEM_STATES) {
+        if (STATE_TRANSITION_MASKS.allowed[state] == 0) return false;
+    }
+    return true;
+}
+
+constexpr bool everyStateReachesIdle() {
+    for (SystemState state : SYSTEM_STATES) {
+        if (!(statesReachableFrom(state) & stateBit(IDLE))) return false;
+    }
+    return true;
+}
+
+static_assert(transitionsUseKnownStates(), "STATE_TRANSITIONS uses a retired state or a self transition");
+static_assert(transitionsAreUnique(), "STATE_TRANSITIONS has a duplicate row");
+static_assert(statesReachableFrom(STARTUP) == allSystemStates(), "a state cannot be reached from STARTUP");
+static_assert(everyStateHasAnExit(), "a state has no way out");
+static_assert(everyStateReachesIdle(), "a state cannot get back to IDLE");
+
+// Report a changeState() that is not in the table (the transition still happens)
+#if STATE_TRANSITION_CHECKS
+void checkStateTransition(SystemState from, SystemState to);
+uint32_t getUndeclaredTransitionCount();
+#else
+static inline void checkStateTransition(SystemState, SystemState) {}
+static inline uint32_t getUndeclaredTransitionCount() { return 0; }
+#endif
+
+// Append the transition graph in Graphviz DOT format
+void formatStateGraphDot(String& out);
+
+#endif // STATE_TRANSITIONS_H
@@ -0,0 +1,49 @@
+#ifndef LED_PATTERN_ENGINE_H
+#define LED_PATTERN_ENGINE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ********************** LED PATTERN ENGINE HEADER ***********************
+//* ************************************************************************
+// Declarative status LED patterns driven from a periodic esp_timer.
+// States set a status code once; the timer callback owns all LED pin writes,
+// so no LED work runs in the control loop.
+
+// Machine status codes shown on the four status LEDs
+enum LedStatus {
+  LED_STATUS_OFF,                   // All LEDs off
+  LED_STATUS_STARTUP,               // Blue solid
+  LED_STATUS_HOMING,                // Blue blinking (500ms)
+  LED_STATUS_IDLE,                  // Green solid
+  LED_STATUS_RELOAD,                // Blue solid
+  LED_STATUS_FEEDING,               // Green solid
+  LED_STATUS_CUTTING,               // Yellow solid
+  LED_STATUS_CUTTING_NO_WOOD,       // Yellow + blue solid
+  LED_STATUS_ERROR,                 // Red/yellow alternating (250ms)
+  LED_STATUS_HOME_POSITION_ERROR,   // Red/yellow alternating (100ms)
+  LED_STATUS_SUCTION_ERROR,         // Red blinking (1500ms)
+  LED_STATUS_COUNT
+};
+
+// A condition flashed over whatever status is showing: every
+// LED_NOTICE_PERIOD_MS the notice mask replaces the pattern for LED_NOTICE_FLASH_MS
+enum LedNotice {
+  LED_NOTICE_NONE,
+  LED_NOTICE_WARNING,               // Blue flash
+  LED_NOTICE_CRITICAL,              // Red + blue flash
+  LED_NOTICE_COUNT
+};
+
+// Create and start the pattern timer (call once from setup after pinMode)
+void beginLedPatternEngine();
+
+// Select the pattern for a status. Re-selecting the active status is a no-op.
+void setLedStatus(LedStatus status);
+LedStatus getLedStatus();
+const char* getLedStatusName(LedStatus status);
+
+void setLedNotice(LedNotice notice);
+LedNotice getLedNotice();
+
+#endif // LED_PATTERN_ENGINE_H
@@ -0,0 +1,64 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <Arduino.h>
+#include "Events/event_queue.h"
+
+//* ************************************************************************
+//* ************************** TIMER WHEEL *********************************
+//* ************************************************************************
+// Hierarchical timer wheel for one-shot timeouts. Deadlines are kept in
+// microseconds; the wheel advances in TIMER_WHEEL_TICK_US ticks across four
+// levels of 64 slots, so insert, cancel and expiry are O(1) per timer.
+// Catching up after a long blocking section steps over empty slots using a
+// per-level occupancy bitmap; only the occupied slots crossed are cascaded.
+// Timers come from a fixed pool (no heap use) and their callbacks run from
+// serviceTimerWheel() in the control loop, never from an interrupt.
+//
+// The time source is pluggable so timeouts can be driven by a fake clock.
+
+typedef void (*TimerCallback)(void* context);
+typedef uint64_t (*TimerWheelClock)();
+
+// Handle to a scheduled timer. Stale handles (fired or cancelled) are ignored.
+typedef uint32_t TimerHandle;
+const TimerHandle INVALID_TIMER_HANDLE = 0;
+
+const uint32_t TIMER_WHEEL_TICK_US = 250;
+const size_t TIMER_WHEEL_POOL_SIZE = 24;
+
+// Schedule a callback after a delay. Returns INVALID_TIMER_HANDLE if the pool is full.
+TimerHandle scheduleTimerUs(uint64_t delayUs, TimerCallback callback, void* context = nullptr);
+inline TimerHandle scheduleTimerMs(unsigned long delayMs, TimerCallback callback, void* context = nullptr) {
+    return scheduleTimerUs((uint64_t)delayMs * 1000ULL, callback, context);
+}
+
+// Schedule an EVENT_TIMER_EXPIRED event for the given timer id
+TimerHandle scheduleEventTimerMs(unsigned long delayMs, EventTimer timerId);
+
+// Clear a flag now and set it when the delay expires (for state step waits)
+TimerHandle scheduleFlagTimerMs(unsigned long delayMs, bool* expiredFlag);
+
+// Cancel a pending timer and clear the handle. Returns true if it was pending.
+bool cancelTimer(TimerHandle& handle);
+bool isTimerActive(TimerHandle handle);
+uint64_t getTimerRemainingUs(TimerHandle handle);
+
+// Advance the wheel to the current clock time and run expired callbacks.
+// Called once per control tick from the StateManager.
+void serviceTimerWheel();
+
+// Replace the time source (nullptr restores esp_timer_get_time)
+void setTimerWheelClock(TimerWheelClock clock);
+uint64_t getTimerWheelTimeUs();
+
+size_t getActiveTimerCount();
+
+struct TimerWheelStats {
+    uint32_t fired;
+    uint32_t cascaded;          // Timers moved down a level
+};
+
+TimerWheelStats getTimerWheelStats();
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,61 @@
+#ifndef WATCHDOG_SUPERVISOR_H
+#define WATCHDOG_SUPERVISOR_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ WATCHDOG SUPERVISOR ***************************
+//* ************************************************************************
+// A supervisor task on WATCHDOG_TASK_CORE checks one heartbeat per subsystem
+// every WATCHDOG_CHECK_INTERVAL_MS:
+//
+//   CONTROL_TICK   loop()            WATCHDOG_CONTROL_TICK_DEADLINE_MS
+//   MOTOR_ENGINE   checked here: a running motor must keep moving
+//                                    WATCHDOG_MOTOR_ENGINE_DEADLINE_MS
+//   NETWORK        network task      WATCHDOG_NETWORK_DEADLINE_MS
+//   LOGGING        fault journal     WATCHDOG_LOGGING_DEADLINE_MS
+//
+// A heartbeat is only checked once it has been fed the first time. When one
+// is late the supervisor stops both motors, extends the feed and 2x4 secure
+// clamps, stores the reason in NVS and restarts. A late NETWORK heartbeat
+// waits until the machine is in IDLE or an error hold so a wedged WiFi stack
+// never aborts a cut. The supervisor task itself is covered by the ESP32
+// task watchdog (WATCHDOG_TWDT_TIMEOUT_S, panic and reset).
+//
+// The loop task may block on purpose (homing); wrap such sections in a
+// WatchdogBlockingScope to give them WATCHDOG_BLOCKING_DEADLINE_MS instead.
+
+enum Heartbeat : uint8_t {
+    HEARTBEAT_CONTROL_TICK,
+    HEARTBEAT_MOTOR_ENGINE,
+    HEARTBEAT_NETWORK,
+    HEARTBEAT_LOGGING,
+    HEARTBEAT_COUNT
+};
+
+// Report a previous watchdog restart and start the supervisor task (call early in setup)
+void beginWatchdogSupervisor();
+
+void feedHeartbeat(Heartbeat heartbeat);
+
+// One supervisor pass: check every armed heartbeat, safe stop and restart on
+// a late one. The task runs it every WATCHDOG_CHECK_INTERVAL_MS; the native
+// test build calls it from the simulated clock instead.
+void runWatchdogCheck();
+
+const char* getHeartbeatName(uint8_t heartbeat);
+
+// Why the previous boot ended, "none" if it was not a watchdog restart
+const char* getLastWatchdogRestart();
+
+// Loop task heartbeats (control tick, logging) get the blocking deadline
+// while one of these is alive
+class WatchdogBlockingScope {
+public:
+    WatchdogBlockingScope();
+    ~WatchdogBlockingScope();
+    WatchdogBlockingScope(const WatchdogBlockingScope&) = delete;
+    WatchdogBlockingScope& operator=(const WatchdogBlockingScope&) = delete;
+};
+
+#endif // WATCHDOG_SUPERVISOR_H
@@ -13,16 +13,19 @@
 const int ROTATION_SERVO_HOME_POSITION = 24;     // Home position (degrees)
 const int ROTATION_SERVO_ACTIVE_POSITION = 90;   // Position when activated (degrees)
 
+// Rotation servo motion profile and calibrated speed model
+const float ROTATION_SERVO_RAMP_VELOCITY_DEG_PER_SEC = 600;  // Commanded ramp rate (degrees/sec)
+const float ROTATION_SERVO_MODEL_SPEED_DEG_PER_SEC = 400;    // Measured loaded slew rate (~0.15 s/60 degrees)
+const unsigned long ROTATION_SERVO_MODEL_LATENCY_MS = 20;    // One 50Hz frame of command latency
+
 //* ************************************************************************
 //* ************************ MOTOR CONFIGURATION **************************
 //* ************************************************************************
 // Motor step calculations and travel distances
 const int CUT_MOTOR_STEPS_PER_INCH = 500;  // 4x increase from 38
 const int FEED_MOTOR_STEPS_PER_INCH = 1000; // Steps per inch for feed motor
-const float CUT_TRAVEL_DISTANCE = 9.0; // inches
-const float FEED_TRAVEL_DISTANCE = 3.4; // inches
-const float CUT_MOTOR_INCREMENTAL_MOVE_INCHES = 0.1; // Inches for incremental reverse
-const float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES = 0.4; // Max inches for incremental reverse before error
+const float CUT_TRAVEL_DISTANCE = 9.0; // inches (default job profile)
+const float FEED_TRAVEL_DISTANCE = 3.4; // inches (default and longest job profile feed stroke)
 
 // Motor homing direction constants
 const int CUT_HOMING_DIRECTION = -1;
@@ -37,6 +40,8 @@ const float CUT_MOTOR_NORMAL_ACCELERATION = 10000; // Acceleration for the cutti
 
 // Return Stroke (Returning State / End of Cutting State)
 const float CUT_MOTOR_RETURN_SPEED = 20000;     // Speed for returning after a cut (steps/sec)
+const unsigned long CUT_MOTOR_FORWARD_PLANNING_MS = 8; // Steps queued ahead during the RETURNING_YES_2x4 return; bounds the home switch overshoot
+const unsigned long CUT_MOTOR_DEFAULT_FORWARD_PLANNING_MS = 20; // FastAccelStepper default for every other cut motor move
 
 // Homing Operation (Homing State)
 const float CUT_MOTOR_HOMING_SPEED = 1000;      // Speed for homing the cut motor (steps/sec)
@@ -59,7 +64,7 @@ const float FEED_MOTOR_HOMING_SPEED = 2000;     // Speed for homing the feed mot
 //* ************************ TIMING CONFIGURATION *************************
 //* ************************************************************************
 // Servo timing configuration
-const unsigned long ROTATION_SERVO_ACTIVE_HOLD_DURATION_MS = 2700;
+const unsigned long ROTATION_SERVO_RELEASE_DWELL_MS = 300; // Dwell after estimated arrival before release check
 
 // Rotation clamp timing
 const unsigned long ROTATION_CLAMP_EXTEND_DURATION_MS = 1200; // 1.2 seconds
@@ -67,9 +72,139 @@ const unsigned long ROTATION_CLAMP_EXTEND_DURATION_MS = 1200; // 1.2 seconds
 // Cut motor homing timeout
 const unsigned long CUT_HOME_TIMEOUT = 5000; // 5 seconds timeout
 
+// Feed motor homing timeout, per wait (switch seek, back-off, move to travel).
+// Must stay below WATCHDOG_BLOCKING_DEADLINE_MS so a dead switch ends in ERROR
+// instead of a watchdog restart.
+const unsigned long FEED_HOME_TIMEOUT = 8000;
+
 // Transfer Arm signal timing
 const unsigned long TA_SIGNAL_DURATION = 2000; // Duration for Transfer Arm signal (ms)
 
+//* ************************************************************************
+//* ******************** STROKE MONITOR CONFIGURATION ********************
+//* ************************************************************************
+// Cut stroke missed-step detection
+const int STROKE_MONITOR_WARMUP_STROKES = 5;     // Strokes averaged before judging drift
+const float STROKE_MONITOR_EWMA_ALPHA = 0.2;     // Baseline weight of each healthy stroke
+const float STROKE_DRIFT_WARNING_INCHES = 0.03;  // Minimum switch drift for a warning
+const float STROKE_LOST_STEPS_INCHES = 0.08;     // Minimum switch drift for lost steps (well inside the recovery seek distance)
+const unsigned long STROKE_LATE_MARGIN_MS = 150; // Minimum time past baseline for a late switch
+
+//* ************************************************************************
+//* ****************** CUT HOME RECOVERY CONFIGURATION *******************
+//* ************************************************************************
+// Cut motor home switch verification and in-line recovery
+const unsigned long CUT_HOME_VERIFY_SETTLE_MS = 30;         // Wait after a stop before each switch read
+const int CUT_HOME_VERIFY_ATTEMPTS = 3;                     // Switch reads before starting recovery
+const float CUT_HOME_RECOVERY_SEEK_SPEED = 1000;            // Seek and back-off speed (steps/sec, homing speed)
+const float CUT_HOME_RECOVERY_REAPPROACH_SPEED = 400;       // Final approach speed (steps/sec)
+const float CUT_HOME_RECOVERY_ACCELERATION = 20000;         // Ramp for recovery moves - stops within ~0.05" at seek speed
+const float CUT_HOME_RECOVERY_MAX_SEEK_INCHES = 0.4;        // Furthest the seek may travel toward home
+const float CUT_HOME_RECOVERY_BACKOFF_INCHES = 0.1;         // Move off the switch to prove it releases
+const unsigned long CUT_HOME_RECOVERY_TIMEOUT_MS = 900;     // Whole recovery, from the start of the seek
+
+//* ************************************************************************
+//* ******************** ADAPTIVE CUT CONFIGURATION **********************
+//* ************************************************************************
+// Adaptive cut feed rate (starts at CUT_MOTOR_NORMAL_SPEED)
+const bool ADAPTIVE_CUT_MODE_ENABLED = false;         // Adaptive mode in the built-in profiles (each profile opts in)
+const float ADAPTIVE_CUT_MAX_SPEED = 1400;            // Upper bound for the learned cut speed (steps/sec)
+const float ADAPTIVE_CUT_RAISE_STEP = 25;             // Increase after a clean streak (steps/sec)
+const float ADAPTIVE_CUT_BACKOFF_FACTOR = 0.85;       // Multiplier applied on an anomaly
+const int ADAPTIVE_CUT_CLEAN_STROKES_TO_RAISE = 3;    // Clean strokes required before each raise
+const unsigned long ADAPTIVE_CUT_LOAD_LIMIT_MV = 1800; // Current sense peak treated as overload (mV)
+
+//* ************************************************************************
+//* ********************** JOB PROFILE CONFIGURATION *********************
+//* ************************************************************************
+// Limits for profile parameters entered from the network (defaults come from the constants above)
+const float JOB_PROFILE_MIN_CUT_SPEED = 200;               // Slowest cut speed a profile may request (steps/sec)
+const float JOB_PROFILE_MAX_CUT_TRAVEL_INCHES = 9.5;       // Longest cut stroke a profile may request
+const float JOB_PROFILE_MAX_FEED_OVERTRAVEL_INCHES = 3.0;  // Furthest a feed push may go past position 0
+const unsigned long JOB_PROFILE_MAX_HOLD_MS = 5000;        // Longest clamp hold / servo dwell
+
+//* ************************************************************************
+//* ********************* FAULT JOURNAL CONFIGURATION ********************
+//* ************************************************************************
+const unsigned long JOURNAL_SNAPSHOT_INTERVAL_MS = 100;       // Snapshot rate into the RAM pre-fault ring
+const unsigned long JOURNAL_POST_FAULT_MS = 5000;             // Keep writing snapshots to flash after a fault
+const unsigned long JOURNAL_POST_FAULT_SNAPSHOT_MS = 250;     // Snapshot rate during the post-fault window
+
+//* ************************************************************************
+//* ******************** FLIGHT RECORDER CONFIGURATION *******************
+//* ************************************************************************
+const unsigned long FLIGHT_RECORDER_SAMPLE_INTERVAL_US = 1000; // 1 kHz - 2048 samples cover ~2 s
+const unsigned long FLIGHT_RECORDER_POST_TRIGGER_MS = 1000;    // Long enough to cover a full cut home recovery
+
+//* ************************************************************************
+//* ********************* LOOP PROFILER CONFIGURATION ********************
+//* ************************************************************************
+const unsigned long LOOP_PROFILER_WINDOW_MS = 10000; // Stats window reported on serial and /loop
+const bool LOOP_PROFILER_SERIAL_REPORT = true;       // Print each window on serial (only while IDLE)
+
+//* ************************************************************************
+//* ******************* STATE INVARIANT CONFIGURATION ********************
+//* ************************************************************************
+const unsigned long STATE_INVARIANT_STUCK_MS = 30000;       // Longest stay in a state that does not wait for the operator
+const unsigned long STATE_INVARIANT_ERROR_GRACE_MS = 1000;  // Motors must have stopped this long after entering ERROR
+
+//* ************************************************************************
+//* ******************** MEMORY MONITOR CONFIGURATION ********************
+//* ************************************************************************
+const unsigned long MEMORY_MONITOR_SAMPLE_MS = 1000;            // Heap and stack sample period
+const unsigned long MEMORY_MONITOR_TREND_INTERVAL_MS = 60000;   // One trend point (minimum) per interval
+const unsigned long MEMORY_WARNING_FREE_HEAP_BYTES = 48000;
+const unsigned long MEMORY_CRITICAL_FREE_HEAP_BYTES = 16000;
+const unsigned long MEMORY_WARNING_LARGEST_BLOCK_BYTES = 16000; // Fragmentation: largest single allocation possible
+const unsigned long MEMORY_CRITICAL_LARGEST_BLOCK_BYTES = 4096;
+const unsigned long MEMORY_WARNING_STACK_BYTES = 512;           // Stack never used by a watched task
+
+//* ************************************************************************
+//* ******************* STEP PULSE CHECK CONFIGURATION *******************
+//* ************************************************************************
+const unsigned int STEP_PULSE_CUT_PCNT_UNIT = 2;      // Pulse counter units clear of the ones the stepper engine uses
+const unsigned int STEP_PULSE_FEED_PCNT_UNIT = 3;
+const unsigned long STEP_PULSE_TOLERANCE_STEPS = 2;   // Largest commanded/emitted difference per move still counted as a match
+
+//* ************************************************************************
+//* *********************** WATCHDOG CONFIGURATION ***********************
+//* ************************************************************************
+const unsigned long WATCHDOG_CHECK_INTERVAL_MS = 100;           // Supervisor task period
+const unsigned long WATCHDOG_CONTROL_TICK_DEADLINE_MS = 1000;   // Longest gap between loop() ticks
+const unsigned long WATCHDOG_BLOCKING_DEADLINE_MS = 15000;      // Same, inside a WatchdogBlockingScope (homing)
+const unsigned long WATCHDOG_MOTOR_ENGINE_DEADLINE_MS = 500;    // A running motor must move within this
+const unsigned long WATCHDOG_NETWORK_DEADLINE_MS = 90000;       // Longer than one connect attempt plus the longest backoff
+const unsigned long WATCHDOG_LOGGING_DEADLINE_MS = 5000;        // Fault journal service, including a sector erase
+const unsigned long WATCHDOG_SAFE_STOP_SETTLE_MS = 200;         // Clamps close before the restart
+const unsigned long WATCHDOG_TWDT_TIMEOUT_S = 5;                // ESP32 task watchdog on the supervisor itself
+const int WATCHDOG_TASK_CORE = 0;
+const unsigned long WATCHDOG_TASK_STACK_SIZE = 4096;            // Bytes
+const unsigned int WATCHDOG_TASK_PRIORITY = 5;                  // Above the network task
+
+//* ************************************************************************
+//* ********************** OTA UPDATE CONFIGURATION **********************
+//* ************************************************************************
+const unsigned long OTA_HEALTH_CHECK_TIMEOUT_MS = 120000; // A new image must home and reach IDLE within this
+const unsigned int OTA_HEALTH_CHECK_MAX_BOOTS = 3;        // Roll back if a new image restarts more often than this
+const unsigned long OTA_WRITE_YIELD_MS = 1;               // Pause after each received chunk
+
+//* ************************************************************************
+//* ************************ NETWORK CONFIGURATION ***********************
+//* ************************************************************************
+const int DIAGNOSTICS_SERVER_PORT = 80; // HTTP status and job profile server
+const int DIAGNOSTICS_JOURNAL_DEFAULT_LIMIT = 500; // Journal records served when no limit is given
+const int NETWORK_TASK_CORE = 0;                       // Core for WiFi, OTA and the diagnostics server (loop runs on core 1)
+const unsigned long NETWORK_TASK_STACK_SIZE = 8192;    // Bytes
+const unsigned int NETWORK_TASK_PRIORITY = 1;
+const unsigned long NETWORK_SERVICE_INTERVAL_MS = 2;   // Delay between OTA / server polls
+const unsigned long NETWORK_CONNECT_TIMEOUT_MS = 10000; // Give up on one connection attempt after this
+const unsigned long NETWORK_RECONNECT_MIN_MS = 1000;   // First retry delay, doubled after each failure
+const unsigned long NETWORK_RECONNECT_MAX_MS = 60000;  // Retry delay ceiling
+const char* const FIRMWARE_VERSION = "1.1.0";          // Reported in mDNS TXT records and fleet beacons
+const unsigned char FLEET_BEACON_GROUP[4] = {239, 255, 42, 1}; // Multicast group for status beacons (site-local scope)
+const int FLEET_BEACON_PORT = 4210;
+const unsigned long FLEET_BEACON_INTERVAL_MS = 5000;   // Status beacon period
+
 //* ************************************************************************
 //* ************************ OPERATIONAL CONSTANTS ***********************
 //* ************************************************************************
@@ -58,4 +58,10 @@ const int TRANSFER_ARM_SIGNAL_PIN = 8;  // Signal to Transfer Arm system
 const int STATUS_LED_RED = 47;      // Error/fault indication
 const int STATUS_LED_YELLOW = 21;   // Warning/caution indication
 const int STATUS_LED_GREEN = 37;    // Ready/operation OK indication
-const int STATUS_LED_BLUE = 19;     // Process active indication 
\ No newline at end of file
+const int STATUS_LED_BLUE = 19;     // Process active indication 
+
+//* ************************************************************************
+//* ************************ ANALOG INPUT PINS ****************************
+//* ************************************************************************
+// Optional analog inputs (-1 = not fitted)
+const int CUT_MOTOR_CURRENT_SENSE_PIN = -1; // Cut motor driver current sense (ADC) 
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "Diagnostics/boot_timing.h"
+
+//* ************************************************************************
+//* *************************** BOOT TIMING ********************************
+//* ************************************************************************
+// Phases are marked from the loop task and the network task. Each phase has
+// a single writer and a 32-bit store, so no locking is needed.
+
+static volatile unsigned long bootPhaseMs[BOOT_PHASE_COUNT];
+static volatile bool bootPhaseReached[BOOT_PHASE_COUNT];
+
+static const char* getBootPhaseName(uint8_t phase) {
+    switch (phase) {
+        case BOOT_PHASE_SETUP_START: return "setup start";
+        case BOOT_PHASE_IO_READY: return "io ready";
+        case BOOT_PHASE_MOTORS_READY: return "motors ready";
+        case BOOT_PHASE_SETUP_DONE: return "setup done";
+        case BOOT_PHASE_HOMING_STARTED: return "homing started";
+        case BOOT_PHASE_IDLE: return "idle";
+        case BOOT_PHASE_WIFI_CONNECTED: return "wifi connected";
+        case BOOT_PHASE_NETWORK_READY: return "network ready";
+        default: return "unknown";
+    }
+}
+
+bool markBootPhase(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT || bootPhaseReached[phase]) return false;
+    bootPhaseMs[phase] = millis();
+    bootPhaseReached[phase] = true;
+    return true;
+}
+
+unsigned long getBootPhaseMs(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT || !bootPhaseReached[phase]) return 0;
+    return bootPhaseMs[phase];
+}
+
+static void formatBootPhase(uint8_t phase, char* line, size_t size) {
+    if (bootPhaseReached[phase]) {
+        snprintf(line, size, "boot %-16s %7lu ms\n", getBootPhaseName(phase), bootPhaseMs[phase]);
+    } else {
+        snprintf(line, size, "boot %-16s    pending\n", getBootPhaseName(phase));
+    }
+}
+
+void formatBootTiming(String& out) {
+    char line[64];
+    for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+        formatBootPhase(phase, line, sizeof(line));
+        out += line;
+    }
+}
+
+// Printed from the loop task when IDLE is first reached: no String
+void printBootTiming() {
+    char line[64];
+    for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+        formatBootPhase(phase, line, sizeof(line));
+        Serial.print(line);
+    }
+}
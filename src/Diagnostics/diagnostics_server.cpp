@@ -0,0 +1,458 @@
+#include "Diagnostics/diagnostics_server.h"
+#include "Config/Config.h"
+#include "Profiles/job_profiles.h"
+#include "StateMachine/StateManager.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "Journal/fault_journal.h"
+#include "FlightRecorder/flight_recorder.h"
+#include "InputTrace/input_trace.h"
+#include "Diagnostics/loop_profiler.h"
+#include "Diagnostics/boot_timing.h"
+#include "Diagnostics/memory_monitor.h"
+#include "Watchdog/watchdog_supervisor.h"
+#include "Network/network_task.h"
+#include "Network/fleet_discovery.h"
+#include "Diagnostics/throughput_counter.h"
+#include "OTAUpdater/ota_updater.h"
+#include "OTAUpdater/ota_health_check.h"
+#include "OTAUpdater/ota_package.h"
+#include "StateMachine/99_SEQUENCE_FUNCTIONS.h"
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+#include "StateMachine/StateTransitions.h"
+#include "StateMachine/99_CUT_HOME_LIMIT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include <WiFi.h>
+#include <WebServer.h>
+
+//* ************************************************************************
+//* ********************** DIAGNOSTICS SERVER ******************************
+//* ************************************************************************
+// Handlers run from handleDiagnosticsServer() on the network task, in
+// parallel with the control loop. They only read status, go through modules
+// that lock their own state (journal, flight recorder, loop profiler), or
+// stage profile edits through the job profile module, which applies them at
+// a cycle boundary on the loop task.
+
+static WebServer server(DIAGNOSTICS_SERVER_PORT);
+
+// Endpoints that change machine behaviour take the OTA password (digest auth)
+static const char* WRITE_ACCESS_USER = "stage1";
+
+static bool hasWriteAccess() {
+    return server.authenticate(WRITE_ACCESS_USER, getOtaPassword());
+}
+
+static bool requireWriteAccess() {
+    if (hasWriteAccess()) return true;
+    server.requestAuthentication(DIGEST_AUTH, getDeviceName(), "authentication required\n");
+    return false;
+}
+
+static bool readProfileIndexArg(uint8_t& index) {
+    if (!server.hasArg("index")) return false;
+    long value = server.arg("index").toInt();
+    if (value < 0 || value >= JOB_PROFILE_COUNT) return false;
+    index = (uint8_t)value;
+    return true;
+}
+
+static void appendProfile(String& out, uint8_t index) {
+    const JobProfile* profile = getJobProfile(index);
+    if (!profile) return;
+    char line[320];
+    snprintf(line, sizeof(line),
+             "%u \"%s\"%s\n"
+             "  cutSpeed=%.0f adaptive=%u cutTravel=%.2f clampEarly=%.2f servoEarly=%.2f\n"
+             "  clampHoldMs=%lu servoDwellMs=%lu\n"
+             "  feedTravel=%.2f push1=%.2f push2=%.2f parkOffset=%.2f regrip=%.2f\n",
+             index, profile->name, index == getActiveJobProfileIndex() ? " (active)" : "",
+             profile->cutSpeed, profile->adaptiveCut ? 1u : 0u, profile->cutTravelInches,
+             profile->rotationClampEarlyOffsetInches, profile->rotationServoEarlyOffsetInches,
+             (unsigned long)profile->rotationClampExtendMs, (unsigned long)profile->rotationServoReleaseDwellMs,
+             profile->feedTravelInches, profile->firstCutPushInches[0], profile->firstCutPushInches[1],
+             profile->firstCutParkOffsetInches, profile->noWoodRegripInches);
+    out += line;
+}
+
+static void readFloatArg(const char* name, float& field) {
+    if (server.hasArg(name)) field = server.arg(name).toFloat();
+}
+
+static void readMsArg(const char* name, uint32_t& field) {
+    if (server.hasArg(name)) field = (uint32_t)server.arg(name).toInt();
+}
+
+static void handleStatus() {
+    const JobProfile& profile = getActiveJobProfile();
+    ThroughputStats throughput = getThroughputStats();
+    char body[768];
+    snprintf(body, sizeof(body),
+             "name=%s\nfirmwareVersion=%s\ncuts=%lu (last hour %lu, last cycle %lu ms)\nstate=%s\nprofile=%u \"%s\"%s\ncutSpeed=%.0f steps/sec (adaptive %s)\nflightRecorder=%s\ninputTrace=%s\ninvariantViolations=%lu\nstepPulseMismatches=%lu\nmemory=%s (%lu control task allocations)\nlastWatchdogRestart=%s\nuptimeMs=%lu\nwifiReconnects=%lu\nfirmware=%s\n",
+             getDeviceName(), FIRMWARE_VERSION,
+             (unsigned long)throughput.totalCuts, (unsigned long)throughput.cutsLastHour,
+             (unsigned long)throughput.lastCycleMs,
+             getSystemStateName(stateManager.getCurrentState()),
+             getActiveJobProfileIndex(), profile.name, isJobProfileChangePending() ? " (change pending)" : "",
+             getCutMotorCuttingSpeed(), isAdaptiveCutEnabled() ? "on" : "off",
+             isFlightRecorderFrozen() ? "frozen" : "armed",
+             isInputTraceFrozen() ? "frozen" : "recording",
+             (unsigned long)getTotalStateInvariantViolations(),
+             (unsigned long)getStepPulseMismatchCount(),
+             getMemoryLevelName(getMemoryLevel()), (unsigned long)getControlAllocationCount(),
+             getLastWatchdogRestart(),
+             millis(), (unsigned long)getNetworkReconnectCount(),
+             isOtaHealthCheckPending() ? "on probation (not homed yet)" : "verified");
+    String out = body;
+    formatBootTiming(out);
+    server.send(200, "text/plain", out);
+}
+
+static void handleProfileList() {
+    String out;
+    for (uint8_t i = 0; i < JOB_PROFILE_COUNT; i++) {
+        appendProfile(out, i);
+    }
+    if (isJobProfileChangePending()) out += "change pending - applies at the next cycle boundary\n";
+    server.send(200, "text/plain", out);
+}
+
+static void handleProfileSelect() {
+    if (!requireWriteAccess()) return;
+    uint8_t index;
+    if (!readProfileIndexArg(index)) {
+        server.send(400, "text/plain", "index must be 0-" + String(JOB_PROFILE_COUNT - 1) + "\n");
+        return;
+    }
+    requestJobProfile(index);
+    server.send(200, "text/plain", "profile " + String(index) + " staged - applies at the next cycle boundary\n");
+}
+
+static void handleProfileSave() {
+    if (!requireWriteAccess()) return;
+    uint8_t index;
+    if (!readProfileIndexArg(index)) {
+        server.send(400, "text/plain", "index must be 0-" + String(JOB_PROFILE_COUNT - 1) + "\n");
+        return;
+    }
+
+    // Start from the stored slot so only the given fields change
+    JobProfile profile = *getJobProfile(index);
+    if (server.hasArg("name")) {
+        memset(profile.name, 0, sizeof(profile.name));
+        strncpy(profile.name, server.arg("name").c_str(), JOB_PROFILE_NAME_LENGTH - 1);
+    }
+    readFloatArg("cutSpeed", profile.cutSpeed);
+    if (server.hasArg("adaptive")) profile.adaptiveCut = server.arg("adaptive").toInt() != 0;
+    readFloatArg("cutTravel", profile.cutTravelInches);
+    readFloatArg("clampEarly", profile.rotationClampEarlyOffsetInches);
+    readFloatArg("servoEarly", profile.rotationServoEarlyOffsetInches);
+    readMsArg("clampHoldMs", profile.rotationClampExtendMs);
+    readMsArg("servoDwellMs", profile.rotationServoReleaseDwellMs);
+    readFloatArg("feedTravel", profile.feedTravelInches);
+    readFloatArg("push1", profile.firstCutPushInches[0]);
+    readFloatArg("push2", profile.firstCutPushInches[1]);
+    readFloatArg("parkOffset", profile.firstCutParkOffsetInches);
+    readFloatArg("regrip", profile.noWoodRegripInches);
+
+    const char* reason = nullptr;
+    if (!saveJobProfile(index, profile, &reason)) {
+        server.send(400, "text/plain", String("rejected: ") + (reason ? reason : "unknown") + "\n");
+        return;
+    }
+    String out = "saved\n";
+    appendProfile(out, index);
+    server.send(200, "text/plain", out);
+}
+
+static void sendJournalLine(const JournalRecord& record, void* context) {
+    (void)context;
+    char line[160];
+    formatJournalRecord(record, line, sizeof(line));
+    size_t length = strlen(line);
+    line[length++] = '\n';
+    server.sendContent(line, length);
+}
+
+static void handleJournal() {
+    if (!isFaultJournalMounted()) {
+        server.send(503, "text/plain", "fault journal partition not mounted\n");
+        return;
+    }
+    size_t limit = DIAGNOSTICS_JOURNAL_DEFAULT_LIMIT;
+    if (server.hasArg("limit")) {
+        long requested = server.arg("limit").toInt();
+        if (requested > 0) limit = (size_t)requested;
+    }
+
+    // Stream line by line - the journal can be far larger than free heap
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/plain", "");
+    char header[96];
+    snprintf(header, sizeof(header), "# %lu records stored, %lu sector erases since boot\n",
+             (unsigned long)getJournalRecordCount(), (unsigned long)getJournalSectorErases());
+    server.sendContent(header);
+    forEachJournalRecord(limit, sendJournalLine, nullptr);
+    server.sendContent("");
+}
+
+static void handleLoopProfile() {
+    String out;
+    formatLoopProfile(out);
+    server.send(200, "text/plain", out);
+}
+
+static void handleFlightRecorderDownload() {
+    size_t total = getFlightRecorderCaptureSize();
+    if (total == 0) {
+        server.send(404, "text/plain", "no frozen capture - recorder is armed\n");
+        return;
+    }
+    server.sendHeader("Content-Disposition", "attachment; filename=flightrecorder.bin");
+    server.setContentLength(total);
+    server.send(200, "application/octet-stream", "");
+    uint8_t chunk[1024];
+    size_t offset = 0;
+    while (offset < total) {
+        size_t copied = readFlightRecorderCapture(offset, chunk, sizeof(chunk));
+        if (copied == 0) break;
+        server.sendContent((const char*)chunk, copied);
+        offset += copied;
+    }
+}
+
+static void handleFlightRecorderTrigger() {
+    if (!triggerFlightRecorder(FLIGHT_TRIGGER_MANUAL)) {
+        server.send(409, "text/plain", "capture already pending or frozen - rearm first\n");
+        return;
+    }
+    server.send(200, "text/plain", "triggered - capture freezes after the post-trigger window\n");
+}
+
+static void handleFlightRecorderRearm() {
+    rearmFlightRecorder();
+    server.send(200, "text/plain", "re-armed\n");
+}
+
+static void handleInputTraceDownload() {
+    size_t total = getInputTraceCaptureSize();
+    if (total == 0) {
+        server.send(404, "text/plain", "no frozen trace - still recording\n");
+        return;
+    }
+    server.sendHeader("Content-Disposition", "attachment; filename=inputs.bin");
+    server.setContentLength(total);
+    server.send(200, "application/octet-stream", "");
+    uint8_t chunk[1024];
+    size_t offset = 0;
+    while (offset < total) {
+        size_t copied = readInputTraceCapture(offset, chunk, sizeof(chunk));
+        if (copied == 0) break;
+        server.sendContent((const char*)chunk, copied);
+        offset += copied;
+    }
+}
+
+static void handleInputTraceFreeze() {
+    if (!freezeInputTrace(INPUT_TRACE_FREEZE_MANUAL)) {
+        server.send(409, "text/plain", "already frozen - rearm first\n");
+        return;
+    }
+    server.send(200, "text/plain", "frozen\n");
+}
+
+static void handleInputTraceRearm() {
+    rearmInputTrace();
+    server.send(200, "text/plain", "re-armed\n");
+}
+
+// Uploaded sequences drive the feed motor and clamps - only swap them while
+// the machine is parked in IDLE
+static bool requireIdleForSequenceChange() {
+    if (currentState == IDLE) return true;
+    server.send(409, "text/plain", String("rejected: machine is in ") + getSystemStateName(currentState) + " - sequences change only in IDLE\n");
+    return false;
+}
+
+static bool readSequenceNameArg(SequenceId& id) {
+    if (findSequenceByName(server.arg("name").c_str(), id)) return true;
+    server.send(400, "text/plain", "name must be feed_first_cut or feed_wood_fwd_one\n");
+    return false;
+}
+
+static void handleSequenceList() {
+    String out;
+    for (uint8_t i = 0; i < SEQUENCE_COUNT; i++) {
+        SequenceId id = (SequenceId)i;
+        out += "# ";
+        out += getSequenceName(id);
+        out += isSequenceReplaced(id) ? " (uploaded)\n" : " (built-in)\n";
+        formatSequence(id, out);
+        out += "\n";
+    }
+    server.send(200, "text/plain", out);
+}
+
+// Upload callback: a compiled sequence is small, so it is collected whole.
+// Nothing is kept from a request without the write credential.
+static uint8_t sequenceUpload[SEQUENCE_BLOB_HEADER_SIZE + SEQUENCE_MAX_INSTRUCTIONS * sizeof(SequenceInstruction)];
+static size_t sequenceUploadLength = 0;
+static bool sequenceUploadTooLarge = false;
+static bool sequenceUploadAuthorized = false;
+
+static void handleSequenceUpload() {
+    HTTPUpload& upload = server.upload();
+    if (upload.status == UPLOAD_FILE_START) {
+        sequenceUploadLength = 0;
+        sequenceUploadTooLarge = false;
+        sequenceUploadAuthorized = hasWriteAccess();
+    } else if (upload.status == UPLOAD_FILE_WRITE) {
+        if (!sequenceUploadAuthorized) return;
+        if (sequenceUploadLength + upload.currentSize > sizeof(sequenceUpload)) {
+            sequenceUploadTooLarge = true;
+            return;
+        }
+        memcpy(sequenceUpload + sequenceUploadLength, upload.buf, upload.currentSize);
+        sequenceUploadLength += upload.currentSize;
+    }
+}
+
+static void handleSequenceInstall() {
+    bool authorized = sequenceUploadAuthorized;
+    sequenceUploadAuthorized = false;
+    if (!requireWriteAccess()) return;
+    if (!authorized) sequenceUploadLength = 0; // Body arrived before the credential
+    if (!requireIdleForSequenceChange()) return;
+    SequenceId id;
+    if (!readSequenceNameArg(id)) return;
+    const char* reason = sequenceUploadTooLarge ? "too many instructions" : nullptr;
+    if (!reason && !installSequence(id, sequenceUpload, sequenceUploadLength, &reason)) {
+        if (!reason) reason = "unknown";
+    }
+    if (reason) {
+        server.send(400, "text/plain", String("rejected: ") + reason + "\n");
+        return;
+    }
+    String out = "installed - used from the next start of the sequence\n";
+    formatSequence(id, out);
+    server.send(200, "text/plain", out);
+}
+
+static void handleSequenceReset() {
+    if (!requireWriteAccess()) return;
+    if (!requireIdleForSequenceChange()) return;
+    SequenceId id;
+    if (!readSequenceNameArg(id)) return;
+    resetSequence(id);
+    server.send(200, "text/plain", String(getSequenceName(id)) + " back to built-in\n");
+}
+
+static void handleHomeStop() {
+    String out;
+    formatCutHomeLimitReport(out);
+    server.send(200, "text/plain", out);
+}
+
+static void handleStepPulses() {
+    String out;
+    formatStepPulseReport(out);
+    server.send(200, "text/plain", out);
+}
+
+static void handleMemory() {
+    String out;
+    formatMemoryReport(out);
+    server.send(200, "text/plain", out);
+}
+
+static void handleStateGraph() {
+    String out;
+    formatStateGraphDot(out);
+    server.send(200, "text/vnd.graphviz", out);
+}
+
+// Upload callback: the package is applied as it streams in. Headers are
+// parsed before the body, so the credential is checked before anything is
+// written to the OTA slot.
+static const char* updateFailure = nullptr;
+static bool updateStarted = false;
+static bool updateAuthorized = false;
+
+static void handleUpdateUpload() {
+    HTTPUpload& upload = server.upload();
+    switch (upload.status) {
+        case UPLOAD_FILE_START:
+            updateStarted = true;
+            updateFailure = nullptr;
+            updateAuthorized = hasWriteAccess();
+            if (!updateAuthorized) {
+                updateFailure = "authentication required";
+                break;
+            }
+            beginOtaPackage(&updateFailure);
+            break;
+        case UPLOAD_FILE_WRITE:
+            feedHeartbeat(HEARTBEAT_NETWORK); // The whole upload runs inside one handleClient() call
+            if (!updateFailure) writeOtaPackage(upload.buf, upload.currentSize, &updateFailure);
+            break;
+        case UPLOAD_FILE_END:
+            if (!updateFailure) endOtaPackage(&updateFailure);
+            break;
+        case UPLOAD_FILE_ABORTED:
+            if (updateAuthorized) abortOtaPackage();
+            updateFailure = "upload aborted";
+            break;
+    }
+}
+
+static void handleUpdateDone() {
+    bool started = updateStarted;
+    updateStarted = false;
+    updateAuthorized = false;
+    if (!requireWriteAccess()) return;
+    if (!started) {
+        server.send(400, "text/plain", "update rejected: no package in the request\n");
+        return;
+    }
+    if (updateFailure) {
+        server.send(isOtaAllowedInState(currentState) ? 400 : 409, "text/plain", String("update rejected: ") + updateFailure + "\n");
+        return;
+    }
+    server.send(200, "text/plain", "update written - restarting into the new image\n");
+    delay(500); // Let the response go out
+    ESP.restart();
+}
+
+void setupDiagnosticsServer() {
+    server.on("/", HTTP_GET, handleStatus);
+    server.on("/profiles", HTTP_GET, handleProfileList);
+    server.on("/profile/select", HTTP_POST, handleProfileSelect);
+    server.on("/profile/save", HTTP_POST, handleProfileSave);
+    server.on("/journal", HTTP_GET, handleJournal);
+    server.on("/loop", HTTP_GET, handleLoopProfile);
+    server.on("/flightrecorder.bin", HTTP_GET, handleFlightRecorderDownload);
+    server.on("/flightrecorder/trigger", handleFlightRecorderTrigger);
+    server.on("/flightrecorder/rearm", handleFlightRecorderRearm);
+    server.on("/inputs.bin", HTTP_GET, handleInputTraceDownload);
+    server.on("/inputs/freeze", handleInputTraceFreeze);
+    server.on("/inputs/rearm", handleInputTraceRearm);
+    server.on("/sequences", HTTP_GET, handleSequenceList);
+    server.on("/sequence", HTTP_POST, handleSequenceInstall, handleSequenceUpload);
+    server.on("/sequence/reset", HTTP_POST, handleSequenceReset);
+    server.on("/memory", HTTP_GET, handleMemory);
+    server.on("/homestop", HTTP_GET, handleHomeStop);
+    server.on("/steps", HTTP_GET, handleStepPulses);
+    server.on("/states.dot", HTTP_GET, handleStateGraph);
+    server.on("/update", HTTP_POST, handleUpdateDone, handleUpdateUpload);
+    server.onNotFound([]() {
+        server.send(404, "text/plain", "not found\n");
+    });
+    server.begin();
+    Serial.print("Diagnostics server on http://");
+    Serial.print(WiFi.localIP());
+    Serial.print(":");
+    Serial.println(DIAGNOSTICS_SERVER_PORT);
+}
+
+void handleDiagnosticsServer() {
+    server.handleClient();
+}
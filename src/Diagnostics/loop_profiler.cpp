@@ -0,0 +1,160 @@
+#include "Diagnostics/loop_profiler.h"
+
+#if LOOP_PROFILER
+
+#include "Config/Config.h"
+#include "StateMachine/StateManager.h"
+#include "freertos/FreeRTOS.h"
+
+//* ************************************************************************
+//* ************************** LOOP PROFILER *******************************
+//* ************************************************************************
+// Sections are recorded from the loop task and the network task (OTA and
+// diagnostics server), so updates to the current window, the rollover and
+// the copy-out of the published window are made under a spinlock. Formatting
+// works on a copy so no text is built while the lock is held.
+
+static const uint8_t LOOP_SECTION_COUNT = LOOP_SECTION_STATE_FIRST + SUCTION_ERROR_HOLD + 1;
+
+struct LoopSectionStats {
+    uint32_t count;
+    uint64_t totalCycles;
+    uint32_t maxCycles;
+    uint32_t histogram[LOOP_PROFILER_BUCKETS];
+};
+
+static LoopSectionStats currentWindow[LOOP_SECTION_COUNT];
+static LoopSectionStats publishedWindow[LOOP_SECTION_COUNT];
+static portMUX_TYPE profilerLock = portMUX_INITIALIZER_UNLOCKED;
+static unsigned long windowStartTime = 0;
+static unsigned long publishedWindowMs = 0;
+static uint32_t lastTickCycles = 0;
+static bool tickSeen = false;
+static uint32_t cyclesPerMicrosecond = 240;
+
+static uint8_t bucketForMicroseconds(uint32_t us) {
+    if (us == 0) return 0;
+    uint8_t bucket = 32 - __builtin_clz(us);
+    return bucket < LOOP_PROFILER_BUCKETS ? bucket : LOOP_PROFILER_BUCKETS - 1;
+}
+
+static const char* sectionName(uint8_t section) {
+    switch (section) {
+        case LOOP_SECTION_TICK_INTERVAL: return "tick interval";
+        case LOOP_SECTION_TICK: return "loop body";
+        case LOOP_SECTION_OTA: return "ota";
+        case LOOP_SECTION_NETWORK: return "network";
+        case LOOP_SECTION_COMMON: return "common ops";
+        default: return getSystemStateName((SystemState)(section - LOOP_SECTION_STATE_FIRST));
+    }
+}
+
+void beginLoopProfiler() {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    if (mhz > 0) cyclesPerMicrosecond = mhz;
+    memset(currentWindow, 0, sizeof(currentWindow));
+    memset(publishedWindow, 0, sizeof(publishedWindow));
+    windowStartTime = millis();
+    tickSeen = false;
+}
+
+void recordLoopProfileSection(uint8_t section, uint32_t cycles) {
+    if (section >= LOOP_SECTION_COUNT) return;
+    uint8_t bucket = bucketForMicroseconds(cycles / cyclesPerMicrosecond);
+    portENTER_CRITICAL(&profilerLock);
+    LoopSectionStats& stats = currentWindow[section];
+    stats.count++;
+    stats.totalCycles += cycles;
+    if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+    stats.histogram[bucket]++;
+    portEXIT_CRITICAL(&profilerLock);
+}
+
+void markLoopProfilerTick() {
+    uint32_t now = readLoopProfilerCycles();
+    if (tickSeen) recordLoopProfileSection(LOOP_SECTION_TICK_INTERVAL, now - lastTickCycles);
+    lastTickCycles = now;
+    tickSeen = true;
+
+    unsigned long elapsed = millis() - windowStartTime;
+    if (elapsed < LOOP_PROFILER_WINDOW_MS) return;
+    portENTER_CRITICAL(&profilerLock);
+    memcpy(publishedWindow, currentWindow, sizeof(publishedWindow));
+    memset(currentWindow, 0, sizeof(currentWindow));
+    publishedWindowMs = elapsed;
+    portEXIT_CRITICAL(&profilerLock);
+    windowStartTime = millis();
+
+    // Printing takes long enough to show up as jitter, so only report while idle
+    if (LOOP_PROFILER_SERIAL_REPORT && currentState == IDLE) printLoopProfile();
+    lastTickCycles = readLoopProfilerCycles(); // Don't count the report against the next interval
+}
+
+// The report line by line, to a String for /loop or straight to serial
+typedef void (*LoopProfileSink)(const char* text, void* context);
+
+static void writeLoopProfile(LoopProfileSink sink, void* context) {
+    LoopSectionStats window[LOOP_SECTION_COUNT]; // ~1.4 KB, fits the loop and network task stacks
+    portENTER_CRITICAL(&profilerLock);
+    memcpy(window, publishedWindow, sizeof(window));
+    unsigned long windowMs = publishedWindowMs;
+    portEXIT_CRITICAL(&profilerLock);
+
+    char line[160];
+    snprintf(line, sizeof(line), "# loop profile: %lu ms window, %lu MHz, times in us\n",
+             windowMs, (unsigned long)cyclesPerMicrosecond);
+    sink(line, context);
+    if (windowMs == 0) {
+        sink("# first window not complete yet\n", context);
+        return;
+    }
+
+    for (uint8_t section = 0; section < LOOP_SECTION_COUNT; section++) {
+        const LoopSectionStats& stats = window[section];
+        if (stats.count == 0) continue;
+
+        // 99th percentile as the upper edge of its histogram bucket
+        uint32_t target = stats.count - stats.count / 100;
+        uint32_t running = 0;
+        uint8_t p99Bucket = 0;
+        for (uint8_t b = 0; b < LOOP_PROFILER_BUCKETS; b++) {
+            running += stats.histogram[b];
+            if (running >= target) { p99Bucket = b; break; }
+        }
+
+        snprintf(line, sizeof(line), "%-20s n=%-8lu avg=%-7lu max=%-8lu p99<%lu\n",
+                 sectionName(section), (unsigned long)stats.count,
+                 (unsigned long)(stats.totalCycles / stats.count / cyclesPerMicrosecond),
+                 (unsigned long)(stats.maxCycles / cyclesPerMicrosecond),
+                 1UL << p99Bucket);
+        sink(line, context);
+
+        sink("  hist", context);
+        for (uint8_t b = 0; b < LOOP_PROFILER_BUCKETS; b++) {
+            if (stats.histogram[b] == 0) continue;
+            snprintf(line, sizeof(line), " <%lu:%lu", 1UL << b, (unsigned long)stats.histogram[b]);
+            sink(line, context);
+        }
+        sink("\n", context);
+    }
+}
+
+static void appendToString(const char* text, void* context) {
+    *(String*)context += text;
+}
+
+static void printToSerial(const char* text, void* context) {
+    (void)context;
+    Serial.print(text);
+}
+
+void formatLoopProfile(String& out) {
+    writeLoopProfile(appendToString, &out);
+}
+
+void printLoopProfile() {
+    // Runs on the loop task: no String
+    writeLoopProfile(printToSerial, nullptr);
+}
+
+#endif // LOOP_PROFILER
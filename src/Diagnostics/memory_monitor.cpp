@@ -0,0 +1,228 @@
+#include "Diagnostics/memory_monitor.h"
+#include "Config/Config.h"
+#include "StateMachine/StateManager.h"
+#include "StatusLeds/led_pattern_engine.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+//* ************************************************************************
+//* ************************** MEMORY MONITOR ******************************
+//* ************************************************************************
+// Sampled from the loop task; the report is read by the diagnostics server on
+// the network task, hence the lock around the published figures.
+
+struct MemoryTrendSample {
+    uint32_t minFreeHeap;
+    uint32_t minLargestBlock;
+};
+
+// Tasks whose stack headroom is tracked (looked up by name until they exist)
+static const char* const WATCHED_TASKS[] = {"loopTask", "network", "watchdog", "StepperTask"};
+static const uint8_t WATCHED_TASK_COUNT = sizeof(WATCHED_TASKS) / sizeof(WATCHED_TASKS[0]);
+
+static portMUX_TYPE memoryLock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t watchedHandles[WATCHED_TASK_COUNT];
+static uint32_t stackFreeBytes[WATCHED_TASK_COUNT];    // Low-water mark, 0 = task not found
+
+static uint32_t freeHeap = 0;
+static uint32_t largestBlock = 0;
+static uint32_t minFreeHeap = UINT32_MAX;
+static uint32_t minLargestBlock = UINT32_MAX;
+
+static MemoryTrendSample trend[MEMORY_MONITOR_TREND_SAMPLES];
+static size_t trendCount = 0;
+static size_t trendNext = 0;
+static MemoryTrendSample currentInterval = {UINT32_MAX, UINT32_MAX};
+
+static MemoryLevel level = MEMORY_OK;
+static unsigned long lastSampleTime = 0;
+static unsigned long intervalStartTime = 0;
+static bool started = false;
+
+// Allocation counting (written by the malloc wrappers on the loop task only)
+static TaskHandle_t controlTask = nullptr;
+static volatile uint32_t controlAllocations = 0;
+static volatile uint32_t lastControlAllocationBytes = 0;
+static uint32_t reportedAllocations = 0;
+
+#if MEMORY_ALLOC_TRACKING
+
+static inline void IRAM_ATTR noteAllocation(size_t size) {
+    if (controlTask && !xPortInIsrContext() && xTaskGetCurrentTaskHandle() == controlTask) {
+        controlAllocations = controlAllocations + 1;
+        lastControlAllocationBytes = size;
+    }
+}
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* IRAM_ATTR __wrap_malloc(size_t size) {
+    noteAllocation(size);
+    return __real_malloc(size);
+}
+
+void* IRAM_ATTR __wrap_calloc(size_t count, size_t size) {
+    noteAllocation(count * size);
+    return __real_calloc(count, size);
+}
+
+void* IRAM_ATTR __wrap_realloc(void* ptr, size_t size) {
+    if (size > 0) noteAllocation(size);
+    return __real_realloc(ptr, size);
+}
+}
+
+#endif // MEMORY_ALLOC_TRACKING
+
+static MemoryLevel classify(uint32_t heap, uint32_t block, const uint32_t* stacks) {
+    if (heap < MEMORY_CRITICAL_FREE_HEAP_BYTES || block < MEMORY_CRITICAL_LARGEST_BLOCK_BYTES) return MEMORY_CRITICAL;
+    if (heap < MEMORY_WARNING_FREE_HEAP_BYTES || block < MEMORY_WARNING_LARGEST_BLOCK_BYTES) return MEMORY_WARNING;
+    for (uint8_t i = 0; i < WATCHED_TASK_COUNT; i++) {
+        if (stacks[i] != 0 && stacks[i] < MEMORY_WARNING_STACK_BYTES) return MEMORY_WARNING;
+    }
+    return MEMORY_OK;
+}
+
+static void takeSample(unsigned long now) {
+    uint32_t heap = ESP.getFreeHeap();
+    uint32_t block = ESP.getMaxAllocHeap();
+
+    uint32_t stacks[WATCHED_TASK_COUNT];
+    for (uint8_t i = 0; i < WATCHED_TASK_COUNT; i++) {
+        if (!watchedHandles[i]) watchedHandles[i] = xTaskGetHandle(WATCHED_TASKS[i]);
+        // ESP-IDF reports the high-water mark in bytes
+        stacks[i] = watchedHandles[i] ? (uint32_t)uxTaskGetStackHighWaterMark(watchedHandles[i]) : 0;
+    }
+    MemoryLevel newLevel = classify(heap, block, stacks);
+
+    portENTER_CRITICAL(&memoryLock);
+    freeHeap = heap;
+    largestBlock = block;
+    if (heap < minFreeHeap) minFreeHeap = heap;
+    if (block < minLargestBlock) minLargestBlock = block;
+    memcpy(stackFreeBytes, stacks, sizeof(stackFreeBytes));
+    if (heap < currentInterval.minFreeHeap) currentInterval.minFreeHeap = heap;
+    if (block < currentInterval.minLargestBlock) currentInterval.minLargestBlock = block;
+    if (now - intervalStartTime >= MEMORY_MONITOR_TREND_INTERVAL_MS) {
+        trend[trendNext] = currentInterval;
+        trendNext = (trendNext + 1) % MEMORY_MONITOR_TREND_SAMPLES;
+        if (trendCount < MEMORY_MONITOR_TREND_SAMPLES) trendCount++;
+        currentInterval = {UINT32_MAX, UINT32_MAX};
+        intervalStartTime = now;
+    }
+    portEXIT_CRITICAL(&memoryLock);
+
+    if (newLevel != level) {
+        Serial.print("MEMORY ");
+        Serial.print(getMemoryLevelName(newLevel));
+        Serial.print(": free heap ");
+        Serial.print(heap);
+        Serial.print(" bytes, largest block ");
+        Serial.print(block);
+        Serial.println(" bytes");
+        level = newLevel;
+        setLedNotice(level == MEMORY_CRITICAL ? LED_NOTICE_CRITICAL :
+                     level == MEMORY_WARNING ? LED_NOTICE_WARNING : LED_NOTICE_NONE);
+    }
+
+    uint32_t allocations = controlAllocations;
+    if (allocations != reportedAllocations) {
+        Serial.print("CONTROL TASK ALLOCATED: ");
+        Serial.print(allocations - reportedAllocations);
+        Serial.print(" heap allocation(s), last ");
+        Serial.print((uint32_t)lastControlAllocationBytes);
+        Serial.print(" bytes, during ");
+        Serial.println(getSystemStateName(stateManager.getCurrentState()));
+        reportedAllocations = allocations;
+    }
+}
+
+void beginMemoryMonitor() {
+    unsigned long now = millis();
+    intervalStartTime = now;
+    lastSampleTime = now;
+    started = true;
+    takeSample(now);
+    // Everything allocated from here on in the loop task is counted
+    controlTask = xTaskGetCurrentTaskHandle();
+}
+
+void serviceMemoryMonitor() {
+    if (!started) return;
+    unsigned long now = millis();
+    if (now - lastSampleTime < MEMORY_MONITOR_SAMPLE_MS) return;
+    lastSampleTime = now;
+    takeSample(now);
+}
+
+MemoryLevel getMemoryLevel() {
+    return level;
+}
+
+const char* getMemoryLevelName(MemoryLevel memoryLevel) {
+    switch (memoryLevel) {
+        case MEMORY_OK: return "OK";
+        case MEMORY_WARNING: return "WARNING";
+        case MEMORY_CRITICAL: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+uint32_t getControlAllocationCount() {
+    return controlAllocations;
+}
+
+void formatMemoryReport(String& out) {
+    uint32_t heap, block, minHeap, minBlock;
+    uint32_t stacks[WATCHED_TASK_COUNT];
+    MemoryTrendSample samples[MEMORY_MONITOR_TREND_SAMPLES];
+    size_t count, next;
+    portENTER_CRITICAL(&memoryLock);
+    heap = freeHeap;
+    block = largestBlock;
+    minHeap = minFreeHeap;
+    minBlock = minLargestBlock;
+    memcpy(stacks, stackFreeBytes, sizeof(stacks));
+    memcpy(samples, trend, sizeof(samples));
+    count = trendCount;
+    next = trendNext;
+    portEXIT_CRITICAL(&memoryLock);
+
+    char line[96];
+    snprintf(line, sizeof(line), "level=%s\n", getMemoryLevelName(level));
+    out += line;
+    snprintf(line, sizeof(line), "freeHeap=%lu (min %lu since boot)\n", (unsigned long)heap, (unsigned long)minHeap);
+    out += line;
+    snprintf(line, sizeof(line), "largestBlock=%lu (min %lu since boot)\n", (unsigned long)block, (unsigned long)minBlock);
+    out += line;
+#if MEMORY_ALLOC_TRACKING
+    snprintf(line, sizeof(line), "controlAllocations=%lu since setup (last %lu bytes)\n",
+             (unsigned long)controlAllocations, (unsigned long)lastControlAllocationBytes);
+#else
+    snprintf(line, sizeof(line), "controlAllocations=not tracked (MEMORY_ALLOC_TRACKING=0)\n");
+#endif
+    out += line;
+
+    out += "# stack headroom, bytes never used\n";
+    for (uint8_t i = 0; i < WATCHED_TASK_COUNT; i++) {
+        if (stacks[i] == 0) {
+            snprintf(line, sizeof(line), "%-12s not running\n", WATCHED_TASKS[i]);
+        } else {
+            snprintf(line, sizeof(line), "%-12s %lu\n", WATCHED_TASKS[i], (unsigned long)stacks[i]);
+        }
+        out += line;
+    }
+
+    snprintf(line, sizeof(line), "# minimum per %lu s, oldest first: freeHeap largestBlock\n",
+             MEMORY_MONITOR_TREND_INTERVAL_MS / 1000);
+    out += line;
+    for (size_t i = 0; i < count; i++) {
+        const MemoryTrendSample& sample = samples[(next + MEMORY_MONITOR_TREND_SAMPLES - count + i) % MEMORY_MONITOR_TREND_SAMPLES];
+        snprintf(line, sizeof(line), "%lu %lu\n", (unsigned long)sample.minFreeHeap, (unsigned long)sample.minLargestBlock);
+        out += line;
+    }
+}
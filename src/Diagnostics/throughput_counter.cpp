@@ -0,0 +1,55 @@
+#include "Diagnostics/throughput_counter.h"
+#include "freertos/FreeRTOS.h"
+
+//* ************************************************************************
+//* ************************ THROUGHPUT COUNTER ****************************
+//* ************************************************************************
+// Written from the loop task, read from the network task.
+
+static const uint8_t MINUTE_BUCKETS = 60;
+static const unsigned long MINUTE_MS = 60000UL;
+
+static portMUX_TYPE throughputLock = portMUX_INITIALIZER_UNLOCKED;
+static uint16_t minuteCuts[MINUTE_BUCKETS];
+static uint32_t currentMinute = 0;      // millis() / MINUTE_MS of the newest bucket
+static uint32_t totalCuts = 0;
+static unsigned long lastCutTime = 0;
+static uint32_t lastCycleMs = 0;
+
+// Clear buckets for the minutes that passed without a cut
+static void advanceToMinute(uint32_t minute) {
+    uint32_t elapsed = minute - currentMinute;
+    if (elapsed >= MINUTE_BUCKETS) {
+        memset(minuteCuts, 0, sizeof(minuteCuts));
+    } else {
+        for (uint32_t m = currentMinute + 1; m <= minute; m++) {
+            minuteCuts[m % MINUTE_BUCKETS] = 0;
+        }
+    }
+    currentMinute = minute;
+}
+
+void noteCutCompleted() {
+    unsigned long now = millis();
+    portENTER_CRITICAL(&throughputLock);
+    advanceToMinute(now / MINUTE_MS);
+    minuteCuts[currentMinute % MINUTE_BUCKETS]++;
+    if (totalCuts > 0) lastCycleMs = now - lastCutTime;
+    lastCutTime = now;
+    totalCuts++;
+    portEXIT_CRITICAL(&throughputLock);
+}
+
+ThroughputStats getThroughputStats() {
+    ThroughputStats stats;
+    portENTER_CRITICAL(&throughputLock);
+    advanceToMinute(millis() / MINUTE_MS);
+    stats.totalCuts = totalCuts;
+    stats.lastCycleMs = lastCycleMs;
+    stats.cutsLastHour = 0;
+    for (uint8_t i = 0; i < MINUTE_BUCKETS; i++) {
+        stats.cutsLastHour += minuteCuts[i];
+    }
+    portEXIT_CRITICAL(&throughputLock);
+    return stats;
+}
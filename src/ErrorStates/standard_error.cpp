@@ -1,14 +1,9 @@
 #include "ErrorStates/standard_error.h"
+#include "StateMachine/StateManager.h"
+#include "OTAUpdater/ota_updater.h"
 
 // External references to global variables and functions from main.cpp
-extern unsigned long lastErrorBlinkTime;
-extern bool errorBlinkState;
 extern bool errorAcknowledged;
-extern SystemState currentState;
-extern void turnRedLedOn();
-extern void turnRedLedOff();
-extern void turnYellowLedOn();
-extern void turnYellowLedOff();
 extern void stopCutMotor();
 extern void stopFeedMotor();
 
@@ -16,26 +11,30 @@ extern void stopFeedMotor();
 //* ***************************** ERROR ************************************
 //* ************************************************************************
 // Handles system error states.
-// Step 1: Blink red and yellow LEDs to indicate an error.
-// Step 2: Ensure cut and feed motors are stopped.
-// Step 3: Wait for the reload switch to be pressed (rising edge) to acknowledge the error.
+// Step 1: Red and yellow LEDs alternate (LED_STATUS_ERROR, driven by the LED pattern engine).
+// Step 2: Ensure cut and feed motors are stopped (every tick, whatever else happens).
+// Step 3: Wait for the reload switch to be pressed (rising edge event) to acknowledge the error.
 // Step 4: Once error is acknowledged, transition to ERROR_RESET state.
+//         An acknowledgement during an OTA upload is ignored - ERROR_RESET
+//         leads straight to homing.
 void handleStandardErrorState() {
-    // Blink error LEDs
-    if (millis() - lastErrorBlinkTime > 250) {
-        errorBlinkState = !errorBlinkState;
-        if(errorBlinkState) turnRedLedOn(); else turnRedLedOff();
-        if(!errorBlinkState) turnYellowLedOn(); else turnYellowLedOff();
-        lastErrorBlinkTime = millis();
-    }
-    
     // Keep motors stopped
     stopCutMotor();
     stopFeedMotor();
     
     // Wait for reload switch to acknowledge error
     if (errorAcknowledged) {
-        currentState = ERROR_RESET;
+        stateManager.changeState(ERROR_RESET);
         Serial.println("Error acknowledged in standard error state. Transitioning to ERROR_RESET.");
     }
-} 
\ No newline at end of file
+}
+
+void handleStandardErrorEvent(const MachineEvent& event) {
+    if (event.type == EVENT_SWITCH_ROSE && event.source == EVENT_SWITCH_RELOAD) {
+        if (isOtaUpdateInProgress()) {
+            Serial.println("Reload ignored - OTA update in progress.");
+            return;
+        }
+        errorAcknowledged = true; // Acted on by handleStandardErrorState() this tick
+    }
+}
@@ -1,54 +1,38 @@
 #include "ErrorStates/suction_error_hold.h"
-#include <Bounce2.h>
+#include "StateMachine/StateManager.h"
+#include "OTAUpdater/ota_updater.h"
 
 // External references to global variables and functions from main.cpp
-extern SystemState currentState;
 extern bool continuousModeActive;
 extern bool startSwitchSafe;
-extern Bounce startCycleSwitch;
-extern void turnRedLedOn();
-extern void turnRedLedOff();
-extern void turnYellowLedOff();
-extern void turnGreenLedOff();
-extern void turnBlueLedOff();
 
 //* ************************************************************************
 //* ********************* SUCTION ERROR HOLD *******************************
 //* ************************************************************************
 // Handles waiting for user to reset a wood suction error via cycle switch.
 // This state is entered from CUTTING (Step 1) if the WOOD_SUCTION_CONFIRM_SENSOR indicates an error (LOW).
-// Step 1: Slowly blink the red LED (e.g., every 1.5 seconds).
-// Step 2: Ensure yellow, green, and blue LEDs are off.
-// Step 3: Monitor the start cycle switch.
+// Step 1: Slowly blink the red LED every 1.5 seconds (LED_STATUS_SUCTION_ERROR).
+// Step 2: Yellow, green, and blue LEDs are off as part of the same pattern.
+// Step 3: Wait for start cycle switch events (the state is event-driven).
 // Step 4: If the start cycle switch shows a rising edge (OFF to ON transition):
 //          - Print a message about resetting from suction error.
 //          - Turn off the red LED.
 //          - Set continuousModeActive to false.
 //          - Set startSwitchSafe to false (requires user to cycle switch again for a new start).
 //          - Transition to HOMING state to re-initialize the system.
-void handleSuctionErrorHoldState() {
-    static unsigned long lastSuctionErrorBlinkTime = 0;
-    static bool suctionErrorBlinkState = false;
-
-    // Blink STATUS_LED_RED every 1.5 seconds
-    if (millis() - lastSuctionErrorBlinkTime >= 1500) {
-        lastSuctionErrorBlinkTime = millis();
-        suctionErrorBlinkState = !suctionErrorBlinkState;
-        if(suctionErrorBlinkState) turnRedLedOn(); else turnRedLedOff();
-    }
-    
-    // Ensure other LEDs are off
-    turnYellowLedOff();
-    turnGreenLedOff();
-    turnBlueLedOff();
-
-    if (startCycleSwitch.rose()) { // Check for start switch OFF to ON transition
+//          The switch is ignored while an OTA upload is in progress.
+void handleSuctionErrorHoldEvent(const MachineEvent& event) {
+    if (event.type == EVENT_SWITCH_ROSE && event.source == EVENT_SWITCH_START_CYCLE) { // Start switch OFF to ON transition
+        if (isOtaUpdateInProgress()) {
+            Serial.println("Start cycle switch ignored - OTA update in progress.");
+            return;
+        }
         Serial.println("Start cycle switch toggled ON. Resetting from suction error. Transitioning to HOMING.");
-        turnRedLedOff();   // Turn off error LED explicitly before changing state
+        setLedStatus(LED_STATUS_OFF);   // Turn off error LED explicitly before changing state
         
         continuousModeActive = false; // Ensure continuous mode is off
         startSwitchSafe = false;      // Require user to cycle switch OFF then ON for a new actual start
         
-        currentState = HOMING;        // Go to HOMING to re-initialize
+        stateManager.changeState(HOMING); // Go to HOMING to re-initialize
     }
 } 
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "Events/event_queue.h"
+#include "freertos/FreeRTOS.h"
+
+//* ************************************************************************
+//* ************************** EVENT QUEUE *********************************
+//* ************************************************************************
+// Ring buffer guarded by a spinlock so the esp_timer task and ISRs can post
+// while the control loop drains.
+
+static portMUX_TYPE eventQueueLock = portMUX_INITIALIZER_UNLOCKED;
+
+static MachineEvent eventQueue[EVENT_QUEUE_SIZE];
+static size_t eventQueueHead = 0;   // Next pop index
+static size_t eventQueueCount = 0;
+
+static MachineEvent eventHistory[EVENT_HISTORY_SIZE];
+static uint32_t eventHistoryLatencyUs[EVENT_HISTORY_SIZE];
+static size_t eventHistoryHead = 0; // Next write index
+
+static EventQueueStats stats = {};
+
+static const char* const EVENT_TYPE_NAMES[EVENT_TYPE_COUNT] = {
+    "NONE",
+    "STATE_ENTERED",
+    "SWITCH_ROSE",
+    "SWITCH_FELL",
+    "SENSOR_CHANGED",
+    "MOTOR_DONE",
+    "TIMER_EXPIRED",
+    "OTA_ENDED"
+};
+
+bool postEvent(EventType type, uint8_t source, int16_t value) {
+    uint32_t now = micros();
+    portENTER_CRITICAL(&eventQueueLock);
+    if (eventQueueCount >= EVENT_QUEUE_SIZE) {
+        stats.dropped++;
+        portEXIT_CRITICAL(&eventQueueLock);
+        return false;
+    }
+    MachineEvent& event = eventQueue[(eventQueueHead + eventQueueCount) % EVENT_QUEUE_SIZE];
+    event.timestampUs = now;
+    event.type = type;
+    event.source = source;
+    event.value = value;
+    eventQueueCount++;
+    stats.posted++;
+    if (eventQueueCount > stats.maxDepth) stats.maxDepth = eventQueueCount;
+    portEXIT_CRITICAL(&eventQueueLock);
+    return true;
+}
+
+bool popEvent(MachineEvent& event) {
+    portENTER_CRITICAL(&eventQueueLock);
+    if (eventQueueCount == 0) {
+        portEXIT_CRITICAL(&eventQueueLock);
+        return false;
+    }
+    event = eventQueue[eventQueueHead];
+    eventQueueHead = (eventQueueHead + 1) % EVENT_QUEUE_SIZE;
+    eventQueueCount--;
+
+    uint32_t latencyUs = micros() - event.timestampUs;
+    stats.dispatched++;
+    if (latencyUs > stats.maxLatencyUs) stats.maxLatencyUs = latencyUs;
+    eventHistory[eventHistoryHead] = event;
+    eventHistoryLatencyUs[eventHistoryHead] = latencyUs;
+    eventHistoryHead = (eventHistoryHead + 1) % EVENT_HISTORY_SIZE;
+    portEXIT_CRITICAL(&eventQueueLock);
+    return true;
+}
+
+size_t getPendingEventCount() {
+    return eventQueueCount;
+}
+
+EventQueueStats getEventQueueStats() {
+    portENTER_CRITICAL(&eventQueueLock);
+    EventQueueStats copy = stats;
+    portEXIT_CRITICAL(&eventQueueLock);
+    return copy;
+}
+
+const char* getEventTypeName(uint8_t type) {
+    if (type >= EVENT_TYPE_COUNT) return "UNKNOWN";
+    return EVENT_TYPE_NAMES[type];
+}
+
+size_t copyEventHistory(MachineEvent* destination, uint32_t* latencyUs, size_t maxEntries) {
+    portENTER_CRITICAL(&eventQueueLock);
+    size_t available = stats.dispatched < EVENT_HISTORY_SIZE ? stats.dispatched : EVENT_HISTORY_SIZE;
+    size_t count = available < maxEntries ? available : maxEntries;
+    size_t start = (eventHistoryHead + EVENT_HISTORY_SIZE - count) % EVENT_HISTORY_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        size_t index = (start + i) % EVENT_HISTORY_SIZE;
+        destination[i] = eventHistory[index];
+        if (latencyUs) latencyUs[i] = eventHistoryLatencyUs[index];
+    }
+    portEXIT_CRITICAL(&eventQueueLock);
+    return count;
+}
+
+void printEventQueueStats() {
+    EventQueueStats snapshot = getEventQueueStats();
+    Serial.printf("Events: posted=%lu dispatched=%lu dropped=%lu maxDepth=%lu maxLatency=%luus\n",
+                  (unsigned long)snapshot.posted, (unsigned long)snapshot.dispatched,
+                  (unsigned long)snapshot.dropped, (unsigned long)snapshot.maxDepth,
+                  (unsigned long)snapshot.maxLatencyUs);
+
+    MachineEvent events[EVENT_HISTORY_SIZE];
+    uint32_t latencies[EVENT_HISTORY_SIZE];
+    size_t count = copyEventHistory(events, latencies, EVENT_HISTORY_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        Serial.printf("  %10lu us  %-14s src=%u val=%d  latency=%luus\n",
+                      (unsigned long)events[i].timestampUs, getEventTypeName(events[i].type),
+                      events[i].source, events[i].value, (unsigned long)latencies[i]);
+    }
+}
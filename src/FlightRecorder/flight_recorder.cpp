@@ -0,0 +1,194 @@
+#include "FlightRecorder/flight_recorder.h"
+#include "Config/Config.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+//* ************************************************************************
+//* ************************* FLIGHT RECORDER ******************************
+//* ************************************************************************
+// The timer callback owns the ring while recording. Triggers come from the
+// loop and rearm requests from the diagnostics server, so mode changes are
+// made under a spinlock. Once frozen the callback stops writing and the ring
+// can be read without locking.
+
+enum RecorderMode : uint8_t {
+    RECORDER_RECORDING,
+    RECORDER_POST_TRIGGER,
+    RECORDER_FROZEN
+};
+
+static portMUX_TYPE recorderLock = portMUX_INITIALIZER_UNLOCKED;
+
+static FlightRecorderSample ring[FLIGHT_RECORDER_SAMPLES];
+static size_t writeIndex = 0;
+static size_t samplesWritten = 0;       // Saturates at FLIGHT_RECORDER_SAMPLES
+static volatile RecorderMode mode = RECORDER_RECORDING;
+static size_t postSamplesRemaining = 0;
+static size_t triggerRingIndex = 0;
+
+static FlightRecorderHeader frozenHeader;
+static size_t frozenFirstIndex = 0;
+
+static esp_timer_handle_t flightRecorderTimer = NULL;
+
+static size_t postTriggerSamples() {
+    size_t samples = (FLIGHT_RECORDER_POST_TRIGGER_MS * 1000UL) / FLIGHT_RECORDER_SAMPLE_INTERVAL_US;
+    if (samples < 1) samples = 1;
+    if (samples > FLIGHT_RECORDER_SAMPLES / 2) samples = FLIGHT_RECORDER_SAMPLES / 2; // Keep a pre-trigger window
+    return samples;
+}
+
+static void freezeCapture() {
+    size_t count = samplesWritten;
+    frozenFirstIndex = (writeIndex + FLIGHT_RECORDER_SAMPLES - count) % FLIGHT_RECORDER_SAMPLES;
+    frozenHeader.sampleCount = count;
+    frozenHeader.triggerIndex = (triggerRingIndex + FLIGHT_RECORDER_SAMPLES - frozenFirstIndex) % FLIGHT_RECORDER_SAMPLES;
+    mode = RECORDER_FROZEN;
+}
+
+static void flightRecorderTimerCallback(void* arg) {
+    if (mode == RECORDER_FROZEN) return;
+
+    FlightRecorderSample& sample = ring[writeIndex];
+    sample.timeUs = (uint32_t)esp_timer_get_time();
+    sample.cutPositionSteps = cutMotor ? cutMotor->getCurrentPosition() : 0;
+    sample.cutSpeedMilliHz = cutMotor ? cutMotor->getCurrentSpeedInMilliHz() : 0;
+    uint8_t flags = 0;
+    if (digitalRead(CUT_MOTOR_HOME_SWITCH) == HIGH) flags |= FLIGHT_SAMPLE_HOME_RAW;
+    if (cutHomingSwitch.read() == HIGH) flags |= FLIGHT_SAMPLE_HOME_DEBOUNCED;
+    if (cutMotor && cutMotor->isRunning()) flags |= FLIGHT_SAMPLE_CUT_RUNNING;
+    if (feedMotor && feedMotor->isRunning()) flags |= FLIGHT_SAMPLE_FEED_RUNNING;
+    sample.flags = flags;
+    sample.state = (uint8_t)currentState;
+    sample.reserved = 0;
+
+    portENTER_CRITICAL(&recorderLock);
+    writeIndex = (writeIndex + 1) % FLIGHT_RECORDER_SAMPLES;
+    if (samplesWritten < FLIGHT_RECORDER_SAMPLES) samplesWritten++;
+    if (mode == RECORDER_POST_TRIGGER && --postSamplesRemaining == 0) {
+        freezeCapture();
+    }
+    portEXIT_CRITICAL(&recorderLock);
+}
+
+void beginFlightRecorder() {
+    if (flightRecorderTimer) return;
+
+    const esp_timer_create_args_t timerArgs = {
+        .callback = &flightRecorderTimerCallback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "flight_recorder",
+        .skip_unhandled_events = true
+    };
+    if (esp_timer_create(&timerArgs, &flightRecorderTimer) != ESP_OK ||
+        esp_timer_start_periodic(flightRecorderTimer, FLIGHT_RECORDER_SAMPLE_INTERVAL_US) != ESP_OK) {
+        Serial.println("Failed to start flight recorder timer");
+        return;
+    }
+    Serial.printf("Flight recorder: %u samples every %lu us, %lu ms after trigger\n",
+                  (unsigned)FLIGHT_RECORDER_SAMPLES, FLIGHT_RECORDER_SAMPLE_INTERVAL_US, FLIGHT_RECORDER_POST_TRIGGER_MS);
+}
+
+bool triggerFlightRecorder(FlightRecorderTrigger reason) {
+    if (!flightRecorderTimer) return false;
+
+    bool started = false;
+    portENTER_CRITICAL(&recorderLock);
+    if (mode == RECORDER_RECORDING) {
+        memset(&frozenHeader, 0, sizeof(frozenHeader));
+        memcpy(frozenHeader.magic, "FREC", 4);
+        frozenHeader.version = FLIGHT_RECORDER_FORMAT_VERSION;
+        frozenHeader.headerSize = sizeof(FlightRecorderHeader);
+        frozenHeader.sampleSize = sizeof(FlightRecorderSample);
+        frozenHeader.triggerReason = reason;
+        frozenHeader.triggerState = (uint8_t)currentState;
+        frozenHeader.sampleIntervalUs = FLIGHT_RECORDER_SAMPLE_INTERVAL_US;
+        frozenHeader.triggerTimeUs = (uint32_t)esp_timer_get_time();
+        frozenHeader.triggerUptimeMs = millis();
+        frozenHeader.cutStepsPerInch = CUT_MOTOR_STEPS_PER_INCH;
+        triggerRingIndex = writeIndex;
+        postSamplesRemaining = postTriggerSamples();
+        mode = RECORDER_POST_TRIGGER;
+        started = true;
+    }
+    portEXIT_CRITICAL(&recorderLock);
+
+    if (started) {
+        Serial.print("Flight recorder: triggered by ");
+        Serial.println(getFlightRecorderTriggerName(reason));
+    }
+    return started;
+}
+
+void rearmFlightRecorder() {
+    portENTER_CRITICAL(&recorderLock);
+    samplesWritten = 0;
+    mode = RECORDER_RECORDING;
+    portEXIT_CRITICAL(&recorderLock);
+    Serial.println("Flight recorder: re-armed");
+}
+
+bool isFlightRecorderFrozen() {
+    return mode == RECORDER_FROZEN;
+}
+
+size_t getFlightRecorderCaptureSize() {
+    if (mode != RECORDER_FROZEN) return 0;
+    return sizeof(FlightRecorderHeader) + frozenHeader.sampleCount * sizeof(FlightRecorderSample);
+}
+
+size_t readFlightRecorderCapture(size_t offset, uint8_t* buffer, size_t length) {
+    size_t total = getFlightRecorderCaptureSize();
+    if (offset >= total) return 0;
+    if (length > total - offset) length = total - offset;
+
+    size_t copied = 0;
+    // Header bytes
+    while (copied < length && offset + copied < sizeof(FlightRecorderHeader)) {
+        buffer[copied] = ((const uint8_t*)&frozenHeader)[offset + copied];
+        copied++;
+    }
+    // Sample bytes, unrolled from the ring oldest first
+    while (copied < length) {
+        size_t sampleOffset = offset + copied - sizeof(FlightRecorderHeader);
+        size_t sampleNumber = sampleOffset / sizeof(FlightRecorderSample);
+        size_t byteInSample = sampleOffset % sizeof(FlightRecorderSample);
+        const uint8_t* source = (const uint8_t*)&ring[(frozenFirstIndex + sampleNumber) % FLIGHT_RECORDER_SAMPLES];
+        size_t chunk = sizeof(FlightRecorderSample) - byteInSample;
+        if (chunk > length - copied) chunk = length - copied;
+        memcpy(buffer + copied, source + byteInSample, chunk);
+        copied += chunk;
+    }
+    return copied;
+}
+
+const char* getFlightRecorderTriggerName(uint8_t reason) {
+    switch (reason) {
+        case FLIGHT_TRIGGER_CUTTING_HOME_CHECK: return "CUTTING_HOME_CHECK";
+        case FLIGHT_TRIGGER_YES_2X4_HOME_CHECK: return "YES_2X4_HOME_CHECK";
+        case FLIGHT_TRIGGER_NO_2X4_HOME_CHECK: return "NO_2X4_HOME_CHECK";
+        case FLIGHT_TRIGGER_REAL_TIME_HOME_CHECK: return "REAL_TIME_HOME_CHECK";
+        case FLIGHT_TRIGGER_MANUAL: return "MANUAL";
+        default: return "NONE";
+    }
+}
+
+void printFlightRecorderStatus() {
+    switch (mode) {
+        case RECORDER_RECORDING:
+            Serial.printf("Flight recorder: recording (%u samples buffered)\n", (unsigned)samplesWritten);
+            break;
+        case RECORDER_POST_TRIGGER:
+            Serial.printf("Flight recorder: triggered by %s, %u samples to go\n",
+                          getFlightRecorderTriggerName(frozenHeader.triggerReason), (unsigned)postSamplesRemaining);
+            break;
+        case RECORDER_FROZEN:
+            Serial.printf("Flight recorder: frozen capture of %lu samples from %s at %lu ms\n",
+                          (unsigned long)frozenHeader.sampleCount,
+                          getFlightRecorderTriggerName(frozenHeader.triggerReason),
+                          (unsigned long)frozenHeader.triggerUptimeMs);
+            break;
+    }
+}
@@ -0,0 +1,188 @@
+#include "InputTrace/input_trace.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+//* ************************************************************************
+//* *************************** INPUT TRACE ********************************
+//* ************************************************************************
+// Edge interrupts and state changes run on the loop core; freeze and rearm
+// requests also come from the diagnostics server on the network task, so
+// every ring update is made under a spinlock. Once frozen nothing writes the
+// ring and it can be read without locking.
+
+static portMUX_TYPE traceLock = portMUX_INITIALIZER_UNLOCKED;
+
+static InputTraceEvent ring[INPUT_TRACE_EVENTS];
+static size_t writeIndex = 0;
+static size_t eventsWritten = 0;        // Saturates at INPUT_TRACE_EVENTS
+static uint32_t eventsLost = 0;
+static volatile bool frozen = false;
+static bool started = false;
+
+static InputTraceHeader frozenHeader;
+static size_t frozenFirstIndex = 0;
+
+static int tracedPins[INPUT_TRACE_INPUT_COUNT];
+
+// Caller holds traceLock
+static void appendEvent(uint8_t source, uint8_t level, uint8_t state) {
+    if (frozen) return;
+    InputTraceEvent& event = ring[writeIndex];
+    event.timeUs = (uint32_t)esp_timer_get_time();
+    event.source = source;
+    event.level = level;
+    event.state = state;
+    event.reserved = 0;
+    writeIndex = (writeIndex + 1) % INPUT_TRACE_EVENTS;
+    if (eventsWritten < INPUT_TRACE_EVENTS) eventsWritten++;
+    else eventsLost++;
+}
+
+void IRAM_ATTR traceInputEdgeFromIsr(uint8_t source, uint8_t level) {
+    if (!started || source >= INPUT_TRACE_INPUT_COUNT) return;
+    portENTER_CRITICAL_ISR(&traceLock);
+    appendEvent(source, level, (uint8_t)currentState);
+    portEXIT_CRITICAL_ISR(&traceLock);
+}
+
+static void IRAM_ATTR inputEdgeIsr(void* arg) {
+    uint8_t source = (uint8_t)(uintptr_t)arg;
+    uint8_t level = digitalRead(tracedPins[source]);
+    portENTER_CRITICAL_ISR(&traceLock);
+    appendEvent(source, level, (uint8_t)currentState);
+    portEXIT_CRITICAL_ISR(&traceLock);
+}
+
+static uint8_t readTracedLevels() {
+    uint8_t levels = 0;
+    for (uint8_t i = 0; i < INPUT_TRACE_INPUT_COUNT; i++) {
+        if (digitalRead(tracedPins[i]) == HIGH) levels |= (1 << i);
+    }
+    return levels;
+}
+
+void beginInputTrace() {
+    if (started) return;
+    tracedPins[INPUT_TRACE_CUT_HOME] = CUT_MOTOR_HOME_SWITCH;
+    tracedPins[INPUT_TRACE_FEED_HOME] = FEED_MOTOR_HOME_SWITCH;
+    tracedPins[INPUT_TRACE_RELOAD] = RELOAD_SWITCH;
+    tracedPins[INPUT_TRACE_START_CYCLE] = START_CYCLE_SWITCH;
+    tracedPins[INPUT_TRACE_MANUAL_FEED] = MANUAL_FEED_SWITCH;
+    tracedPins[INPUT_TRACE_2X4_SENSOR] = _2x4_PRESENT_SENSOR;
+    tracedPins[INPUT_TRACE_SUCTION_SENSOR] = WOOD_SUCTION_CONFIRM_SENSOR;
+
+    for (uint8_t i = 0; i < INPUT_TRACE_INPUT_COUNT; i++) {
+        if (i == INPUT_TRACE_CUT_HOME) continue; // Forwarded by the cut home limit interrupt
+        attachInterruptArg(tracedPins[i], inputEdgeIsr, (void*)(uintptr_t)i, CHANGE);
+    }
+    started = true;
+    Serial.printf("Input trace: %u events, %u inputs\n", (unsigned)INPUT_TRACE_EVENTS, (unsigned)INPUT_TRACE_INPUT_COUNT);
+}
+
+void noteInputTraceState(uint8_t fromState, uint8_t toState) {
+    if (!started) return;
+    portENTER_CRITICAL(&traceLock);
+    appendEvent(INPUT_TRACE_STATE, toState, fromState);
+    portEXIT_CRITICAL(&traceLock);
+
+    if (toState == ERROR) freezeInputTrace(INPUT_TRACE_FREEZE_ERROR);
+    else if (toState == SUCTION_ERROR_HOLD) freezeInputTrace(INPUT_TRACE_FREEZE_SUCTION_ERROR);
+}
+
+bool freezeInputTrace(InputTraceFreeze reason) {
+    if (!started) return false;
+
+    uint8_t levels = readTracedLevels();
+    bool froze = false;
+    portENTER_CRITICAL(&traceLock);
+    if (!frozen) {
+        memset(&frozenHeader, 0, sizeof(frozenHeader));
+        memcpy(frozenHeader.magic, "ITRC", 4);
+        frozenHeader.version = INPUT_TRACE_FORMAT_VERSION;
+        frozenHeader.headerSize = sizeof(InputTraceHeader);
+        frozenHeader.eventSize = sizeof(InputTraceEvent);
+        frozenHeader.freezeReason = reason;
+        frozenHeader.freezeState = (uint8_t)currentState;
+        frozenHeader.eventCount = eventsWritten;
+        frozenHeader.eventsLost = eventsLost;
+        frozenHeader.freezeTimeUs = (uint32_t)esp_timer_get_time();
+        frozenHeader.freezeUptimeMs = millis();
+        frozenHeader.levelsAtFreeze = levels;
+        frozenFirstIndex = (writeIndex + INPUT_TRACE_EVENTS - eventsWritten) % INPUT_TRACE_EVENTS;
+        frozen = true;
+        froze = true;
+    }
+    portEXIT_CRITICAL(&traceLock);
+
+    if (froze) {
+        Serial.printf("Input trace: frozen by %s (%lu events)\n", getInputTraceFreezeName(reason),
+                      (unsigned long)frozenHeader.eventCount);
+    }
+    return froze;
+}
+
+void rearmInputTrace() {
+    portENTER_CRITICAL(&traceLock);
+    eventsWritten = 0;
+    eventsLost = 0;
+    frozen = false;
+    portEXIT_CRITICAL(&traceLock);
+    Serial.println("Input trace: re-armed");
+}
+
+bool isInputTraceFrozen() {
+    return frozen;
+}
+
+size_t getInputTraceCaptureSize() {
+    if (!frozen) return 0;
+    return sizeof(InputTraceHeader) + frozenHeader.eventCount * sizeof(InputTraceEvent);
+}
+
+size_t readInputTraceCapture(size_t offset, uint8_t* buffer, size_t length) {
+    size_t total = getInputTraceCaptureSize();
+    if (offset >= total) return 0;
+    if (length > total - offset) length = total - offset;
+
+    size_t copied = 0;
+    // Header bytes
+    while (copied < length && offset + copied < sizeof(InputTraceHeader)) {
+        buffer[copied] = ((const uint8_t*)&frozenHeader)[offset + copied];
+        copied++;
+    }
+    // Event bytes, unrolled from the ring oldest first
+    while (copied < length) {
+        size_t eventOffset = offset + copied - sizeof(InputTraceHeader);
+        size_t eventNumber = eventOffset / sizeof(InputTraceEvent);
+        size_t byteInEvent = eventOffset % sizeof(InputTraceEvent);
+        const uint8_t* source = (const uint8_t*)&ring[(frozenFirstIndex + eventNumber) % INPUT_TRACE_EVENTS];
+        size_t chunk = sizeof(InputTraceEvent) - byteInEvent;
+        if (chunk > length - copied) chunk = length - copied;
+        memcpy(buffer + copied, source + byteInEvent, chunk);
+        copied += chunk;
+    }
+    return copied;
+}
+
+const char* getInputTraceFreezeName(uint8_t reason) {
+    switch (reason) {
+        case INPUT_TRACE_FREEZE_ERROR: return "ERROR";
+        case INPUT_TRACE_FREEZE_SUCTION_ERROR: return "SUCTION_ERROR_HOLD";
+        case INPUT_TRACE_FREEZE_MANUAL: return "MANUAL";
+        default: return "NONE";
+    }
+}
+
+void printInputTraceStatus() {
+    if (frozen) {
+        Serial.printf("Input trace: frozen trace of %lu events from %s at %lu ms\n",
+                      (unsigned long)frozenHeader.eventCount,
+                      getInputTraceFreezeName(frozenHeader.freezeReason),
+                      (unsigned long)frozenHeader.freezeUptimeMs);
+    } else {
+        Serial.printf("Input trace: recording (%u events buffered, %lu overwritten)\n",
+                      (unsigned)eventsWritten, (unsigned long)eventsLost);
+    }
+}
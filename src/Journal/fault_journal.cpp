@@ -0,0 +1,443 @@
+#include "Journal/fault_journal.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_STROKE_MONITOR_FUNCTIONS.h"
+#include "StateMachine/StateManager.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stddef.h>
+
+//* ************************************************************************
+//* ************************** FAULT JOURNAL *******************************
+//* ************************************************************************
+// Partition layout: 4 KB sectors, each starting with a 32-byte header
+// (magic + sector sequence) followed by 127 record slots. The head sector is
+// the valid sector with the highest sequence; the write position is its first
+// erased slot. When the head sector fills, the next sector is erased (dropping
+// the oldest records) and stamped with the next sector sequence.
+// A record torn by power loss fails its CRC and is skipped when reading.
+// Appends come from the loop task and reads from the diagnostics server on
+// the network task; journalLock covers the write position and each flash
+// access, and is released before a visitor runs.
+
+static const char* JOURNAL_PARTITION_LABEL = "journal";
+static const esp_partition_subtype_t JOURNAL_PARTITION_SUBTYPE = (esp_partition_subtype_t)0x40;
+static const uint32_t JOURNAL_SECTOR_SIZE = 4096;
+static const uint32_t JOURNAL_SECTOR_MAGIC = 0x314E524A; // "JRN1"
+static const uint32_t JOURNAL_ERASED_WORD = 0xFFFFFFFF;
+static const uint32_t RECORDS_PER_SECTOR = JOURNAL_SECTOR_SIZE / sizeof(JournalRecord) - 1; // Slot 0 is the header
+static const size_t JOURNAL_READ_CHUNK_RECORDS = 8;
+
+struct JournalSectorHeader {
+    uint32_t magic;
+    uint32_t sectorSequence;
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(JournalSectorHeader) == sizeof(JournalRecord), "Sector header fills one record slot");
+
+// Flash position
+static SemaphoreHandle_t journalLock = nullptr;
+static const esp_partition_t* partition = nullptr;
+static uint32_t sectorCount = 0;
+static uint32_t headSector = 0;
+static uint32_t headSectorSequence = 0;
+static uint32_t writeIndex = 0;         // Next free slot in the head sector
+static uint32_t nextSequence = 1;
+static uint32_t firstSequence = 0;      // Oldest stored record (0 = empty)
+static uint16_t bootCount = 0;
+static uint32_t sectorErases = 0;
+
+// RAM pre-fault ring
+static JournalRecord preFaultRing[JOURNAL_PRE_FAULT_RECORDS];
+static size_t preFaultHead = 0;         // Oldest record
+static size_t preFaultCount = 0;
+
+// Fault commit and post-fault window
+static bool faultCommitPending = false;
+static bool postFaultBacklog = false;   // Post-fault records held in RAM while a motor ran
+static unsigned long postFaultUntilMs = 0;
+static unsigned long lastSnapshotMs = 0;
+
+static uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static bool isRecordValid(const JournalRecord& record) {
+    return record.sequence != JOURNAL_ERASED_WORD &&
+           record.crc == crc16((const uint8_t*)&record, offsetof(JournalRecord, crc));
+}
+
+static bool isRecordErased(const JournalRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    for (size_t i = 0; i < sizeof(record); i++) {
+        if (bytes[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static size_t slotOffset(uint32_t sector, uint32_t slot) {
+    return (size_t)sector * JOURNAL_SECTOR_SIZE + (size_t)(slot + 1) * sizeof(JournalRecord);
+}
+
+static bool readSectorHeader(uint32_t sector, JournalSectorHeader& header) {
+    if (esp_partition_read(partition, (size_t)sector * JOURNAL_SECTOR_SIZE, &header, sizeof(header)) != ESP_OK) return false;
+    return header.magic == JOURNAL_SECTOR_MAGIC;
+}
+
+static bool formatSector(uint32_t sector, uint32_t sequence) {
+    if (esp_partition_erase_range(partition, (size_t)sector * JOURNAL_SECTOR_SIZE, JOURNAL_SECTOR_SIZE) != ESP_OK) return false;
+    sectorErases++;
+    JournalSectorHeader header;
+    memset(&header, 0xFF, sizeof(header));
+    header.magic = JOURNAL_SECTOR_MAGIC;
+    header.sectorSequence = sequence;
+    return esp_partition_write(partition, (size_t)sector * JOURNAL_SECTOR_SIZE, &header, sizeof(header)) == ESP_OK;
+}
+
+// First valid record sequence in a sector (0 if none)
+static uint32_t readFirstSequence(uint32_t sector) {
+    JournalSectorHeader header;
+    if (!readSectorHeader(sector, header)) return 0;
+    JournalRecord record;
+    for (uint32_t slot = 0; slot < RECORDS_PER_SECTOR; slot++) {
+        if (esp_partition_read(partition, slotOffset(sector, slot), &record, sizeof(record)) != ESP_OK) return 0;
+        if (isRecordErased(record)) return 0;
+        if (isRecordValid(record)) return record.sequence;
+    }
+    return 0;
+}
+
+// Scan a sector; returns the first erased slot and the last valid record
+static uint32_t scanSector(uint32_t sector, JournalRecord& lastValid, bool& haveLastValid) {
+    JournalRecord record;
+    for (uint32_t slot = 0; slot < RECORDS_PER_SECTOR; slot++) {
+        if (esp_partition_read(partition, slotOffset(sector, slot), &record, sizeof(record)) != ESP_OK) return RECORDS_PER_SECTOR;
+        if (isRecordErased(record)) return slot;
+        if (isRecordValid(record)) {
+            lastValid = record;
+            haveLastValid = true;
+        }
+    }
+    return RECORDS_PER_SECTOR;
+}
+
+static bool mountJournal() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, JOURNAL_PARTITION_SUBTYPE, JOURNAL_PARTITION_LABEL);
+    if (!partition) return false;
+    sectorCount = partition->size / JOURNAL_SECTOR_SIZE;
+    if (sectorCount < 2) {
+        partition = nullptr;
+        return false;
+    }
+
+    bool found = false;
+    uint32_t oldestSector = 0;
+    uint32_t oldestSequence = 0;
+    JournalSectorHeader header;
+    for (uint32_t sector = 0; sector < sectorCount; sector++) {
+        if (!readSectorHeader(sector, header)) continue;
+        if (!found || header.sectorSequence > headSectorSequence) {
+            headSector = sector;
+            headSectorSequence = header.sectorSequence;
+        }
+        if (!found || header.sectorSequence < oldestSequence) {
+            oldestSector = sector;
+            oldestSequence = header.sectorSequence;
+        }
+        found = true;
+    }
+
+    if (!found) {
+        // Blank partition
+        headSector = 0;
+        headSectorSequence = 1;
+        writeIndex = 0;
+        return formatSector(headSector, headSectorSequence);
+    }
+
+    JournalRecord lastValid;
+    bool haveLastValid = false;
+    writeIndex = scanSector(headSector, lastValid, haveLastValid);
+    if (!haveLastValid) {
+        // Head sector is empty - the last record is in the sector before it
+        uint32_t previousSector = (headSector + sectorCount - 1) % sectorCount;
+        if (readSectorHeader(previousSector, header) && header.sectorSequence + 1 == headSectorSequence) {
+            scanSector(previousSector, lastValid, haveLastValid);
+        }
+    }
+    if (haveLastValid) {
+        nextSequence = lastValid.sequence + 1;
+        bootCount = lastValid.bootCount;
+    }
+    firstSequence = readFirstSequence(oldestSector);
+    return true;
+}
+
+static bool appendToFlashLocked(JournalRecord& record) {
+    if (writeIndex >= RECORDS_PER_SECTOR) {
+        uint32_t nextSector = (headSector + 1) % sectorCount;
+        JournalSectorHeader header;
+        bool droppingOldest = readSectorHeader(nextSector, header); // Log has wrapped
+        if (!formatSector(nextSector, headSectorSequence + 1)) return false;
+        headSector = nextSector;
+        headSectorSequence++;
+        writeIndex = 0;
+        if (droppingOldest) {
+            uint32_t oldest = readFirstSequence((headSector + 1) % sectorCount);
+            firstSequence = oldest != 0 ? oldest : nextSequence;
+        }
+    }
+
+    record.sequence = nextSequence;
+    record.crc = crc16((const uint8_t*)&record, offsetof(JournalRecord, crc));
+    if (esp_partition_write(partition, slotOffset(headSector, writeIndex), &record, sizeof(record)) != ESP_OK) return false;
+    writeIndex++;
+    nextSequence++;
+    if (firstSequence == 0) firstSequence = record.sequence;
+    return true;
+}
+
+static bool appendToFlash(JournalRecord& record) {
+    if (!partition) return false;
+    xSemaphoreTake(journalLock, portMAX_DELAY);
+    bool written = appendToFlashLocked(record);
+    xSemaphoreGive(journalLock);
+    return written;
+}
+
+static void captureRecord(JournalRecord& record, JournalRecordType type, uint8_t state, uint8_t previousState, int16_t detail) {
+    memset(&record, 0, sizeof(record));
+    record.uptimeMs = millis();
+    record.bootCount = bootCount;
+    record.type = type;
+    record.state = state;
+    record.previousState = previousState;
+
+    uint8_t inputs = 0;
+    if (cutHomingSwitch.read() == HIGH) inputs |= JOURNAL_IN_CUT_HOME;
+    if (feedHomingSwitch.read() == HIGH) inputs |= JOURNAL_IN_FEED_HOME;
+    if (reloadSwitch.read() == HIGH) inputs |= JOURNAL_IN_RELOAD;
+    if (startCycleSwitch.read() == HIGH) inputs |= JOURNAL_IN_START;
+    if (pushwoodForwardSwitch.read() == HIGH) inputs |= JOURNAL_IN_MANUAL_FEED;
+    if (digitalRead(_2x4_PRESENT_SENSOR) == HIGH) inputs |= JOURNAL_IN_2X4_SENSOR;
+    if (digitalRead(WOOD_SUCTION_CONFIRM_SENSOR) == HIGH) inputs |= JOURNAL_IN_SUCTION_SENSOR;
+    record.inputs = inputs;
+
+    uint8_t outputs = 0;
+    if (getOutput(ROTATION_CLAMP) == HIGH) outputs |= JOURNAL_OUT_ROTATION_CLAMP;
+    if (getOutput(FEED_CLAMP) == HIGH) outputs |= JOURNAL_OUT_FEED_CLAMP;
+    if (getOutput(_2x4_SECURE_CLAMP) == HIGH) outputs |= JOURNAL_OUT_2X4_SECURE_CLAMP;
+    if (getOutput(TRANSFER_ARM_SIGNAL_PIN) == HIGH) outputs |= JOURNAL_OUT_TA_SIGNAL;
+    if (cutMotor && cutMotor->isRunning()) outputs |= JOURNAL_OUT_CUT_RUNNING;
+    if (feedMotor && feedMotor->isRunning()) outputs |= JOURNAL_OUT_FEED_RUNNING;
+    record.outputs = outputs;
+
+    record.profileIndex = getActiveJobProfileIndex();
+    record.cutPositionSteps = cutMotor ? cutMotor->getCurrentPosition() : 0;
+    record.feedPositionSteps = feedMotor ? feedMotor->getCurrentPosition() : 0;
+    record.detail = detail;
+    record.cutStrokes = getCutStrokeStats().strokes;
+}
+
+static void pushPreFault(const JournalRecord& record) {
+    size_t index = (preFaultHead + preFaultCount) % JOURNAL_PRE_FAULT_RECORDS;
+    preFaultRing[index] = record;
+    if (preFaultCount < JOURNAL_PRE_FAULT_RECORDS) {
+        preFaultCount++;
+    } else {
+        preFaultHead = (preFaultHead + 1) % JOURNAL_PRE_FAULT_RECORDS; // Drop the oldest
+    }
+}
+
+// Flash writes and erases stall the cache, so they only happen with both axes stopped
+static bool areMotorsStopped() {
+    return !(cutMotor && cutMotor->isRunning()) && !(feedMotor && feedMotor->isRunning());
+}
+
+static bool isPostFaultWindowActive(unsigned long now) {
+    return postFaultUntilMs != 0 && (long)(postFaultUntilMs - now) > 0;
+}
+
+static size_t drainPreFaultRing() {
+    size_t committed = 0;
+    while (preFaultCount > 0) {
+        if (!appendToFlash(preFaultRing[preFaultHead])) break;
+        preFaultHead = (preFaultHead + 1) % JOURNAL_PRE_FAULT_RECORDS;
+        preFaultCount--;
+        committed++;
+    }
+    return committed;
+}
+
+static void commitPreFaultRing() {
+    size_t committed = drainPreFaultRing();
+    faultCommitPending = false;
+    postFaultUntilMs = millis() + JOURNAL_POST_FAULT_MS;
+    if (postFaultUntilMs == 0) postFaultUntilMs = 1;
+    Serial.printf("Fault journal: %u records committed to flash.\n", (unsigned)committed);
+}
+
+void beginFaultJournal() {
+    if (!journalLock) journalLock = xSemaphoreCreateMutex();
+    if (!journalLock || !mountJournal()) {
+        Serial.println("Fault journal: no journal partition - recording to RAM only.");
+        return;
+    }
+    bootCount++;
+    JournalRecord record;
+    captureRecord(record, JOURNAL_BOOT, currentState, currentState, (int16_t)esp_reset_reason());
+    appendToFlash(record);
+    Serial.printf("Fault journal: boot %u, %lu records stored, %lu sectors.\n",
+                  bootCount, (unsigned long)getJournalRecordCount(), (unsigned long)sectorCount);
+}
+
+void journalStateChange(uint8_t fromState, uint8_t toState) {
+    JournalRecord record;
+    captureRecord(record, JOURNAL_STATE_CHANGE, toState, fromState, 0);
+    pushPreFault(record);
+
+    if (toState == ERROR || toState == SUCTION_ERROR_HOLD) {
+        // Fault record carries the inputs and positions at the moment of the fault
+        captureRecord(record, JOURNAL_FAULT, toState, fromState, 0);
+        pushPreFault(record);
+        faultCommitPending = true;
+    } else if (isPostFaultWindowActive(millis()) && !faultCommitPending) {
+        postFaultBacklog = true; // Recovery transitions go to flash at the next stop
+    }
+}
+
+void serviceFaultJournal() {
+    unsigned long now = millis();
+
+    bool motorsStopped = areMotorsStopped();
+
+    // Commit once the axes have stopped, so flash writes never stall a move.
+    // Until then everything stays in the RAM ring, however long that takes.
+    if (faultCommitPending && motorsStopped) {
+        commitPreFaultRing();
+    }
+
+    bool postFault = isPostFaultWindowActive(now);
+    unsigned long interval = postFault ? JOURNAL_POST_FAULT_SNAPSHOT_MS : JOURNAL_SNAPSHOT_INTERVAL_MS;
+    if (now - lastSnapshotMs >= interval) {
+        lastSnapshotMs = now;
+        JournalRecord record;
+        captureRecord(record, JOURNAL_SNAPSHOT, currentState, currentState, 0);
+        pushPreFault(record);
+        if (postFault && !faultCommitPending) postFaultBacklog = true;
+    }
+
+    // Post-fault records follow the ring to flash whenever the axes are still
+    if (postFaultBacklog && motorsStopped) {
+        drainPreFaultRing();
+        postFaultBacklog = false;
+    }
+}
+
+size_t forEachJournalRecord(size_t maxRecords, JournalRecordVisitor visitor, void* context) {
+    if (!partition || !visitor) return 0;
+
+    // Walk from the write position as it was on entry; later appends are not visited
+    xSemaphoreTake(journalLock, portMAX_DELAY);
+    uint32_t first = firstSequence;
+    uint32_t lastSequence = nextSequence - 1;
+    uint32_t head = headSector;
+    uint32_t headSequence = headSectorSequence;
+    xSemaphoreGive(journalLock);
+    if (first == 0) return 0;
+
+    uint32_t minimumSequence = first;
+    if (maxRecords > 0 && lastSequence - first + 1 > maxRecords) {
+        minimumSequence = lastSequence - (uint32_t)maxRecords + 1;
+    }
+
+    size_t visited = 0;
+    JournalRecord chunk[JOURNAL_READ_CHUNK_RECORDS];
+    for (uint32_t i = 1; i <= sectorCount; i++) {
+        uint32_t sector = (head + i) % sectorCount; // Oldest sector first, head last
+        JournalSectorHeader header;
+        xSemaphoreTake(journalLock, portMAX_DELAY);
+        bool haveHeader = readSectorHeader(sector, header);
+        uint32_t sectorFirst = (haveHeader && sector != head) ? readFirstSequence(sector) : 0;
+        xSemaphoreGive(journalLock);
+        if (!haveHeader) continue;
+        if (header.sectorSequence > headSequence || headSequence - header.sectorSequence >= sectorCount) continue; // Reused since entry
+        if (sectorFirst != 0 && sectorFirst + RECORDS_PER_SECTOR <= minimumSequence) continue; // Entirely older than requested
+
+        for (uint32_t slot = 0; slot < RECORDS_PER_SECTOR; slot += JOURNAL_READ_CHUNK_RECORDS) {
+            size_t count = min((size_t)(RECORDS_PER_SECTOR - slot), JOURNAL_READ_CHUNK_RECORDS);
+            xSemaphoreTake(journalLock, portMAX_DELAY);
+            bool readOk = esp_partition_read(partition, slotOffset(sector, slot), chunk, count * sizeof(JournalRecord)) == ESP_OK;
+            xSemaphoreGive(journalLock);
+            if (!readOk) break;
+            bool reachedErased = false;
+            for (size_t j = 0; j < count; j++) {
+                if (isRecordErased(chunk[j])) {
+                    reachedErased = true;
+                    break;
+                }
+                if (!isRecordValid(chunk[j]) || chunk[j].sequence < minimumSequence || chunk[j].sequence > lastSequence) continue;
+                visitor(chunk[j], context);
+                visited++;
+            }
+            if (reachedErased) break;
+        }
+    }
+    return visited;
+}
+
+static const char* getJournalRecordTypeName(uint8_t type) {
+    switch (type) {
+        case JOURNAL_BOOT: return "BOOT";
+        case JOURNAL_STATE_CHANGE: return "STATE";
+        case JOURNAL_SNAPSHOT: return "SNAP";
+        case JOURNAL_FAULT: return "FAULT";
+    }
+    return "?";
+}
+
+void formatJournalRecord(const JournalRecord& record, char* buffer, size_t size) {
+    snprintf(buffer, size,
+             "#%lu boot=%u t=%lu.%03lu %-5s %s->%s in=%02X out=%02X cut=%ld feed=%ld profile=%u strokes=%lu detail=%d",
+             (unsigned long)record.sequence, record.bootCount,
+             (unsigned long)(record.uptimeMs / 1000), (unsigned long)(record.uptimeMs % 1000),
+             getJournalRecordTypeName(record.type),
+             getSystemStateName((SystemState)record.previousState), getSystemStateName((SystemState)record.state),
+             record.inputs, record.outputs, (long)record.cutPositionSteps, (long)record.feedPositionSteps,
+             record.profileIndex, (unsigned long)record.cutStrokes, record.detail);
+}
+
+bool isFaultJournalMounted() {
+    return partition != nullptr;
+}
+
+uint32_t getJournalRecordCount() {
+    if (firstSequence == 0) return 0;
+    return nextSequence - firstSequence;
+}
+
+uint32_t getJournalSectorErases() {
+    return sectorErases;
+}
+
+void printFaultJournalStatus() {
+    if (!partition) {
+        Serial.println("Fault journal: not mounted");
+        return;
+    }
+    Serial.printf("Fault journal: boot %u, %lu records (#%lu-#%lu), head sector %lu/%lu slot %lu, %lu erases since boot, %u pre-fault records buffered\n",
+                  bootCount, (unsigned long)getJournalRecordCount(), (unsigned long)firstSequence,
+                  (unsigned long)(nextSequence - 1), (unsigned long)headSector, (unsigned long)sectorCount,
+                  (unsigned long)writeIndex, (unsigned long)sectorErases, (unsigned)preFaultCount);
+}
@@ -0,0 +1,86 @@
+#include "Network/fleet_discovery.h"
+#include "Config/Config.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/StateManager.h"
+#include "Diagnostics/throughput_counter.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <ESPmDNS.h>
+
+//* ************************************************************************
+//* ************************* FLEET DISCOVERY ******************************
+//* ************************************************************************
+// MDNS itself is started by ArduinoOTA.begin() with getDeviceName() as the
+// hostname; this only adds services to it. TXT records are rewritten when
+// the state or cut count changes, at most once per beacon.
+
+static char deviceName[16] = "";
+static WiFiUDP beaconSocket;
+static bool discoveryStarted = false;
+static unsigned long lastBeaconTime = 0;
+static SystemState advertisedState = ERROR_RESET;
+static uint32_t advertisedCuts = UINT32_MAX;
+
+const char* getDeviceName() {
+  if (deviceName[0] == '\0') {
+    uint64_t mac = ESP.getEfuseMac(); // Byte 0 of the MAC in the low byte
+    snprintf(deviceName, sizeof(deviceName), "stage1-%02x%02x%02x",
+             (unsigned)((mac >> 24) & 0xFF), (unsigned)((mac >> 32) & 0xFF), (unsigned)((mac >> 40) & 0xFF));
+  }
+  return deviceName;
+}
+
+static void updateTxtRecords(SystemState state, const ThroughputStats& stats) {
+  char value[16];
+  MDNS.addServiceTxt("stage1", "tcp", "state", getSystemStateName(state));
+  snprintf(value, sizeof(value), "%lu", (unsigned long)stats.totalCuts);
+  MDNS.addServiceTxt("stage1", "tcp", "cuts", value);
+  snprintf(value, sizeof(value), "%lu", (unsigned long)stats.cutsLastHour);
+  MDNS.addServiceTxt("stage1", "tcp", "cph", value);
+  advertisedState = state;
+  advertisedCuts = stats.totalCuts;
+}
+
+static void sendBeacon(SystemState state, const ThroughputStats& stats) {
+  char beacon[320];
+  int length = snprintf(beacon, sizeof(beacon),
+                        "{\"name\":\"%s\",\"ip\":\"%s\",\"fw\":\"%s\",\"state\":\"%s\",\"uptimeMs\":%lu,"
+                        "\"cuts\":%lu,\"cutsLastHour\":%lu,\"cycleMs\":%lu,\"rssi\":%d}",
+                        getDeviceName(), WiFi.localIP().toString().c_str(), FIRMWARE_VERSION,
+                        getSystemStateName(state), millis(), (unsigned long)stats.totalCuts,
+                        (unsigned long)stats.cutsLastHour, (unsigned long)stats.lastCycleMs, (int)WiFi.RSSI());
+  if (length <= 0 || length >= (int)sizeof(beacon)) return;
+
+  IPAddress group(FLEET_BEACON_GROUP[0], FLEET_BEACON_GROUP[1], FLEET_BEACON_GROUP[2], FLEET_BEACON_GROUP[3]);
+  if (beaconSocket.beginPacket(group, FLEET_BEACON_PORT)) {
+    beaconSocket.write((const uint8_t*)beacon, length);
+    beaconSocket.endPacket();
+  }
+}
+
+void beginFleetDiscovery() {
+  MDNS.addService("http", "tcp", DIAGNOSTICS_SERVER_PORT);
+  MDNS.addService("stage1", "tcp", DIAGNOSTICS_SERVER_PORT);
+  MDNS.addServiceTxt("stage1", "tcp", "fw", FIRMWARE_VERSION);
+  MDNS.addServiceTxt("stage1", "tcp", "id", getDeviceName());
+  updateTxtRecords(currentState, getThroughputStats());
+  discoveryStarted = true;
+  lastBeaconTime = millis() - FLEET_BEACON_INTERVAL_MS; // First beacon right away
+  Serial.printf("Fleet discovery: %s.local, beacons to %u.%u.%u.%u:%d\n", getDeviceName(),
+                FLEET_BEACON_GROUP[0], FLEET_BEACON_GROUP[1], FLEET_BEACON_GROUP[2], FLEET_BEACON_GROUP[3],
+                FLEET_BEACON_PORT);
+}
+
+void serviceFleetDiscovery() {
+  if (!discoveryStarted) return;
+  unsigned long now = millis();
+  if (now - lastBeaconTime < FLEET_BEACON_INTERVAL_MS) return;
+  lastBeaconTime = now;
+
+  SystemState state = currentState;
+  ThroughputStats stats = getThroughputStats();
+  if (state != advertisedState || stats.totalCuts != advertisedCuts) {
+    updateTxtRecords(state, stats);
+  }
+  sendBeacon(state, stats);
+}
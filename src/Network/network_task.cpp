@@ -0,0 +1,105 @@
+#include "Network/network_task.h"
+#include "Config/Config.h"
+#include "OTAUpdater/ota_updater.h"
+#include "Diagnostics/diagnostics_server.h"
+#include "Network/fleet_discovery.h"
+#include "Diagnostics/loop_profiler.h"
+#include "Diagnostics/boot_timing.h"
+#include "Watchdog/watchdog_supervisor.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <WiFi.h>
+
+//* ************************************************************************
+//* ************************** NETWORK TASK ********************************
+//* ************************************************************************
+// Connect, start OTA and the diagnostics server on the first connection,
+// then poll them. Waiting is done with vTaskDelay so the idle task on this
+// core keeps running.
+
+static const char* ssid = "Everwood";
+static const char* password = "Everwood-Staff";
+
+static TaskHandle_t networkTaskHandle = NULL;
+static volatile bool networkConnected = false;
+static volatile uint32_t reconnectCount = 0;
+
+static bool connectWiFi() {
+  WiFi.begin(ssid, password);
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start >= NETWORK_CONNECT_TIMEOUT_MS) {
+      WiFi.disconnect();
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+  return true;
+}
+
+// Keep trying until connected, doubling the delay after each failure
+static void connectWithBackoff() {
+  unsigned long retryDelay = NETWORK_RECONNECT_MIN_MS;
+  while (!connectWiFi()) {
+    feedHeartbeat(HEARTBEAT_NETWORK);
+    reconnectCount++;
+    Serial.printf("WiFi connection failed, retrying in %lu ms\n", retryDelay);
+    vTaskDelay(pdMS_TO_TICKS(retryDelay));
+    retryDelay = min(retryDelay * 2, NETWORK_RECONNECT_MAX_MS);
+  }
+  networkConnected = true;
+  Serial.print("WiFi connected, IP address: ");
+  Serial.println(WiFi.localIP());
+}
+
+static void networkTask(void* arg) {
+  (void)arg;
+  WiFi.mode(WIFI_STA);
+  WiFi.setHostname(getDeviceName());
+  WiFi.setAutoReconnect(false); // Reconnects go through the backoff above
+
+  connectWithBackoff();
+  markBootPhase(BOOT_PHASE_WIFI_CONNECTED);
+  setupOTA();
+  setupDiagnosticsServer();
+  beginFleetDiscovery();
+  markBootPhase(BOOT_PHASE_NETWORK_READY);
+
+  for (;;) {
+    feedHeartbeat(HEARTBEAT_NETWORK);
+    if (WiFi.status() != WL_CONNECTED) {
+      networkConnected = false;
+      reconnectCount++;
+      Serial.println("WiFi connection lost");
+      WiFi.disconnect();
+      connectWithBackoff();
+    }
+    {
+      LoopProfileScope otaProfile(LOOP_SECTION_OTA);
+      handleOTA();
+    }
+    {
+      LoopProfileScope networkProfile(LOOP_SECTION_NETWORK);
+      handleDiagnosticsServer();
+    }
+    serviceFleetDiscovery();
+    vTaskDelay(pdMS_TO_TICKS(NETWORK_SERVICE_INTERVAL_MS));
+  }
+}
+
+void startNetworkTask() {
+  if (networkTaskHandle) return;
+  if (xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK_SIZE, NULL,
+                              NETWORK_TASK_PRIORITY, &networkTaskHandle, NETWORK_TASK_CORE) != pdPASS) {
+    networkTaskHandle = NULL;
+    Serial.println("Failed to start network task - running without WiFi");
+  }
+}
+
+bool isNetworkConnected() {
+  return networkConnected;
+}
+
+uint32_t getNetworkReconnectCount() {
+  return reconnectCount;
+}
@@ -0,0 +1,114 @@
+#include "OTAUpdater/ota_health_check.h"
+#include "Config/Config.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include <Preferences.h>
+
+//* ************************************************************************
+//* ************************* OTA HEALTH CHECK *****************************
+//* ************************************************************************
+// NVS keys: "pending" is the label of the image on probation, "fallback" the
+// image that installed it and "boots" how often the pending image has started.
+
+static const char* OTA_NVS_NAMESPACE = "ota";
+
+static bool checkPending = false;
+static unsigned long checkStartTime = 0;
+static char fallbackLabel[17] = "";
+
+static void clearProbation() {
+  Preferences preferences;
+  if (!preferences.begin(OTA_NVS_NAMESPACE, false)) return;
+  preferences.remove("pending");
+  preferences.remove("fallback");
+  preferences.remove("boots");
+  preferences.end();
+}
+
+static void rollBack(const char* reason) {
+  Serial.printf("OTA health check failed (%s) - rolling back to %s\n", reason, fallbackLabel);
+  stopCutMotor();
+  stopFeedMotor();
+  clearProbation();
+
+  // Let a rollback-enabled bootloader handle it if it put this image on probation
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  esp_ota_img_states_t imageState;
+  if (running && esp_ota_get_state_partition(running, &imageState) == ESP_OK &&
+      imageState == ESP_OTA_IMG_PENDING_VERIFY) {
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+  }
+
+  const esp_partition_t* fallback = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, fallbackLabel);
+  if (!fallback || esp_ota_set_boot_partition(fallback) != ESP_OK) {
+    Serial.println("OTA rollback: fallback image not bootable - keeping this image");
+    checkPending = false;
+    return;
+  }
+  delay(100); // Let the message out
+  esp_restart();
+}
+
+void noteOtaImageInstalled() {
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  const esp_partition_t* installed = esp_ota_get_boot_partition();
+  if (!running || !installed || running == installed) return;
+
+  Preferences preferences;
+  if (!preferences.begin(OTA_NVS_NAMESPACE, false)) return;
+  preferences.putString("pending", installed->label);
+  preferences.putString("fallback", running->label);
+  preferences.putUChar("boots", 0);
+  preferences.end();
+}
+
+void beginOtaHealthCheck() {
+  Preferences preferences;
+  if (!preferences.begin(OTA_NVS_NAMESPACE, false)) return;
+  String pending = preferences.getString("pending", "");
+  if (pending.length() == 0) {
+    preferences.end();
+    return;
+  }
+
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  if (!running || !pending.equals(running->label)) {
+    // The new image never started (or was already rolled back) - nothing on probation
+    preferences.end();
+    Serial.printf("OTA health check: %s is not running - discarding probation\n", pending.c_str());
+    clearProbation();
+    return;
+  }
+
+  uint8_t boots = preferences.getUChar("boots", 0) + 1;
+  preferences.putUChar("boots", boots);
+  preferences.getString("fallback", fallbackLabel, sizeof(fallbackLabel));
+  preferences.end();
+
+  checkPending = true;
+  checkStartTime = millis();
+  Serial.printf("OTA health check: image %s on probation, boot %u of %u, must home within %lu ms\n",
+                running->label, boots, OTA_HEALTH_CHECK_MAX_BOOTS, OTA_HEALTH_CHECK_TIMEOUT_MS);
+  if (boots > OTA_HEALTH_CHECK_MAX_BOOTS) {
+    rollBack("restarted before homing");
+  }
+}
+
+void serviceOtaHealthCheck() {
+  if (!checkPending) return;
+
+  extern bool isHomed;
+  if (currentState == IDLE && isHomed) {
+    checkPending = false;
+    esp_ota_mark_app_valid_cancel_rollback();
+    clearProbation();
+    Serial.println("OTA health check passed - image marked valid");
+  } else if (millis() - checkStartTime >= OTA_HEALTH_CHECK_TIMEOUT_MS) {
+    rollBack("no successful homing in time");
+  }
+}
+
+bool isOtaHealthCheckPending() {
+  return checkPending;
+}
@@ -0,0 +1,291 @@
+#include "OTAUpdater/ota_package.h"
+#include "OTAUpdater/ota_updater.h"
+#include "OTAUpdater/ota_health_check.h"
+#include "Config/Config.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_ota_ops.h"
+#include "mbedtls/sha256.h"
+#if __has_include("rom/miniz.h")
+#include "rom/miniz.h"
+#else
+#include "esp32s3/rom/miniz.h"
+#endif
+
+//* ************************************************************************
+//* *************************** OTA PACKAGE ********************************
+//* ************************************************************************
+// Runs on the network task from the /update upload handler. Bytes flow:
+// package -> header parser -> ROM inflater (32 KB window) -> delta op parser
+// (delta only) -> esp_ota_write() on the inactive slot. The inflater state
+// and window are only allocated while an update is in progress.
+
+static const size_t OTA_PACKAGE_COPY_CHUNK = 1024;
+
+enum PackageStage : uint8_t {
+    PACKAGE_IDLE,
+    PACKAGE_HEADER,
+    PACKAGE_BODY,
+    PACKAGE_DONE,
+    PACKAGE_FAILED
+};
+
+static PackageStage stage = PACKAGE_IDLE;
+static bool packageOpen = false;        // Holds the OTA flag, buffers and hash context
+static const char* failure = nullptr;
+static OtaPackageHeader header;
+static size_t headerBytes = 0;
+
+static tinfl_decompressor* inflator = nullptr;
+static uint8_t* window = nullptr;
+static size_t windowOffset = 0;
+static bool inflateDone = false;
+
+static const esp_partition_t* basePartition = nullptr;
+static const esp_partition_t* targetPartition = nullptr;
+static esp_ota_handle_t otaHandle = 0;
+static bool otaOpen = false;
+static size_t imageWritten = 0;
+static mbedtls_sha256_context imageSha;
+
+// Delta op parser
+static uint8_t opBuffer[9];
+static size_t opBytes = 0;
+static size_t insertRemaining = 0;
+
+static bool fail(const char* reason) {
+    failure = reason;
+    stage = PACKAGE_FAILED;
+    return false;
+}
+
+static void releaseBuffers() {
+    free(inflator);
+    free(window);
+    inflator = nullptr;
+    window = nullptr;
+}
+
+static uint32_t readLittleEndian32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static bool writeImage(const uint8_t* data, size_t length) {
+    if (imageWritten + length > header.imageSize) return fail("image larger than the header says");
+    if (esp_ota_write(otaHandle, data, length) != ESP_OK) return fail("flash write failed");
+    mbedtls_sha256_update(&imageSha, data, length);
+    imageWritten += length;
+    return true;
+}
+
+static bool copyFromBase(uint32_t offset, uint32_t length) {
+    if (offset > header.baseSize || length > header.baseSize - offset) return fail("delta copies past the base image");
+    uint8_t chunk[OTA_PACKAGE_COPY_CHUNK];
+    while (length > 0) {
+        size_t count = min((size_t)length, OTA_PACKAGE_COPY_CHUNK);
+        if (esp_partition_read(basePartition, offset, chunk, count) != ESP_OK) return fail("reading the running image failed");
+        if (!writeImage(chunk, count)) return false;
+        offset += count;
+        length -= count;
+    }
+    return true;
+}
+
+// Decompressed bytes: the image itself, or delta ops
+static bool consumeInflated(const uint8_t* data, size_t length) {
+    if (header.type == OTA_PACKAGE_FULL) return writeImage(data, length);
+
+    while (length > 0) {
+        if (insertRemaining > 0) {
+            size_t count = min(length, insertRemaining);
+            if (!writeImage(data, count)) return false;
+            insertRemaining -= count;
+            data += count;
+            length -= count;
+            continue;
+        }
+
+        opBuffer[opBytes++] = *data++;
+        length--;
+        uint8_t op = opBuffer[0];
+        size_t opSize = op == OTA_DELTA_OP_COPY ? 9 : op == OTA_DELTA_OP_INSERT ? 5 : 0;
+        if (opSize == 0) return fail("unknown delta op");
+        if (opBytes < opSize) continue;
+        opBytes = 0;
+
+        if (op == OTA_DELTA_OP_COPY) {
+            if (!copyFromBase(readLittleEndian32(opBuffer + 1), readLittleEndian32(opBuffer + 5))) return false;
+        } else {
+            insertRemaining = readLittleEndian32(opBuffer + 1);
+        }
+    }
+    return true;
+}
+
+static bool inflate(const uint8_t* data, size_t length) {
+    while (!inflateDone) {
+        size_t inBytes = length;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - windowOffset;
+        tinfl_status status = tinfl_decompress(inflator, data, &inBytes, window, window + windowOffset, &outBytes,
+                                               TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+        data += inBytes;
+        length -= inBytes;
+        if (outBytes > 0 && !consumeInflated(window + windowOffset, outBytes)) return false;
+        windowOffset = (windowOffset + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+        if (status < TINFL_STATUS_DONE) return fail("corrupt compressed data");
+        if (status == TINFL_STATUS_DONE) inflateDone = true;
+        else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && length == 0) break;
+    }
+    if (length > 0) return fail("data after the end of the compressed stream");
+    return true;
+}
+
+static bool sha256OfBase(uint32_t size, uint8_t digest[32]) {
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    uint8_t chunk[OTA_PACKAGE_COPY_CHUNK];
+    bool ok = true;
+    for (uint32_t offset = 0; offset < size && ok; offset += OTA_PACKAGE_COPY_CHUNK) {
+        size_t count = min((size_t)(size - offset), OTA_PACKAGE_COPY_CHUNK);
+        ok = esp_partition_read(basePartition, offset, chunk, count) == ESP_OK;
+        if (ok) mbedtls_sha256_update(&sha, chunk, count);
+    }
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    return ok;
+}
+
+// Header complete: check it and open the target slot
+static bool startBody() {
+    if (memcmp(header.magic, "SPKG", 4) != 0) return fail("not an update package");
+    if (header.version != OTA_PACKAGE_FORMAT_VERSION || header.headerSize != sizeof(OtaPackageHeader)) {
+        return fail("unsupported package version");
+    }
+    if (header.compression != 1) return fail("unsupported compression");
+    if (header.type != OTA_PACKAGE_FULL && header.type != OTA_PACKAGE_DELTA) return fail("unknown package type");
+
+    basePartition = esp_ota_get_running_partition();
+    targetPartition = esp_ota_get_next_update_partition(NULL);
+    if (!basePartition || !targetPartition) return fail("no OTA slot available");
+    if (header.imageSize == 0 || header.imageSize > targetPartition->size) return fail("image does not fit the OTA slot");
+
+    if (header.type == OTA_PACKAGE_DELTA) {
+        if (header.baseSize > basePartition->size) return fail("delta base larger than the running slot");
+        uint8_t digest[32];
+        if (!sha256OfBase(header.baseSize, digest)) return fail("reading the running image failed");
+        if (memcmp(digest, header.baseSha256, sizeof(digest)) != 0) return fail("delta was built against a different firmware");
+    }
+
+    inflator = (tinfl_decompressor*)malloc(sizeof(tinfl_decompressor));
+    window = (uint8_t*)malloc(TINFL_LZ_DICT_SIZE);
+    if (!inflator || !window) return fail("not enough memory to decompress");
+    tinfl_init(inflator);
+
+    if (esp_ota_begin(targetPartition, header.imageSize, &otaHandle) != ESP_OK) return fail("could not start writing the OTA slot");
+    otaOpen = true;
+    mbedtls_sha256_starts(&imageSha, 0);
+    Serial.printf("OTA package: %s, %lu byte image into %s\n",
+                  header.type == OTA_PACKAGE_DELTA ? "delta" : "full",
+                  (unsigned long)header.imageSize, targetPartition->label);
+    stage = PACKAGE_BODY;
+    return true;
+}
+
+// A failed package gives the OTA flag back; an installed one keeps it until
+// the diagnostics server restarts the machine
+static void closePackage(bool installed) {
+    if (!packageOpen) return;
+    packageOpen = false;
+    if (otaOpen) esp_ota_abort(otaHandle);
+    otaOpen = false;
+    mbedtls_sha256_free(&imageSha);
+    releaseBuffers();
+    if (!installed) releaseOtaUpdate();
+}
+
+bool beginOtaPackage(const char** reason) {
+    if (stage == PACKAGE_HEADER || stage == PACKAGE_BODY) abortOtaPackage();
+    if (!tryClaimOtaUpdate()) {
+        stage = PACKAGE_FAILED;
+        failure = "machine busy - updates are only accepted in IDLE or an error hold";
+        if (reason) *reason = failure;
+        return false;
+    }
+
+    packageOpen = true;
+    stage = PACKAGE_HEADER;
+    failure = nullptr;
+    headerBytes = 0;
+    windowOffset = 0;
+    inflateDone = false;
+    imageWritten = 0;
+    opBytes = 0;
+    insertRemaining = 0;
+    otaOpen = false;
+    mbedtls_sha256_init(&imageSha);
+    return true;
+}
+
+bool writeOtaPackage(const uint8_t* data, size_t length, const char** reason) {
+    if (stage == PACKAGE_HEADER) {
+        size_t count = min(length, sizeof(OtaPackageHeader) - headerBytes);
+        memcpy((uint8_t*)&header + headerBytes, data, count);
+        headerBytes += count;
+        data += count;
+        length -= count;
+        if (headerBytes == sizeof(OtaPackageHeader)) startBody();
+    }
+    if (stage == PACKAGE_BODY && length > 0) {
+        inflate(data, length);
+        vTaskDelay(pdMS_TO_TICKS(OTA_WRITE_YIELD_MS)); // Leave the core to lower priority work between chunks
+    }
+
+    if (stage == PACKAGE_FAILED) {
+        closePackage(false);
+        if (reason) *reason = failure;
+        return false;
+    }
+    return true;
+}
+
+bool endOtaPackage(const char** reason) {
+    if (stage == PACKAGE_BODY) {
+        uint8_t digest[32];
+        mbedtls_sha256_finish(&imageSha, digest);
+        if (!inflateDone) fail("package truncated");
+        else if (imageWritten != header.imageSize || insertRemaining > 0 || opBytes > 0) fail("image shorter than the header says");
+        else if (memcmp(digest, header.imageSha256, sizeof(digest)) != 0) fail("image checksum mismatch");
+        else {
+            otaOpen = false; // esp_ota_end() releases the handle either way
+            if (esp_ota_end(otaHandle) != ESP_OK) fail("image failed validation");
+            else if (esp_ota_set_boot_partition(targetPartition) != ESP_OK) fail("could not select the new image");
+            else stage = PACKAGE_DONE;
+        }
+    } else if (stage == PACKAGE_HEADER) {
+        fail("package truncated");
+    }
+
+    if (stage != PACKAGE_DONE) {
+        if (!failure) failure = "no package received";
+        closePackage(false);
+        stage = PACKAGE_FAILED;
+        if (reason) *reason = failure;
+        return false;
+    }
+
+    noteOtaImageInstalled(); // New image boots on probation
+    closePackage(true);
+    Serial.printf("OTA package: %lu bytes written to %s\n", (unsigned long)imageWritten, targetPartition->label);
+    return true;
+}
+
+void abortOtaPackage() {
+    if (stage == PACKAGE_HEADER || stage == PACKAGE_BODY) {
+        Serial.println("OTA package: upload aborted");
+        closePackage(false);
+    }
+    stage = PACKAGE_IDLE;
+}
@@ -1,35 +1,59 @@
 #include "OTAUpdater/ota_updater.h"
+#include "OTAUpdater/ota_health_check.h"
+#include "Network/fleet_discovery.h"
+#include "Config/Config.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Watchdog/watchdog_supervisor.h"
+#include "Events/event_queue.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <WiFi.h>
 #include <ESPmDNS.h>
 #include <WiFiUdp.h>
 #include <ArduinoOTA.h>
+#include <Update.h>
 
 //* ************************************************************************
 //* *********************** OTA UPDATER IMPLEMENTATION *********************
 //* ************************************************************************
-// Handles WiFi connection and Over-The-Air updates for the ESP32.
+// Handles Over-The-Air updates for the ESP32. WiFi is brought up by the
+// network task, which calls setupOTA() once connected.
+// Uploads are only accepted while the machine is stopped (IDLE or an error
+// hold): in any other state ArduinoOTA is not polled, so espota gets no
+// answer to its invitation. The whole transfer runs inside one handle() call
+// on the network task, writing to the inactive app slot; IDLE ignores its
+// inputs while otaUpdateInProgress is set so no cycle starts underneath it,
+// and StateManager::changeState() refuses any transition out of the OTA-safe
+// states (ERROR_RESET and HOMING from the error holds included) until it ends.
+// Packages posted to /update (see ota_package.h) use the same gate and flag.
+//
+// The network task claims the flag while the loop task may be changing
+// state, so otaLock covers the claim together with its state check, and
+// changeState() holds off claims from its check until currentState is
+// written. A successful upload never releases the flag: the machine
+// restarts straight after, and nothing may move in between.
 
-const char* ssid = "Everwood";
-const char* password = "Everwood-Staff";
+// From the OTA_PASSWORD environment variable at build time (platformio.ini,
+// .env.example), the same value espota uploads with: never in the repository
+#ifndef OTA_PASSWORD
+#error "OTA_PASSWORD is not defined - set it in the environment, see .env.example"
+#endif
+static_assert(sizeof(OTA_PASSWORD) > 1, "OTA_PASSWORD is empty - set it in the environment, see .env.example");
+static const char* otaPassword = OTA_PASSWORD;
 
-void setupOTA() {
-  Serial.println("Booting for OTA...");
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid, password);
-  while (WiFi.waitForConnectResult() != WL_CONNECTED) {
-    Serial.println("Connection Failed! Rebooting...");
-    delay(5000);
-    ESP.restart();
-  }
+static portMUX_TYPE otaLock = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool otaUpdateInProgress = false;
+static bool stateChangeInFlight = false;   // changeState() is leaving the OTA-safe states
+static bool arduinoOtaClaimed = false;     // This ArduinoOTA transfer holds the flag
 
+void setupOTA() {
   // Port defaults to 3232
   // ArduinoOTA.setPort(3232);
 
-  // Hostname defaults to esp3232-[MAC]
-  ArduinoOTA.setHostname("stage1-esp32s3");
+  // stage1-xxyyzz from the MAC, so several saws can share the network
+  ArduinoOTA.setHostname(getDeviceName());
 
-  // No authentication by default
-  // ArduinoOTA.setPassword("admin");
+  ArduinoOTA.setPassword(otaPassword);
 
   // Password can be set with it's md5 value as well
   // MD5(admin) = 21232f297a57a5a743894a0e4a801fc3
@@ -44,17 +68,31 @@ void setupOTA() {
         type = "filesystem";
       }
       // NOTE: if updating SPIFFS, ensure SPIFFS is mounted via SPIFFS.begin()
+      // handleOTA() checked the state before handle(); it may have changed since
+      arduinoOtaClaimed = tryClaimOtaUpdate();
+      if (!arduinoOtaClaimed) {
+        Serial.println("OTA refused - machine busy");
+        Update.abort(); // The transfer then fails with a receive error
+        return;
+      }
       Serial.println("Start updating " + type);
       // digitalWrite(STATUS_LED_RED, HIGH); // Indicate OTA start
     })
     .onEnd([]() {
+      // The new image is now the boot partition - it boots on probation
+      // The flag stays claimed - ArduinoOTA restarts as soon as this returns
+      if (ArduinoOTA.getCommand() == U_FLASH) noteOtaImageInstalled();
       Serial.println("\nEnd");
       // digitalWrite(STATUS_LED_RED, LOW); // Indicate OTA end
     })
     .onProgress([](unsigned int progress, unsigned int total) {
       Serial.printf("Progress: %u%%\r", (progress / (total / 100)));
+      feedHeartbeat(HEARTBEAT_NETWORK); // The whole upload runs inside one handleOTA() call
+      vTaskDelay(pdMS_TO_TICKS(OTA_WRITE_YIELD_MS)); // Called per chunk - leave the core to lower priority work
     })
     .onError([](ota_error_t error) {
+      if (arduinoOtaClaimed) releaseOtaUpdate();
+      arduinoOtaClaimed = false;
       Serial.printf("Error[%u]: ", error);
       if (error == OTA_AUTH_ERROR) {
         Serial.println("Auth Failed");
@@ -78,6 +116,50 @@ void setupOTA() {
   Serial.println(WiFi.localIP());
 }
 
+const char* getOtaPassword() {
+  return otaPassword;
+}
+
+bool isOtaAllowedInState(SystemState state) {
+  return state == IDLE || state == ERROR || state == SUCTION_ERROR_HOLD;
+}
+
+bool isOtaUpdateInProgress() {
+  return otaUpdateInProgress;
+}
+
+bool tryClaimOtaUpdate() {
+  portENTER_CRITICAL(&otaLock);
+  bool claimed = !otaUpdateInProgress && !stateChangeInFlight && isOtaAllowedInState(currentState);
+  if (claimed) otaUpdateInProgress = true;
+  portEXIT_CRITICAL(&otaLock);
+  return claimed;
+}
+
+void releaseOtaUpdate() {
+  portENTER_CRITICAL(&otaLock);
+  bool ended = otaUpdateInProgress;
+  otaUpdateInProgress = false;
+  portEXIT_CRITICAL(&otaLock);
+  if (ended) postEvent(EVENT_OTA_ENDED, 0); // IDLE ignored its inputs during the upload
+}
+
+bool beginOtaGuardedTransition(SystemState fromState, SystemState toState) {
+  if (!isOtaAllowedInState(fromState) || isOtaAllowedInState(toState)) return true;
+  portENTER_CRITICAL(&otaLock);
+  bool allowed = !otaUpdateInProgress;
+  if (allowed) stateChangeInFlight = true;
+  portEXIT_CRITICAL(&otaLock);
+  return allowed;
+}
+
+void endOtaGuardedTransition() {
+  portENTER_CRITICAL(&otaLock);
+  stateChangeInFlight = false;
+  portEXIT_CRITICAL(&otaLock);
+}
+
 void handleOTA() {
+  if (!isOtaAllowedInState(currentState)) return;
   ArduinoOTA.handle();
 } 
\ No newline at end of file
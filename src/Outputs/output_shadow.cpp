@@ -0,0 +1,122 @@
+#include "Outputs/output_shadow.h"
+#include "freertos/FreeRTOS.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+
+//* ************************************************************************
+//* ********************** OUTPUT SHADOW REGISTER **************************
+//* ************************************************************************
+// Desired/actual pin masks cover GPIO 0-63. GPIO 0-31 use the OUT registers
+// and GPIO 32+ use the OUT1 registers. The LED pattern timer and the control
+// loop both flush, so the masks are protected by a spinlock; the timer only
+// flushes the LED pins.
+
+static portMUX_TYPE outputShadowLock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint64_t managedMask = 0;
+static uint64_t desiredMask = 0;
+static uint64_t actualMask = 0;
+
+static OutputChangeLogEntry changeLog[OUTPUT_CHANGE_LOG_SIZE];
+static size_t changeLogHead = 0;     // Next write index
+static uint32_t changeCount = 0;     // Total changes since boot
+
+static inline uint64_t pinBit(int pin) {
+    return (uint64_t)1 << pin;
+}
+
+void registerShadowOutput(int pin, int initialLevel) {
+    if (pin < 0 || pin > 63) return;
+    uint64_t bit = pinBit(pin);
+    portENTER_CRITICAL(&outputShadowLock);
+    managedMask |= bit;
+    if (initialLevel == HIGH) {
+        desiredMask |= bit;
+        actualMask &= ~bit;  // Unknown actual level - force the first write
+    } else {
+        desiredMask &= ~bit;
+        actualMask |= bit;
+    }
+    portEXIT_CRITICAL(&outputShadowLock);
+}
+
+void setOutput(int pin, int level) {
+    if (pin < 0 || pin > 63) return;
+    uint64_t bit = pinBit(pin);
+    portENTER_CRITICAL(&outputShadowLock);
+    if (level == HIGH) {
+        desiredMask |= bit;
+    } else {
+        desiredMask &= ~bit;
+    }
+    portEXIT_CRITICAL(&outputShadowLock);
+}
+
+int getOutput(int pin) {
+    if (pin < 0 || pin > 63) return LOW;
+    return (desiredMask & pinBit(pin)) ? HIGH : LOW;
+}
+
+uint64_t getOutputMask(int pin) {
+    if (pin < 0 || pin > 63) return 0;
+    return pinBit(pin);
+}
+
+void flushOutputs(uint64_t mask) {
+    portENTER_CRITICAL(&outputShadowLock);
+    uint64_t changed = (desiredMask ^ actualMask) & managedMask & mask;
+    if (changed == 0) {
+        portEXIT_CRITICAL(&outputShadowLock);
+        return;
+    }
+
+    uint64_t setBits = changed & desiredMask;
+    uint64_t clearBits = changed & ~desiredMask;
+    if ((uint32_t)setBits) REG_WRITE(GPIO_OUT_W1TS_REG, (uint32_t)setBits);
+    if ((uint32_t)clearBits) REG_WRITE(GPIO_OUT_W1TC_REG, (uint32_t)clearBits);
+    if (setBits >> 32) REG_WRITE(GPIO_OUT1_W1TS_REG, (uint32_t)(setBits >> 32));
+    if (clearBits >> 32) REG_WRITE(GPIO_OUT1_W1TC_REG, (uint32_t)(clearBits >> 32));
+    actualMask = (actualMask & ~changed) | (desiredMask & changed);
+
+    // Record each changed pin in the change log
+    uint32_t now = micros();
+    while (changed) {
+        int pin = __builtin_ctzll(changed);
+        changed &= changed - 1;
+        OutputChangeLogEntry& entry = changeLog[changeLogHead];
+        entry.timestampUs = now;
+        entry.pin = pin;
+        entry.level = (setBits & pinBit(pin)) ? HIGH : LOW;
+        changeLogHead = (changeLogHead + 1) % OUTPUT_CHANGE_LOG_SIZE;
+        changeCount++;
+    }
+    portEXIT_CRITICAL(&outputShadowLock);
+}
+
+uint32_t getOutputChangeCount() {
+    return changeCount;
+}
+
+size_t copyOutputChangeLog(OutputChangeLogEntry* destination, size_t maxEntries) {
+    portENTER_CRITICAL(&outputShadowLock);
+    size_t available = changeCount < OUTPUT_CHANGE_LOG_SIZE ? changeCount : OUTPUT_CHANGE_LOG_SIZE;
+    size_t count = available < maxEntries ? available : maxEntries;
+    size_t start = (changeLogHead + OUTPUT_CHANGE_LOG_SIZE - count) % OUTPUT_CHANGE_LOG_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        destination[i] = changeLog[(start + i) % OUTPUT_CHANGE_LOG_SIZE];
+    }
+    portEXIT_CRITICAL(&outputShadowLock);
+    return count;
+}
+
+void printOutputChangeLog() {
+    OutputChangeLogEntry entries[OUTPUT_CHANGE_LOG_SIZE];
+    size_t count = copyOutputChangeLog(entries, OUTPUT_CHANGE_LOG_SIZE);
+    Serial.print("Output change log (");
+    Serial.print(changeCount);
+    Serial.println(" changes since boot):");
+    for (size_t i = 0; i < count; i++) {
+        Serial.printf("  %10lu us  GPIO %2u -> %s\n", (unsigned long)entries[i].timestampUs,
+                      entries[i].pin, entries[i].level == HIGH ? "HIGH" : "LOW");
+    }
+}
@@ -0,0 +1,214 @@
+#include "Profiles/job_profiles.h"
+#include "Config/Config.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "freertos/FreeRTOS.h"
+#include <Preferences.h>
+
+//* ************************************************************************
+//* ************************** JOB PROFILES ********************************
+//* ************************************************************************
+// Each slot is stored as one NVS blob ("p<index>") next to the active index
+// ("active"). A blob from before adaptiveCut was added loads with adaptive
+// mode off; any other size or out-of-range values fall back to the built-in
+// default. Requests may come from the network
+// handler, so the staged selection is handed over under a spinlock.
+
+static const char* JOB_PROFILE_NVS_NAMESPACE = "jobprof";
+static const uint8_t NO_PENDING_PROFILE = 0xFF;
+
+static portMUX_TYPE jobProfileLock = portMUX_INITIALIZER_UNLOCKED;
+
+static JobProfile profiles[JOB_PROFILE_COUNT];
+static JobProfile activeProfile;
+static uint8_t activeIndex = 0;
+static volatile uint8_t pendingIndex = NO_PENDING_PROFILE;
+
+static void makeProfileKey(char* key, size_t size, uint8_t index) {
+    snprintf(key, size, "p%u", index);
+}
+
+static void makeDefaultProfile(JobProfile& profile, uint8_t index) {
+    memset(&profile, 0, sizeof(profile));
+    if (index == 0) {
+        strncpy(profile.name, "2x4 standard", JOB_PROFILE_NAME_LENGTH - 1);
+    } else {
+        snprintf(profile.name, JOB_PROFILE_NAME_LENGTH, "profile %u", index);
+    }
+    profile.cutSpeed = CUT_MOTOR_NORMAL_SPEED;
+    profile.cutTravelInches = CUT_TRAVEL_DISTANCE;
+    profile.feedTravelInches = FEED_TRAVEL_DISTANCE;
+    profile.rotationClampEarlyOffsetInches = ROTATION_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES;
+    profile.rotationServoEarlyOffsetInches = ROTATION_SERVO_EARLY_ACTIVATION_OFFSET_INCHES;
+    profile.rotationClampExtendMs = ROTATION_CLAMP_EXTEND_DURATION_MS;
+    profile.rotationServoReleaseDwellMs = ROTATION_SERVO_RELEASE_DWELL_MS;
+    profile.firstCutPushInches[0] = -1.0f;
+    profile.firstCutPushInches[1] = -2.0f;
+    profile.firstCutParkOffsetInches = 2.75f;
+    profile.noWoodRegripInches = 2.0f;
+    profile.adaptiveCut = ADAPTIVE_CUT_MODE_ENABLED;
+}
+
+// Stored size of the layout without adaptiveCut
+static const size_t JOB_PROFILE_V1_SIZE = offsetof(JobProfile, adaptiveCut);
+
+static bool validateProfile(const JobProfile& profile, const char** reason) {
+    const char* problem = nullptr;
+    if (profile.name[0] == '\0' || memchr(profile.name, '\0', JOB_PROFILE_NAME_LENGTH) == nullptr) {
+        problem = "name must be 1-15 characters";
+    } else if (!(profile.cutSpeed >= JOB_PROFILE_MIN_CUT_SPEED && profile.cutSpeed <= ADAPTIVE_CUT_MAX_SPEED)) {
+        problem = "cut speed out of range";
+    } else if (!(profile.cutTravelInches > 0.0f && profile.cutTravelInches <= JOB_PROFILE_MAX_CUT_TRAVEL_INCHES)) {
+        problem = "cut travel out of range";
+    } else if (!(profile.feedTravelInches > 0.0f && profile.feedTravelInches <= FEED_TRAVEL_DISTANCE)) {
+        problem = "feed travel longer than FEED_TRAVEL_DISTANCE";
+    } else if (!(profile.rotationClampEarlyOffsetInches >= 0.0f && profile.rotationClampEarlyOffsetInches < profile.cutTravelInches) ||
+               !(profile.rotationServoEarlyOffsetInches >= 0.0f && profile.rotationServoEarlyOffsetInches < profile.cutTravelInches)) {
+        problem = "early activation offset out of range";
+    } else if (profile.rotationClampExtendMs > JOB_PROFILE_MAX_HOLD_MS || profile.rotationServoReleaseDwellMs > JOB_PROFILE_MAX_HOLD_MS) {
+        problem = "hold time out of range";
+    } else if (!(profile.firstCutPushInches[0] >= -JOB_PROFILE_MAX_FEED_OVERTRAVEL_INCHES && profile.firstCutPushInches[0] < profile.feedTravelInches) ||
+               !(profile.firstCutPushInches[1] >= -JOB_PROFILE_MAX_FEED_OVERTRAVEL_INCHES && profile.firstCutPushInches[1] < profile.feedTravelInches) ||
+               !(profile.firstCutParkOffsetInches >= 0.0f && profile.firstCutParkOffsetInches <= profile.feedTravelInches + JOB_PROFILE_MAX_FEED_OVERTRAVEL_INCHES) ||
+               !(profile.noWoodRegripInches >= 0.0f && profile.noWoodRegripInches <= profile.feedTravelInches)) {
+        problem = "feed stroke plan out of range";
+    }
+    if (reason) *reason = problem;
+    return problem == nullptr;
+}
+
+void beginJobProfiles() {
+    Preferences preferences;
+    bool opened = preferences.begin(JOB_PROFILE_NVS_NAMESPACE, true);
+
+    for (uint8_t i = 0; i < JOB_PROFILE_COUNT; i++) {
+        makeDefaultProfile(profiles[i], i);
+        if (!opened) continue;
+
+        char key[8];
+        makeProfileKey(key, sizeof(key), i);
+        JobProfile stored;
+        makeDefaultProfile(stored, i);
+        stored.adaptiveCut = false;
+        size_t storedSize = preferences.getBytesLength(key);
+        if ((storedSize == sizeof(stored) || storedSize == JOB_PROFILE_V1_SIZE) &&
+            preferences.getBytes(key, &stored, storedSize) == storedSize) {
+            const char* reason = nullptr;
+            if (validateProfile(stored, &reason)) {
+                profiles[i] = stored;
+            } else {
+                Serial.printf("Job profiles: slot %u ignored (%s) - using defaults.\n", i, reason);
+            }
+        }
+    }
+
+    activeIndex = opened ? preferences.getUChar("active", 0) : 0;
+    if (opened) preferences.end();
+    if (activeIndex >= JOB_PROFILE_COUNT) activeIndex = 0;
+
+    activeProfile = profiles[activeIndex];
+    pendingIndex = NO_PENDING_PROFILE;
+    Serial.printf("Job profiles: active profile %u \"%s\"\n", activeIndex, activeProfile.name);
+}
+
+const JobProfile& getActiveJobProfile() {
+    return activeProfile;
+}
+
+uint8_t getActiveJobProfileIndex() {
+    return activeIndex;
+}
+
+const JobProfile* getJobProfile(uint8_t index) {
+    if (index >= JOB_PROFILE_COUNT) return nullptr;
+    return &profiles[index];
+}
+
+bool requestJobProfile(uint8_t index) {
+    if (index >= JOB_PROFILE_COUNT) return false;
+    portENTER_CRITICAL(&jobProfileLock);
+    pendingIndex = index;
+    portEXIT_CRITICAL(&jobProfileLock);
+    Serial.printf("Job profiles: profile %u \"%s\" selected - applies at the next cycle boundary.\n",
+                  index, profiles[index].name);
+    return true;
+}
+
+void requestNextJobProfile() {
+    uint8_t pending = pendingIndex;
+    uint8_t base = pending != NO_PENDING_PROFILE ? pending : activeIndex;
+    requestJobProfile((base + 1) % JOB_PROFILE_COUNT);
+}
+
+bool isJobProfileChangePending() {
+    return pendingIndex != NO_PENDING_PROFILE;
+}
+
+bool saveJobProfile(uint8_t index, const JobProfile& profile, const char** reason) {
+    if (index >= JOB_PROFILE_COUNT) {
+        if (reason) *reason = "invalid profile index";
+        return false;
+    }
+    if (!validateProfile(profile, reason)) return false;
+
+    Preferences preferences;
+    if (!preferences.begin(JOB_PROFILE_NVS_NAMESPACE, false)) {
+        if (reason) *reason = "failed to open NVS";
+        return false;
+    }
+    char key[8];
+    makeProfileKey(key, sizeof(key), index);
+    size_t written = preferences.putBytes(key, &profile, sizeof(profile));
+    preferences.end();
+    if (written != sizeof(profile)) {
+        if (reason) *reason = "NVS write failed";
+        return false;
+    }
+
+    portENTER_CRITICAL(&jobProfileLock);
+    profiles[index] = profile;
+    if (index == activeIndex && pendingIndex == NO_PENDING_PROFILE) {
+        pendingIndex = index; // Reload the edited active profile between cycles
+    }
+    portEXIT_CRITICAL(&jobProfileLock);
+    Serial.printf("Job profiles: slot %u \"%s\" saved.\n", index, profile.name);
+    return true;
+}
+
+bool applyPendingJobProfile() {
+    if (pendingIndex == NO_PENDING_PROFILE) return false;
+
+    portENTER_CRITICAL(&jobProfileLock);
+    uint8_t index = pendingIndex;
+    pendingIndex = NO_PENDING_PROFILE;
+    activeProfile = profiles[index];
+    portEXIT_CRITICAL(&jobProfileLock);
+
+    bool indexChanged = index != activeIndex;
+    activeIndex = index;
+    if (indexChanged) {
+        Preferences preferences;
+        if (preferences.begin(JOB_PROFILE_NVS_NAMESPACE, false)) {
+            preferences.putUChar("active", activeIndex);
+            preferences.end();
+        }
+    }
+
+    // The learned cut rate is kept per profile and floors at the profile cut speed
+    beginAdaptiveCut(activeIndex);
+    Serial.printf("Job profiles: now running profile %u \"%s\"\n", activeIndex, activeProfile.name);
+    return true;
+}
+
+void printJobProfile(uint8_t index) {
+    const JobProfile* profile = getJobProfile(index);
+    if (!profile) return;
+    Serial.printf("Profile %u \"%s\"%s\n", index, profile->name, index == activeIndex ? " (active)" : "");
+    Serial.printf("  Cut: %.0f steps/sec%s, travel %.2f in, clamp early %.2f in, servo early %.2f in\n",
+                  profile->cutSpeed, profile->adaptiveCut ? " (adaptive)" : "", profile->cutTravelInches,
+                  profile->rotationClampEarlyOffsetInches, profile->rotationServoEarlyOffsetInches);
+    Serial.printf("  Holds: clamp %lu ms, servo dwell %lu ms\n",
+                  (unsigned long)profile->rotationClampExtendMs, (unsigned long)profile->rotationServoReleaseDwellMs);
+    Serial.printf("  Feed: travel %.2f in, first cut pushes %.2f / %.2f in, park offset %.2f in, no-wood regrip %.2f in\n",
+                  profile->feedTravelInches, profile->firstCutPushInches[0], profile->firstCutPushInches[1],
+                  profile->firstCutParkOffsetInches, profile->noWoodRegripInches);
+}
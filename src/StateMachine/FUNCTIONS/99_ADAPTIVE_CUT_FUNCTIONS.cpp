@@ -0,0 +1,181 @@
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "Profiles/job_profiles.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include <Preferences.h>
+
+//* ************************************************************************
+//* ********************** ADAPTIVE CUT FEED RATE **************************
+//* ************************************************************************
+// Rate rules per stroke:
+//   - lost steps / missed switch / current over limit: multiply by the backoff factor
+//   - drift warning / current near limit: hold and reset the clean streak
+//   - clean: after ADAPTIVE_CUT_CLEAN_STROKES_TO_RAISE clean strokes, raise by one step
+// The rate is clamped to [active profile cut speed, ADAPTIVE_CUT_MAX_SPEED].
+// NVS is only written on a backoff or when the rate has moved a full persist
+// step since the last write, which keeps flash wear to a few writes per day.
+// The write is left pending until both axes have stopped, so the flash cache
+// is never off under a running step queue.
+//
+// Adaptive mode is off unless the active profile opts in (no current sensor is
+// fitted, so the stroke timing proxy is the only feedback).
+
+static const char* ADAPTIVE_CUT_NVS_NAMESPACE = "adaptcut";
+static const float ADAPTIVE_CUT_PERSIST_STEP = 50.0f;       // steps/sec between NVS writes
+static const float ADAPTIVE_CUT_LOAD_HOLD_FRACTION = 0.85f; // Current above this fraction of the limit holds the rate
+
+static bool adaptiveEnabled = false;
+static bool persistPending = false;
+static uint8_t activeProfileIndex = 0;
+static float currentRate = 0.0f;
+static float persistedRate = 0.0f;
+static uint32_t cleanStreak = 0;
+static uint32_t raises = 0;
+static uint32_t backoffs = 0;
+
+// Current sense window for the stroke in progress
+static uint32_t loadPeakMv = 0;
+static uint32_t loadSampleCount = 0;
+
+static float minimumRate() {
+    return getActiveJobProfile().cutSpeed;
+}
+
+static float clampRate(float rate) {
+    return constrain(rate, minimumRate(), max(minimumRate(), ADAPTIVE_CUT_MAX_SPEED));
+}
+
+static void makeRateKey(char* key, size_t size, uint8_t profileIndex) {
+    snprintf(key, size, "rate%u", profileIndex);
+}
+
+static void persistRate() {
+    persistPending = true; // Written by serviceAdaptiveCut() once both axes stop
+}
+
+static void writePendingRate() {
+    persistPending = false;
+    Preferences preferences;
+    if (!preferences.begin(ADAPTIVE_CUT_NVS_NAMESPACE, false)) {
+        Serial.println("Adaptive cut: failed to open NVS - rate not saved.");
+        return;
+    }
+    char key[12];
+    makeRateKey(key, sizeof(key), activeProfileIndex);
+    preferences.putFloat(key, currentRate);
+    preferences.end();
+    persistedRate = currentRate;
+}
+
+void beginAdaptiveCut(uint8_t profileIndex) {
+    if (persistPending) writePendingRate(); // Profile swaps only happen with both axes stopped
+    activeProfileIndex = profileIndex;
+    adaptiveEnabled = getActiveJobProfile().adaptiveCut;
+    currentRate = minimumRate();
+
+    Preferences preferences;
+    if (preferences.begin(ADAPTIVE_CUT_NVS_NAMESPACE, true)) {
+        char key[12];
+        makeRateKey(key, sizeof(key), profileIndex);
+        currentRate = clampRate(preferences.getFloat(key, minimumRate()));
+        preferences.end();
+    }
+    persistedRate = currentRate;
+    cleanStreak = 0;
+    loadPeakMv = 0;
+    loadSampleCount = 0;
+
+    Serial.print("Adaptive cut: profile ");
+    Serial.print(profileIndex);
+    Serial.print(" starting at ");
+    Serial.print(currentRate, 0);
+    Serial.println(adaptiveEnabled ? " steps/sec" : " steps/sec (adaptive mode disabled)");
+}
+
+float getCutMotorCuttingSpeed() {
+    if (!adaptiveEnabled || currentRate <= 0.0f) return minimumRate();
+    return currentRate;
+}
+
+void serviceAdaptiveCut() {
+    if (!persistPending) return;
+    if ((cutMotor && cutMotor->isRunning()) || (feedMotor && feedMotor->isRunning())) return;
+    writePendingRate();
+}
+
+void setAdaptiveCutEnabled(bool enabled) {
+    adaptiveEnabled = enabled;
+    cleanStreak = 0;
+}
+
+bool isAdaptiveCutEnabled() {
+    return adaptiveEnabled;
+}
+
+void sampleAdaptiveCutLoad() {
+    if (CUT_MOTOR_CURRENT_SENSE_PIN < 0) return;
+    uint32_t millivolts = analogReadMilliVolts(CUT_MOTOR_CURRENT_SENSE_PIN);
+    if (millivolts > loadPeakMv) loadPeakMv = millivolts;
+    loadSampleCount++;
+}
+
+void recordAdaptiveCutOutcome(StrokeVerdict verdict) {
+    uint32_t peakMv = loadPeakMv;
+    bool loadSampled = loadSampleCount > 0;
+    loadPeakMv = 0;
+    loadSampleCount = 0;
+    if (!adaptiveEnabled || verdict == STROKE_NOT_MONITORED) return;
+
+    bool overLimit = loadSampled && peakMv >= ADAPTIVE_CUT_LOAD_LIMIT_MV;
+    bool nearLimit = loadSampled && peakMv >= ADAPTIVE_CUT_LOAD_LIMIT_MV * ADAPTIVE_CUT_LOAD_HOLD_FRACTION;
+    float previousRate = currentRate;
+
+    if (verdict == STROKE_LOST_STEPS || verdict == STROKE_NO_SWITCH || overLimit) {
+        currentRate = clampRate(currentRate * ADAPTIVE_CUT_BACKOFF_FACTOR);
+        cleanStreak = 0;
+        backoffs++;
+        Serial.print("Adaptive cut: anomaly (");
+        Serial.print(overLimit ? "current over limit" : getStrokeVerdictName(verdict));
+        Serial.print(") - backing off to ");
+        Serial.print(currentRate, 0);
+        Serial.println(" steps/sec");
+        if (currentRate != persistedRate) persistRate();
+        return;
+    }
+
+    if (verdict == STROKE_DRIFT_WARNING || verdict == STROKE_LEARNING || nearLimit) {
+        // Hold: no raise while the baseline is learning or the load is marginal
+        cleanStreak = 0;
+        return;
+    }
+
+    cleanStreak++;
+    if (cleanStreak >= (uint32_t)ADAPTIVE_CUT_CLEAN_STROKES_TO_RAISE && currentRate < ADAPTIVE_CUT_MAX_SPEED) {
+        currentRate = clampRate(currentRate + ADAPTIVE_CUT_RAISE_STEP);
+        cleanStreak = 0;
+        raises++;
+        Serial.print("Adaptive cut: ");
+        Serial.print(previousRate, 0);
+        Serial.print(" -> ");
+        Serial.print(currentRate, 0);
+        Serial.println(" steps/sec");
+        if (fabsf(currentRate - persistedRate) >= ADAPTIVE_CUT_PERSIST_STEP || currentRate >= ADAPTIVE_CUT_MAX_SPEED) {
+            persistRate();
+        }
+    }
+}
+
+void resetAdaptiveCutRate() {
+    currentRate = minimumRate();
+    cleanStreak = 0;
+    persistRate();
+    Serial.println("Adaptive cut: learned rate reset to minimum.");
+}
+
+void printAdaptiveCutStatus() {
+    Serial.printf("Adaptive cut: %s, profile %u, rate %.0f steps/sec (saved %.0f%s), clean streak %lu, raises %lu, backoffs %lu\n",
+                  adaptiveEnabled ? "enabled" : "disabled", activeProfileIndex, currentRate, persistedRate,
+                  persistPending ? ", write pending" : "",
+                  (unsigned long)cleanStreak, (unsigned long)raises, (unsigned long)backoffs);
+}
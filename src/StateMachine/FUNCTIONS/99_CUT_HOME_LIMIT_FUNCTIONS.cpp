@@ -0,0 +1,149 @@
+#include "StateMachine/99_CUT_HOME_LIMIT_FUNCTIONS.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "InputTrace/input_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+//* ************************************************************************
+//* ************************** CUT HOME LIMIT ******************************
+//* ************************************************************************
+// The interrupt runs on the loop core. Whichever of the interrupt and the
+// loop-rate fallback claims a stop first owns it until the motor has stopped.
+
+extern volatile bool cutMotorInReturningYes2x4Return; // From main.cpp
+
+enum LimitStopOwner : uint8_t {
+    LIMIT_STOP_NONE,
+    LIMIT_STOP_INTERRUPT,
+    LIMIT_STOP_LOOP
+};
+
+static portMUX_TYPE limitLock = portMUX_INITIALIZER_UNLOCKED;
+static volatile LimitStopOwner stopOwner = LIMIT_STOP_NONE;
+static volatile int32_t edgePosition = 0;
+
+// Latest rising edge in any state, for the stroke monitor
+static volatile int32_t latestEdgePosition = 0;
+static volatile int64_t latestEdgeTimeUs = 0;
+static volatile bool latestEdgePending = false;
+
+static uint32_t histogram[CUT_HOME_LIMIT_BUCKETS];
+static uint32_t interruptStops = 0;
+static uint32_t loopStops = 0;
+static uint32_t lastOvershoot = 0;
+static uint32_t maxOvershoot = 0;
+
+static void IRAM_ATTR cutHomeEdgeIsr(void* arg) {
+    (void)arg;
+    uint8_t level = digitalRead(CUT_MOTOR_HOME_SWITCH);
+    traceInputEdgeFromIsr(INPUT_TRACE_CUT_HOME, level);
+    if (level != HIGH || !cutMotor) return;
+
+    int64_t nowUs = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&limitLock);
+    int32_t position = cutMotor->getCurrentPosition();
+    latestEdgePosition = position;
+    latestEdgeTimeUs = nowUs;
+    latestEdgePending = true;
+    if (cutMotorInReturningYes2x4Return && stopOwner == LIMIT_STOP_NONE && cutMotor->isRunning()) {
+        edgePosition = position;
+        cutMotor->forceStop(); // No new steps; the queued ones still go out
+        stopOwner = LIMIT_STOP_INTERRUPT;
+    }
+    portEXIT_CRITICAL_ISR(&limitLock);
+}
+
+static uint8_t bucketForSteps(uint32_t steps) {
+    uint8_t bucket = 0;
+    while (steps > 0 && bucket < CUT_HOME_LIMIT_BUCKETS - 1) {
+        steps >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void beginCutHomeLimit() {
+    attachInterruptArg(CUT_MOTOR_HOME_SWITCH, cutHomeEdgeIsr, NULL, CHANGE);
+}
+
+void beginCutReturnHomeLimit() {
+    // Before the return move is queued, so its first steps use the short planning time
+    if (cutMotor) cutMotor->setForwardPlanningTimeInMs((uint8_t)CUT_MOTOR_FORWARD_PLANNING_MS);
+    cutMotorInReturningYes2x4Return = true;
+}
+
+void endCutReturnHomeLimit() {
+    cutMotorInReturningYes2x4Return = false;
+    if (cutMotor) cutMotor->setForwardPlanningTimeInMs((uint8_t)CUT_MOTOR_DEFAULT_FORWARD_PLANNING_MS);
+}
+
+void serviceCutHomeLimit(bool switchHigh) {
+    if (!cutMotor) return;
+
+    if (stopOwner == LIMIT_STOP_INTERRUPT) {
+        if (cutMotor->isRunning()) return; // Queue still draining
+        // The return counts down toward home
+        int32_t overshoot = edgePosition - cutMotor->getCurrentPosition();
+        lastOvershoot = overshoot > 0 ? (uint32_t)overshoot : 0;
+        if (lastOvershoot > maxOvershoot) maxOvershoot = lastOvershoot;
+        histogram[bucketForSteps(lastOvershoot)]++;
+        interruptStops++;
+        serviceStepPulseCheck(); // Close the stroke on the old reference first
+        cutMotor->setCurrentPosition(0);
+        stopOwner = LIMIT_STOP_NONE;
+        Serial.printf("Cut motor stopped on the home switch %lu steps past the edge.\n", (unsigned long)lastOvershoot);
+        return;
+    }
+
+    if (stopOwner == LIMIT_STOP_LOOP) {
+        if (!cutMotor->isRunning()) stopOwner = LIMIT_STOP_NONE;
+        return;
+    }
+
+    // Fallback: switch already made when the return started, so no rising edge
+    if (cutMotorInReturningYes2x4Return && switchHigh && cutMotor->isRunning()) {
+        portENTER_CRITICAL(&limitLock);
+        bool claimed = stopOwner == LIMIT_STOP_NONE;
+        if (claimed) stopOwner = LIMIT_STOP_LOOP;
+        portEXIT_CRITICAL(&limitLock);
+        if (!claimed) return;
+        Serial.println("Cut motor hit homing sensor during RETURNING_YES_2x4 return - stopping immediately!");
+        cutMotor->forceStopAndNewPosition(0);  // Stop immediately and set position to 0
+        rebaseStepPulseCheck(cutMotor);
+        loopStops++;
+    }
+}
+
+bool takeCutHomeEdge(int32_t& position, int64_t& timeUs) {
+    portENTER_CRITICAL(&limitLock);
+    bool pending = latestEdgePending;
+    position = latestEdgePosition;
+    timeUs = latestEdgeTimeUs;
+    latestEdgePending = false;
+    portEXIT_CRITICAL(&limitLock);
+    return pending;
+}
+
+void formatCutHomeLimitReport(String& out) {
+    char line[128];
+    uint32_t bound = (uint32_t)(CUT_MOTOR_RETURN_SPEED * CUT_MOTOR_FORWARD_PLANNING_MS / 1000.0f);
+    snprintf(line, sizeof(line), "# cut home limit: %lu interrupt stops, %lu loop-rate stops\n",
+             (unsigned long)interruptStops, (unsigned long)loopStops);
+    out += line;
+    snprintf(line, sizeof(line), "bound=%lu steps (%.0f steps/sec, %lu ms forward planning)\n",
+             (unsigned long)bound, CUT_MOTOR_RETURN_SPEED, CUT_MOTOR_FORWARD_PLANNING_MS);
+    out += line;
+    snprintf(line, sizeof(line), "lastOvershoot=%lu steps\nmaxOvershoot=%lu steps\n",
+             (unsigned long)lastOvershoot, (unsigned long)maxOvershoot);
+    out += line;
+    out += "hist";
+    for (uint8_t b = 0; b < CUT_HOME_LIMIT_BUCKETS; b++) {
+        if (histogram[b] == 0) continue;
+        snprintf(line, sizeof(line), " <%lu:%lu", 1UL << b, (unsigned long)histogram[b]);
+        out += line;
+    }
+    out += "\n";
+}
@@ -0,0 +1,154 @@
+#include "StateMachine/99_CUT_HOME_RECOVERY_FUNCTIONS.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ********************* CUT MOTOR HOME RECOVERY **************************
+//* ************************************************************************
+// Replaces the blocking 3 x delay(30) switch reads and the 0.1 inch
+// incremental moves. The debounced switch is updated once per tick by the
+// StateManager, so every phase only reads it. Moves stop with stopMove() so
+// the recovery acceleration also ramps the motor down onto the switch.
+
+void CutHomeRecovery::begin(const char* contextName, FlightRecorderTrigger triggerReason) {
+    context = contextName;
+    trigger = triggerReason;
+    failureReason = nullptr;
+    recovered = false;
+    verifyAttempt = 0;
+    recoveryStartTime = 0;
+    enterPhase(PHASE_VERIFYING);
+    Serial.print(context);
+    Serial.println(": Checking cut motor position switch.");
+}
+
+void CutHomeRecovery::cancel() {
+    if (phase == PHASE_IDLE) return;
+    if (cutMotor && cutMotor->isRunning()) {
+        cutMotor->forceStopAndNewPosition(cutMotor->getCurrentPosition());
+    }
+    configureCutMotorForCutting();
+    phase = PHASE_IDLE;
+}
+
+void CutHomeRecovery::enterPhase(Phase next) {
+    phase = next;
+    phaseStartTime = millis();
+}
+
+void CutHomeRecovery::startMove(float speed, long steps) {
+    cutMotor->setSpeedInHz((uint32_t)speed);
+    cutMotor->setAcceleration((uint32_t)CUT_HOME_RECOVERY_ACCELERATION);
+    cutMotor->move(steps);
+}
+
+CutHomeRecoveryStatus CutHomeRecovery::finishHomed() {
+    cutMotor->setCurrentPosition(0);
+    rebaseStepPulseCheck(cutMotor);
+    configureCutMotorForCutting();
+    phase = PHASE_IDLE;
+    Serial.print(context);
+    if (recovered) {
+        Serial.print(": Cut motor home recovered in ");
+        Serial.print(millis() - recoveryStartTime);
+        Serial.println(" ms. Position recalibrated to 0.");
+    } else {
+        Serial.println(": Cut motor position switch detected HIGH. Position recalibrated to 0.");
+    }
+    return CUT_HOME_HOMED;
+}
+
+CutHomeRecoveryStatus CutHomeRecovery::fail(const char* reason) {
+    if (cutMotor && cutMotor->isRunning()) {
+        cutMotor->forceStopAndNewPosition(cutMotor->getCurrentPosition());
+    }
+    configureCutMotorForCutting();
+    phase = PHASE_IDLE;
+    failureReason = reason;
+    Serial.print(context);
+    Serial.print(": Cut motor home recovery failed - ");
+    Serial.println(reason);
+    return CUT_HOME_FAILED;
+}
+
+CutHomeRecoveryStatus CutHomeRecovery::update() {
+    if (phase == PHASE_IDLE) return failureReason ? CUT_HOME_FAILED : CUT_HOME_HOMED;
+    if (!cutMotor) return fail("cut motor not initialized");
+
+    if (recoveryStartTime != 0 && millis() - recoveryStartTime >= CUT_HOME_RECOVERY_TIMEOUT_MS) {
+        return fail("recovery timed out");
+    }
+
+    const bool switchHigh = cutHomingSwitch.read() == HIGH;
+    const bool settled = !cutMotor->isRunning() && millis() - phaseStartTime >= CUT_HOME_VERIFY_SETTLE_MS;
+
+    switch (phase) {
+        case PHASE_VERIFYING:
+            if (cutMotor->isRunning()) {
+                phaseStartTime = millis(); // Settle time counts from the stop
+                break;
+            }
+            if (millis() - phaseStartTime < CUT_HOME_VERIFY_SETTLE_MS * (unsigned long)(verifyAttempt + 1)) break;
+            verifyAttempt++;
+            Serial.print("Cut position switch read attempt "); Serial.print(verifyAttempt); Serial.print(": "); Serial.println(switchHigh);
+            if (switchHigh) return finishHomed();
+            if (verifyAttempt < CUT_HOME_VERIFY_ATTEMPTS) break;
+
+            Serial.print(context);
+            Serial.println(": Cut motor position switch did not detect home. Starting slow seek toward the switch.");
+            triggerFlightRecorder(trigger);
+            recoveryStartTime = millis();
+            startMove(CUT_HOME_RECOVERY_SEEK_SPEED, lroundf(CUT_HOMING_DIRECTION * CUT_HOME_RECOVERY_MAX_SEEK_INCHES * CUT_MOTOR_STEPS_PER_INCH));
+            enterPhase(PHASE_SEEKING);
+            break;
+
+        case PHASE_SEEKING:
+            if (switchHigh) {
+                cutMotor->stopMove();
+                enterPhase(PHASE_SEEK_SETTLING);
+            } else if (!cutMotor->isRunning()) {
+                return fail("home switch not found within the seek distance");
+            }
+            break;
+
+        case PHASE_SEEK_SETTLING:
+            if (!settled) break;
+            if (!switchHigh) return fail("home switch dropped out after the seek stopped");
+            // Move off the switch to prove it releases
+            startMove(CUT_HOME_RECOVERY_SEEK_SPEED, lroundf(-CUT_HOMING_DIRECTION * CUT_HOME_RECOVERY_BACKOFF_INCHES * CUT_MOTOR_STEPS_PER_INCH));
+            enterPhase(PHASE_BACKING_OFF);
+            break;
+
+        case PHASE_BACKING_OFF:
+            if (!cutMotor->isRunning()) enterPhase(PHASE_BACKOFF_SETTLING);
+            break;
+
+        case PHASE_BACKOFF_SETTLING:
+            if (!settled) break;
+            if (switchHigh) return fail("home switch stuck closed after backing off");
+            // Come back slower, allowing twice the back-off distance
+            startMove(CUT_HOME_RECOVERY_REAPPROACH_SPEED, lroundf(CUT_HOMING_DIRECTION * 2.0f * CUT_HOME_RECOVERY_BACKOFF_INCHES * CUT_MOTOR_STEPS_PER_INCH));
+            enterPhase(PHASE_REAPPROACHING);
+            break;
+
+        case PHASE_REAPPROACHING:
+            if (switchHigh) {
+                cutMotor->stopMove();
+                enterPhase(PHASE_REVERIFYING);
+            } else if (!cutMotor->isRunning()) {
+                return fail("home switch not found on the re-approach");
+            }
+            break;
+
+        case PHASE_REVERIFYING:
+            if (!settled) break;
+            if (!switchHigh) return fail("home switch dropped out on re-verify");
+            recovered = true;
+            return finishHomed();
+
+        case PHASE_IDLE:
+            break;
+    }
+    return CUT_HOME_IN_PROGRESS;
+}
@@ -3,6 +3,8 @@
 #include <FastAccelStepper.h>
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
 #include "StateMachine/99_CUT_MOTOR_ERROR_FUNCTIONS.h"
+#include "StateMachine/StateManager.h"
+#include "FlightRecorder/flight_recorder.h"
 
 //* ************************************************************************
 //* ****************** CUT MOTOR HOME ERROR HANDLER **********************
@@ -22,51 +24,9 @@
 //!
 //! Therefore, this error detection system implements a recovery approach
 //! that attempts to slowly move the cut motor back to home position.
-
-// ========================================================================
-//! RECOVERY SYSTEM CONFIGURATION
-// ========================================================================
-
-//! TIMEOUT AND SPEED CONSTANTS
-const unsigned long CUT_MOTOR_HOME_RECOVERY_TIMEOUT_MS = 5000; // 5 second maximum recovery time
-const float CUT_MOTOR_HOME_RECOVERY_SPEED = 1000; // Recovery speed (same as homing speed)
-
-// ========================================================================
-//! RESULT STRUCTURE CREATION HELPERS
-// ========================================================================
-
-//! SUCCESS RESULT - Home position detected successfully
-CutMotorHomeErrorResult createSuccessResult() {
-    CutMotorHomeErrorResult result;
-    result.wasHomeDetected = true;
-    result.shouldTransitionToError = false;
-    result.shouldAttemptSlowRecovery = false;
-    result.shouldContinueWithWarning = false;
-    result.errorMessage = "";
-    return result;
-}
-
-//! ERROR TRANSITION RESULT - Critical error requiring ERROR state
-CutMotorHomeErrorResult createErrorTransitionResult(const String& message) {
-    CutMotorHomeErrorResult result;
-    result.wasHomeDetected = false;
-    result.shouldTransitionToError = true;
-    result.shouldAttemptSlowRecovery = false;
-    result.shouldContinueWithWarning = false;
-    result.errorMessage = message;
-    return result;
-}
-
-//! WARNING RESULT - Issue detected but operation can continue
-CutMotorHomeErrorResult createWarningOnlyResult(const String& message) {
-    CutMotorHomeErrorResult result;
-    result.wasHomeDetected = false;
-    result.shouldTransitionToError = false;
-    result.shouldAttemptSlowRecovery = false;
-    result.shouldContinueWithWarning = true;
-    result.errorMessage = message;
-    return result;
-}
+//! The recovery itself is the non-blocking CutHomeRecovery sub-state machine
+//! in 99_CUT_HOME_RECOVERY_FUNCTIONS, run from the CUTTING, RETURNING_YES_2x4
+//! and RETURNING_NO_2x4 states.
 
 // ========================================================================
 //! REAL-TIME HOME SENSOR MONITORING SYSTEM
@@ -158,6 +118,7 @@ void performCutMotorRealTimeHomeSensorCheck(FastAccelStepper* cutMotor, Bounce&
                 } else {
                     //! FALSE TRIGGER OR INSUFFICIENT CONTACT
                     Serial.println("WARNING: Home sensor not active after 30ms verification delay.");
+                    triggerFlightRecorder(FLIGHT_TRIGGER_REAL_TIME_HOME_CHECK);
                     Serial.println("This was likely a false trigger or insufficient contact. Motor will continue movement.");
                     //? Note: cutMotorInYes2x4Return flag remains true so movement can continue
                 }
@@ -173,129 +134,6 @@ void performCutMotorRealTimeHomeSensorCheck(FastAccelStepper* cutMotor, Bounce&
     }
 }
 
-// ========================================================================
-//! MAIN HOME ERROR DETECTION AND RECOVERY SYSTEM  
-// ========================================================================
-
-//! PRIMARY CUT MOTOR HOME ERROR DETECTION WITH RECOVERY CAPABILITY
-//! This is the main function that handles all cut motor home position verification
-//! and implements slow recovery when initial detection fails.
-CutMotorHomeErrorResult handleCutMotorHomeError(
-    Bounce& cutHomingSwitch, 
-    FastAccelStepper* cutMotor, 
-    const String& contextDescription,
-    bool allowSlowRecovery
-) {
-    bool sensorDetectedHome = false;
-    Serial.print("ERROR DETECTION: Checking cut motor home position for context: ");
-    Serial.println(contextDescription);
-    
-    // ====================================================================
-    //! PHASE 1: INITIAL HOME VERIFICATION (3-try approach)
-    // ====================================================================
-    
-    for (int attemptNumber = 1; attemptNumber <= 3; attemptNumber++) {
-        delay(30);  // Brief delay for sensor stabilization
-        cutHomingSwitch.update();
-        Serial.print("Initial home verification attempt ");
-        Serial.print(attemptNumber);
-        Serial.print(" of 3: ");
-        Serial.println(cutHomingSwitch.read() == HIGH ? "HOME DETECTED" : "NO HOME");
-        
-        if (cutHomingSwitch.read() == HIGH) {
-            sensorDetectedHome = true;
-            if (cutMotor) {
-                cutMotor->setCurrentPosition(0); // Recalibrate position to absolute zero
-            }
-            Serial.print("SUCCESS: Cut motor home position confirmed on initial check for ");
-            Serial.println(contextDescription);
-            return createSuccessResult();
-        }
-    }
-    
-    // ====================================================================
-    //! PHASE 2: SLOW RECOVERY ATTEMPT (if enabled for this context)
-    // ====================================================================
-    
-    if (!sensorDetectedHome && allowSlowRecovery) {
-        Serial.println("INITIATING SLOW RECOVERY: Moving cut motor slowly back to home at homing speed...");
-        
-        if (cutMotor) {
-            //! CONFIGURE MOTOR FOR RECOVERY MOVEMENT
-            cutMotor->setSpeedInHz(CUT_MOTOR_HOME_RECOVERY_SPEED);
-            cutMotor->setAcceleration(10000); // Moderate acceleration for controlled movement
-            
-            //! START RECOVERY MOVEMENT (backward toward home)
-            cutMotor->runBackward();
-            
-            unsigned long recoveryStartTime = millis();
-            bool homeFoundDuringRecovery = false;
-            
-            Serial.print("Slow recovery started at homing speed (");
-            Serial.print(CUT_MOTOR_HOME_RECOVERY_SPEED);
-            Serial.println(" steps/sec) with 5-second timeout...");
-            
-            //! MONITOR FOR HOME SENSOR DETECTION DURING RECOVERY
-            while ((millis() - recoveryStartTime) < CUT_MOTOR_HOME_RECOVERY_TIMEOUT_MS) {
-                cutHomingSwitch.update();
-                
-                if (cutHomingSwitch.read() == HIGH) {
-                    //! HOME SENSOR DETECTED DURING RECOVERY!
-                    cutMotor->forceStopAndNewPosition(0);
-                    homeFoundDuringRecovery = true;
-                    
-                    unsigned long recoveryDuration = millis() - recoveryStartTime;
-                    Serial.print("SUCCESS: Home sensor detected during slow recovery after ");
-                    Serial.print(recoveryDuration);
-                    Serial.println(" ms. Cut motor position recalibrated to 0.");
-                    
-                    String successMessage = "Recovery successful for " + contextDescription + 
-                                          " after " + String(recoveryDuration) + " ms";
-                    return createSuccessResult();
-                }
-                
-                // Small delay to prevent excessive sensor polling
-                delay(10);
-            }
-            
-            //! RECOVERY TIMEOUT - Stop motor and report error
-            cutMotor->forceStopAndNewPosition(cutMotor->getCurrentPosition());
-            
-            if (!homeFoundDuringRecovery) {
-                String timeoutErrorMessage = String("CRITICAL ERROR: Recovery timeout after 5 seconds. ") +
-                                           String("Cut motor failed to find home position during slow recovery for context: ") + 
-                                           contextDescription;
-                Serial.println(timeoutErrorMessage);
-                return createErrorTransitionResult(timeoutErrorMessage);
-            }
-        } else {
-            String motorErrorMessage = "CRITICAL ERROR: Cut motor object is null during recovery for context: " + contextDescription;
-            Serial.println(motorErrorMessage);
-            return createErrorTransitionResult(motorErrorMessage);
-        }
-    } 
-    // ====================================================================
-    //! PHASE 3: HANDLE CASES WHERE SLOW RECOVERY IS DISABLED
-    // ====================================================================
-    
-    else if (!allowSlowRecovery) {
-        //? Slow recovery not allowed for this context (currently only used for NO_WOOD sequences)
-        String warningMessage = String("WARNING: Cut motor home sensor did not detect home for ") + contextDescription + 
-                              String(", but slow recovery disabled. Proceeding with warning.");
-        Serial.println(warningMessage);
-        return createWarningOnlyResult(warningMessage);
-    }
-    
-    // ====================================================================
-    //! FINAL FALLBACK - All detection and recovery attempts failed
-    // ====================================================================
-    
-    String finalErrorMessage = String("FAILED: Cut motor home sensor did not detect home position after 3 attempts. ") +
-                             String("Context: ") + contextDescription;
-    Serial.println(finalErrorMessage);
-    return createErrorTransitionResult(finalErrorMessage);
-}
-
 // ========================================================================
 //! ERROR STATE TRANSITION HANDLER
 // ========================================================================
@@ -306,7 +144,6 @@ CutMotorHomeErrorResult handleCutMotorHomeError(
 void executeCutMotorErrorStateTransition(
     FastAccelStepper* cutMotor,
     FastAccelStepper* positionMotor,
-    SystemState& currentState,
     int& cuttingStep,
     int& cuttingSubStep7,
     int& fixPositionStep,
@@ -334,12 +171,11 @@ void executeCutMotorErrorStateTransition(
     }
     
     //! SET ERROR INDICATION LEDS - Visual status indicators
-    turnRedLedOn();      // Red = Error condition
-    turnYellowLedOff();  // Yellow off = Operation stopped
-    Serial.println("Error LEDs activated (Red ON, Yellow OFF).");
+    setLedStatus(LED_STATUS_ERROR);  // Red/yellow alternating = Error condition
+    Serial.println("Error LEDs activated.");
     
     //! TRANSITION TO ERROR STATE
-    currentState = ERROR;
+    stateManager.changeState(ERROR);
     errorStartTime = millis();
     
     //! RESET ALL STATE MACHINE COUNTERS - Clean slate for restart
@@ -351,26 +187,3 @@ void executeCutMotorErrorStateTransition(
     Serial.println("System transitioned to ERROR state due to cut motor home detection failure.");
     Serial.println("User must acknowledge error with reload switch to continue.");
 }
-
-// ========================================================================
-//! RESULT LOGGING AND REPORTING
-// ========================================================================
-
-//! LOG CUT MOTOR HOME ERROR RESULTS FOR DEBUGGING AND MONITORING
-void logCutMotorHomeErrorResult(const CutMotorHomeErrorResult& result) {
-    if (!result.errorMessage.isEmpty()) {
-        Serial.print("Cut Motor Home Error Handler Result: ");
-        Serial.println(result.errorMessage);
-    }
-    
-    //! VISUAL STATUS INDICATORS FOR SERIAL MONITOR
-    if (result.wasHomeDetected) {
-        Serial.println("✓ Cut motor home position successfully verified.");
-    } else if (result.shouldAttemptSlowRecovery) {
-        Serial.println("→ Slow recovery at homing speed will be attempted.");
-    } else if (result.shouldTransitionToError) {
-        Serial.println("✗ ERROR STATE TRANSITION REQUIRED.");
-    } else if (result.shouldContinueWithWarning) {
-        Serial.println("⚠ Continuing with warning - monitor system closely.");
-    }
-} 
\ No newline at end of file
@@ -1,11 +1,17 @@
 // IMPORTANT NOTE: This file contains helper functions used by 'Stage 1 Feb25.cpp'.
 // It relies on 'Stage 1 Feb25.cpp' for pin definitions and global variable declarations (via extern).
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_SERVO_MOTION_FUNCTIONS.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "StateMachine/StateManager.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "Config/Config.h"
+#include "Diagnostics/memory_monitor.h"
 
 //* ************************************************************************
 //* *********************** HELPER FUNCTIONS ******************************
 //* ************************************************************************
-// Helper functions for clamp control, LED control, inter-stage signaling,
+// Helper functions for clamp control, inter-stage signaling,
 // and motor control used by the main Stage 1 control system.
 
 // Note: Pin definitions, global servo variables, motor objects, and related constants
@@ -15,18 +21,55 @@
 //* *********************** SIGNALING FUNCTIONS ****************************
 //* ************************************************************************
 // Contains functions related to signaling other stages or components.
+// Signal and clamp timeouts are one-shot timers on the timer wheel.
+
+static TimerHandle taSignalTimer = INVALID_TIMER_HANDLE;
+static TimerHandle rotationClampTimer = INVALID_TIMER_HANDLE;
+static TimerHandle rotationServoReleaseTimer = INVALID_TIMER_HANDLE;
+static bool rotationServoReleaseDue = false;
+
+static void onTASignalTimeout(void* context) {
+  setOutput(TRANSFER_ARM_SIGNAL_PIN, LOW); // Return to inactive state (LOW)
+  signalTAActive = false;
+  postEvent(EVENT_TIMER_EXPIRED, EVENT_TIMER_TA_SIGNAL);
+  Serial.println("Signal to Transfer Arm (TA) timed out and reset to LOW");
+}
+
+static void onRotationClampTimeout(void* context) {
+  retractRotationClamp();
+  postEvent(EVENT_TIMER_EXPIRED, EVENT_TIMER_ROTATION_CLAMP);
+  Serial.println("Rotation Clamp retracted after 1 second.");
+}
+
+static void onRotationServoReleaseDue(void* context) {
+  rotationServoReleaseDue = true;
+  postEvent(EVENT_TIMER_EXPIRED, EVENT_TIMER_SERVO_RELEASE);
+}
+
+// Release is due once the servo has (by speed model) arrived and the piece has had its dwell
+static void scheduleRotationServoRelease() {
+  cancelTimer(rotationServoReleaseTimer);
+  rotationServoReleaseDue = false;
+  rotationServoReleaseTimer = scheduleTimerMs(rotationServoMotion.getTravelTimeMs() + getActiveJobProfile().rotationServoReleaseDwellMs,
+                                              onRotationServoReleaseDue);
+}
+
+bool isRotationServoReleaseDue() {
+  return rotationServoReleaseDue;
+}
 
 void sendSignalToTA() {
   // Set the signal pin HIGH to trigger Transfer Arm (active HIGH)
-  digitalWrite(TRANSFER_ARM_SIGNAL_PIN, HIGH);
-  signalTAStartTime = millis();
+  setOutput(TRANSFER_ARM_SIGNAL_PIN, HIGH);
+  cancelTimer(taSignalTimer);
+  taSignalTimer = scheduleTimerMs(TA_SIGNAL_DURATION, onTASignalTimeout);
   signalTAActive = true;
   Serial.println("TA Signal activated (HIGH).");
 
   // Only activate servo if it hasn't been activated early
   if (!rotationServoIsActiveAndTiming) {
-    rotationServo.write(ROTATION_SERVO_ACTIVE_POSITION);
-    rotationServoActiveStartTime = millis();
+    rotationServoMotion.moveTo(ROTATION_SERVO_ACTIVE_POSITION);
+    scheduleRotationServoRelease();
     rotationServoIsActiveAndTiming = true;
     Serial.print("Rotation servo moved to ");
     Serial.print(ROTATION_SERVO_ACTIVE_POSITION);
@@ -40,180 +83,58 @@ void sendSignalToTA() {
 //* ************************* CLAMP FUNCTIONS ******************************
 //* ************************************************************************
 // Contains functions for controlling various clamps.
+// Clamp outputs go through the output shadow register and are driven on the next flush.
 // Clamp Logic: LOW = extended, HIGH = retracted
 // Rotation Clamp Logic: HIGH = extended, LOW = retracted
 
 void extendFeedClamp() {
     // Feed clamp extends when LOW (inversed logic)
-    digitalWrite(FEED_CLAMP, LOW); // Extended
+    setOutput(FEED_CLAMP, LOW); // Extended
     Serial.println("Feed Clamp Extended");
 }
 
 void retractFeedClamp() {
     // Feed clamp retracts when HIGH (inversed logic)
-    digitalWrite(FEED_CLAMP, HIGH); // Retracted
+    setOutput(FEED_CLAMP, HIGH); // Retracted
     Serial.println("Feed Clamp Retracted");
 }
 
 void extend2x4SecureClamp() {
     // 2x4 secure clamp extends when LOW (inversed logic)
-    digitalWrite(_2x4_SECURE_CLAMP, LOW); // Extended
+    setOutput(_2x4_SECURE_CLAMP, LOW); // Extended
     Serial.println("2x4 Secure Clamp Extended");
 }
 
 void retract2x4SecureClamp() {
     // 2x4 secure clamp retracts when HIGH (inversed logic)
-    digitalWrite(_2x4_SECURE_CLAMP, HIGH); // Retracted
+    setOutput(_2x4_SECURE_CLAMP, HIGH); // Retracted
     Serial.println("2x4 Secure Clamp Retracted");
 }
 
 void extendRotationClamp() {
     // Rotation clamp extends when HIGH
-    digitalWrite(ROTATION_CLAMP, HIGH); // Extended 
-    rotationClampExtendTime = millis();
+    setOutput(ROTATION_CLAMP, HIGH); // Extended 
+    cancelTimer(rotationClampTimer);
+    rotationClampTimer = scheduleTimerMs(getActiveJobProfile().rotationClampExtendMs, onRotationClampTimeout);
     rotationClampIsExtended = true;
     Serial.println("Rotation Clamp Extended");
 }
 
 void retractRotationClamp() {
     // Rotation clamp retracts when LOW
-    digitalWrite(ROTATION_CLAMP, LOW); // Retracted 
+    setOutput(ROTATION_CLAMP, LOW); // Retracted 
+    cancelTimer(rotationClampTimer);
     rotationClampIsExtended = false; // Assuming we want to clear the flag when explicitly retracting
     Serial.println("Rotation Clamp Retracted");
 }
 
-//* ************************************************************************
-//* *************************** LED FUNCTIONS ******************************
-//* ************************************************************************
-// Contains functions for controlling LEDs.
-
-void turnRedLedOn() {
-  static bool lastRedLedState = false;
-  digitalWrite(STATUS_LED_RED, HIGH);
-  digitalWrite(STATUS_LED_YELLOW, LOW);
-  digitalWrite(STATUS_LED_GREEN, LOW);
-  digitalWrite(STATUS_LED_BLUE, LOW);
-  if (!lastRedLedState) {
-    Serial.println("Red LED ON");
-    lastRedLedState = true;
-  }
-}
-
-void turnRedLedOff() {
-  static bool lastRedLedState = true;
-  digitalWrite(STATUS_LED_RED, LOW);
-  if (lastRedLedState) {
-    Serial.println("Red LED OFF");
-    lastRedLedState = false;
-  }
-}
-
-void turnYellowLedOn() {
-  static bool lastYellowLedState = false;
-  digitalWrite(STATUS_LED_YELLOW, HIGH);
-  digitalWrite(STATUS_LED_RED, LOW);
-  digitalWrite(STATUS_LED_GREEN, LOW);
-  digitalWrite(STATUS_LED_BLUE, LOW);
-  if (!lastYellowLedState) {
-    Serial.println("Yellow LED ON");
-    lastYellowLedState = true;
-  }
-}
-
-void turnYellowLedOff() {
-  static bool lastYellowLedState = true;
-  digitalWrite(STATUS_LED_YELLOW, LOW);
-  if (lastYellowLedState) {
-    Serial.println("Yellow LED OFF");
-    lastYellowLedState = false;
-  }
-}
-
-void turnGreenLedOn() {
-  static bool lastGreenLedState = false;
-  digitalWrite(STATUS_LED_GREEN, HIGH);
-  digitalWrite(STATUS_LED_RED, LOW);
-  digitalWrite(STATUS_LED_YELLOW, LOW);
-  digitalWrite(STATUS_LED_BLUE, LOW);
-  if (!lastGreenLedState) {
-    Serial.println("Green LED ON");
-    lastGreenLedState = true;
-  }
-}
-
-void turnGreenLedOff() {
-  static bool lastGreenLedState = true;
-  digitalWrite(STATUS_LED_GREEN, LOW);
-  if (lastGreenLedState) {
-    Serial.println("Green LED OFF");
-    lastGreenLedState = false;
-  }
-}
-
-void turnBlueLedOn() {
-  static bool lastBlueLedState = false;
-  digitalWrite(STATUS_LED_BLUE, HIGH);
-  digitalWrite(STATUS_LED_RED, LOW);
-  digitalWrite(STATUS_LED_GREEN, LOW);
-  digitalWrite(STATUS_LED_YELLOW, LOW);
-  if (!lastBlueLedState) {
-    Serial.println("Blue LED ON");
-    lastBlueLedState = true;
-  }
-}
-
-void turnBlueLedOff() {
-  static bool lastBlueLedState = true;
-  digitalWrite(STATUS_LED_BLUE, LOW);
-  if (lastBlueLedState) {
-    Serial.println("Blue LED OFF");
-    lastBlueLedState = false;
-  }
-}
-
-void allLedsOff() {
-    turnRedLedOff();
-    turnYellowLedOff();
-    turnGreenLedOff();
-    turnBlueLedOff();
-}
-
-void handleHomingLedBlink() {
-    static unsigned long blinkTimer = 0;
-    if (millis() - blinkTimer > 500) {
-        blinkState = !blinkState;
-        if (blinkState) turnBlueLedOn(); else turnBlueLedOff();
-        blinkTimer = millis();
-    }
-}
-
-void handleErrorLedBlink() {
-    if (millis() - lastErrorBlinkTime > 250) {
-        errorBlinkState = !errorBlinkState;
-        if(errorBlinkState) turnRedLedOn(); else turnRedLedOff();
-        if(!errorBlinkState) turnYellowLedOn(); else turnYellowLedOff();
-        lastErrorBlinkTime = millis();
-    }
-}
-
-void handleSuctionErrorLedBlink(unsigned long& lastBlinkTimeRef, bool& blinkStateRef) {
-    if (millis() - lastBlinkTimeRef >= 1500) {
-        lastBlinkTimeRef = millis();
-        blinkStateRef = !blinkStateRef;
-        if(blinkStateRef) turnRedLedOn(); else turnRedLedOff();
-    }
-    turnYellowLedOff();
-    turnGreenLedOff();
-    turnBlueLedOff();
-}
-
 //* ************************************************************************
 //* *********************** MOTOR CONTROL FUNCTIONS ************************
 //* ************************************************************************
 
 void configureCutMotorForCutting() {
     if (cutMotor) {
-        cutMotor->setSpeedInHz((uint32_t)CUT_MOTOR_NORMAL_SPEED);
+        cutMotor->setSpeedInHz((uint32_t)getCutMotorCuttingSpeed()); // Adaptive rate, or the job profile cut speed
         cutMotor->setAcceleration((uint32_t)CUT_MOTOR_NORMAL_ACCELERATION);
     }
 }
@@ -241,7 +162,7 @@ void configureFeedMotorForReturn() {
 
 void moveCutMotorToCut() {
     if (cutMotor) {
-        cutMotor->moveTo(CUT_TRAVEL_DISTANCE * CUT_MOTOR_STEPS_PER_INCH);
+        cutMotor->moveTo(getActiveJobProfile().cutTravelInches * CUT_MOTOR_STEPS_PER_INCH);
     }
 }
 
@@ -253,7 +174,7 @@ void moveCutMotorToHome() {
 
 void moveFeedMotorToTravel() {
     if (feedMotor) {
-        feedMotor->moveTo(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH);
+        feedMotor->moveTo(getActiveJobProfile().feedTravelInches * FEED_MOTOR_STEPS_PER_INCH);
     }
 }
 
@@ -282,8 +203,9 @@ void stopFeedMotor() {
 }
 
 // Basic blocking homing function for Cut Motor - can be expanded
-void homeCutMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
-    if (!cutMotor) return;
+bool homeCutMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
+    if (!cutMotor) return false;
+    flushOutputs(); // Apply pending clamp changes before blocking
     unsigned long startTime = millis();
     cutMotor->setSpeedInHz((uint32_t)CUT_MOTOR_HOMING_SPEED);
     cutMotor->moveTo(-40000);
@@ -293,50 +215,78 @@ void homeCutMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
         if (millis() - startTime > timeout) {
             Serial.println("Cut motor homing timeout!");
             cutMotor->stopMove();
-            return;
+            return false;
         }
     }
     cutMotor->stopMove();
     cutMotor->setCurrentPosition(0);
+    rebaseStepPulseCheck(cutMotor); // Still decelerating
     Serial.println("Cut motor homed.");
+    return true;
+}
+
+// Busy-wait for a blocking move; a motor still running after the timeout is stopped
+bool waitForMotorStop(FastAccelStepper* motor, unsigned long timeout) {
+    if (!motor) return true;
+    unsigned long startTime = millis();
+    while (motor->isRunning()) {
+        if (millis() - startTime > timeout) {
+            motor->stopMove();
+            return false;
+        }
+    }
+    return true;
 }
 
 // Basic blocking homing function for Feed Motor - can be expanded
-void homeFeedMotorBlocking(Bounce& homingSwitch) {
-    if (!feedMotor) return;
+bool homeFeedMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
+    if (!feedMotor) return false;
+    flushOutputs(); // Apply pending clamp changes before blocking
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Home switch sits at the profile feed travel
     
     // Step 1: Move toward home switch until it triggers
     feedMotor->setSpeedInHz((uint32_t)FEED_MOTOR_HOMING_SPEED);
     feedMotor->moveTo(10000 * FEED_MOTOR_STEPS_PER_INCH);
 
+    unsigned long startTime = millis();
     while (homingSwitch.read() != HIGH) {
         homingSwitch.update();
+        if (millis() - startTime > timeout) {
+            Serial.println("Feed motor homing timeout - home switch never closed!");
+            feedMotor->stopMove();
+            return false;
+        }
     }
     feedMotor->stopMove();
-    feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH);
+    feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH);
+    rebaseStepPulseCheck(feedMotor); // Still decelerating
     Serial.println("Feed motor hit home switch.");
     
     // Step 2: Move to -1 inch from home switch to establish working zero
     Serial.println("Moving feed motor to -1 inch from home switch...");
-    feedMotor->moveTo(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH - 0.3 * FEED_MOTOR_STEPS_PER_INCH);
+    feedMotor->moveTo(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH - 0.3 * FEED_MOTOR_STEPS_PER_INCH);
     
-    // Wait for move to complete
-    while (feedMotor->isRunning()) {
-        // Wait for move to finish
+    if (!waitForMotorStop(feedMotor, timeout)) {
+        Serial.println("Feed motor homing timeout moving off the switch!");
+        return false;
     }
     
     // Step 3: Set this position (-0.5 inch from switch) as the new zero
-    feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH);
+    feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH);
+    rebaseStepPulseCheck(feedMotor);
     Serial.println("Feed motor homed: 1 inch from switch set as position 0.");
     
     configureFeedMotorForNormalOperation();
+    return true;
 }
 
 void moveFeedMotorToInitialAfterHoming() {
     if (feedMotor) {
+        flushOutputs(); // Apply pending clamp changes before blocking
         configureFeedMotorForNormalOperation();
         moveFeedMotorToHome();
-        while(feedMotor->isRunning()){
+        if (!waitForMotorStop(feedMotor, FEED_HOME_TIMEOUT)) {
+            Serial.println("Feed motor timeout moving to its initial position!");
         }
     }
 }
@@ -354,6 +304,7 @@ bool checkAndRecalibrateCutMotorHome(int attempts) {
         if (cutHomingSwitch.read() == HIGH) {
             sensorDetectedHome = true;
             cutMotor->setCurrentPosition(0);
+            rebaseStepPulseCheck(cutMotor);
             Serial.println("Cut motor position switch detected HIGH. Position recalibrated to 0.");
             break;
         }
@@ -373,13 +324,13 @@ void handleReloadMode() {
             isReloadMode = true;
             retractFeedClamp();
             retract2x4SecureClamp();
-            turnYellowLedOn();
+            setLedStatus(LED_STATUS_RELOAD);
             Serial.println("Entered reload mode");
         } else if (!reloadSwitchOn && isReloadMode) {
             isReloadMode = false;
             extendFeedClamp();
             extend2x4SecureClamp();
-            turnYellowLedOff();
+            setLedStatus(LED_STATUS_IDLE);
             Serial.println("Exited reload mode, ready for operation");
         }
     }
@@ -392,7 +343,7 @@ void handleErrorAcknowledgement() {
         // For CUTTING state, the homePositionErrorDetected flag logic needs to remain there,
         // but the transition to ERROR_RESET can be centralized if errorAcknowledged is set.
         if (currentState == ERROR) {
-            currentState = ERROR_RESET;
+            stateManager.changeState(ERROR_RESET);
             errorAcknowledged = true; // Set flag, main loop will see this for ERROR state
             Serial.println("Error acknowledged by reload switch (from ERROR state). Transitioning to ERROR_RESET.");
         }
@@ -443,44 +394,41 @@ bool shouldStartCycle() {
             && !woodSuctionError && startSwitchSafe);
 }
 
+bool mayStartCycle() {
+    // Heap close to exhaustion: no new cycle (the status LEDs flash the notice)
+    if (getMemoryLevel() != MEMORY_CRITICAL) return true;
+    Serial.println("Cycle start refused: memory CRITICAL (see /memory). Cycle the start switch once it recovers.");
+    startSwitchSafe = false; // A switch held through the refusal must not start a cycle on recovery
+    return false;
+}
+
 // Point 4: Rotation Servo Timing
 void activateRotationServo() {
     // Activate rotation servo without sending TA signal
     if (!rotationServoIsActiveAndTiming) {
-        rotationServo.write(ROTATION_SERVO_ACTIVE_POSITION);
-        rotationServoActiveStartTime = millis();
+        rotationServoMotion.moveTo(ROTATION_SERVO_ACTIVE_POSITION);
+        scheduleRotationServoRelease();
         rotationServoIsActiveAndTiming = true;
-        Serial.print("Rotation servo activated to ");
+        Serial.print("Rotation servo ramping to ");
         Serial.print(ROTATION_SERVO_ACTIVE_POSITION);
-        Serial.println(" degrees.");
+        Serial.print(" degrees. Estimated arrival in ");
+        Serial.print(rotationServoMotion.getTravelTimeMs());
+        Serial.println(" ms.");
     } else {
         Serial.println("Rotation servo already active - skipping activation.");
     }
 }
 
 void handleRotationServoReturn() {
-    // Move rotation servo to home position
-    rotationServo.write(ROTATION_SERVO_HOME_POSITION);
+    // Ramp rotation servo to home position
+    rotationServoMotion.moveTo(ROTATION_SERVO_HOME_POSITION);
+    cancelTimer(rotationServoReleaseTimer);
+    rotationServoReleaseDue = false;
     Serial.print("Rotation servo returned to home position (");
     Serial.print(ROTATION_SERVO_HOME_POSITION);
     Serial.println(" degrees).");
 }
 
-void handleTASignalTiming() { 
-  if (signalTAActive && millis() - signalTAStartTime >= TA_SIGNAL_DURATION) {
-    digitalWrite(TRANSFER_ARM_SIGNAL_PIN, LOW); // Return to inactive state (LOW)
-    signalTAActive = false;
-    Serial.println("Signal to Transfer Arm (TA) completed"); 
-  }
-}
-
-void handleRotationClampRetract() { // Point 4
-    if (rotationClampIsExtended && (millis() - rotationClampExtendTime >= ROTATION_CLAMP_EXTEND_DURATION_MS)) {
-        retractRotationClamp();
-        Serial.println("Rotation Clamp retracted after 1 second.");
-    }
-}
-
 void moveFeedMotorToPostCutHome() {
     if (feedMotor) {
         feedMotor->moveTo(0);
@@ -0,0 +1,81 @@
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+
+#if STATE_INVARIANT_CHECKS
+
+#include "StateMachine/StateManager.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "Outputs/output_shadow.h"
+
+//* ************************************************************************
+//* ************************* STATE INVARIANTS *****************************
+//* ************************************************************************
+
+static uint32_t violations[INVARIANT_COUNT];
+static bool violated[INVARIANT_COUNT];
+
+static SystemState trackedState = STARTUP;
+static unsigned long trackedStateSince = 0;
+
+static void report(StateInvariant invariant, bool failing, SystemState state) {
+    if (failing && !violated[invariant]) {
+        violations[invariant]++;
+        Serial.print("INVARIANT VIOLATED: ");
+        Serial.print(getStateInvariantName(invariant));
+        Serial.print(" in ");
+        Serial.println(getSystemStateName(state));
+    }
+    violated[invariant] = failing;
+}
+
+// States that wait for the operator may last any time
+static bool mayWaitIndefinitely(SystemState state) {
+    return state == IDLE || state == ERROR || state == SUCTION_ERROR_HOLD;
+}
+
+void checkStateInvariants(SystemState state) {
+    unsigned long now = millis();
+    if (state != trackedState) {
+        trackedState = state;
+        trackedStateSince = now;
+    }
+    unsigned long timeInState = now - trackedStateSince;
+
+    // Positive cut speed is the stroke away from home. The wood is pushed by a
+    // positive feed move with the feed clamp extended (move_feed travel after
+    // extend feed_clamp); negative feed moves are carriage returns with the
+    // clamp retracted. Both clamps extend on LOW.
+    int32_t cutSpeed = cutMotor && cutMotor->isRunning() ? cutMotor->getCurrentSpeedInMilliHz() : 0;
+    int32_t feedSpeed = feedMotor && feedMotor->isRunning() ? feedMotor->getCurrentSpeedInMilliHz() : 0;
+    bool feedClampExtended = getOutput(FEED_CLAMP) == LOW;
+    report(INVARIANT_CUT_WHILE_FEED_ADVANCING, cutSpeed > 0 && feedSpeed > 0 && feedClampExtended, state);
+
+    bool settledInError = state == ERROR && timeInState >= STATE_INVARIANT_ERROR_GRACE_MS;
+    report(INVARIANT_MOTOR_RUNNING_IN_ERROR, settledInError && (cutSpeed != 0 || feedSpeed != 0), state);
+    bool woodHeld = feedClampExtended || getOutput(_2x4_SECURE_CLAMP) == LOW;
+    report(INVARIANT_WOOD_UNCLAMPED_IN_ERROR, settledInError && !woodHeld, state);
+
+    report(INVARIANT_STATE_STUCK, !mayWaitIndefinitely(state) && timeInState > STATE_INVARIANT_STUCK_MS, state);
+}
+
+uint32_t getStateInvariantViolations(StateInvariant invariant) {
+    return invariant < INVARIANT_COUNT ? violations[invariant] : 0;
+}
+
+uint32_t getTotalStateInvariantViolations() {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < INVARIANT_COUNT; i++) total += violations[i];
+    return total;
+}
+
+const char* getStateInvariantName(uint8_t invariant) {
+    switch (invariant) {
+        case INVARIANT_CUT_WHILE_FEED_ADVANCING: return "CUT_WHILE_FEED_ADVANCING";
+        case INVARIANT_MOTOR_RUNNING_IN_ERROR: return "MOTOR_RUNNING_IN_ERROR";
+        case INVARIANT_WOOD_UNCLAMPED_IN_ERROR: return "WOOD_UNCLAMPED_IN_ERROR";
+        case INVARIANT_STATE_STUCK: return "STATE_STUCK";
+        default: return "UNKNOWN";
+    }
+}
+
+#endif // STATE_INVARIANT_CHECKS
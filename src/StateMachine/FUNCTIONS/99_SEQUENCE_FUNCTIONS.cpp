@@ -0,0 +1,433 @@
+#include "StateMachine/99_SEQUENCE_FUNCTIONS.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "freertos/FreeRTOS.h"
+#include <Preferences.h>
+
+//* ************************************************************************
+//* ************************ SEQUENCE INTERPRETER **************************
+//* ************************************************************************
+// Uploads arrive on the network task while the loop task may be starting a
+// sequence, so the active program table is only touched under a spinlock;
+// runners work on their own copy.
+
+static const char* SEQUENCE_NVS_NAMESPACE = "sequences";
+
+// Built-in programs (tools/sequences/*.seq compile to the same code)
+static const SequenceInstruction builtInFeedFirstCut[] = {
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_FEED_CLAMP, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_MOVE_FEED, SEQUENCE_PARAM_FIRST_PUSH_1, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_FEED_CLAMP, 1, 0},
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_SECURE_CLAMP, 0, 0},
+    {SEQUENCE_OP_WAIT_MS, 0, 0, 200},
+    {SEQUENCE_OP_MOVE_FEED, SEQUENCE_PARAM_FEED_TRAVEL, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    // Second push
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_FEED_CLAMP, 0, 0},
+    {SEQUENCE_OP_MOVE_FEED, SEQUENCE_PARAM_FIRST_PUSH_2, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_FEED_CLAMP, 1, 0},
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_SECURE_CLAMP, 0, 0},
+    {SEQUENCE_OP_WAIT_MS, 0, 0, 200},
+    {SEQUENCE_OP_MOVE_FEED, SEQUENCE_PARAM_FIRST_CUT_PARK, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_BRANCH_INPUT, SEQUENCE_INPUT_START_SWITCH, HIGH, 19},
+    {SEQUENCE_OP_END, SEQUENCE_EXIT_IDLE, 0, 0},
+    {SEQUENCE_OP_END, SEQUENCE_EXIT_CUT, 0, 0},
+};
+
+static const SequenceInstruction builtInFeedWoodFwdOne[] = {
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_FEED_CLAMP, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_MOVE_FEED, SEQUENCE_PARAM_ZERO, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_FEED_CLAMP, 1, 0},
+    {SEQUENCE_OP_SET_OUTPUT, SEQUENCE_OUTPUT_SECURE_CLAMP, 0, 0},
+    {SEQUENCE_OP_WAIT_MS, 0, 0, 200},
+    {SEQUENCE_OP_MOVE_FEED, SEQUENCE_PARAM_FEED_TRAVEL, 0, 0},
+    {SEQUENCE_OP_WAIT_FEED, 0, 0, 0},
+    {SEQUENCE_OP_BRANCH_INPUT, SEQUENCE_INPUT_START_SWITCH, HIGH, 11},
+    {SEQUENCE_OP_END, SEQUENCE_EXIT_IDLE, 0, 0},
+    {SEQUENCE_OP_END, SEQUENCE_EXIT_CUT, 0, 0},
+};
+
+static portMUX_TYPE sequenceLock = portMUX_INITIALIZER_UNLOCKED;
+static SequenceProgram activePrograms[SEQUENCE_COUNT];
+static bool replaced[SEQUENCE_COUNT];
+
+static const char* const sequenceNames[SEQUENCE_COUNT] = {"feed_first_cut", "feed_wood_fwd_one"};
+static const char* const paramNames[SEQUENCE_PARAM_COUNT] = {"zero", "travel", "push1", "push2", "park", "regrip"};
+static const char* const outputNames[SEQUENCE_OUTPUT_COUNT] = {"feed_clamp", "secure_clamp", "rotation_clamp"};
+static const char* const inputNames[SEQUENCE_INPUT_COUNT] = {"start_switch", "2x4_sensor", "suction_sensor", "feed_home", "cut_home"};
+static const char* const exitNames[SEQUENCE_EXIT_COUNT] = {"idle", "cut"};
+
+static void loadBuiltIn(SequenceId id, SequenceProgram& program) {
+    const SequenceInstruction* code = id == SEQUENCE_FEED_FIRST_CUT ? builtInFeedFirstCut : builtInFeedWoodFwdOne;
+    size_t length = id == SEQUENCE_FEED_FIRST_CUT ? sizeof(builtInFeedFirstCut) / sizeof(SequenceInstruction)
+                                                  : sizeof(builtInFeedWoodFwdOne) / sizeof(SequenceInstruction);
+    memset(&program, 0, sizeof(program));
+    program.length = length;
+    memcpy(program.code, code, length * sizeof(SequenceInstruction));
+}
+
+static bool parseBlob(const uint8_t* blob, size_t length, SequenceProgram& program, const char** reason) {
+    if (length < SEQUENCE_BLOB_HEADER_SIZE || memcmp(blob, "SEQ1", 4) != 0) {
+        if (reason) *reason = "not a compiled sequence";
+        return false;
+    }
+    uint16_t count = (uint16_t)blob[4] | ((uint16_t)blob[5] << 8);
+    if (count == 0 || count > SEQUENCE_MAX_INSTRUCTIONS) {
+        if (reason) *reason = "too many instructions";
+        return false;
+    }
+    if (length != SEQUENCE_BLOB_HEADER_SIZE + count * sizeof(SequenceInstruction)) {
+        if (reason) *reason = "length does not match the instruction count";
+        return false;
+    }
+    memset(&program, 0, sizeof(program));
+    program.length = count;
+    memcpy(program.code, blob + SEQUENCE_BLOB_HEADER_SIZE, count * sizeof(SequenceInstruction));
+    return validateSequence(program, reason);
+}
+
+static void makeSequenceKey(char* key, size_t size, SequenceId id) {
+    snprintf(key, size, "s%u", (unsigned)id);
+}
+
+bool validateSequence(const SequenceProgram& program, const char** reason) {
+    const char* problem = nullptr;
+    bool hasEnd = false;
+    if (program.length == 0 || program.length > SEQUENCE_MAX_INSTRUCTIONS) {
+        problem = "empty or too long";
+    }
+    for (uint16_t i = 0; i < program.length && !problem; i++) {
+        const SequenceInstruction& instruction = program.code[i];
+        switch (instruction.op) {
+            case SEQUENCE_OP_END:
+                hasEnd = true;
+                if (instruction.a >= SEQUENCE_EXIT_COUNT) problem = "unknown exit code";
+                break;
+            case SEQUENCE_OP_MOVE_FEED:
+                if (instruction.a >= SEQUENCE_PARAM_COUNT) problem = "unknown feed position";
+                break;
+            case SEQUENCE_OP_WAIT_FEED:
+            case SEQUENCE_OP_WAIT_MS:
+                break;
+            case SEQUENCE_OP_SET_OUTPUT:
+                if (instruction.a >= SEQUENCE_OUTPUT_COUNT || instruction.b < 0 || instruction.b > 1) problem = "bad output";
+                break;
+            case SEQUENCE_OP_WAIT_INPUT:
+            case SEQUENCE_OP_BRANCH_INPUT:
+                if (instruction.a >= SEQUENCE_INPUT_COUNT || instruction.b < 0 || instruction.b > 1) problem = "bad input";
+                else if (instruction.op == SEQUENCE_OP_BRANCH_INPUT && instruction.c >= program.length) problem = "branch target out of range";
+                break;
+            case SEQUENCE_OP_JUMP:
+                if (instruction.c >= program.length) problem = "jump target out of range";
+                break;
+            default:
+                problem = "unknown instruction";
+                break;
+        }
+    }
+    if (!problem) {
+        uint8_t lastOp = program.code[program.length - 1].op;
+        if (!hasEnd) problem = "no end instruction";
+        else if (lastOp != SEQUENCE_OP_END && lastOp != SEQUENCE_OP_JUMP) problem = "runs off the end of the program";
+    }
+    if (reason) *reason = problem;
+    return problem == nullptr;
+}
+
+void beginSequences() {
+    Preferences preferences;
+    bool opened = preferences.begin(SEQUENCE_NVS_NAMESPACE, true);
+    for (uint8_t i = 0; i < SEQUENCE_COUNT; i++) {
+        SequenceId id = (SequenceId)i;
+        loadBuiltIn(id, activePrograms[i]);
+        replaced[i] = false;
+        if (!opened) continue;
+
+        char key[8];
+        makeSequenceKey(key, sizeof(key), id);
+        uint8_t blob[SEQUENCE_BLOB_HEADER_SIZE + SEQUENCE_MAX_INSTRUCTIONS * sizeof(SequenceInstruction)];
+        size_t length = preferences.getBytesLength(key);
+        if (length == 0 || length > sizeof(blob) || preferences.getBytes(key, blob, length) != length) continue;
+
+        SequenceProgram stored;
+        const char* reason = nullptr;
+        if (parseBlob(blob, length, stored, &reason)) {
+            activePrograms[i] = stored;
+            replaced[i] = true;
+            Serial.printf("Sequences: using uploaded %s (%u instructions)\n", sequenceNames[i], stored.length);
+        } else {
+            Serial.printf("Sequences: uploaded %s ignored (%s) - using built-in\n", sequenceNames[i], reason);
+        }
+    }
+    if (opened) preferences.end();
+}
+
+void getSequence(SequenceId id, SequenceProgram& program) {
+    if (id >= SEQUENCE_COUNT) id = SEQUENCE_FEED_WOOD_FWD_ONE;
+    portENTER_CRITICAL(&sequenceLock);
+    program = activePrograms[id];
+    portEXIT_CRITICAL(&sequenceLock);
+}
+
+bool isSequenceReplaced(SequenceId id) {
+    return id < SEQUENCE_COUNT && replaced[id];
+}
+
+bool installSequence(SequenceId id, const uint8_t* blob, size_t length, const char** reason) {
+    if (id >= SEQUENCE_COUNT) {
+        if (reason) *reason = "unknown sequence";
+        return false;
+    }
+    SequenceProgram program;
+    if (!parseBlob(blob, length, program, reason)) return false;
+
+    Preferences preferences;
+    char key[8];
+    makeSequenceKey(key, sizeof(key), id);
+    if (!preferences.begin(SEQUENCE_NVS_NAMESPACE, false) || preferences.putBytes(key, blob, length) != length) {
+        preferences.end();
+        if (reason) *reason = "could not store in NVS";
+        return false;
+    }
+    preferences.end();
+
+    portENTER_CRITICAL(&sequenceLock);
+    activePrograms[id] = program;
+    replaced[id] = true;
+    portEXIT_CRITICAL(&sequenceLock);
+    Serial.printf("Sequences: %s replaced (%u instructions), used from its next start\n", sequenceNames[id], program.length);
+    return true;
+}
+
+void resetSequence(SequenceId id) {
+    if (id >= SEQUENCE_COUNT) return;
+    Preferences preferences;
+    char key[8];
+    makeSequenceKey(key, sizeof(key), id);
+    if (preferences.begin(SEQUENCE_NVS_NAMESPACE, false)) {
+        preferences.remove(key);
+        preferences.end();
+    }
+    SequenceProgram program;
+    loadBuiltIn(id, program);
+    portENTER_CRITICAL(&sequenceLock);
+    activePrograms[id] = program;
+    replaced[id] = false;
+    portEXIT_CRITICAL(&sequenceLock);
+    Serial.printf("Sequences: %s back to built-in\n", sequenceNames[id]);
+}
+
+const char* getSequenceName(SequenceId id) {
+    return id < SEQUENCE_COUNT ? sequenceNames[id] : "unknown";
+}
+
+bool findSequenceByName(const char* name, SequenceId& id) {
+    for (uint8_t i = 0; i < SEQUENCE_COUNT; i++) {
+        if (strcmp(name, sequenceNames[i]) == 0) {
+            id = (SequenceId)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void formatSequence(SequenceId id, String& out) {
+    SequenceProgram program;
+    getSequence(id, program);
+
+    bool isTarget[SEQUENCE_MAX_INSTRUCTIONS] = {};
+    for (uint16_t i = 0; i < program.length; i++) {
+        uint8_t op = program.code[i].op;
+        if (op == SEQUENCE_OP_BRANCH_INPUT || op == SEQUENCE_OP_JUMP) isTarget[program.code[i].c] = true;
+    }
+
+    char line[80];
+    for (uint16_t i = 0; i < program.length; i++) {
+        const SequenceInstruction& in = program.code[i];
+        if (isTarget[i]) {
+            snprintf(line, sizeof(line), "L%u:\n", i);
+            out += line;
+        }
+        switch (in.op) {
+            case SEQUENCE_OP_END:
+                snprintf(line, sizeof(line), "    end %s\n", exitNames[in.a]);
+                break;
+            case SEQUENCE_OP_MOVE_FEED:
+                if (in.b == 0) snprintf(line, sizeof(line), "    move_feed %s\n", paramNames[in.a]);
+                else snprintf(line, sizeof(line), "    move_feed %s %+.2f\n", paramNames[in.a], in.b / 100.0f);
+                break;
+            case SEQUENCE_OP_WAIT_FEED:
+                if (in.c == 0) snprintf(line, sizeof(line), "    wait_feed\n");
+                else snprintf(line, sizeof(line), "    wait_feed %u\n", in.c);
+                break;
+            case SEQUENCE_OP_SET_OUTPUT:
+                snprintf(line, sizeof(line), "    %s %s\n", in.b ? "extend" : "retract", outputNames[in.a]);
+                break;
+            case SEQUENCE_OP_WAIT_MS:
+                snprintf(line, sizeof(line), "    wait %u\n", in.c);
+                break;
+            case SEQUENCE_OP_WAIT_INPUT:
+                if (in.c == 0) snprintf(line, sizeof(line), "    wait_input %s %s\n", inputNames[in.a], in.b ? "high" : "low");
+                else snprintf(line, sizeof(line), "    wait_input %s %s %u\n", inputNames[in.a], in.b ? "high" : "low", in.c);
+                break;
+            case SEQUENCE_OP_BRANCH_INPUT:
+                snprintf(line, sizeof(line), "    if %s %s goto L%u\n", inputNames[in.a], in.b ? "high" : "low", in.c);
+                break;
+            case SEQUENCE_OP_JUMP:
+                snprintf(line, sizeof(line), "    goto L%u\n", in.c);
+                break;
+        }
+        out += line;
+    }
+}
+
+//* ************************************************************************
+//* ************************** SEQUENCE RUNNER *****************************
+//* ************************************************************************
+
+static float feedParamInches(uint8_t param) {
+    const JobProfile& profile = getActiveJobProfile();
+    switch (param) {
+        case SEQUENCE_PARAM_FEED_TRAVEL: return profile.feedTravelInches;
+        case SEQUENCE_PARAM_FIRST_PUSH_1: return profile.firstCutPushInches[0];
+        case SEQUENCE_PARAM_FIRST_PUSH_2: return profile.firstCutPushInches[1];
+        case SEQUENCE_PARAM_FIRST_CUT_PARK: return profile.feedTravelInches - profile.firstCutParkOffsetInches;
+        case SEQUENCE_PARAM_NO_WOOD_REGRIP: return profile.noWoodRegripInches;
+        default: return 0.0f;
+    }
+}
+
+static int readSequenceInput(uint8_t input) {
+    switch (input) {
+        case SEQUENCE_INPUT_START_SWITCH: return startCycleSwitch.read();
+        case SEQUENCE_INPUT_2X4_SENSOR: return digitalRead(_2x4_PRESENT_SENSOR);
+        case SEQUENCE_INPUT_SUCTION_SENSOR: return digitalRead(WOOD_SUCTION_CONFIRM_SENSOR);
+        case SEQUENCE_INPUT_FEED_HOME: return feedHomingSwitch.read();
+        case SEQUENCE_INPUT_CUT_HOME: return cutHomingSwitch.read();
+        default: return LOW;
+    }
+}
+
+static void setSequenceOutput(uint8_t output, bool extended) {
+    switch (output) {
+        case SEQUENCE_OUTPUT_FEED_CLAMP:
+            if (extended) extendFeedClamp(); else retractFeedClamp();
+            break;
+        case SEQUENCE_OUTPUT_SECURE_CLAMP:
+            if (extended) extend2x4SecureClamp(); else retract2x4SecureClamp();
+            break;
+        case SEQUENCE_OUTPUT_ROTATION_CLAMP:
+            if (extended) extendRotationClamp(); else retractRotationClamp();
+            break;
+    }
+}
+
+void SequenceRunner::begin(const char* contextName, SequenceId id) {
+    getSequence(id, program);
+    context = contextName;
+    active = true;
+    pc = 0;
+    waiting = false;
+    exitCode = SEQUENCE_EXIT_IDLE;
+    failureReason = nullptr;
+    Serial.printf("%s: Running %s sequence (%s, %u instructions)\n", context, getSequenceName(id),
+                  isSequenceReplaced(id) ? "uploaded" : "built-in", program.length);
+}
+
+void SequenceRunner::cancel() {
+    if (!active) return;
+    stopFeedMotor();
+    active = false;
+}
+
+SequenceStatus SequenceRunner::fail(const char* reason) {
+    failureReason = reason;
+    active = false;
+    stopFeedMotor();
+    Serial.printf("%s: Sequence failed at instruction %u: %s\n", context, pc, reason);
+    return SEQUENCE_FAILED;
+}
+
+// Start (or continue) the wait at pc; false while still waiting
+bool SequenceRunner::holdWait(uint16_t timeoutMs, const char* timeoutReason, SequenceStatus& status) {
+    if (!waiting) {
+        waiting = true;
+        waitStartTime = millis();
+    }
+    if (timeoutMs > 0 && millis() - waitStartTime >= timeoutMs) status = fail(timeoutReason);
+    return false;
+}
+
+// Run one instruction. Returns true when pc moved on and the next one may run now.
+bool SequenceRunner::step(const SequenceInstruction& in, SequenceStatus& status) {
+    switch (in.op) {
+        case SEQUENCE_OP_END:
+            exitCode = in.a;
+            active = false;
+            status = SEQUENCE_DONE;
+            return false;
+
+        case SEQUENCE_OP_MOVE_FEED: {
+            float target = feedParamInches(in.a) + in.b / 100.0f;
+            if (target < -JOB_PROFILE_MAX_FEED_OVERTRAVEL_INCHES || target > FEED_TRAVEL_DISTANCE) {
+                status = fail("feed move out of range");
+                return false;
+            }
+            moveFeedMotorToPosition(target);
+            Serial.printf("%s: Moving feed motor to %.2f inch\n", context, target);
+            break;
+        }
+
+        case SEQUENCE_OP_WAIT_FEED:
+            if (feedMotor && feedMotor->isRunning()) return holdWait(in.c, "feed move timed out", status);
+            break;
+
+        case SEQUENCE_OP_SET_OUTPUT:
+            setSequenceOutput(in.a, in.b != 0);
+            break;
+
+        case SEQUENCE_OP_WAIT_MS:
+            if (!waiting) {
+                waiting = true;
+                waitStartTime = millis();
+            }
+            if (millis() - waitStartTime < in.c) return false;
+            break;
+
+        case SEQUENCE_OP_WAIT_INPUT:
+            if (readSequenceInput(in.a) != in.b) return holdWait(in.c, "input wait timed out", status);
+            break;
+
+        case SEQUENCE_OP_BRANCH_INPUT:
+            if (readSequenceInput(in.a) == in.b) {
+                pc = in.c;
+                waiting = false;
+                return true;
+            }
+            break;
+
+        case SEQUENCE_OP_JUMP:
+            pc = in.c;
+            waiting = false;
+            return true;
+    }
+    pc++;
+    waiting = false;
+    return true;
+}
+
+SequenceStatus SequenceRunner::update() {
+    if (!active) return failureReason ? SEQUENCE_FAILED : SEQUENCE_DONE;
+    for (uint8_t n = 0; n < SEQUENCE_MAX_STEPS_PER_UPDATE; n++) {
+        SequenceStatus status = SEQUENCE_RUNNING;
+        if (!step(program.code[pc], status)) return status;
+    }
+    return SEQUENCE_RUNNING;
+}
@@ -0,0 +1,22 @@
+#include "StateMachine/99_SERVO_MOTION_FUNCTIONS.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ********************* SERVO MOTION FUNCTIONS **************************
+//* ************************************************************************
+// Rotation servo motion controller instance and configuration.
+// The controller ramps rotationServo toward its target and estimates when the
+// arm has physically arrived, so the release check can run as soon as the
+// piece is actually at the active position instead of after a fixed hold.
+
+ServoMotionController<Servo> rotationServoMotion(rotationServo);
+
+void configureRotationServoMotion() {
+    rotationServoMotion.setVelocity(ROTATION_SERVO_RAMP_VELOCITY_DEG_PER_SEC);
+    rotationServoMotion.setSpeedModel(ROTATION_SERVO_MODEL_SPEED_DEG_PER_SEC, ROTATION_SERVO_MODEL_LATENCY_MS);
+
+    Serial.print("Rotation servo motion configured. Estimated travel home->active: ");
+    Serial.print(rotationServoMotion.estimateTravelTimeMs(ROTATION_SERVO_HOME_POSITION, ROTATION_SERVO_ACTIVE_POSITION));
+    Serial.println(" ms");
+}
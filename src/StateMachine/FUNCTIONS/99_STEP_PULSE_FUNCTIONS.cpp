@@ -0,0 +1,151 @@
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+
+//* ************************************************************************
+//* ************************* STEP PULSE CHECK *****************************
+//* ************************************************************************
+// A move is tracked from the first tick its motor is seen running to the
+// first tick it is seen stopped. Both ends read the position and the pulse
+// count back to back; a motor still stepping between the two reads skews the
+// snapshot by at most a step, which the tolerance covers. Moves that start
+// and finish inside one blocking call are never seen and go unchecked.
+
+struct StepPulseChannel {
+    FastAccelStepper* motor;
+    bool inMove;
+    int32_t startPosition;
+    int16_t startCount;
+    StepPulseStats stats;
+};
+
+static StepPulseChannel channels[STEP_PULSE_MOTOR_COUNT];
+
+// Difference folded into [-range/2, range/2)
+static int32_t wrapCounterDelta(int32_t delta) {
+    delta %= STEP_PULSE_COUNTER_RANGE;
+    if (delta >= STEP_PULSE_COUNTER_RANGE / 2) delta -= STEP_PULSE_COUNTER_RANGE;
+    if (delta < -STEP_PULSE_COUNTER_RANGE / 2) delta += STEP_PULSE_COUNTER_RANGE;
+    return delta;
+}
+
+static int16_t readCounter(const StepPulseChannel& channel) {
+#if defined(SUPPORT_ESP32_PULSE_COUNTER)
+    return channel.motor->readPulseCounter();
+#else
+    (void)channel;
+    return 0;
+#endif
+}
+
+static bool attachChannel(StepPulseChannel& channel, FastAccelStepper* motor, unsigned int unit, int dirPin) {
+    channel.motor = motor;
+    if (!motor) return false;
+#if defined(SUPPORT_ESP32_PULSE_COUNTER)
+    channel.stats.attached = motor->attachToPulseCounter((uint8_t)unit, -STEP_PULSE_COUNTER_RANGE,
+                                                         STEP_PULSE_COUNTER_RANGE, (uint16_t)dirPin);
+#else
+    (void)unit;
+    (void)dirPin;
+    channel.stats.attached = false;
+#endif
+    return channel.stats.attached;
+}
+
+static void startMove(StepPulseChannel& channel) {
+    channel.startPosition = channel.motor->getCurrentPosition();
+    channel.startCount = readCounter(channel);
+    channel.inMove = true;
+}
+
+static void finishMove(StepPulseChannel& channel, StepPulseMotor which) {
+    int32_t commanded = channel.motor->getCurrentPosition() - channel.startPosition;
+    int32_t emitted = (int32_t)readCounter(channel) - channel.startCount;
+    int32_t discrepancy = wrapCounterDelta(commanded - emitted);
+    channel.inMove = false;
+
+    StepPulseStats& stats = channel.stats;
+    stats.moves++;
+    stats.lastDiscrepancy = discrepancy;
+    if (abs(discrepancy) > abs(stats.worstDiscrepancy)) stats.worstDiscrepancy = discrepancy;
+    if ((uint32_t)abs(discrepancy) <= STEP_PULSE_TOLERANCE_STEPS) return;
+
+    stats.mismatchedMoves++;
+    stats.lastMismatchMs = millis();
+    Serial.printf("STEP PULSE CHECK: %s motor moved %ld steps but emitted %ld pulses (%+ld)\n",
+                  getStepPulseMotorName(which), (long)commanded, (long)(commanded - discrepancy),
+                  (long)discrepancy);
+}
+
+void beginStepPulseCheck() {
+    bool cutAttached = attachChannel(channels[STEP_PULSE_CUT], cutMotor, STEP_PULSE_CUT_PCNT_UNIT, CUT_MOTOR_DIR_PIN);
+    bool feedAttached = attachChannel(channels[STEP_PULSE_FEED], feedMotor, STEP_PULSE_FEED_PCNT_UNIT, FEED_MOTOR_DIR_PIN);
+    Serial.printf("Step pulse check: cut %s, feed %s\n",
+                  cutAttached ? "counting" : "unavailable", feedAttached ? "counting" : "unavailable");
+}
+
+void serviceStepPulseCheck() {
+    for (uint8_t i = 0; i < STEP_PULSE_MOTOR_COUNT; i++) {
+        StepPulseChannel& channel = channels[i];
+        if (!channel.stats.attached) continue;
+        bool running = channel.motor->isRunning();
+        if (running && !channel.inMove) startMove(channel);
+        else if (!running && channel.inMove) finishMove(channel, (StepPulseMotor)i);
+    }
+}
+
+void rebaseStepPulseCheck(FastAccelStepper* motor) {
+    for (uint8_t i = 0; i < STEP_PULSE_MOTOR_COUNT; i++) {
+        StepPulseChannel& channel = channels[i];
+        if (channel.motor != motor || !channel.stats.attached || !channel.inMove) continue;
+        startMove(channel);
+        channel.stats.rebases++;
+    }
+}
+
+StepPulseStats getStepPulseStats(StepPulseMotor motor) {
+    return channels[motor].stats;
+}
+
+const char* getStepPulseMotorName(StepPulseMotor motor) {
+    switch (motor) {
+        case STEP_PULSE_CUT: return "cut";
+        case STEP_PULSE_FEED: return "feed";
+        default: return "unknown";
+    }
+}
+
+uint32_t getStepPulseMismatchCount() {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < STEP_PULSE_MOTOR_COUNT; i++) {
+        total += channels[i].stats.mismatchedMoves;
+    }
+    return total;
+}
+
+void formatStepPulseReport(String& out) {
+    char line[160];
+    snprintf(line, sizeof(line), "# step pulse check: tolerance %lu steps, counter range +/-%d\n",
+             (unsigned long)STEP_PULSE_TOLERANCE_STEPS, STEP_PULSE_COUNTER_RANGE);
+    out += line;
+    for (uint8_t i = 0; i < STEP_PULSE_MOTOR_COUNT; i++) {
+        const StepPulseChannel& channel = channels[i];
+        const StepPulseStats& stats = channel.stats;
+        const char* name = getStepPulseMotorName((StepPulseMotor)i);
+        if (!stats.attached) {
+            snprintf(line, sizeof(line), "%s: no pulse counter\n", name);
+            out += line;
+            continue;
+        }
+        snprintf(line, sizeof(line), "%s: moves=%lu mismatched=%lu rebased=%lu last=%+ld worst=%+ld lastMismatchMs=%lu\n",
+                 name, (unsigned long)stats.moves, (unsigned long)stats.mismatchedMoves,
+                 (unsigned long)stats.rebases, (long)stats.lastDiscrepancy, (long)stats.worstDiscrepancy,
+                 (unsigned long)stats.lastMismatchMs);
+        out += line;
+        snprintf(line, sizeof(line), "%s: position=%ld counter=%d%s\n",
+                 name, (long)channel.motor->getCurrentPosition(), readCounter(channel),
+                 channel.inMove ? " (in move)" : "");
+        out += line;
+    }
+}
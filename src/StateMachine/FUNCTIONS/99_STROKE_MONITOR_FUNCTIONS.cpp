@@ -0,0 +1,179 @@
+#include "StateMachine/99_STROKE_MONITOR_FUNCTIONS.h"
+#include "Config/Config.h"
+#include "esp_timer.h"
+
+//* ************************************************************************
+//* ********************** CUT STROKE MONITOR ******************************
+//* ************************************************************************
+// Baseline switch position and time-to-switch are exponentially weighted
+// means with matching variance estimates. Thresholds are the larger of a
+// fixed distance and a multiple of the learned standard deviation, so a
+// noisy switch does not raise false alarms and a clean one stays sensitive.
+
+static const float STROKE_WARNING_SIGMA = 3.0f;
+static const float STROKE_LOST_STEPS_SIGMA = 5.0f;
+
+// Current stroke
+static bool strokeActive = false;
+static bool switchSeen = false;
+static bool lateReported = false;
+static int64_t strokeStartUs = 0;
+static int32_t strokeStartSteps = 0;
+static int32_t switchSteps = 0;
+static float switchTimeMs = 0.0f;
+
+// Learned baseline and statistics
+static uint32_t healthyStrokes = 0;
+static float switchStepsVariance = 0.0f;
+static float timeVarianceMs = 0.0f;
+static float totalAbsDriftSteps = 0.0f;
+static StrokeStats stats = {};
+static StrokeVerdict lastVerdict = STROKE_NOT_MONITORED;
+
+static void updateEwma(float sample, float& mean, float& variance) {
+    if (healthyStrokes == 0) {
+        mean = sample;
+        variance = 0.0f;
+        return;
+    }
+    // Plain running mean during warm-up, EWMA afterwards
+    float alpha = healthyStrokes < (uint32_t)STROKE_MONITOR_WARMUP_STROKES
+                      ? 1.0f / (healthyStrokes + 1)
+                      : STROKE_MONITOR_EWMA_ALPHA;
+    float delta = sample - mean;
+    mean += alpha * delta;
+    variance = (1.0f - alpha) * (variance + alpha * delta * delta);
+}
+
+void beginCutStrokeReturn(FastAccelStepper* cutMotor) {
+    if (!cutMotor) return;
+    strokeActive = true;
+    switchSeen = false;
+    lateReported = false;
+    strokeStartUs = esp_timer_get_time();
+    strokeStartSteps = cutMotor->getCurrentPosition();
+}
+
+void noteCutStrokeHomeSwitch(int32_t edgeSteps, int64_t edgeTimeUs) {
+    if (!strokeActive || switchSeen) return;
+    if (edgeTimeUs < strokeStartUs) return; // Edge from before this return
+    switchSeen = true;
+    switchSteps = edgeSteps;
+    switchTimeMs = (edgeTimeUs - strokeStartUs) / 1000.0f;
+}
+
+void updateCutStrokeMonitor() {
+    if (!strokeActive || switchSeen || lateReported) return;
+    if (healthyStrokes < (uint32_t)STROKE_MONITOR_WARMUP_STROKES) return;
+
+    float elapsedMs = (esp_timer_get_time() - strokeStartUs) / 1000.0f;
+    float lateLimitMs = stats.baselineTimeMs + max((float)STROKE_LATE_MARGIN_MS, STROKE_WARNING_SIGMA * stats.timeStdDevMs);
+    if (elapsedMs > lateLimitMs) {
+        lateReported = true;
+        Serial.print("STROKE MONITOR: Home switch late - ");
+        Serial.print(elapsedMs, 0);
+        Serial.print(" ms into return (baseline ");
+        Serial.print(stats.baselineTimeMs, 0);
+        Serial.println(" ms). Possible stall or lost steps on return.");
+    }
+}
+
+StrokeVerdict finishCutStrokeReturn() {
+    if (!strokeActive) {
+        lastVerdict = STROKE_NOT_MONITORED;
+        return lastVerdict;
+    }
+    strokeActive = false;
+    stats.strokes++;
+
+    if (!switchSeen) {
+        stats.missedSwitchStrokes++;
+        lastVerdict = STROKE_NO_SWITCH;
+        Serial.println("STROKE MONITOR: Return finished without a home switch edge.");
+        return lastVerdict;
+    }
+
+    // Warm-up: every stroke with a switch edge feeds the baseline
+    if (healthyStrokes < (uint32_t)STROKE_MONITOR_WARMUP_STROKES) {
+        updateEwma((float)switchSteps, stats.baselineSwitchSteps, switchStepsVariance);
+        updateEwma(switchTimeMs, stats.baselineTimeMs, timeVarianceMs);
+        healthyStrokes++;
+        stats.switchStepsStdDev = sqrtf(switchStepsVariance);
+        stats.timeStdDevMs = sqrtf(timeVarianceMs);
+        lastVerdict = STROKE_LEARNING;
+        Serial.printf("STROKE MONITOR: Learning stroke %lu/%d - switch at %ld steps, %.1f ms\n",
+                      (unsigned long)healthyStrokes, STROKE_MONITOR_WARMUP_STROKES, (long)switchSteps, switchTimeMs);
+        return lastVerdict;
+    }
+
+    float driftSteps = (float)switchSteps - stats.baselineSwitchSteps;
+    float timeDeviationMs = switchTimeMs - stats.baselineTimeMs;
+    float absDrift = fabsf(driftSteps);
+    float warningSteps = max(STROKE_DRIFT_WARNING_INCHES * CUT_MOTOR_STEPS_PER_INCH, STROKE_WARNING_SIGMA * stats.switchStepsStdDev);
+    float lostSteps = max(STROKE_LOST_STEPS_INCHES * CUT_MOTOR_STEPS_PER_INCH, STROKE_LOST_STEPS_SIGMA * stats.switchStepsStdDev);
+    float lateLimitMs = max((float)STROKE_LATE_MARGIN_MS, STROKE_WARNING_SIGMA * stats.timeStdDevMs);
+
+    stats.lastDriftSteps = driftSteps;
+    totalAbsDriftSteps += absDrift;
+    stats.meanAbsDriftSteps = totalAbsDriftSteps / (stats.strokes - stats.missedSwitchStrokes);
+    if (absDrift > stats.maxAbsDriftSteps) stats.maxAbsDriftSteps = absDrift;
+
+    if (absDrift >= lostSteps) {
+        stats.lostStepStrokes++;
+        lastVerdict = STROKE_LOST_STEPS;
+    } else if (absDrift >= warningSteps || timeDeviationMs > lateLimitMs) {
+        stats.warnings++;
+        lastVerdict = STROKE_DRIFT_WARNING;
+    } else {
+        updateEwma((float)switchSteps, stats.baselineSwitchSteps, switchStepsVariance);
+        updateEwma(switchTimeMs, stats.baselineTimeMs, timeVarianceMs);
+        healthyStrokes++;
+        stats.switchStepsStdDev = sqrtf(switchStepsVariance);
+        stats.timeStdDevMs = sqrtf(timeVarianceMs);
+        lastVerdict = STROKE_OK;
+    }
+
+    Serial.printf("STROKE MONITOR: %s - switch at %ld steps (drift %+.0f steps / %+.3f in), %.1f ms (%+.1f ms)\n",
+                  getStrokeVerdictName(lastVerdict), (long)switchSteps, driftSteps,
+                  driftSteps / CUT_MOTOR_STEPS_PER_INCH, switchTimeMs, timeDeviationMs);
+    if (lastVerdict == STROKE_LOST_STEPS) {
+        Serial.println(driftSteps > 0
+            ? "STROKE MONITOR: Switch reached early - steps lost on the cut stroke (cut may be short)."
+            : "STROKE MONITOR: Switch reached late - steps lost on the return stroke.");
+    }
+    return lastVerdict;
+}
+
+bool isCutStrokeReturnActive() {
+    return strokeActive;
+}
+
+StrokeVerdict getLastCutStrokeVerdict() {
+    return lastVerdict;
+}
+
+StrokeStats getCutStrokeStats() {
+    return stats;
+}
+
+const char* getStrokeVerdictName(StrokeVerdict verdict) {
+    switch (verdict) {
+        case STROKE_NOT_MONITORED: return "NOT_MONITORED";
+        case STROKE_LEARNING: return "LEARNING";
+        case STROKE_OK: return "OK";
+        case STROKE_DRIFT_WARNING: return "DRIFT_WARNING";
+        case STROKE_LOST_STEPS: return "LOST_STEPS";
+        case STROKE_NO_SWITCH: return "NO_SWITCH";
+    }
+    return "UNKNOWN";
+}
+
+void printCutStrokeStats() {
+    Serial.printf("Cut strokes: %lu (warnings %lu, lost steps %lu, missed switch %lu)\n",
+                  (unsigned long)stats.strokes, (unsigned long)stats.warnings,
+                  (unsigned long)stats.lostStepStrokes, (unsigned long)stats.missedSwitchStrokes);
+    Serial.printf("  Baseline switch %.1f steps (sd %.1f), time %.1f ms (sd %.1f)\n",
+                  stats.baselineSwitchSteps, stats.switchStepsStdDev, stats.baselineTimeMs, stats.timeStdDevMs);
+    Serial.printf("  Drift last %+.1f, mean |%.1f|, max |%.1f| steps\n",
+                  stats.lastDriftSteps, stats.meanAbsDriftSteps, stats.maxAbsDriftSteps);
+}
@@ -1,15 +1,30 @@
 #include "StateMachine/00_STARTUP.h"
 #include "StateMachine/StateManager.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Watchdog/watchdog_supervisor.h"
 
 //* ************************************************************************
 //* ************************** STARTUP STATE *******************************
 //* ************************************************************************
 // Handles the initial startup state, transitioning to HOMING.
-// Step 1: Turn on the blue LED to indicate startup/homing.
+// Step 1: Show the startup LED status (blue) to indicate startup/homing.
 // Step 2: Transition to the HOMING state.
+//         The first STARTUP after a watchdog restart goes to ERROR instead:
+//         homing again on its own could run into the same fault and restart
+//         forever. The reload switch acknowledges it and homing follows.
 
 void StartupState::execute(StateManager& stateManager) {
-    turnBlueLedOn();  // Blue LED on during startup/homing
+    setLedStatus(LED_STATUS_STARTUP);  // Blue LED on during startup/homing
+    if (!watchdogRestartChecked) {
+        watchdogRestartChecked = true;
+        if (strcmp(getLastWatchdogRestart(), "none") != 0) {
+            Serial.print("Startup: restarted by the watchdog (");
+            Serial.print(getLastWatchdogRestart());
+            Serial.println(") - holding in ERROR, press reload to home.");
+            extend2x4SecureClamp();
+            stateManager.changeState(ERROR);
+            return;
+        }
+    }
     stateManager.changeState(HOMING);
 } 
\ No newline at end of file
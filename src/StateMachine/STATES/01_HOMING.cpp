@@ -1,47 +1,54 @@
 #include "StateMachine/01_HOMING.h"
 #include "StateMachine/StateManager.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "Watchdog/watchdog_supervisor.h"
+#include "Config/Config.h"
 
 //* ************************************************************************
 //* ************************** HOMING STATE ********************************
 //* ************************************************************************
 // Handles the homing sequence for all motors.
-// Step 1: Blink blue LED to indicate homing in progress.
-// Step 2: Home the cut motor (blocking). If fails, it might retry or transition to ERROR (currently retries).
+// Step 1: Blue LED blinks (LED_STATUS_HOMING) to indicate homing in progress.
+// Step 2: Home the cut motor (blocking, CUT_HOME_TIMEOUT).
 // Step 3: If cut motor homed, home the feed motor (blocking). Retract feed clamp before homing.
 // Step 4: If feed motor homed, move feed motor to FEED_TRAVEL_DISTANCE (blocking). Re-extend feed clamp.
+//         Steps 3 and 4 give up after FEED_HOME_TIMEOUT per wait.
+//         Any timeout stops both motors and goes to ERROR: a dead home switch
+//         waits for the operator instead of tripping the watchdog.
 // Step 5: If all homing and initial positioning are complete, set isHomed flag to true.
-// Step 6: Turn off blue LED, turn on green LED.
+// Step 6: IDLE entry switches the LEDs to solid green.
 // Step 7: Ensure servo is at 2 degrees.
 // Step 8: Transition to IDLE state.
 
+// Hold the wood and wait for the operator (reload acknowledges, then homing restarts)
+static void failHoming(StateManager& stateManager, const char* what) {
+    Serial.print("ERROR: Homing failed - ");
+    Serial.println(what);
+    stopCutMotor();
+    stopFeedMotor();
+    extend2x4SecureClamp();
+    stateManager.changeState(ERROR);
+}
+
 void HomingState::onEnter(StateManager& stateManager) {
     // Reset homing state variables when entering
     cutMotorHomed = false;
     feedMotorHomed = false;
     feedMotorMoved = false;
     feedHomingPhaseInitiated = false;
-    blinkTimer = 0;
 }
 
 void HomingState::execute(StateManager& stateManager) {
-    // Blink blue LED to indicate homing in progress
-    if (millis() - blinkTimer > 500) {
-        bool blinkState = stateManager.getBlinkState();
-        blinkState = !blinkState;
-        stateManager.setBlinkState(blinkState);
-        if (blinkState) turnBlueLedOn(); else turnBlueLedOff();
-        blinkTimer = millis();
-    }
-
+    // Each step below blocks until its move finishes
+    WatchdogBlockingScope blockingHoming;
+    
     if (!cutMotorHomed) {
         Serial.println("Starting cut motor homing phase (blocking)...");
         extern const unsigned long CUT_HOME_TIMEOUT; // This is in main.cpp
-        homeCutMotorBlocking(*stateManager.getCutHomingSwitch(), CUT_HOME_TIMEOUT);
-        if (stateManager.getCutMotor() && stateManager.getCutMotor()->getCurrentPosition() == 0) { // Check if homing was successful
+        if (homeCutMotorBlocking(*stateManager.getCutHomingSwitch(), CUT_HOME_TIMEOUT)) {
             cutMotorHomed = true;
         } else {
-            Serial.println("Cut motor homing failed or timed out. Retrying or error.");
+            failHoming(stateManager, "cut motor home switch not reached.");
         }
     } else if (!feedMotorHomed) {
         if (!feedHomingPhaseInitiated) {
@@ -50,15 +57,20 @@ void HomingState::execute(StateManager& stateManager) {
             Serial.println("Feed clamp retracted for homing."); 
             feedHomingPhaseInitiated = true;
         }
-        homeFeedMotorBlocking(*stateManager.getFeedHomingSwitch());
-        feedMotorHomed = true; 
         feedHomingPhaseInitiated = false; // Reset for next potential homing cycle
+        if (!homeFeedMotorBlocking(*stateManager.getFeedHomingSwitch(), FEED_HOME_TIMEOUT)) {
+            failHoming(stateManager, "feed motor home switch not reached.");
+            return;
+        }
+        feedMotorHomed = true; 
     } else if (!feedMotorMoved) {
         extendFeedClamp();
         Serial.println("Feed clamp re-extended.");
         moveFeedMotorToTravel();
-        while(stateManager.getFeedMotor()->isRunning()){
-            // Wait for feed motor to reach FEED_TRAVEL_DISTANCE
+        // Wait for feed motor to reach FEED_TRAVEL_DISTANCE
+        if (!waitForMotorStop(stateManager.getFeedMotor(), FEED_HOME_TIMEOUT)) {
+            failHoming(stateManager, "feed motor did not reach the travel position.");
+            return;
         }
         feedMotorMoved = true;
         Serial.println("Feed motor moved to FEED_TRAVEL_DISTANCE (blocking complete).");
@@ -71,9 +83,6 @@ void HomingState::execute(StateManager& stateManager) {
         extern bool isHomed; // This is in main.cpp
         isHomed = true; 
 
-        turnBlueLedOff();
-        turnGreenLedOn();
-
         // Set initial servo position via function call
         handleRotationServoReturn();
         stateManager.changeState(IDLE);
@@ -1,15 +1,19 @@
 #include "StateMachine/02_IDLE.h"
 #include "StateMachine/StateManager.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "OTAUpdater/ota_updater.h"
 
 //* ************************************************************************
 //* ************************** IDLE STATE **********************************
 //* ************************************************************************
 // Handles the idle state, awaiting user input or automatic cycle start.
+// Idle is event-driven: onEvent() runs for each switch edge, sensor change,
+// timer, state entry or OTA end event and execute() never runs, so a machine
+// sitting in IDLE costs almost nothing per loop.
 // Maintains secure wood clamp extended and feed clamp retracted.
 // Checks for pushwood forward switch press to transition to FeedFirstCut state.
 // If not in reload mode:
-//   Step 1: Turn on green LED to indicate system is idle.
+//   Step 1: Green LED indicates system is idle (applied on IDLE entry).
 //   Step 2: Check for pushwood forward switch press AND 2x4 sensor high to start FeedFirstCut.
 //           - AND Reload mode is not active.
 //           - AND Start cycle switch safety is not active.
@@ -20,6 +24,13 @@
 //           - If high, transition to FeedFirstCut state.
 //           - If low, transition to FeedWoodFwdOne state.
 //
+//   Reload mode:
+//           - Manual feed switch press selects the next job profile.
+//
+//   OTA:
+//           - While an upload is being written all inputs are ignored; the
+//             OTA_ENDED event re-evaluates them once a failed upload ends.
+//
 //   Loop maintenance:
 //           - Ensure position and wood secure clamps are engaged.
 //           - If no 2x4 is detected, turn on blue LED for NO_WOOD mode indication.
@@ -28,22 +39,36 @@
 //           - OR Continuous mode active AND not already in a cutting cycle.
 //           - AND Wood suction error is not present.
 //           - AND Start switch is safe to use (wasn't ON at startup or has been cycled).
+//           - AND Memory is not CRITICAL (mayStartCycle(); a refusal requires
+//             the start switch to be cycled again).
 //   Step 5: If start conditions met:
-//           - Turn off green LED, turn on yellow LED.
+//           - LEDs switch to the cutting status (yellow) on CUTTING entry.
 //           - Set cuttingCycleInProgress flag to true.
 //           - Transition to CUTTING state.
 //           - Configure cut motor for cutting speed.
 //           - Ensure position and wood secure clamps are engaged.
 //           - If no wood is detected, turn on blue LED for NO_WOOD mode indication.
 
-void IdleState::execute(StateManager& stateManager) {
+void IdleState::onEvent(StateManager& stateManager, const MachineEvent& event) {
+    // No cycle may start while the network task is writing a new image
+    if (isOtaUpdateInProgress()) return;
+    
+    bool switchRose = event.type == EVENT_SWITCH_ROSE;
+    bool manualFeedPressed = switchRose && event.source == EVENT_SWITCH_MANUAL_FEED;
+    bool startCycleRose = switchRose && event.source == EVENT_SWITCH_START_CYCLE;
+    
     // Handle reload mode logic first
     handleReloadModeLogic(stateManager);
     
     // Check for FeedFirstCut conditions if not in reload mode
     if (!stateManager.getIsReloadMode()) {
-        checkFirstCutConditions(stateManager);
-        checkStartConditions(stateManager);
+        checkFirstCutConditions(stateManager, manualFeedPressed);
+        if (stateManager.getCurrentState() == IDLE) {
+            checkStartConditions(stateManager, startCycleRose);
+        }
+    } else if (manualFeedPressed) {
+        // In reload mode the manual feed switch steps through the job profiles
+        requestNextJobProfile(); // Applied by the StateManager on the next idle tick
     }
 }
 
@@ -53,6 +78,11 @@ void IdleState::onEnter(StateManager& stateManager) {
     retractFeedClamp();
     retractRotationClamp(); // Ensure rotation clamp is retracted in IDLE state
     Serial.println("Idle: Secure wood clamp extended, feed clamp retracted, rotation clamp retracted");
+    
+    // Keep showing reload mode if the reload switch is still on
+    if (stateManager.getIsReloadMode()) {
+        setLedStatus(LED_STATUS_RELOAD);
+    }
 }
 
 void IdleState::handleReloadModeLogic(StateManager& stateManager) {
@@ -65,21 +95,19 @@ void IdleState::handleReloadModeLogic(StateManager& stateManager) {
         stateManager.setIsReloadMode(true);
         retractFeedClamp(); // Retract feed clamp
         retract2x4SecureClamp(); // Retract 2x4 secure clamp
-        turnBlueLedOn();     // Turn on blue LED for reload mode
+        setLedStatus(LED_STATUS_RELOAD);     // Blue LED for reload mode
     } else if (!reloadSwitchOn && isReloadMode) {
         // Exit reload mode
         stateManager.setIsReloadMode(false);
         extend2x4SecureClamp(); // Re-extend 2x4 secure clamp
         retractFeedClamp();   // Keep feed clamp retracted (idle state default)
-        turnBlueLedOff();       // Turn off blue LED
+        setLedStatus(LED_STATUS_IDLE);       // Back to green idle LED
     }
 }
 
-void IdleState::checkFirstCutConditions(StateManager& stateManager) {
+void IdleState::checkFirstCutConditions(StateManager& stateManager, bool pushwoodPressed) {
     // Check for pushwood forward switch press and 2x4 sensor state
-    extern Bounce pushwoodForwardSwitch;
     extern const int _2x4_PRESENT_SENSOR;
-    bool pushwoodPressed = pushwoodForwardSwitch.rose();
     bool _2x4SensorHigh = (digitalRead(_2x4_PRESENT_SENSOR) == HIGH);
     bool _2x4SensorLow = (digitalRead(_2x4_PRESENT_SENSOR) == LOW);
     
@@ -93,10 +121,7 @@ void IdleState::checkFirstCutConditions(StateManager& stateManager) {
     }
 }
 
-void IdleState::checkStartConditions(StateManager& stateManager) {
-    turnGreenLedOn();
-    
-    bool startCycleRose = stateManager.getStartCycleSwitch()->rose();
+void IdleState::checkStartConditions(StateManager& stateManager, bool startCycleRose) {
     bool continuousModeActive = stateManager.getContinuousModeActive();
     bool cuttingCycleInProgress = stateManager.getCuttingCycleInProgress();
     bool woodSuctionError = stateManager.getWoodSuctionError();
@@ -104,11 +129,7 @@ void IdleState::checkStartConditions(StateManager& stateManager) {
     bool _2x4Present = stateManager.get2x4Present();
     
     if (((startCycleRose || (continuousModeActive && !cuttingCycleInProgress)) 
-        && !woodSuctionError) && startSwitchSafe) {
-        turnGreenLedOff();
-        turnYellowLedOn();
-        turnBlueLedOff();
-        
+        && !woodSuctionError) && startSwitchSafe && mayStartCycle()) {
         stateManager.setCuttingCycleInProgress(true);
         stateManager.changeState(CUTTING);
         configureCutMotorForCutting();
@@ -117,7 +138,7 @@ void IdleState::checkStartConditions(StateManager& stateManager) {
         extend2x4SecureClamp();
         
         if (!_2x4Present) {
-            turnBlueLedOn();
+            setLedStatus(LED_STATUS_CUTTING_NO_WOOD);
         }
     }
 } 
\ No newline at end of file
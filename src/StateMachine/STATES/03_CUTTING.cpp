@@ -1,6 +1,9 @@
 #include "StateMachine/03_CUTTING.h"
 #include "StateMachine/StateManager.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "Diagnostics/throughput_counter.h"
 
 //* ************************************************************************
 //* ************************** CUTTING STATE *******************************
@@ -32,11 +35,6 @@ void CuttingState::execute(StateManager& stateManager) {
         return;
     }
     
-    // Handle signal timing independently of motor movements
-    if (signalActive && millis() - signalStartTime >= 2000) { // Original was 2000ms
-        signalActive = false;
-    }
-
     switch (cuttingStep) {
         case 0: 
             handleCuttingStep0(stateManager);
@@ -73,13 +71,13 @@ void CuttingState::handleCuttingStep1(StateManager& stateManager) {
     // CUTTING (Step 1): Check WAS_WOOD_SUCTIONED_SENSOR, start cut motor, monitor position for servo activation
     extern const int WOOD_SUCTION_CONFIRM_SENSOR; // From main.cpp
     
-    if (stepStartTime == 0) {
-        stepStartTime = millis();
+    if (!isTimerActive(suctionCheckTimer) && !suctionCheckDue) {
+        suctionCheckTimer = scheduleFlagTimerMs(500, &suctionCheckDue);
         Serial.println("Cutting Step 1: Checking suction sensor then starting cut motion.");
     }
 
     // Check suction sensor after brief delay to ensure it's stabilized
-    if (millis() - stepStartTime >= 500) {
+    if (suctionCheckDue) {
         if (digitalRead(WOOD_SUCTION_CONFIRM_SENSOR) == LOW) { // LOW means NO SUCTION (Error condition)
             Serial.println("Cutting Step 1: WAS_WOOD_SUCTIONED_SENSOR is LOW (No Suction). Error detected. Transitioning to SUCTION_ERROR_HOLD state.");
             stateManager.changeState(SUCTION_ERROR_HOLD);
@@ -90,7 +88,7 @@ void CuttingState::handleCuttingStep1(StateManager& stateManager) {
             configureCutMotorForCutting();
             moveCutMotorToCut();
             cuttingStep = 2;
-            stepStartTime = 0; // Reset for next step
+            suctionCheckDue = false; // Reset for next cycle
         }
     }
 }
@@ -98,9 +96,9 @@ void CuttingState::handleCuttingStep1(StateManager& stateManager) {
 void CuttingState::handleCuttingStep2(StateManager& stateManager) {
     FastAccelStepper* cutMotor = stateManager.getCutMotor();
     extern const int _2x4_PRESENT_SENSOR; // From main.cpp
-    extern const float CUT_TRAVEL_DISTANCE; // From main.cpp
-    extern const float ROTATION_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES; // From main.cpp
-    extern const float ROTATION_SERVO_EARLY_ACTIVATION_OFFSET_INCHES; // From main.cpp
+    const JobProfile& profile = getActiveJobProfile(); // Cut travel and early activation offsets
+    const float clampActivationInches = profile.cutTravelInches - profile.rotationClampEarlyOffsetInches;
+    const float servoActivationInches = profile.cutTravelInches - profile.rotationServoEarlyOffsetInches;
     extern const int CUT_MOTOR_STEPS_PER_INCH; // From main.cpp
     
     // Debug logging for motor position every 500ms
@@ -117,35 +115,41 @@ void CuttingState::handleCuttingStep2(StateManager& stateManager) {
         lastDebugTime = millis();
     }
     
+    // Sample the cut load proxy while the blade is moving through the stock
+    if (cutMotor && cutMotor->isRunning()) {
+        sampleAdaptiveCutLoad();
+    }
+    
     // Early Rotation Clamp Activation (matching old catcher clamp logic)
     if (!rotationClampActivatedThisCycle && cutMotor &&
-        cutMotor->getCurrentPosition() >= ((CUT_TRAVEL_DISTANCE - ROTATION_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES) * CUT_MOTOR_STEPS_PER_INCH)) {
+        cutMotor->getCurrentPosition() >= (clampActivationInches * CUT_MOTOR_STEPS_PER_INCH)) {
         Serial.print("*** ACTIVATING ROTATION CLAMP *** Position: ");
         Serial.print((float)cutMotor->getCurrentPosition() / CUT_MOTOR_STEPS_PER_INCH);
         Serial.print(" inches, Activation threshold: ");
-        Serial.print(CUT_TRAVEL_DISTANCE - ROTATION_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES);
+        Serial.print(clampActivationInches);
         Serial.println(" inches");
         extendRotationClamp(); // FIXED: Extend clamp when reaching activation position (matching old catcher clamp logic)
         rotationClampActivatedThisCycle = true;
         Serial.print("Cutting Step 2: Cut motor reached ");
-        Serial.print(CUT_TRAVEL_DISTANCE - ROTATION_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES);
+        Serial.print(clampActivationInches);
         Serial.println(" inches - extending rotation clamp early.");
     }
     
     // Early Rotation Servo Activation (matching old catcher servo logic)
     if (!rotationServoActivatedThisCycle && cutMotor &&
-        cutMotor->getCurrentPosition() >= ((CUT_TRAVEL_DISTANCE - ROTATION_SERVO_EARLY_ACTIVATION_OFFSET_INCHES) * CUT_MOTOR_STEPS_PER_INCH)) {
+        cutMotor->getCurrentPosition() >= (servoActivationInches * CUT_MOTOR_STEPS_PER_INCH)) {
         Serial.println("Cutting Step 2: Activating Rotation Servo (early).");
         activateRotationServo();
         rotationServoActivatedThisCycle = true;
         Serial.print("Cutting Step 2: Cut motor reached ");
-        Serial.print(CUT_TRAVEL_DISTANCE - ROTATION_SERVO_EARLY_ACTIVATION_OFFSET_INCHES);
+        Serial.print(servoActivationInches);
         Serial.println(" inches - activating rotation servo early.");
     }
     
     // Check if motor finished moving to cut position
     if (cutMotor && !cutMotor->isRunning()) {
         Serial.println("Cutting Step 2: Cut fully complete."); 
+        noteCutCompleted();
         sendSignalToTA(); // Signal to Transfer Arm (this also activates servo if not already active)
         configureCutMotorForReturn();
 
@@ -176,61 +180,37 @@ void CuttingState::handleCuttingStep3(StateManager& stateManager) {
 }
 
 void CuttingState::handleCuttingStep4(StateManager& stateManager) {
-    Serial.println("Cutting Step 4: (Logic moved to Step 7 for wood path) Feed motor at home (0).");
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
     FastAccelStepper* cutMotor = stateManager.getCutMotor();
-    extern const float CUT_MOTOR_INCREMENTAL_MOVE_INCHES; // From main.cpp
-    extern const float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES; // From main.cpp
-    extern const int CUT_MOTOR_STEPS_PER_INCH; // From main.cpp
-    extern const float FEED_TRAVEL_DISTANCE; // From main.cpp
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Active job profile
     
-    if (feedMotor && !feedMotor->isRunning()) {
+    if (!cutHomeRecovery.isActive()) {
+        Serial.println("Cutting Step 4: (Logic moved to Step 7 for wood path) Feed motor at home (0).");
+        if (!feedMotor || feedMotor->isRunning()) return;
         retract2x4SecureClamp();
         Serial.println("Feed clamp retracted.");
 
-        if (cutMotor && !cutMotor->isRunning()) {
-            Serial.println("Cut motor also at home. Checking cut motor position switch.");
-            bool sensorDetectedHome = false;
-            for (int i = 0; i < 3; i++) {
-                delay(30);
-                stateManager.getCutHomingSwitch()->update();
-                Serial.print("Cut position switch read attempt "); Serial.print(i+1); Serial.print(": "); Serial.println(stateManager.getCutHomingSwitch()->read());
-                if (stateManager.getCutHomingSwitch()->read() == HIGH) {
-                    sensorDetectedHome = true;
-                    if (cutMotor) cutMotor->setCurrentPosition(0); // Recalibrate to 0 when switch is hit
-                    Serial.println("Cut motor position switch detected HIGH. Position recalibrated to 0.");
-                    break;
-                }
-            }
-            if (!sensorDetectedHome) {
-                Serial.println("ERROR: Cut motor position switch did not detect home after return attempt.");
-                if (cutMotorIncrementalMoveTotalInches < CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES) {
-                    Serial.print("Attempting incremental move. Total moved: ");
-                    Serial.print(cutMotorIncrementalMoveTotalInches);
-                    Serial.println(" inches.");
-                    cutMotor->move(-CUT_MOTOR_INCREMENTAL_MOVE_INCHES * CUT_MOTOR_STEPS_PER_INCH);
-                    cutMotorIncrementalMoveTotalInches += CUT_MOTOR_INCREMENTAL_MOVE_INCHES;
-                    // Stay in cuttingStep 4 to re-check sensor after move
-                } else {
-                    Serial.println("ERROR: Cut motor position switch did not detect home after MAX incremental moves!");
-                    stopCutMotor();
-                    stopFeedMotor();
-                    extend2x4SecureClamp();
-                    turnRedLedOn();
-                    turnYellowLedOff();
-                    stateManager.changeState(ERROR);
-                    stateManager.setErrorStartTime(millis());
-                    resetSteps();
-                    cutMotorIncrementalMoveTotalInches = 0.0; // Reset for next attempt
-                    Serial.println("Transitioning to ERROR state due to cut motor homing failure after cut.");
-                }
-            } else {
-                Serial.println("Cut motor position switch confirmed home. Moving feed motor to final position.");
-                cutMotorIncrementalMoveTotalInches = 0.0; // Reset on success
-                moveFeedMotorToPosition(FEED_TRAVEL_DISTANCE);
-                cuttingStep = 5; 
-            }
-        }
+        if (!cutMotor || cutMotor->isRunning()) return;
+        Serial.println("Cut motor also at home. Checking cut motor position switch.");
+        cutHomeRecovery.begin("CUTTING", FLIGHT_TRIGGER_CUTTING_HOME_CHECK);
+    }
+
+    CutHomeRecoveryStatus homeStatus = cutHomeRecovery.update();
+    if (homeStatus == CUT_HOME_IN_PROGRESS) return;
+
+    if (homeStatus == CUT_HOME_FAILED) {
+        Serial.println("ERROR: Cut motor position switch did not detect home after recovery!");
+        stopCutMotor();
+        stopFeedMotor();
+        extend2x4SecureClamp();
+        stateManager.changeState(ERROR);
+        stateManager.setErrorStartTime(millis());
+        resetSteps();
+        Serial.println("Transitioning to ERROR state due to cut motor homing failure after cut.");
+    } else {
+        Serial.println("Cut motor position switch confirmed home. Moving feed motor to final position.");
+        moveFeedMotorToPosition(feedTravelInches);
+        cuttingStep = 5; 
     }
 }
 
@@ -255,7 +235,7 @@ void CuttingState::handleCuttingStep5(StateManager& stateManager) {
 void CuttingState::handleCuttingStep8_FeedMotorHomingSequence(StateManager& stateManager) {
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
     extern const float FEED_MOTOR_HOMING_SPEED; // From main.cpp
-    extern const float FEED_TRAVEL_DISTANCE; // From main.cpp
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Active job profile
     extern const int FEED_MOTOR_STEPS_PER_INCH; // From main.cpp
     
     // Non-blocking feed motor homing sequence
@@ -275,7 +255,8 @@ void CuttingState::handleCuttingStep8_FeedMotorHomingSequence(StateManager& stat
                 Serial.println("Feed Motor Homing Step 8.1: Home switch triggered. Stopping motor.");
                 if (feedMotor) {
                     feedMotor->stopMove();
-                    feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH);
+                    feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH);
+                    rebaseStepPulseCheck(feedMotor); // Still decelerating
                 }
                 Serial.println("Feed motor hit home switch.");
                 cuttingSubStep8 = 2;
@@ -285,7 +266,7 @@ void CuttingState::handleCuttingStep8_FeedMotorHomingSequence(StateManager& stat
         case 2: // Wait for motor to stop, then move to -0.2 inch from switch
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("Feed Motor Homing Step 8.2: Moving to -0.2 inch from home switch to establish working zero.");
-                feedMotor->moveTo(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH - 0.1 * FEED_MOTOR_STEPS_PER_INCH);
+                feedMotor->moveTo(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH - 0.1 * FEED_MOTOR_STEPS_PER_INCH);
                 cuttingSubStep8 = 3;
             }
             break;
@@ -293,7 +274,8 @@ void CuttingState::handleCuttingStep8_FeedMotorHomingSequence(StateManager& stat
         case 3: // Wait for positioning move to complete, then set new zero
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("Feed Motor Homing Step 8.3: Setting new working zero position.");
-                feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH); // Set this position as the new zero
+                feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH); // Set this position as the new zero
+                rebaseStepPulseCheck(feedMotor);
                 Serial.println("Feed motor homed: 0.2 inch from switch set as position 0.");
                 
                 configureFeedMotorForNormalOperation();
@@ -305,17 +287,16 @@ void CuttingState::handleCuttingStep8_FeedMotorHomingSequence(StateManager& stat
             Serial.println("Feed Motor Homing Step 8.4: Homing sequence complete.");
             extend2x4SecureClamp();
             Serial.println("2x4 secure clamp extended."); 
-            turnYellowLedOff();
             stateManager.setCuttingCycleInProgress(false);
             
             // Check if start cycle switch is active for continuous operation
-            if (stateManager.getStartCycleSwitch()->read() == HIGH && stateManager.getStartSwitchSafe()) {
+            if (stateManager.getStartCycleSwitch()->read() == HIGH && stateManager.getStartSwitchSafe() &&
+                mayStartCycle()) {
                 Serial.println("Start cycle switch is active - continuing with another cut cycle.");
                 // Prepare for next cycle
                 extend2x4SecureClamp();
                 extendRotationClamp(); // Extend rotation clamp for next cutting cycle
                 configureCutMotorForCutting(); // Ensure cut motor is set to proper cutting speed
-                turnYellowLedOn();
                 stateManager.setCuttingCycleInProgress(true);
                 stateManager.changeState(CUTTING);
                 resetSteps();
@@ -331,16 +312,7 @@ void CuttingState::handleCuttingStep8_FeedMotorHomingSequence(StateManager& stat
 
 void CuttingState::handleHomePositionError(StateManager& stateManager) {
     Serial.println("Home position error detected during cutting operation."); 
-    unsigned long lastErrorBlinkTime = stateManager.getLastErrorBlinkTime();
-    bool errorBlinkState = stateManager.getErrorBlinkState();
-    
-    if (millis() - lastErrorBlinkTime > 100) { 
-        errorBlinkState = !errorBlinkState;
-        stateManager.setErrorBlinkState(errorBlinkState);
-        if(errorBlinkState) turnRedLedOn(); else turnRedLedOff();
-        if(!errorBlinkState) turnYellowLedOn(); else turnYellowLedOff();
-        stateManager.setLastErrorBlinkTime(millis());
-    }
+    setLedStatus(LED_STATUS_HOME_POSITION_ERROR);
     
     FastAccelStepper* cutMotor = stateManager.getCutMotor();
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
@@ -359,11 +331,11 @@ void CuttingState::handleHomePositionError(StateManager& stateManager) {
 
 void CuttingState::resetSteps() {
     cuttingStep = 0;
-    signalStartTime = 0;
-    signalActive = false;
+    cancelTimer(suctionCheckTimer);
+    suctionCheckDue = false;
     homePositionErrorDetected = false;
     rotationClampActivatedThisCycle = false;
     rotationServoActivatedThisCycle = false;
-    cutMotorIncrementalMoveTotalInches = 0.0;
+    cutHomeRecovery.cancel();
     cuttingSubStep8 = 0; // Reset position motor homing substep
 } 
\ No newline at end of file
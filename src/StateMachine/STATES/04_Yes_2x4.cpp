@@ -1,6 +1,10 @@
 #include "StateMachine/04_Yes_2x4.h"
 #include "StateMachine/StateManager.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_STROKE_MONITOR_FUNCTIONS.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "StateMachine/99_CUT_HOME_LIMIT_FUNCTIONS.h"
 #include "Config/Pins_Definitions.h"
 
 //* ************************************************************************
@@ -24,10 +28,10 @@ void ReturningYes2x4State::onEnter(StateManager& stateManager) {
     retract2x4SecureClamp(); 
     Serial.println("Feed and 2x4 Secure clamps disengaged for simultaneous return.");
 
-    // Set flag to indicate we're in RETURNING_YES_2x4 return mode - enable homing sensor check
-    extern bool cutMotorInReturningYes2x4Return; // From main.cpp
-    cutMotorInReturningYes2x4Return = true;
+    // Enable the home switch stop for the RETURNING_YES_2x4 return
+    beginCutReturnHomeLimit();
     moveCutMotorToHome();
+    beginCutStrokeReturn(stateManager.getCutMotor()); // Track switch timing for missed-step detection
     moveFeedMotorToHome();
     
     // Initialize step tracking
@@ -36,14 +40,14 @@ void ReturningYes2x4State::onEnter(StateManager& stateManager) {
 
 void ReturningYes2x4State::onExit(StateManager& stateManager) {
     Serial.println("Exiting RETURNING_YES_2x4 state");
+    endCutReturnHomeLimit(); // Also on the way to ERROR
     resetSteps();
 }
 
 void ReturningYes2x4State::handleReturningYes2x4Sequence(StateManager& stateManager) {
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
     FastAccelStepper* cutMotor = stateManager.getCutMotor();
-    extern const float FEED_TRAVEL_DISTANCE; // From main.cpp
-    extern bool cutMotorInReturningYes2x4Return; // From main.cpp
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Active job profile
     
     // This step handles the completion of the "RETURNING_YES_2x4 Sequence".
     switch (returningYes2x4SubStep) {
@@ -56,45 +60,45 @@ void ReturningYes2x4State::handleReturningYes2x4Sequence(StateManager& stateMana
             }
             break;
 
-        case 1: // Wait for cut motor to home, then proceed with original logic
-            if (cutMotor && !cutMotor->isRunning()) {
+        case 1: // Wait for cut motor to home, then verify (and if needed recover) the home switch
+            if (!cutHomeRecovery.isActive()) {
+                if (!cutMotor || cutMotor->isRunning()) break;
                 Serial.println("RETURNING_YES_2x4 Step 1: Cut motor has returned home.");
-                // Clear the RETURNING_YES_2x4 return flag since cut motor has stopped
-                cutMotorInReturningYes2x4Return = false;
+                // Cut motor has stopped: back to the default planning time
+                endCutReturnHomeLimit();
+                
+                // Compare this stroke's switch position and timing against the learned baseline
+                StrokeVerdict strokeVerdict = finishCutStrokeReturn();
+                recordAdaptiveCutOutcome(strokeVerdict);
+                strokeLostSteps = strokeVerdict == STROKE_LOST_STEPS;
 
-                // Check the cut motor homing switch. If not detected, transition to ERROR.
-                bool sensorDetectedHome = false;
-                Serial.println("Checking cut motor position switch after simultaneous return.");
-                for (int i = 0; i < 3; i++) { 
-                    delay(30);  
-                    stateManager.getCutHomingSwitch()->update();
-                    Serial.print("Cut position switch read attempt "); Serial.print(i+1); Serial.print(": "); Serial.println(stateManager.getCutHomingSwitch()->read());
-                    if (stateManager.getCutHomingSwitch()->read() == HIGH) {
-                        sensorDetectedHome = true;
-                        if (cutMotor) cutMotor->setCurrentPosition(0); 
-                        Serial.println("Cut motor position switch detected HIGH. Position recalibrated to 0.");
-                        break; 
-                    }
-                }
+                // Check the cut motor homing switch. If it cannot be recovered, transition to ERROR.
+                cutHomeRecovery.begin("RETURNING_YES_2x4", FLIGHT_TRIGGER_YES_2X4_HOME_CHECK);
+            }
+
+            {
+                CutHomeRecoveryStatus homeStatus = cutHomeRecovery.update();
+                if (homeStatus == CUT_HOME_IN_PROGRESS) break;
 
-                if (!sensorDetectedHome) {
+                if (homeStatus == CUT_HOME_FAILED) {
                     // Homing failed, transition to ERROR state.
                     Serial.println("ERROR: Cut motor position switch did not detect home after simultaneous return!");
                     stopCutMotor();
                     extend2x4SecureClamp(); 
-                    turnRedLedOn();
-                    turnYellowLedOff(); 
                     stateManager.changeState(ERROR);
                     stateManager.setErrorStartTime(millis());
                     resetSteps();
                 } else {
                     // Homing successful, proceed with next steps.
+                    if (strokeLostSteps) {
+                        Serial.println("RETURNING_YES_2x4: Lost cut motor steps detected - position re-zeroed at home switch before next feed.");
+                    }
                     retract2x4SecureClamp();
                     Serial.println("2x4 secure clamp retracted after successful cut motor home detection.");
 
                     Serial.println("Cut motor position switch confirmed home. Proceeding to move feed motor to final travel position.");
                     configureFeedMotorForNormalOperation();
-                    moveFeedMotorToPosition(FEED_TRAVEL_DISTANCE);
+                    moveFeedMotorToPosition(feedTravelInches);
                     returningYes2x4SubStep = 2; // Move to feed motor homing sequence
                 }
             }
@@ -126,7 +130,7 @@ void ReturningYes2x4State::handleReturningYes2x4Sequence(StateManager& stateMana
 void ReturningYes2x4State::handleReturningYes2x4FeedMotorHoming(StateManager& stateManager) {
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
     extern const float FEED_MOTOR_HOMING_SPEED; // From main.cpp
-    extern const float FEED_TRAVEL_DISTANCE; // From main.cpp
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Active job profile
     extern const int FEED_MOTOR_STEPS_PER_INCH; // From main.cpp
     
     // Non-blocking feed motor homing sequence
@@ -146,7 +150,8 @@ void ReturningYes2x4State::handleReturningYes2x4FeedMotorHoming(StateManager& st
                 Serial.println("RETURNING_YES_2x4 Feed Motor Homing Step 1: Home switch triggered. Stopping motor.");
                 if (feedMotor) {
                     feedMotor->stopMove();
-                    feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH);
+                    feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH);
+                    rebaseStepPulseCheck(feedMotor); // Still decelerating
                 }
                 Serial.println("Feed motor hit home switch.");
                 feedHomingSubStep = 2;
@@ -156,7 +161,7 @@ void ReturningYes2x4State::handleReturningYes2x4FeedMotorHoming(StateManager& st
         case 2: // Wait for motor to stop, then move to -0.2 inch from switch
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("RETURNING_YES_2x4 Feed Motor Homing Step 2: Moving to -0.2 inch from home switch to establish working zero.");
-                feedMotor->moveTo(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH - 0.1 * FEED_MOTOR_STEPS_PER_INCH);
+                feedMotor->moveTo(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH - 0.1 * FEED_MOTOR_STEPS_PER_INCH);
                 feedHomingSubStep = 3;
             }
             break;
@@ -164,7 +169,8 @@ void ReturningYes2x4State::handleReturningYes2x4FeedMotorHoming(StateManager& st
         case 3: // Wait for positioning move to complete, then set new zero
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("RETURNING_YES_2x4 Feed Motor Homing Step 3: Setting new working zero position.");
-                feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH); // Set this position as the new zero
+                feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH); // Set this position as the new zero
+                rebaseStepPulseCheck(feedMotor);
                 Serial.println("Feed motor homed: 0.2 inch from switch set as position 0.");
                 
                 configureFeedMotorForNormalOperation();
@@ -176,16 +182,15 @@ void ReturningYes2x4State::handleReturningYes2x4FeedMotorHoming(StateManager& st
             Serial.println("RETURNING_YES_2x4 Feed Motor Homing Step 4: Homing sequence complete.");
             extend2x4SecureClamp(); 
             Serial.println("2x4 secure clamp engaged."); 
-            turnYellowLedOff();
             stateManager.setCuttingCycleInProgress(false);
             
             // Check if start cycle switch is active for continuous operation
-            if (stateManager.getStartCycleSwitch()->read() == HIGH && stateManager.getStartSwitchSafe()) {
+            if (stateManager.getStartCycleSwitch()->read() == HIGH && stateManager.getStartSwitchSafe() &&
+                mayStartCycle()) {
                 Serial.println("Start cycle switch is active - continuing with another cut cycle.");
                 // Prepare for next cycle
                 extendFeedClamp();
                 configureCutMotorForCutting(); // Ensure cut motor is set to proper cutting speed
-                turnYellowLedOn();
                 stateManager.setCuttingCycleInProgress(true);
                 stateManager.changeState(CUTTING);
                 resetSteps();
@@ -202,4 +207,6 @@ void ReturningYes2x4State::handleReturningYes2x4FeedMotorHoming(StateManager& st
 void ReturningYes2x4State::resetSteps() {
     returningYes2x4SubStep = 0;
     feedHomingSubStep = 0;
+    cutHomeRecovery.cancel();
+    strokeLostSteps = false;
 } 
\ No newline at end of file
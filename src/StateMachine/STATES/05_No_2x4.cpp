@@ -1,6 +1,9 @@
 #include "StateMachine/05_No_2x4.h"
 #include "StateMachine/StateManager.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/99_STROKE_MONITOR_FUNCTIONS.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
 #include "Config/Pins_Definitions.h"
 
 //* ************************************************************************
@@ -9,6 +12,9 @@
 // Handles the RETURNING_NO_2x4 cutting sequence when no wood is detected.
 // This state manages the multi-step process for handling material that doesn't trigger the wood sensor.
 
+// Time allowed for a clamp cylinder to finish moving before the next step
+static const unsigned long CYLINDER_ACTION_DELAY_MS = 150;
+
 void ReturningNo2x4State::execute(StateManager& stateManager) {
     handleReturningNo2x4Sequence(stateManager);
 }
@@ -20,13 +26,16 @@ void ReturningNo2x4State::onEnter(StateManager& stateManager) {
     Serial.println("RETURNING_NO_2x4 state - Wood sensor reads HIGH. Starting RETURNING_NO_2x4 Sequence.");
     configureCutMotorForReturn();
     moveCutMotorToHome();
+    beginCutStrokeReturn(stateManager.getCutMotor()); // Track switch timing for missed-step detection
     configureFeedMotorForNormalOperation();
     
     // Initialize step tracking
     returningNo2x4Step = 0;
     returningNo2x4HomingSubStep = 0;
-    cylinderActionTime = 0;
+    cancelTimer(cylinderTimer);
+    cylinderSettled = false;
     waitingForCylinder = false;
+    cutHomeRecovery.cancel();
 }
 
 void ReturningNo2x4State::onExit(StateManager& stateManager) {
@@ -36,9 +45,7 @@ void ReturningNo2x4State::onExit(StateManager& stateManager) {
 
 void ReturningNo2x4State::handleReturningNo2x4Sequence(StateManager& stateManager) {
     // RETURNING_NO_2x4 sequence logic
-    FastAccelStepper* cutMotor = stateManager.getCutMotor();
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
-    const unsigned long CYLINDER_ACTION_DELAY_MS = 150;
     
     if (returningNo2x4Step == 0) { // First time entering this specific RETURNING_NO_2x4 logic path
         Serial.println("RETURNING_NO_2x4 Step 0: Initiating feed motor to home & retracting 2x4 secure clamp.");
@@ -54,7 +61,7 @@ void ReturningNo2x4State::handleReturningNo2x4Sequence(StateManager& stateManage
         returningNo2x4Step = 1;
     }
 
-    if (waitingForCylinder && (millis() - cylinderActionTime >= CYLINDER_ACTION_DELAY_MS)) {
+    if (waitingForCylinder && cylinderSettled) {
         waitingForCylinder = false;
         returningNo2x4Step++; 
     }
@@ -67,14 +74,19 @@ void ReturningNo2x4State::handleReturningNo2x4Sequence(StateManager& stateManage
 void ReturningNo2x4State::handleReturningNo2x4Step(StateManager& stateManager, int step) {
     FastAccelStepper* cutMotor = stateManager.getCutMotor();
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
-    extern const float FEED_TRAVEL_DISTANCE; // From main.cpp
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Active job profile
     
     switch (step) { 
         case 1: // New Step: Wait for cut motor, then extend feed clamp
             if (cutMotor && !cutMotor->isRunning()) {
                 Serial.println("RETURNING_NO_2x4 Step 1: Cut motor returned home. Extending feed clamp.");
+                StrokeVerdict strokeVerdict = finishCutStrokeReturn();
+                recordAdaptiveCutOutcome(strokeVerdict);
+                if (strokeVerdict == STROKE_LOST_STEPS) {
+                    Serial.println("RETURNING_NO_2x4 Step 1: Lost cut motor steps detected - position is re-zeroed by the home switch check in step 8.");
+                }
                 extendFeedClamp();
-                cylinderActionTime = millis();
+                cylinderTimer = scheduleFlagTimerMs(CYLINDER_ACTION_DELAY_MS, &cylinderSettled);
                 waitingForCylinder = true; // Will cause returningNo2x4Step to increment to 2 after delay
             }
             break;
@@ -83,23 +95,25 @@ void ReturningNo2x4State::handleReturningNo2x4Step(StateManager& stateManager, i
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("RETURNING_NO_2x4 Step 2: Feed motor at home. Disengaging feed clamp."); 
                 retractFeedClamp();
-                cylinderActionTime = millis();
+                cylinderTimer = scheduleFlagTimerMs(CYLINDER_ACTION_DELAY_MS, &cylinderSettled);
                 waitingForCylinder = true; // Increments to 3
             }
             break;
             
         case 3: // Was original returningNo2x4Step 2: move feed motor to 2.0 inches
-            Serial.println("RETURNING_NO_2x4 Step 3: Moving feed motor to 2.0 inches."); 
+            Serial.print("RETURNING_NO_2x4 Step 3: Moving feed motor to regrip position ");
+            Serial.print(getActiveJobProfile().noWoodRegripInches);
+            Serial.println(" inches.");
             configureFeedMotorForNormalOperation(); // Ensure correct config
-            moveFeedMotorToPosition(2.0);
+            moveFeedMotorToPosition(getActiveJobProfile().noWoodRegripInches);
             returningNo2x4Step = 4; // Directly advance step here as it's a command
             break;
             
         case 4: // Was original returningNo2x4Step 3: wait for feed motor at 2.0, extend feed clamp
             if (feedMotor && !feedMotor->isRunning()) {
-                Serial.println("RETURNING_NO_2x4 Step 4: Feed motor at 2.0 inches. Extending feed clamp."); 
+                Serial.println("RETURNING_NO_2x4 Step 4: Feed motor at regrip position. Extending feed clamp.");
                 extendFeedClamp();
-                cylinderActionTime = millis();
+                cylinderTimer = scheduleFlagTimerMs(CYLINDER_ACTION_DELAY_MS, &cylinderSettled);
                 waitingForCylinder = true; // Increments to 5
             }
             break;
@@ -115,46 +129,32 @@ void ReturningNo2x4State::handleReturningNo2x4Step(StateManager& stateManager, i
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("RETURNING_NO_2x4 Step 6: Feed motor at home. Disengaging feed clamp."); 
                 retractFeedClamp();
-                cylinderActionTime = millis();
+                cylinderTimer = scheduleFlagTimerMs(CYLINDER_ACTION_DELAY_MS, &cylinderSettled);
                 waitingForCylinder = true; // Increments to 7
             }
             break;
             
         case 7: // Was original returningNo2x4Step 6: move feed motor to final position
-            Serial.println("RETURNING_NO_2x4 Step 7: Moving feed motor to final position (FEED_TRAVEL_DISTANCE).");
+            Serial.println("RETURNING_NO_2x4 Step 7: Moving feed motor to final position (profile feed travel).");
             configureFeedMotorForNormalOperation();
-            moveFeedMotorToPosition(FEED_TRAVEL_DISTANCE);
+            moveFeedMotorToPosition(feedTravelInches);
             returningNo2x4Step = 8; // Directly advance step
             break;
             
         case 8: // Was original returningNo2x4Step 7: wait for motor, check cut home, start feed motor homing
-            if (feedMotor && !feedMotor->isRunning()) {
+            if (!cutHomeRecovery.isActive()) {
+                if (!feedMotor || feedMotor->isRunning()) break;
                 Serial.println("RETURNING_NO_2x4 Step 8: Feed motor at final position."); 
-                bool sensorDetectedHome = false;
-                Serial.println("RETURNING_NO_2x4 Step 8: Checking cut motor position switch."); 
-                for (int i = 0; i < 3; i++) {
-                    delay(30);  
-                    stateManager.getCutHomingSwitch()->update();
-                    bool sensorReading = stateManager.getCutHomingSwitch()->read();
-                    Serial.print("Cut position switch read attempt "); 
-                    Serial.print(i+1); 
-                    Serial.print(" of 3: "); 
-                    Serial.print(sensorReading ? "HIGH" : "LOW");
-                    Serial.print(" (raw: ");
-                    Serial.print(sensorReading);
-                    Serial.println(")");
-                    
-                    if (sensorReading == HIGH) {
-                        sensorDetectedHome = true;
-                        if (cutMotor) cutMotor->setCurrentPosition(0); 
-                        Serial.println("Cut motor position switch detected HIGH during RETURNING_NO_2x4 sequence completion.");
-                        break;  
-                    }
-                }
+                cutHomeRecovery.begin("RETURNING_NO_2x4 Step 8", FLIGHT_TRIGGER_NO_2X4_HOME_CHECK);
+            }
+
+            {
+                CutHomeRecoveryStatus homeStatus = cutHomeRecovery.update();
+                if (homeStatus == CUT_HOME_IN_PROGRESS) break;
                 
                 // TEMPORARY FIX: Always proceed regardless of sensor to identify the issue
-                if (!sensorDetectedHome) {
-                    Serial.println("DIAGNOSTIC: Cut motor home sensor did NOT detect HIGH.");
+                if (homeStatus == CUT_HOME_FAILED) {
+                    Serial.println("DIAGNOSTIC: Cut motor home sensor did NOT detect HIGH, even after recovery.");
                     Serial.println("DIAGNOSTIC: Proceeding anyway to test if sensor logic is inverted.");
                     Serial.println("DIAGNOSTIC: If cut motor is physically at home, sensor logic may need inversion.");
                 } else {
@@ -185,7 +185,7 @@ void ReturningNo2x4State::handleReturningNo2x4Step(StateManager& stateManager, i
 void ReturningNo2x4State::handleReturningNo2x4FeedMotorHoming(StateManager& stateManager) {
     FastAccelStepper* feedMotor = stateManager.getFeedMotor();
     extern const float FEED_MOTOR_HOMING_SPEED; // From main.cpp
-    extern const float FEED_TRAVEL_DISTANCE; // From main.cpp
+    const float feedTravelInches = getActiveJobProfile().feedTravelInches; // Active job profile
     extern const int FEED_MOTOR_STEPS_PER_INCH; // From main.cpp
     
     // Non-blocking feed motor homing sequence for RETURNING_NO_2x4
@@ -205,7 +205,8 @@ void ReturningNo2x4State::handleReturningNo2x4FeedMotorHoming(StateManager& stat
                 Serial.println("RETURNING_NO_2x4 Feed Motor Homing Step 9.1: Home switch triggered. Stopping motor.");
                 if (feedMotor) {
                     feedMotor->stopMove();
-                    feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH);
+                    feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH);
+                    rebaseStepPulseCheck(feedMotor); // Still decelerating
                 }
                 Serial.println("RETURNING_NO_2x4: Feed motor hit home switch.");
                 returningNo2x4HomingSubStep = 2;
@@ -215,7 +216,7 @@ void ReturningNo2x4State::handleReturningNo2x4FeedMotorHoming(StateManager& stat
         case 2: // Wait for motor to stop, then move to -0.1 inch from switch
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("RETURNING_NO_2x4 Feed Motor Homing Step 9.2: Moving to -0.1 inch from home switch to establish working zero.");
-                feedMotor->moveTo(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH - 0.1 * FEED_MOTOR_STEPS_PER_INCH);
+                feedMotor->moveTo(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH - 0.1 * FEED_MOTOR_STEPS_PER_INCH);
                 returningNo2x4HomingSubStep = 3;
             }
             break;
@@ -223,7 +224,8 @@ void ReturningNo2x4State::handleReturningNo2x4FeedMotorHoming(StateManager& stat
         case 3: // Wait for positioning move to complete, then set new zero
             if (feedMotor && !feedMotor->isRunning()) {
                 Serial.println("RETURNING_NO_2x4 Feed Motor Homing Step 9.3: Setting new working zero position.");
-                feedMotor->setCurrentPosition(FEED_TRAVEL_DISTANCE * FEED_MOTOR_STEPS_PER_INCH); // Set this position as the new zero
+                feedMotor->setCurrentPosition(feedTravelInches * FEED_MOTOR_STEPS_PER_INCH); // Set this position as the new zero
+                rebaseStepPulseCheck(feedMotor);
                 Serial.println("RETURNING_NO_2x4: Feed motor homed: 0.1 inch from switch set as position 0.");
                 
                 configureFeedMotorForNormalOperation();
@@ -238,8 +240,6 @@ void ReturningNo2x4State::handleReturningNo2x4FeedMotorHoming(StateManager& stat
             Serial.println("2x4 secure clamp disengaged (final check in RETURNING_NO_2x4)."); 
             extend2x4SecureClamp(); 
             Serial.println("2x4 secure clamp engaged."); 
-            turnYellowLedOff();
-            turnBlueLedOn(); 
 
             resetSteps();
             stateManager.setCuttingCycleInProgress(false);
@@ -261,6 +261,8 @@ void ReturningNo2x4State::handleReturningNo2x4FeedMotorHoming(StateManager& stat
 void ReturningNo2x4State::resetSteps() {
     returningNo2x4Step = 0;
     returningNo2x4HomingSubStep = 0;
-    cylinderActionTime = 0;
+    cancelTimer(cylinderTimer);
+    cylinderSettled = false;
     waitingForCylinder = false;
+    cutHomeRecovery.cancel();
 } 
\ No newline at end of file
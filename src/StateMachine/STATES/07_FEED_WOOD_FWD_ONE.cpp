@@ -7,90 +7,38 @@
 //* ************************************************************************
 // Handles the feed wood forward one sequence when fix position switch is pressed
 // in idle state AND 2x4 sensor reads LOW.
+// The steps are the feed_wood_fwd_one sequence (tools/sequences/feed_wood_fwd_one.seq);
+// its exit code picks CUTTING or IDLE.
 
 void FeedWoodFwdOneState::execute(StateManager& stateManager) {
-    executeStep(stateManager);
+    SequenceStatus status = sequence.update();
+    if (status == SEQUENCE_RUNNING) return;
+
+    if (status == SEQUENCE_FAILED) {
+        Serial.print("FeedWoodFwdOne: Sequence failed - ");
+        Serial.println(sequence.getFailureReason());
+        extend2x4SecureClamp(); // Hold the wood like the other paths into ERROR
+        stateManager.changeState(ERROR);
+        return;
+    }
+
+    if (sequence.getExitCode() == SEQUENCE_EXIT_CUT) {
+        Serial.println("FeedWoodFwdOne: Start cycle switch HIGH - transitioning to CUTTING state");
+        stateManager.changeState(CUTTING);
+        stateManager.setCuttingCycleInProgress(true);
+        configureCutMotorForCutting();
+        extendFeedClamp();
+    } else {
+        Serial.println("FeedWoodFwdOne: Start cycle switch LOW - transitioning to IDLE state");
+        stateManager.changeState(IDLE);
+    }
 }
 
 void FeedWoodFwdOneState::onEnter(StateManager& stateManager) {
-    currentStep = RETRACT_FEED_CLAMP;
-    stepStartTime = 0;
     Serial.println("FeedWoodFwdOne: Starting feed wood forward one sequence");
+    sequence.begin("FeedWoodFwdOne", SEQUENCE_FEED_WOOD_FWD_ONE);
 }
 
 void FeedWoodFwdOneState::onExit(StateManager& stateManager) {
-    currentStep = RETRACT_FEED_CLAMP;
-    stepStartTime = 0;
-    Serial.println("FeedWoodFwdOne: Feed clamp retracted");
+    sequence.cancel(); // Only stops the feed motor if the sequence was cut short
 }
-
-void FeedWoodFwdOneState::executeStep(StateManager& stateManager) {
-    FastAccelStepper* feedMotor = stateManager.getFeedMotor();
-    extern const float FEED_TRAVEL_DISTANCE;
-
-    switch (currentStep) {
-        case RETRACT_FEED_CLAMP:
-            retractFeedClamp();
-            Serial.println("FeedWoodFwdOne: Feed clamp retracted");
-            advanceToNextStep(stateManager);
-            break;
-
-        case MOVE_POSITION_MOTOR_TO_ZERO:
-            if (feedMotor && !feedMotor->isRunning()) {
-                moveFeedMotorToHome();
-                Serial.println("FeedWoodFwdOne: Moving feed motor to 0");
-                advanceToNextStep(stateManager);
-            }
-            break;
-
-        case EXTEND_FEED_CLAMP_RETRACT_SECURE:
-            if (feedMotor && !feedMotor->isRunning()) {
-                //! STEP 3: EXTEND FEED CLAMP AND RETRACT SECURE WOOD CLAMP
-                extendFeedClamp();
-                retract2x4SecureClamp();
-                Serial.println("FeedWoodFwdOne: Feed clamp extended, secure 2x4 clamp retracted");
-                stepStartTime = millis();
-                advanceToNextStep(stateManager);
-            }
-            break;
-
-        case WAIT_200MS:
-            if (millis() - stepStartTime >= 200) {
-                Serial.println("FeedWoodFwdOne: Waiting 200ms");
-                advanceToNextStep(stateManager);
-            }
-            break;
-
-        case MOVE_TO_TRAVEL_DISTANCE:
-            if (feedMotor && !feedMotor->isRunning()) {
-                moveFeedMotorToPosition(FEED_TRAVEL_DISTANCE);
-                Serial.println("FeedWoodFwdOne: Moving feed motor to travel distance");
-                advanceToNextStep(stateManager);
-            }
-            break;
-
-        case CHECK_START_CYCLE_SWITCH:
-            if (feedMotor && !feedMotor->isRunning()) {
-                Serial.println("FeedWoodFwdOne: Checking start cycle switch for next state");
-                
-                // Check the start cycle switch state
-                if (stateManager.getStartCycleSwitch()->read() == HIGH) {
-                    Serial.println("FeedWoodFwdOne: Start cycle switch HIGH - transitioning to CUTTING state");
-                    stateManager.changeState(CUTTING);
-                    stateManager.setCuttingCycleInProgress(true);
-                    configureCutMotorForCutting();
-                    turnYellowLedOn();
-                    extendFeedClamp();
-                } else {
-                    Serial.println("FeedWoodFwdOne: Start cycle switch LOW - transitioning to IDLE state");
-                    stateManager.changeState(IDLE);
-                }
-            }
-            break;
-    }
-}
-
-void FeedWoodFwdOneState::advanceToNextStep(StateManager& stateManager) {
-    currentStep = static_cast<FeedWoodFwdOneStep>(static_cast<int>(currentStep) + 1);
-    stepStartTime = 0; // Reset step timer
-} 
\ No newline at end of file
@@ -10,6 +10,22 @@
 #include "ErrorStates/standard_error.h"
 #include "ErrorStates/error_reset.h"
 #include "ErrorStates/suction_error_hold.h"
+#include "StateMachine/99_SERVO_MOTION_FUNCTIONS.h"
+#include "Outputs/output_shadow.h"
+#include "StateMachine/99_STROKE_MONITOR_FUNCTIONS.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+#include "StateMachine/StateTransitions.h"
+#include "StateMachine/99_CUT_HOME_LIMIT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "Journal/fault_journal.h"
+#include "InputTrace/input_trace.h"
+#include "OTAUpdater/ota_health_check.h"
+#include "OTAUpdater/ota_updater.h"
+#include "Diagnostics/loop_profiler.h"
+#include "Diagnostics/boot_timing.h"
+#include "Diagnostics/memory_monitor.h"
+#include "Watchdog/watchdog_supervisor.h"
 #include <memory>
 
 //* ************************************************************************
@@ -30,18 +46,56 @@ static CuttingState cuttingState;
 static ReturningYes2x4State returningYes2x4State;
 static ReturningNo2x4State returningNo2x4State;
 
-StateManager::StateManager() : previousState(ERROR_RESET) {
+StateManager::StateManager()
+    : previousState(ERROR_RESET), ledStatusState(STARTUP), enteredState(ERROR_RESET),
+      inputEventsPrimed(false), cutMotorWasRunning(false), feedMotorWasRunning(false),
+      last2x4SensorLevel(false), lastSuctionSensorLevel(false) {
     // Constructor - previousState initialized to different state to ensure first print
+    // enteredState differs from STARTUP so the first tick posts STATE_ENTERED
+}
+
+// Boot timing milestones on the control path; the summary prints once on first reaching IDLE
+static void markBootStateReached(SystemState state) {
+    if (state == HOMING) {
+        markBootPhase(BOOT_PHASE_HOMING_STARTED);
+    } else if (state == IDLE && markBootPhase(BOOT_PHASE_IDLE)) {
+        printBootTiming();
+    }
 }
 
 void StateManager::execute() {
-    handleCommonOperations();
+    {
+        LoopProfileScope commonProfile(LOOP_SECTION_COMMON);
+        handleCommonOperations();
+    }
+    
+    // setup() assigns the initial state directly, so pick up its LED status
+    // and post its entry event on the first tick
+    if (currentState != ledStatusState) {
+        applyLedStatusForState(currentState);
+    }
+    if (currentState != enteredState) {
+        journalStateChange(enteredState, currentState);
+        noteInputTraceState(enteredState, currentState);
+        enteredState = currentState;
+        postEvent(EVENT_STATE_ENTERED, currentState);
+        markBootStateReached(currentState);
+    }
+    checkStateInvariants(currentState);
     
-    // Update error LED blinking for ERROR state
-    if (currentState == ERROR) {
-        handleErrorLedBlink();
+    // A machine sitting in IDLE is between cycles
+    if (currentState == IDLE) {
+        applyJobProfileAtCycleBoundary();
     }
     
+    // Event-driven states only run through their event handlers
+    dispatchEvents();
+    if (!stateRequiresPolling(currentState)) {
+        flushOutputs();
+        return;
+    }
+    
+    LoopProfileScope stateProfile(LOOP_SECTION_STATE_FIRST + currentState);
     switch (currentState) {
         case STARTUP:
             startupState.execute(*this);
@@ -74,13 +128,23 @@ void StateManager::execute() {
             handleErrorResetState();
             break;
         case SUCTION_ERROR_HOLD:
-            handleSuctionErrorHoldState();
-            break;
+            break; // Event-driven
     }
+    
+    // Drive every output that changed during this tick
+    flushOutputs();
 }
 
 void StateManager::changeState(SystemState newState) {
     if (currentState != newState) {
+        // No motion while an upload is writing flash
+        if (!beginOtaGuardedTransition(currentState, newState)) {
+            Serial.printf("State change %s -> %s refused - OTA update in progress.\n",
+                          getSystemStateName(currentState), getSystemStateName(newState));
+            return;
+        }
+        checkStateTransition(currentState, newState);
+        
         // Call onExit for the current state before changing
         switch (currentState) {
             case STARTUP: startupState.onExit(*this); break;
@@ -97,6 +161,19 @@ void StateManager::changeState(SystemState newState) {
         
         previousState = currentState;
         currentState = newState;
+        endOtaGuardedTransition();
+        journalStateChange(previousState, newState);
+        noteInputTraceState(previousState, newState);
+        
+        // Entering IDLE or CUTTING is a cycle boundary - swap in a staged job profile
+        if (newState == IDLE || newState == CUTTING) {
+            applyJobProfileAtCycleBoundary();
+        }
+        
+        applyLedStatusForState(newState);
+        enteredState = newState;
+        postEvent(EVENT_STATE_ENTERED, newState);
+        markBootStateReached(newState);
         
         // Call onEnter for the new state after changing
         switch (newState) {
@@ -129,27 +206,96 @@ void StateManager::changeState(SystemState newState) {
     }
 }
 
+void StateManager::applyLedStatusForState(SystemState state) {
+    ledStatusState = state;
+    switch (state) {
+        case STARTUP: setLedStatus(LED_STATUS_STARTUP); break;
+        case HOMING: setLedStatus(LED_STATUS_HOMING); break;
+        case IDLE: setLedStatus(LED_STATUS_IDLE); break;
+        case FEED_FIRST_CUT: setLedStatus(LED_STATUS_FEEDING); break;
+        case FEED_WOOD_FWD_ONE: setLedStatus(LED_STATUS_FEEDING); break;
+        case CUTTING: setLedStatus(LED_STATUS_CUTTING); break;
+        case RETURNING_YES_2x4: setLedStatus(LED_STATUS_CUTTING); break;
+        case RETURNING_NO_2x4: setLedStatus(LED_STATUS_CUTTING_NO_WOOD); break;
+        case ERROR: setLedStatus(LED_STATUS_ERROR); break;
+        case ERROR_RESET: setLedStatus(LED_STATUS_OFF); break;
+        case SUCTION_ERROR_HOLD: setLedStatus(LED_STATUS_SUCTION_ERROR); break;
+    }
+}
+
+bool StateManager::applyJobProfileAtCycleBoundary() {
+    if (!isJobProfileChangePending()) return false;
+    // Never swap under a moving axis; the change stays staged until both motors stop
+    if ((cutMotor && cutMotor->isRunning()) || (feedMotor && feedMotor->isRunning())) return false;
+    
+    float previousFeedTravel = getActiveJobProfile().feedTravelInches;
+    if (!applyPendingJobProfile()) return false;
+    
+    // The feed home switch sits at the profile feed travel, so shift the feed
+    // position reference by the change in travel
+    float travelChange = getActiveJobProfile().feedTravelInches - previousFeedTravel;
+    if (feedMotor && travelChange != 0.0f) {
+        feedMotor->setCurrentPosition(feedMotor->getCurrentPosition() + lroundf(travelChange * FEED_MOTOR_STEPS_PER_INCH));
+    }
+    configureCutMotorForCutting(); // Pick up the new profile cut speed
+    return true;
+}
+
+void StateManager::dispatchEvents() {
+    MachineEvent event;
+    // A handler may change state; later events go to the state it entered
+    while (popEvent(event)) {
+        switch (currentState) {
+            case STARTUP: startupState.onEvent(*this, event); break;
+            case HOMING: homingState.onEvent(*this, event); break;
+            case IDLE: idleState.onEvent(*this, event); break;
+            case FEED_FIRST_CUT: break; // Sequence runners poll every tick
+            case FEED_WOOD_FWD_ONE: break;
+            case CUTTING: cuttingState.onEvent(*this, event); break;
+            case RETURNING_YES_2x4: returningYes2x4State.onEvent(*this, event); break;
+            case RETURNING_NO_2x4: returningNo2x4State.onEvent(*this, event); break;
+            case ERROR: handleStandardErrorEvent(event); break;
+            case ERROR_RESET: break;
+            case SUCTION_ERROR_HOLD: handleSuctionErrorHoldEvent(event); break;
+        }
+    }
+}
+
+bool StateManager::stateRequiresPolling(SystemState state) const {
+    switch (state) {
+        case IDLE: return idleState.requiresPolling();
+        // Waits for the start switch edge
+        case SUCTION_ERROR_HOLD: return false;
+        // ERROR re-asserts the motor stop every tick; ERROR_RESET runs once
+        default: return true;
+    }
+}
+
 void StateManager::printStateChange() {
     if (currentState != previousState) {
         Serial.print("Current State: ");
-        switch (currentState) {
-            case STARTUP: Serial.println("STARTUP"); break;
-            case HOMING: Serial.println("HOMING"); break;
-            case IDLE: Serial.println("IDLE"); break;
-            case FEED_FIRST_CUT: Serial.println("FEED_FIRST_CUT"); break;
-            case FEED_WOOD_FWD_ONE: Serial.println("FEED_WOOD_FWD_ONE"); break;
-            case CUTTING: Serial.println("CUTTING"); break;
-            case RETURNING_YES_2x4: Serial.println("RETURNING_YES_2x4"); break;
-            case RETURNING_NO_2x4: Serial.println("RETURNING_NO_2x4"); break;
-            case ERROR: Serial.println("ERROR"); break;
-            case ERROR_RESET: Serial.println("ERROR_RESET"); break;
-            case SUCTION_ERROR_HOLD: Serial.println("SUCTION_ERROR_HOLD"); break;
-            default: Serial.println("UNKNOWN"); break;
-        }
+        Serial.println(getSystemStateName(currentState));
         previousState = currentState;
     }
 }
 
+const char* getSystemStateName(SystemState state) {
+    switch (state) {
+        case STARTUP: return "STARTUP";
+        case HOMING: return "HOMING";
+        case IDLE: return "IDLE";
+        case FEED_FIRST_CUT: return "FEED_FIRST_CUT";
+        case FEED_WOOD_FWD_ONE: return "FEED_WOOD_FWD_ONE";
+        case CUTTING: return "CUTTING";
+        case RETURNING_YES_2x4: return "RETURNING_YES_2x4";
+        case RETURNING_NO_2x4: return "RETURNING_NO_2x4";
+        case ERROR: return "ERROR";
+        case ERROR_RESET: return "ERROR_RESET";
+        case SUCTION_ERROR_HOLD: return "SUCTION_ERROR_HOLD";
+        default: return "UNKNOWN";
+    }
+}
+
 void StateManager::updateSwitches() {
     // Update all debounced switches - moved from main loop
     cutHomingSwitch.update();
@@ -159,36 +305,102 @@ void StateManager::updateSwitches() {
     pushwoodForwardSwitch.update();
 }
 
+void StateManager::postInputEvents() {
+    extern const int _2x4_PRESENT_SENSOR; // This is in main.cpp
+    extern const int WOOD_SUCTION_CONFIRM_SENSOR; // This is in main.cpp
+    bool _2x4SensorLevel = digitalRead(_2x4_PRESENT_SENSOR) == HIGH;
+    bool suctionSensorLevel = digitalRead(WOOD_SUCTION_CONFIRM_SENSOR) == HIGH;
+    bool cutMotorRunning = cutMotor && cutMotor->isRunning();
+    bool feedMotorRunning = feedMotor && feedMotor->isRunning();
+    
+    if (inputEventsPrimed) {
+        // Switch edges
+        Bounce* switches[] = { &cutHomingSwitch, &feedHomingSwitch, &reloadSwitch, &startCycleSwitch, &pushwoodForwardSwitch };
+        const EventSwitch switchIds[] = { EVENT_SWITCH_CUT_HOME, EVENT_SWITCH_FEED_HOME, EVENT_SWITCH_RELOAD,
+                                          EVENT_SWITCH_START_CYCLE, EVENT_SWITCH_MANUAL_FEED };
+        for (size_t i = 0; i < sizeof(switchIds) / sizeof(switchIds[0]); i++) {
+            if (switches[i]->rose()) postEvent(EVENT_SWITCH_ROSE, switchIds[i]);
+            if (switches[i]->fell()) postEvent(EVENT_SWITCH_FELL, switchIds[i]);
+        }
+        
+        // Sensor level changes
+        if (_2x4SensorLevel != last2x4SensorLevel) {
+            postEvent(EVENT_SENSOR_CHANGED, EVENT_SENSOR_2X4_PRESENT, _2x4SensorLevel ? HIGH : LOW);
+        }
+        if (suctionSensorLevel != lastSuctionSensorLevel) {
+            postEvent(EVENT_SENSOR_CHANGED, EVENT_SENSOR_WOOD_SUCTION, suctionSensorLevel ? HIGH : LOW);
+        }
+        
+        // Motor move completion (running -> stopped)
+        if (cutMotorWasRunning && !cutMotorRunning) {
+            postEvent(EVENT_MOTOR_DONE, EVENT_MOTOR_CUT, (int16_t)constrain(cutMotor->getCurrentPosition(), -32768L, 32767L));
+        }
+        if (feedMotorWasRunning && !feedMotorRunning) {
+            postEvent(EVENT_MOTOR_DONE, EVENT_MOTOR_FEED, (int16_t)constrain(feedMotor->getCurrentPosition(), -32768L, 32767L));
+        }
+    }
+    
+    inputEventsPrimed = true;
+    last2x4SensorLevel = _2x4SensorLevel;
+    lastSuctionSensorLevel = suctionSensorLevel;
+    cutMotorWasRunning = cutMotorRunning;
+    feedMotorWasRunning = feedMotorRunning;
+}
+
 void StateManager::handleCommonOperations() {
     // Update all switches first
     updateSwitches();
+    postInputEvents();
+    
+    // Run expired timeouts (TA signal, rotation clamp, servo release, state waits)
+    serviceTimerWheel();
+    
+    // Snapshot inputs and positions for the fault journal
+    serviceFaultJournal();
+    feedHeartbeat(HEARTBEAT_LOGGING);
+    
+    // Confirm or roll back an image fresh from OTA
+    serviceOtaHealthCheck();
+    
+    // Heap and stack headroom
+    serviceMemoryMonitor();
+    
+    // Save a learned cut rate once both axes have stopped
+    serviceAdaptiveCut();
     
-    // Check for cut motor hitting home sensor during RETURNING_YES_2x4 return
-    extern bool cutMotorInReturningYes2x4Return; // This global flag is still in main.cpp
-    if (cutMotorInReturningYes2x4Return && cutMotor && cutMotor->isRunning() && cutHomingSwitch.read() == HIGH) {
-        Serial.println("Cut motor hit homing sensor during RETURNING_YES_2x4 return - stopping immediately!");
-        cutMotor->forceStopAndNewPosition(0);  // Stop immediately and set position to 0
+    // Cut carriage position and time at the home switch edge, as captured by its interrupt
+    int32_t cutHomeEdgeSteps;
+    int64_t cutHomeEdgeUs;
+    if (takeCutHomeEdge(cutHomeEdgeSteps, cutHomeEdgeUs)) {
+        noteCutStrokeHomeSwitch(cutHomeEdgeSteps, cutHomeEdgeUs);
     }
+    updateCutStrokeMonitor();
+    
+    // Reconcile emitted step pulses with each finished move (before the home limit re-zeroes the cut motor)
+    serviceStepPulseCheck();
+    
+    // Finish the home switch stop during the RETURNING_YES_2x4 return (started by the switch interrupt)
+    serviceCutHomeLimit(cutHomingSwitch.read() == HIGH);
+
+    // Advance rotation servo ramp and arrival estimate
+    rotationServoMotion.update();
 
-    // Handle rotation servo return after hold duration at active position AND when WAS_WOOD_SUCTIONED_SENSOR reads HIGH
-    if (rotationServoIsActiveAndTiming && millis() - rotationServoActiveStartTime >= ROTATION_SERVO_ACTIVE_HOLD_DURATION_MS) {
+    // Handle rotation servo return once the release timer has fired (servo arrived at the active
+    // position by speed model and the piece has had the release dwell) AND WAS_WOOD_SUCTIONED_SENSOR reads HIGH
+    if (rotationServoIsActiveAndTiming && isRotationServoReleaseDue()) {
         extern const int WOOD_SUCTION_CONFIRM_SENSOR; // This is in main.cpp
+        static unsigned long lastSuctionWaitLogTime = 0;
         if (digitalRead(WOOD_SUCTION_CONFIRM_SENSOR) == HIGH) {
             // Return rotation servo to home position
-            rotationServo.write(ROTATION_SERVO_HOME_POSITION);
-            Serial.println("Servo timing completed AND WAS_WOOD_SUCTIONED_SENSOR is HIGH, returning rotation servo to home.");
+            Serial.println("Servo release dwell completed AND WAS_WOOD_SUCTIONED_SENSOR is HIGH, returning rotation servo to home.");
+            handleRotationServoReturn();
             rotationServoIsActiveAndTiming = false; // Clear flag
-        } else {
+        } else if (millis() - lastSuctionWaitLogTime >= 500) {
             Serial.println("Waiting for WAS_WOOD_SUCTIONED_SENSOR to read HIGH before returning rotation servo...");
+            lastSuctionWaitLogTime = millis();
         }
     }
 
-    // Handle Rotation Clamp retraction after 1 second
-    if (rotationClampIsExtended && (millis() - rotationClampExtendTime >= ROTATION_CLAMP_EXTEND_DURATION_MS)) {
-        retractRotationClamp();
-        Serial.println("Rotation Clamp retracted after 1 second.");
-    }
-
     // 2x4 sensor - Update global _2x4Present flag
     extern const int _2x4_PRESENT_SENSOR; // This is in main.cpp
     _2x4Present = (digitalRead(_2x4_PRESENT_SENSOR) == LOW);
@@ -198,23 +410,9 @@ void StateManager::handleCommonOperations() {
         startSwitchSafe = true;
     }
     
-    // Handle error acknowledgment separately
-    if (reloadSwitch.rose() && currentState == ERROR) {
-        changeState(ERROR_RESET);
-        errorAcknowledged = true;
-    }
-    
     // Check for continuous mode activation/deactivation - modified to include safety check
     bool startSwitchOn = startCycleSwitch.read() == HIGH;
     if (startSwitchOn != continuousModeActive && startSwitchSafe) {
         continuousModeActive = startSwitchOn;
     }
-    
-    // Handle TA signal timeout after TA_SIGNAL_DURATION
-    if (signalTAActive && millis() - signalTAStartTime >= TA_SIGNAL_DURATION) {
-        extern const int TRANSFER_ARM_SIGNAL_PIN; // This is in main.cpp
-        digitalWrite(TRANSFER_ARM_SIGNAL_PIN, LOW); // Return to inactive state (LOW)
-        signalTAActive = false;
-        Serial.println("Signal to Transfer Arm (TA) timed out and reset to LOW"); 
-    }
 } 
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "StateMachine/StateTransitions.h"
+#include "StateMachine/StateManager.h"
+
+//* ************************************************************************
+//* ************************ STATE TRANSITIONS *****************************
+//* ************************************************************************
+
+#if STATE_TRANSITION_CHECKS
+static uint32_t undeclaredTransitions = 0;
+
+void checkStateTransition(SystemState from, SystemState to) {
+    if (from == to || isStateTransitionDeclared(from, to)) return;
+    undeclaredTransitions++;
+    Serial.print("UNDECLARED TRANSITION: ");
+    Serial.print(getSystemStateName(from));
+    Serial.print(" -> ");
+    Serial.print(getSystemStateName(to));
+    Serial.println(" (add it to STATE_TRANSITIONS)");
+}
+
+uint32_t getUndeclaredTransitionCount() {
+    return undeclaredTransitions;
+}
+#endif
+
+void formatStateGraphDot(String& out) {
+    out += "digraph stage1 {\n";
+    out += "    rankdir=LR;\n";
+    out += "    node [shape=box];\n";
+    out += "    STARTUP [style=bold];\n";
+    out += "    ERROR [color=red]; SUCTION_ERROR_HOLD [color=red];\n";
+    for (const StateTransition& transition : STATE_TRANSITIONS) {
+        out += "    ";
+        out += getSystemStateName(transition.from);
+        out += " -> ";
+        out += getSystemStateName(transition.to);
+        out += " [label=\"";
+        out += transition.reason;
+        out += "\"];\n";
+    }
+    out += "}\n";
+}
@@ -0,0 +1,127 @@
+#include "StatusLeds/led_pattern_engine.h"
+#include "Config/Pins_Definitions.h"
+#include "Outputs/output_shadow.h"
+#include "esp_timer.h"
+
+//* ************************************************************************
+//* ********************** LED PATTERN ENGINE *****************************
+//* ************************************************************************
+// Each status maps to a pattern of two LED masks and a half period.
+// A solid pattern has a zero half period; a blink alternates between the
+// primary mask and the alternate mask every half period. The esp_timer
+// callback only touches the LED pins when the displayed mask changes.
+
+// LED bit masks
+static const uint8_t LED_RED = 1 << 0;
+static const uint8_t LED_YELLOW = 1 << 1;
+static const uint8_t LED_GREEN = 1 << 2;
+static const uint8_t LED_BLUE = 1 << 3;
+
+// Pattern engine tick
+static const uint64_t LED_PATTERN_TICK_US = 50000; // 50ms
+
+// Notice flash: short enough that the status underneath still reads
+static const uint32_t LED_NOTICE_PERIOD_MS = 2000;
+static const uint32_t LED_NOTICE_FLASH_MS = 200;
+static const uint8_t LED_NOTICE_MASKS[LED_NOTICE_COUNT] = { 0, LED_BLUE, LED_RED | LED_BLUE };
+
+struct LedPattern {
+  uint8_t primaryMask;       // LEDs lit during the first half period (or always, if solid)
+  uint8_t alternateMask;     // LEDs lit during the second half period
+  uint16_t halfPeriodMs;     // 0 = solid
+  const char* name;
+};
+
+static const LedPattern LED_PATTERNS[LED_STATUS_COUNT] = {
+  { 0,                      0,          0,    "OFF" },
+  { LED_BLUE,               0,          0,    "STARTUP" },
+  { LED_BLUE,               0,          500,  "HOMING" },
+  { LED_GREEN,              0,          0,    "IDLE" },
+  { LED_BLUE,               0,          0,    "RELOAD" },
+  { LED_GREEN,              0,          0,    "FEEDING" },
+  { LED_YELLOW,             0,          0,    "CUTTING" },
+  { LED_YELLOW | LED_BLUE,  0,          0,    "CUTTING_NO_WOOD" },
+  { LED_RED,                LED_YELLOW, 250,  "ERROR" },
+  { LED_RED,                LED_YELLOW, 100,  "HOME_POSITION_ERROR" },
+  { LED_RED,                0,          1500, "SUCTION_ERROR" },
+};
+
+static volatile uint8_t activeStatus = LED_STATUS_OFF;
+static volatile uint32_t patternStartMs = 0;
+static volatile uint8_t activeNotice = LED_NOTICE_NONE;
+static uint8_t displayedMask = 0xFF; // Force the first write
+static esp_timer_handle_t ledPatternTimer = NULL;
+static uint64_t ledOutputMask = 0; // The timer flushes these pins and nothing else
+
+static void writeLedMask(uint8_t mask) {
+  setOutput(STATUS_LED_RED, (mask & LED_RED) ? HIGH : LOW);
+  setOutput(STATUS_LED_YELLOW, (mask & LED_YELLOW) ? HIGH : LOW);
+  setOutput(STATUS_LED_GREEN, (mask & LED_GREEN) ? HIGH : LOW);
+  setOutput(STATUS_LED_BLUE, (mask & LED_BLUE) ? HIGH : LOW);
+  flushOutputs(ledOutputMask);
+}
+
+static void ledPatternTimerCallback(void* arg) {
+  const LedPattern& pattern = LED_PATTERNS[activeStatus];
+  uint8_t mask = pattern.primaryMask;
+  if (pattern.halfPeriodMs > 0) {
+    uint32_t elapsed = millis() - patternStartMs;
+    if ((elapsed / pattern.halfPeriodMs) & 1) {
+      mask = pattern.alternateMask;
+    }
+  }
+  if (activeNotice != LED_NOTICE_NONE && millis() % LED_NOTICE_PERIOD_MS < LED_NOTICE_FLASH_MS) {
+    mask = LED_NOTICE_MASKS[activeNotice];
+  }
+
+  if (mask != displayedMask) {
+    writeLedMask(mask);
+    displayedMask = mask;
+  }
+}
+
+void beginLedPatternEngine() {
+  if (ledPatternTimer) return;
+  ledOutputMask = getOutputMask(STATUS_LED_RED) | getOutputMask(STATUS_LED_YELLOW) |
+                  getOutputMask(STATUS_LED_GREEN) | getOutputMask(STATUS_LED_BLUE);
+
+  const esp_timer_create_args_t timerArgs = {
+    .callback = &ledPatternTimerCallback,
+    .arg = NULL,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "led_pattern",
+    .skip_unhandled_events = true
+  };
+  if (esp_timer_create(&timerArgs, &ledPatternTimer) != ESP_OK ||
+      esp_timer_start_periodic(ledPatternTimer, LED_PATTERN_TICK_US) != ESP_OK) {
+    Serial.println("Failed to start LED pattern timer");
+    return;
+  }
+  ledPatternTimerCallback(NULL); // Show the current status immediately
+}
+
+void setLedStatus(LedStatus status) {
+  if (status == activeStatus || status >= LED_STATUS_COUNT) return;
+  patternStartMs = millis();
+  activeStatus = status;
+  Serial.print("LED status: ");
+  Serial.println(LED_PATTERNS[status].name);
+}
+
+LedStatus getLedStatus() {
+  return (LedStatus)activeStatus;
+}
+
+const char* getLedStatusName(LedStatus status) {
+  if (status >= LED_STATUS_COUNT) return "UNKNOWN";
+  return LED_PATTERNS[status].name;
+}
+
+void setLedNotice(LedNotice notice) {
+  if (notice >= LED_NOTICE_COUNT) return;
+  activeNotice = notice;
+}
+
+LedNotice getLedNotice() {
+  return (LedNotice)activeNotice;
+}
@@ -0,0 +1,282 @@
+#include "Timing/timer_wheel.h"
+#include "esp_timer.h"
+
+//* ************************************************************************
+//* ************************** TIMER WHEEL *********************************
+//* ************************************************************************
+// Four levels of 64 slots. A timer is placed on the lowest level whose span
+// covers its remaining ticks; whenever a level's index wraps, the next
+// level's current slot is cascaded down. Level 0 slots fire when reached.
+// Slots hold doubly linked lists of pool indices. Timers are scheduled and
+// serviced from the control loop only.
+//
+// Each level keeps a bitmap of its non-empty slots. The wheel steps straight
+// to the next tick that has work - a non-empty level-0 slot to fire or a
+// non-empty higher slot to cascade - so catching up after a long blocking
+// section costs O(levels) per occupied slot crossed, not per missed tick or
+// per pending timer. Timers stay in their slots while the wheel skips ahead.
+
+static const int TIMER_WHEEL_LEVELS = 4;
+static const int TIMER_WHEEL_SLOT_BITS = 6;
+static const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+static const uint64_t TIMER_WHEEL_SLOT_MASK = TIMER_WHEEL_SLOTS - 1;
+static const int16_t NO_TIMER = -1;
+
+struct TimerEntry {
+    uint64_t deadlineUs;
+    uint64_t deadlineTick;
+    TimerCallback callback;
+    void* context;
+    int16_t next;
+    int16_t prev;
+    uint8_t level;
+    uint8_t slot;
+    uint16_t generation;
+    bool active;
+};
+
+static TimerEntry timerPool[TIMER_WHEEL_POOL_SIZE];
+static int16_t wheelSlots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+static uint64_t occupiedSlots[TIMER_WHEEL_LEVELS];   // Bit per non-empty slot
+static TimerWheelStats wheelStats;
+static int16_t freeListHead = NO_TIMER;
+static uint64_t currentTick = 0;
+static size_t activeTimerCount = 0;
+static bool wheelInitialized = false;
+static TimerWheelClock wheelClock = nullptr;
+
+static uint64_t defaultClock() {
+    return (uint64_t)esp_timer_get_time();
+}
+
+uint64_t getTimerWheelTimeUs() {
+    return wheelClock ? wheelClock() : defaultClock();
+}
+
+static void initTimerWheel() {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            wheelSlots[level][slot] = NO_TIMER;
+        }
+        occupiedSlots[level] = 0;
+    }
+    for (size_t i = 0; i < TIMER_WHEEL_POOL_SIZE; i++) {
+        timerPool[i].active = false;
+        timerPool[i].generation = 1;
+        timerPool[i].next = (i + 1 < TIMER_WHEEL_POOL_SIZE) ? (int16_t)(i + 1) : NO_TIMER;
+    }
+    freeListHead = 0;
+    currentTick = getTimerWheelTimeUs() / TIMER_WHEEL_TICK_US;
+    activeTimerCount = 0;
+    wheelInitialized = true;
+}
+
+void setTimerWheelClock(TimerWheelClock clock) {
+    wheelClock = clock;
+    // Restart from the new time base; pending timers are dropped
+    initTimerWheel();
+}
+
+static void linkTimer(int16_t index) {
+    TimerEntry& entry = timerPool[index];
+    // Cascaded timers that are already due land in the slot about to fire
+    uint64_t delta = entry.deadlineTick > currentTick ? entry.deadlineTick - currentTick : 0;
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           delta >= (1ULL << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    // Deadlines beyond the top level alias into it and are re-placed on cascade
+    uint64_t slotTick = delta == 0 ? currentTick : entry.deadlineTick;
+    uint8_t slot = (slotTick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+
+    entry.level = level;
+    entry.slot = slot;
+    entry.prev = NO_TIMER;
+    entry.next = wheelSlots[level][slot];
+    if (entry.next != NO_TIMER) timerPool[entry.next].prev = index;
+    wheelSlots[level][slot] = index;
+    occupiedSlots[level] |= 1ULL << slot;
+}
+
+static void unlinkTimer(int16_t index) {
+    TimerEntry& entry = timerPool[index];
+    if (entry.prev != NO_TIMER) {
+        timerPool[entry.prev].next = entry.next;
+    } else {
+        wheelSlots[entry.level][entry.slot] = entry.next;
+        if (entry.next == NO_TIMER) occupiedSlots[entry.level] &= ~(1ULL << entry.slot);
+    }
+    if (entry.next != NO_TIMER) timerPool[entry.next].prev = entry.prev;
+    entry.next = NO_TIMER;
+    entry.prev = NO_TIMER;
+}
+
+static void releaseTimer(int16_t index) {
+    TimerEntry& entry = timerPool[index];
+    entry.active = false;
+    entry.generation++;
+    if (entry.generation == 0) entry.generation = 1;
+    entry.next = freeListHead;
+    freeListHead = index;
+    activeTimerCount--;
+}
+
+static int16_t indexFromHandle(TimerHandle handle) {
+    if (handle == INVALID_TIMER_HANDLE || !wheelInitialized) return NO_TIMER;
+    uint32_t index = (handle & 0xFFFF) - 1;
+    uint16_t generation = handle >> 16;
+    if (index >= TIMER_WHEEL_POOL_SIZE) return NO_TIMER;
+    const TimerEntry& entry = timerPool[index];
+    if (!entry.active || entry.generation != generation) return NO_TIMER;
+    return (int16_t)index;
+}
+
+TimerHandle scheduleTimerUs(uint64_t delayUs, TimerCallback callback, void* context) {
+    if (!wheelInitialized) initTimerWheel();
+    if (freeListHead == NO_TIMER || callback == nullptr) {
+        Serial.println("Timer wheel: no free timer - schedule request dropped");
+        return INVALID_TIMER_HANDLE;
+    }
+
+    int16_t index = freeListHead;
+    TimerEntry& entry = timerPool[index];
+    freeListHead = entry.next;
+
+    entry.deadlineUs = getTimerWheelTimeUs() + delayUs;
+    entry.deadlineTick = (entry.deadlineUs + TIMER_WHEEL_TICK_US - 1) / TIMER_WHEEL_TICK_US;
+    if (entry.deadlineTick <= currentTick) entry.deadlineTick = currentTick + 1; // Current slot already fired
+    entry.callback = callback;
+    entry.context = context;
+    entry.active = true;
+    activeTimerCount++;
+    linkTimer(index);
+
+    return ((uint32_t)entry.generation << 16) | (uint32_t)(index + 1);
+}
+
+static void postTimerEvent(void* context) {
+    postEvent(EVENT_TIMER_EXPIRED, (uint8_t)(uintptr_t)context);
+}
+
+TimerHandle scheduleEventTimerMs(unsigned long delayMs, EventTimer timerId) {
+    return scheduleTimerMs(delayMs, postTimerEvent, (void*)(uintptr_t)timerId);
+}
+
+static void setExpiredFlag(void* context) {
+    *static_cast<bool*>(context) = true;
+}
+
+TimerHandle scheduleFlagTimerMs(unsigned long delayMs, bool* expiredFlag) {
+    *expiredFlag = false;
+    return scheduleTimerMs(delayMs, setExpiredFlag, expiredFlag);
+}
+
+bool cancelTimer(TimerHandle& handle) {
+    int16_t index = indexFromHandle(handle);
+    handle = INVALID_TIMER_HANDLE;
+    if (index == NO_TIMER) return false;
+    unlinkTimer(index);
+    releaseTimer(index);
+    return true;
+}
+
+bool isTimerActive(TimerHandle handle) {
+    return indexFromHandle(handle) != NO_TIMER;
+}
+
+uint64_t getTimerRemainingUs(TimerHandle handle) {
+    int16_t index = indexFromHandle(handle);
+    if (index == NO_TIMER) return 0;
+    uint64_t now = getTimerWheelTimeUs();
+    return timerPool[index].deadlineUs > now ? timerPool[index].deadlineUs - now : 0;
+}
+
+// Move every timer in a higher-level slot down to the level that now covers it
+static void cascadeSlot(int level, int slot) {
+    int16_t index = wheelSlots[level][slot];
+    wheelSlots[level][slot] = NO_TIMER;
+    occupiedSlots[level] &= ~(1ULL << slot);
+    while (index != NO_TIMER) {
+        int16_t next = timerPool[index].next;
+        linkTimer(index);
+        wheelStats.cascaded++;
+        index = next;
+    }
+}
+
+static uint64_t rotateRight(uint64_t bits, unsigned shift) {
+    shift &= 63;
+    return shift ? (bits >> shift) | (bits << (64 - shift)) : bits;
+}
+
+// First tick after currentTick at which a level has a non-empty slot to
+// fire (level 0) or cascade (level n, on the ticks where level n-1 wraps)
+static uint64_t nextOccupiedTick() {
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (occupiedSlots[level] == 0) continue;
+        int shift = TIMER_WHEEL_SLOT_BITS * level;
+        uint64_t boundary = ((currentTick >> shift) + 1) << shift;  // Next tick this level is reached
+        uint64_t ahead = rotateRight(occupiedSlots[level], (boundary >> shift) & TIMER_WHEEL_SLOT_MASK);
+        uint64_t tick = boundary + ((uint64_t)__builtin_ctzll(ahead) << shift);
+        if (tick < next) next = tick;
+    }
+    return next;
+}
+
+void serviceTimerWheel() {
+    if (!wheelInitialized) initTimerWheel();
+    uint64_t targetTick = getTimerWheelTimeUs() / TIMER_WHEEL_TICK_US;
+
+    while (currentTick < targetTick) {
+        // Empty slots in between need no work: step straight to the next one that has some
+        uint64_t tick = nextOccupiedTick();
+        if (tick > targetTick) {
+            currentTick = targetTick;
+            break;
+        }
+        currentTick = tick;
+
+        // Cascade higher levels whenever the level below wraps
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if ((currentTick >> (TIMER_WHEEL_SLOT_BITS * (level - 1))) & TIMER_WHEEL_SLOT_MASK) break;
+            cascadeSlot(level, (currentTick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+        }
+
+        // Fire everything due in this level-0 slot. Entries are removed one at a
+        // time so callbacks may schedule or cancel other timers safely.
+        int slot = currentTick & TIMER_WHEEL_SLOT_MASK;
+        int16_t index;
+        int16_t notDue = NO_TIMER;
+        while ((index = wheelSlots[0][slot]) != NO_TIMER) {
+            unlinkTimer(index);
+            TimerEntry& entry = timerPool[index];
+            if (entry.deadlineTick > currentTick) {
+                // Aliased from the top level - not due yet, re-placed after the slot is done
+                entry.next = notDue;
+                notDue = index;
+                continue;
+            }
+            TimerCallback callback = entry.callback;
+            void* context = entry.context;
+            releaseTimer(index);
+            wheelStats.fired++;
+            callback(context);
+        }
+        while (notDue != NO_TIMER) {
+            int16_t next = timerPool[notDue].next;
+            linkTimer(notDue);
+            notDue = next;
+        }
+    }
+}
+
+TimerWheelStats getTimerWheelStats() {
+    return wheelStats;
+}
+
+size_t getActiveTimerCount() {
+    return activeTimerCount;
+}
@@ -0,0 +1,198 @@
+#include "Watchdog/watchdog_supervisor.h"
+#include "Config/Config.h"
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+#include "StateMachine/StateManager.h"
+#include "Outputs/output_shadow.h"
+#include "esp_idf_version.h"
+#include "esp_system.h"
+#include "esp_task_wdt.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <Preferences.h>
+
+//* ************************************************************************
+//* ************************ WATCHDOG SUPERVISOR ***************************
+//* ************************************************************************
+// NVS keys in "watchdog": "heartbeat" that was late, "state" at the time,
+// "late" ms past its deadline and "uptime". Cleared once reported.
+
+static const char* WATCHDOG_NVS_NAMESPACE = "watchdog";
+
+static portMUX_TYPE heartbeatLock = portMUX_INITIALIZER_UNLOCKED;
+static unsigned long lastBeat[HEARTBEAT_COUNT];
+static bool armed[HEARTBEAT_COUNT];
+static uint8_t blockingScopes = 0;
+
+static TaskHandle_t supervisorTaskHandle = NULL;
+static char lastRestart[80] = "none";
+
+// Motor progress seen by the supervisor (feeds MOTOR_ENGINE)
+static int32_t lastCutPosition = 0;
+static int32_t lastFeedPosition = 0;
+
+static unsigned long deadlineFor(uint8_t heartbeat, bool blocking) {
+    switch (heartbeat) {
+        case HEARTBEAT_CONTROL_TICK: return blocking ? WATCHDOG_BLOCKING_DEADLINE_MS : WATCHDOG_CONTROL_TICK_DEADLINE_MS;
+        case HEARTBEAT_MOTOR_ENGINE: return WATCHDOG_MOTOR_ENGINE_DEADLINE_MS;
+        case HEARTBEAT_NETWORK: return WATCHDOG_NETWORK_DEADLINE_MS;
+        case HEARTBEAT_LOGGING: return blocking ? WATCHDOG_BLOCKING_DEADLINE_MS : WATCHDOG_LOGGING_DEADLINE_MS;
+        default: return 0;
+    }
+}
+
+void feedHeartbeat(Heartbeat heartbeat) {
+    if (heartbeat >= HEARTBEAT_COUNT) return;
+    unsigned long now = millis();
+    portENTER_CRITICAL(&heartbeatLock);
+    lastBeat[heartbeat] = now;
+    armed[heartbeat] = true;
+    portEXIT_CRITICAL(&heartbeatLock);
+}
+
+WatchdogBlockingScope::WatchdogBlockingScope() {
+    feedHeartbeat(HEARTBEAT_CONTROL_TICK);
+    portENTER_CRITICAL(&heartbeatLock);
+    blockingScopes++;
+    portEXIT_CRITICAL(&heartbeatLock);
+}
+
+WatchdogBlockingScope::~WatchdogBlockingScope() {
+    portENTER_CRITICAL(&heartbeatLock);
+    if (blockingScopes > 0) blockingScopes--;
+    portEXIT_CRITICAL(&heartbeatLock);
+    feedHeartbeat(HEARTBEAT_CONTROL_TICK);
+}
+
+const char* getHeartbeatName(uint8_t heartbeat) {
+    switch (heartbeat) {
+        case HEARTBEAT_CONTROL_TICK: return "CONTROL_TICK";
+        case HEARTBEAT_MOTOR_ENGINE: return "MOTOR_ENGINE";
+        case HEARTBEAT_NETWORK: return "NETWORK";
+        case HEARTBEAT_LOGGING: return "LOGGING";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* getLastWatchdogRestart() {
+    return lastRestart;
+}
+
+// A running motor whose position has not changed means the step engine stalled
+static void checkMotorEngine() {
+    bool progressing = true;
+    if (cutMotor && cutMotor->isRunning()) {
+        int32_t position = cutMotor->getCurrentPosition();
+        if (position == lastCutPosition) progressing = false;
+        lastCutPosition = position;
+    }
+    if (feedMotor && feedMotor->isRunning()) {
+        int32_t position = feedMotor->getCurrentPosition();
+        if (position == lastFeedPosition) progressing = false;
+        lastFeedPosition = position;
+    }
+    if (progressing) feedHeartbeat(HEARTBEAT_MOTOR_ENGINE);
+}
+
+static bool isMachineAtRest() {
+    SystemState state = currentState;
+    return state == IDLE || state == ERROR || state == SUCTION_ERROR_HOLD;
+}
+
+// Runs beside a loop task that may be stuck anywhere, even holding the Serial
+// lock or halfway through a set of clamp writes: no printing, and only the two
+// clamp bits are flushed. The reason is reported from NVS after the restart.
+static void safeStopAndRestart(uint8_t heartbeat, unsigned long lateMs) {
+    SystemState state = currentState;
+
+    if (cutMotor) cutMotor->forceStopAndNewPosition(cutMotor->getCurrentPosition());
+    if (feedMotor) feedMotor->forceStopAndNewPosition(feedMotor->getCurrentPosition());
+    setOutput(FEED_CLAMP, LOW);         // Extended (inversed logic)
+    setOutput(_2x4_SECURE_CLAMP, LOW);  // Extended (inversed logic)
+    flushOutputs(getOutputMask(FEED_CLAMP) | getOutputMask(_2x4_SECURE_CLAMP));
+
+    Preferences preferences;
+    if (preferences.begin(WATCHDOG_NVS_NAMESPACE, false)) {
+        preferences.putUChar("heartbeat", heartbeat);
+        preferences.putUChar("state", (uint8_t)state);
+        preferences.putULong("late", lateMs);
+        preferences.putULong("uptime", millis());
+        preferences.end();
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(WATCHDOG_SAFE_STOP_SETTLE_MS)); // Clamps close
+    esp_restart();
+}
+
+void runWatchdogCheck() {
+    checkMotorEngine();
+
+    unsigned long now = millis();
+    unsigned long beats[HEARTBEAT_COUNT];
+    bool checked[HEARTBEAT_COUNT];
+    bool blocking;
+    portENTER_CRITICAL(&heartbeatLock);
+    memcpy(beats, lastBeat, sizeof(beats));
+    memcpy(checked, armed, sizeof(checked));
+    blocking = blockingScopes > 0;
+    portEXIT_CRITICAL(&heartbeatLock);
+
+    for (uint8_t i = 0; i < HEARTBEAT_COUNT; i++) {
+        if (!checked[i]) continue;
+        unsigned long age = now - beats[i];
+        unsigned long deadline = deadlineFor(i, blocking);
+        if (age <= deadline) continue;
+        if (i == HEARTBEAT_NETWORK && !isMachineAtRest()) continue;
+        safeStopAndRestart(i, age - deadline);
+    }
+}
+
+static void supervisorTask(void* arg) {
+    (void)arg;
+    esp_task_wdt_add(NULL);
+
+    for (;;) {
+        esp_task_wdt_reset();
+        runWatchdogCheck();
+        vTaskDelay(pdMS_TO_TICKS(WATCHDOG_CHECK_INTERVAL_MS));
+    }
+}
+
+static void reportPreviousRestart() {
+    Preferences preferences;
+    if (preferences.begin(WATCHDOG_NVS_NAMESPACE, false)) {
+        if (preferences.isKey("heartbeat")) {
+            uint8_t heartbeat = preferences.getUChar("heartbeat", HEARTBEAT_COUNT);
+            uint8_t state = preferences.getUChar("state", 0);
+            snprintf(lastRestart, sizeof(lastRestart), "%s heartbeat %lu ms late in %s at %lu ms uptime",
+                     getHeartbeatName(heartbeat), (unsigned long)preferences.getULong("late", 0),
+                     getSystemStateName((SystemState)state), (unsigned long)preferences.getULong("uptime", 0));
+            preferences.clear();
+        }
+        preferences.end();
+    }
+    if (strcmp(lastRestart, "none") == 0 && esp_reset_reason() == ESP_RST_TASK_WDT) {
+        snprintf(lastRestart, sizeof(lastRestart), "task watchdog (supervisor or a subscribed task stalled)");
+    }
+    if (strcmp(lastRestart, "none") != 0) {
+        Serial.print("Last restart by watchdog: ");
+        Serial.println(lastRestart);
+    }
+}
+
+void beginWatchdogSupervisor() {
+    if (supervisorTaskHandle) return;
+    reportPreviousRestart();
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_task_wdt_config_t config = {(uint32_t)(WATCHDOG_TWDT_TIMEOUT_S * 1000), 1 << 0, true};
+    if (esp_task_wdt_reconfigure(&config) != ESP_OK) esp_task_wdt_init(&config);
+#else
+    esp_task_wdt_init(WATCHDOG_TWDT_TIMEOUT_S, true);
+#endif
+
+    if (xTaskCreatePinnedToCore(supervisorTask, "watchdog", WATCHDOG_TASK_STACK_SIZE, NULL,
+                                WATCHDOG_TASK_PRIORITY, &supervisorTaskHandle, WATCHDOG_TASK_CORE) != pdPASS) {
+        supervisorTaskHandle = NULL;
+        Serial.println("Failed to start watchdog supervisor - heartbeats are not checked");
+    }
+}
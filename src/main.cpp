@@ -5,13 +5,29 @@
 #include <ESP32Servo.h>
 #include "Config/Pins_Definitions.h"
 #include "Config/Config.h"
-#include "OTAUpdater/ota_updater.h"
+#include "Network/network_task.h"
+#include "OTAUpdater/ota_health_check.h"
 #include "StateMachine/99_GENERAL_FUNCTIONS.h"
 #include "StateMachine/StateManager.h"
 #include "ErrorStates/standard_error.h"
 #include "ErrorStates/error_reset.h"
 #include "ErrorStates/suction_error_hold.h"
 #include "StateMachine/99_CUT_MOTOR_ERROR_FUNCTIONS.h"
+#include "StateMachine/99_SERVO_MOTION_FUNCTIONS.h"
+#include "StatusLeds/led_pattern_engine.h"
+#include "Outputs/output_shadow.h"
+#include "StateMachine/99_ADAPTIVE_CUT_FUNCTIONS.h"
+#include "Profiles/job_profiles.h"
+#include "StateMachine/99_SEQUENCE_FUNCTIONS.h"
+#include "Journal/fault_journal.h"
+#include "FlightRecorder/flight_recorder.h"
+#include "InputTrace/input_trace.h"
+#include "Diagnostics/loop_profiler.h"
+#include "Diagnostics/memory_monitor.h"
+#include "Watchdog/watchdog_supervisor.h"
+#include "StateMachine/99_CUT_HOME_LIMIT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "Diagnostics/boot_timing.h"
 
 //* ************************************************************************
 //* ************************ AUTOMATED TABLE SAW **************************
@@ -22,10 +38,8 @@
 // Pin definitions and configuration constants are now in Config/ header files
 
 // Timing variables (constants moved to Config/system_config.h)
-unsigned long rotationServoActiveStartTime = 0;
 bool rotationServoIsActiveAndTiming = false;
 
-unsigned long rotationClampExtendTime = 0;
 bool rotationClampIsExtended = false;
 
 // SystemStates Enum is now in Functions.h
@@ -62,21 +76,14 @@ bool continuousModeActive = false;  // New flag for continuous operation
 bool startSwitchSafe = false;       // New flag to track if start switch is safe
 
 // Timers for various operations
-unsigned long lastBlinkTime = 0;
-unsigned long lastErrorBlinkTime = 0;
 unsigned long errorStartTime = 0;
 unsigned long feedMoveStartTime = 0;
 
-// LED states
-bool blinkState = false;
-bool errorBlinkState = false;
-
 // Global variables for signal handling
-unsigned long signalTAStartTime = 0; // For Transfer Arm signal
 bool signalTAActive = false;      // For Transfer Arm signal
 
 // New flag to track cut motor return during RETURNING_YES_2x4 mode
-bool cutMotorInReturningYes2x4Return = false;
+volatile bool cutMotorInReturningYes2x4Return = false; // Read by the cut home switch interrupt
 
 // Additional variables needed by states - declarations moved to above
 
@@ -85,10 +92,18 @@ bool cutMotorInReturningYes2x4Return = false;
 // StateManager instance is created in StateManager.cpp
 
 void setup() {
+  markBootPhase(BOOT_PHASE_SETUP_START);
   Serial.begin(115200);
   Serial.println("Automated Table Saw Control System - Stage 1");
   
-  setupOTA();
+  //! Count this boot if the image is fresh from OTA (rolls back after repeated restarts)
+  beginOtaHealthCheck();
+  
+  //! Report a watchdog restart and start supervising heartbeats (each is checked once first fed)
+  beginWatchdogSupervisor();
+  
+  //! WiFi, OTA and the diagnostics server come up on the other core while we home
+  startNetworkTask();
 
   //! Configure pin modes
   pinMode(CUT_MOTOR_STEP_PIN, OUTPUT);
@@ -115,14 +130,24 @@ void setup() {
   pinMode(STATUS_LED_BLUE, OUTPUT);
   
   pinMode(TRANSFER_ARM_SIGNAL_PIN, OUTPUT);
-  digitalWrite(TRANSFER_ARM_SIGNAL_PIN, LOW);
+  
+  //! Put clamps, LEDs and signals under the output shadow register
+  registerShadowOutput(ROTATION_CLAMP, LOW);
+  registerShadowOutput(FEED_CLAMP, LOW);
+  registerShadowOutput(_2x4_SECURE_CLAMP, LOW);
+  registerShadowOutput(STATUS_LED_RED, LOW);
+  registerShadowOutput(STATUS_LED_YELLOW, LOW);
+  registerShadowOutput(STATUS_LED_GREEN, LOW);
+  registerShadowOutput(STATUS_LED_BLUE, LOW);
+  registerShadowOutput(TRANSFER_ARM_SIGNAL_PIN, LOW);
   
   //! Initialize clamps and LEDs
   extendFeedClamp();
   extend2x4SecureClamp();
   retractRotationClamp();
-  allLedsOff();
-  turnBlueLedOn();
+  flushOutputs();
+  setLedStatus(LED_STATUS_STARTUP);
+  beginLedPatternEngine();
   
   //! Configure switch debouncing
   cutHomingSwitch.attach(CUT_MOTOR_HOME_SWITCH);
@@ -140,6 +165,18 @@ void setup() {
   pushwoodForwardSwitch.attach(MANUAL_FEED_SWITCH);
   pushwoodForwardSwitch.interval(20);
   
+  //! Timestamp every input edge for offline replay of sensor chatter
+  beginInputTrace();
+  markBootPhase(BOOT_PHASE_IO_READY);
+  
+  //! Mount the fault journal and record this boot (motors are not running yet)
+  beginFaultJournal();
+  
+  //! Load the job profile and its learned cut rate before the motors are configured
+  beginJobProfiles();
+  beginAdaptiveCut(getActiveJobProfileIndex());
+  beginSequences();
+  
   //! Initialize motors
   engine.init();
 
@@ -160,10 +197,21 @@ void setup() {
   } else {
     Serial.println("Failed to init feedMotor");
   }
+
+  //! Stop the cut motor from the home switch interrupt during returns
+  beginCutHomeLimit();
+  
+  //! Count emitted step pulses to check the commanded positions
+  beginStepPulseCheck();
+  
+  //! Start sampling the cut motor for home-check post-mortems
+  beginFlightRecorder();
   
   //! Initialize servo
   rotationServo.setTimerWidth(14);
   rotationServo.attach(ROTATION_SERVO_PIN);
+  configureRotationServoMotion();
+  markBootPhase(BOOT_PHASE_MOTORS_READY);
   
   //! Configure initial state
   currentState = STARTUP;
@@ -175,12 +223,20 @@ void setup() {
     startSwitchSafe = true;
   }
   
+  beginLoopProfiler();
   delay(10);
+  markBootPhase(BOOT_PHASE_SETUP_DONE);
+  
+  //! Last: loop task heap allocations are counted from here on
+  beginMemoryMonitor();
 }
 
 void loop() {
-  handleOTA(); // Handle OTA requests
+  markLoopProfilerTick();
+  LoopProfileScope tickProfile(LOOP_SECTION_TICK);
 
+  // OTA and the diagnostics server are serviced by the network task
   // Execute the state machine - all the logic below has been moved to StateManager
   stateManager.execute();
+  feedHeartbeat(HEARTBEAT_CONTROL_TICK);
 }
@@ -0,0 +1,208 @@
+#include "sim_machine.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/StateManager.h"
+#include "StateMachine/StateTransitions.h"
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include <cstdio>
+#include <cstdlib>
+
+//* ************************************************************************
+//* ************************ STATE MACHINE FUZZ TARGET *********************
+//* ************************************************************************
+// Drives StateManager::execute() (through loop()) on the machine model with
+// operator input sequences and aborts on:
+//   - a new state invariant violation (99_INVARIANT_FUNCTIONS.h)
+//   - a state change the transition table does not declare
+//   - a step pulse mismatch
+//   - the cut axis physically moving out while the feed axis advances with
+//     the feed clamp extended (checked on the model, not on commands)
+//   - a watchdog safe stop or any other restart, or a stalled critical section
+//   - the machine not getting back to IDLE between inputs
+//
+// Input: two-byte records, up to FUZZ_MAX_RECORDS and FUZZ_MAX_RUN_MS of
+// simulated time:
+//   byte 0  bit 0 reload, bit 1 start, bit 2 manual feed (HIGH = on),
+//           bit 3 no 2x4 (sensor HIGH), bit 4 suction lost (sensor LOW)
+//   byte 1  how long to hold them, in FUZZ_TIME_UNIT_MS (+1)
+//
+// libFuzzer (clang):   pio run -e native_fuzz
+//                      .pio/build/native_fuzz/program test/fuzz/corpus
+// Any compiler:        random inputs or replay of saved crash files
+//                      .pio/build/native_fuzz/program [runs | files...]
+//                      with -DFUZZ_STANDALONE_MAIN=1
+
+#ifndef FUZZ_STANDALONE_MAIN
+#define FUZZ_STANDALONE_MAIN 0
+#endif
+
+const size_t FUZZ_MAX_RECORDS = 64;
+const uint32_t FUZZ_TIME_UNIT_MS = 5;
+const uint32_t FUZZ_MAX_RUN_MS = 20000;
+const uint32_t FUZZ_RETURN_TO_IDLE_MS = 30000;   // Per attempt
+
+enum FuzzInput : uint8_t {
+    FUZZ_RELOAD = 1 << 0,
+    FUZZ_START = 1 << 1,
+    FUZZ_MANUAL_FEED = 1 << 2,
+    FUZZ_NO_2X4 = 1 << 3,
+    FUZZ_SUCTION_LOST = 1 << 4
+};
+
+static double lastCutInches;
+static double lastFeedInches;
+static const uint8_t* currentInput;
+static size_t currentInputSize;
+
+static void fuzzFail(const char* what) {
+    fprintf(stderr, "FUZZ FAILURE: %s (state %s at %.3f s)\n", what, getSystemStateName(currentState),
+            simMicros() / 1e6);
+    for (const SimTransition& transition : simTransitions()) {
+        fprintf(stderr, "  %.3f s  %s -> %s\n", transition.atUs / 1e6, getSystemStateName(transition.from),
+                getSystemStateName(transition.to));
+    }
+#if FUZZ_STANDALONE_MAIN
+    // libFuzzer saves the input itself
+    FILE* file = fopen("crash-standalone", "wb");
+    if (file) {
+        fwrite(currentInput, 1, currentInputSize, file);
+        fclose(file);
+        fprintf(stderr, "Input saved to crash-standalone\n");
+    }
+#endif
+    abort();
+}
+
+static void applyInputs(uint8_t inputs) {
+    simSetInput(RELOAD_SWITCH, (inputs & FUZZ_RELOAD) ? HIGH : LOW);
+    simSetInput(START_CYCLE_SWITCH, (inputs & FUZZ_START) ? HIGH : LOW);
+    simSetInput(MANUAL_FEED_SWITCH, (inputs & FUZZ_MANUAL_FEED) ? HIGH : LOW);
+    simSetInput(_2x4_PRESENT_SENSOR, (inputs & FUZZ_NO_2X4) ? HIGH : LOW);
+    simSetInput(WOOD_SUCTION_CONFIRM_SENSOR, (inputs & FUZZ_SUCTION_LOST) ? LOW : HIGH);
+}
+
+// Cut moving out while the clamped wood is pushed forward, on the model
+static void checkAxes() {
+    double cutInches = simCutInches();
+    double feedInches = simFeedInches();
+    bool cutMovingOut = cutInches > lastCutInches;
+    bool feedAdvancing = feedInches > lastFeedInches;
+    lastCutInches = cutInches;
+    lastFeedInches = feedInches;
+    if (cutMovingOut && feedAdvancing && simGetOutput(FEED_CLAMP) == LOW) {
+        fuzzFail("cut axis moving out while the clamped feed advances");
+    }
+}
+
+static void run(uint32_t ms) {
+    try {
+        simRunFor(ms);
+    } catch (const SimRestart& restart) {
+        fuzzFail(restart.reason);
+    } catch (const SimStall&) {
+        fuzzFail("simulated time stalled inside a critical section");
+    }
+}
+
+static void press(int pin) {
+    simSetInput(pin, HIGH);
+    run(100);
+    simSetInput(pin, LOW);
+    run(100);
+}
+
+// Operator inputs released, wood loaded and suction on; acknowledge a hold
+static void returnToIdle() {
+    applyInputs(0);
+    for (int attempt = 0; attempt < 3 && currentState != IDLE; attempt++) {
+        if (currentState == ERROR) press(RELOAD_SWITCH);
+        else if (currentState == SUCTION_ERROR_HOLD) press(START_CYCLE_SWITCH);
+        uint64_t endUs = simMicros() + FUZZ_RETURN_TO_IDLE_MS * 1000ULL;
+        while (currentState != IDLE && currentState != ERROR && currentState != SUCTION_ERROR_HOLD &&
+               simMicros() < endUs) {
+            run(10);
+        }
+    }
+    if (currentState != IDLE) fuzzFail("did not return to IDLE");
+}
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv) {
+    (void)argc;
+    (void)argv;
+    simBoot();
+    run(0);
+    if (!simRunUntilState(IDLE, 10000)) fuzzFail("did not home to IDLE after boot");
+    lastCutInches = simCutInches();
+    lastFeedInches = simFeedInches();
+    simSetStepHook(checkAxes);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    currentInput = data;
+    currentInputSize = size;
+    returnToIdle();
+    simClearTransitions();
+
+    uint32_t invariantsBefore = getTotalStateInvariantViolations();
+    uint32_t undeclaredBefore = getUndeclaredTransitionCount();
+    uint32_t pulseMismatchesBefore = getStepPulseMismatchCount();
+
+    uint32_t elapsedMs = 0;
+    for (size_t record = 0; record + 1 < size && record / 2 < FUZZ_MAX_RECORDS; record += 2) {
+        uint32_t holdMs = (data[record + 1] + 1u) * FUZZ_TIME_UNIT_MS;
+        if (elapsedMs + holdMs > FUZZ_MAX_RUN_MS) holdMs = FUZZ_MAX_RUN_MS - elapsedMs;
+        applyInputs(data[record]);
+        run(holdMs);
+        elapsedMs += holdMs;
+
+        if (getTotalStateInvariantViolations() != invariantsBefore) fuzzFail("state invariant violated");
+        if (getUndeclaredTransitionCount() != undeclaredBefore) fuzzFail("undeclared transition");
+        if (getStepPulseMismatchCount() != pulseMismatchesBefore) fuzzFail("step pulse mismatch");
+        if (elapsedMs >= FUZZ_MAX_RUN_MS) break;
+    }
+    return 0;
+}
+
+#if FUZZ_STANDALONE_MAIN
+
+// Without libFuzzer: replay the given files, or run random inputs
+int main(int argc, char** argv) {
+    LLVMFuzzerInitialize(&argc, &argv);
+    if (argc > 1 && atoi(argv[1]) == 0) {
+        for (int i = 1; i < argc; i++) {
+            FILE* file = fopen(argv[i], "rb");
+            if (!file) {
+                fprintf(stderr, "%s: cannot open\n", argv[i]);
+                return 1;
+            }
+            uint8_t data[FUZZ_MAX_RECORDS * 2];
+            size_t size = fread(data, 1, sizeof(data), file);
+            fclose(file);
+            printf("%s: %u bytes\n", argv[i], (unsigned)size);
+            LLVMFuzzerTestOneInput(data, size);
+        }
+        return 0;
+    }
+
+    unsigned runs = argc > 1 ? (unsigned)atoi(argv[1]) : 100;
+    uint32_t seed = 0x5eed1234;
+    for (unsigned run = 0; run < runs; run++) {
+        uint8_t data[FUZZ_MAX_RECORDS * 2];
+        size_t size = 2 + seed % (sizeof(data) - 1);
+        for (size_t i = 0; i < size; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            data[i] = (uint8_t)seed;
+        }
+        LLVMFuzzerTestOneInput(data, size);
+        if ((run + 1) % 10 == 0) {
+            printf("%u runs, simulated %.0f s\n", run + 1, simMicros() / 1e6);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+#endif // FUZZ_STANDALONE_MAIN
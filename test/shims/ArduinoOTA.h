@@ -0,0 +1,37 @@
+#ifndef NATIVE_SHIM_ARDUINOOTA_H
+#define NATIVE_SHIM_ARDUINOOTA_H
+
+#include <Arduino.h>
+#include <Update.h>
+#include <functional>
+
+typedef enum { OTA_AUTH_ERROR, OTA_BEGIN_ERROR, OTA_CONNECT_ERROR, OTA_RECEIVE_ERROR, OTA_END_ERROR } ota_error_t;
+
+// Keeps the callbacks so a test can play an upload through them
+class ArduinoOTAClass {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    ArduinoOTAClass& setHostname(const char* name) { (void)name; return *this; }
+    ArduinoOTAClass& setPassword(const char* password) { (void)password; return *this; }
+    ArduinoOTAClass& setPasswordHash(const char* hash) { (void)hash; return *this; }
+    ArduinoOTAClass& setPort(uint16_t port) { (void)port; return *this; }
+    ArduinoOTAClass& onStart(THandlerFunction fn) { startCallback = fn; return *this; }
+    ArduinoOTAClass& onEnd(THandlerFunction fn) { endCallback = fn; return *this; }
+    ArduinoOTAClass& onError(THandlerFunction_Error fn) { errorCallback = fn; return *this; }
+    ArduinoOTAClass& onProgress(THandlerFunction_Progress fn) { progressCallback = fn; return *this; }
+    void begin() {}
+    void handle() {}
+    int getCommand() { return U_FLASH; }
+
+    THandlerFunction startCallback;
+    THandlerFunction endCallback;
+    THandlerFunction_Error errorCallback;
+    THandlerFunction_Progress progressCallback;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif // NATIVE_SHIM_ARDUINOOTA_H
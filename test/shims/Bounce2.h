@@ -0,0 +1,32 @@
+#ifndef NATIVE_SHIM_BOUNCE2_H
+#define NATIVE_SHIM_BOUNCE2_H
+
+#include <Arduino.h>
+
+// Bounce2's stable-interval debouncer, reading the simulated pins
+class Bounce {
+public:
+    Bounce() {}
+    void attach(int pin);
+    void attach(int pin, int mode);
+    void interval(uint16_t intervalMs) { intervalMillis = intervalMs; }
+    bool update();
+    bool read() const { return debouncedState; }
+    bool changed() const { return changedState; }
+    bool rose() const { return debouncedState && changedState; }
+    bool fell() const { return !debouncedState && changedState; }
+    unsigned long currentDuration() const { return millis() - stateChangeLastTime; }
+    unsigned long previousDuration() const { return durationOfPreviousState; }
+
+private:
+    int pin = -1;
+    uint16_t intervalMillis = 10;
+    bool debouncedState = false;
+    bool unstableState = false;
+    bool changedState = false;
+    unsigned long previousMillis = 0;
+    unsigned long stateChangeLastTime = 0;
+    unsigned long durationOfPreviousState = 0;
+};
+
+#endif // NATIVE_SHIM_BOUNCE2_H
@@ -0,0 +1,24 @@
+#ifndef NATIVE_SHIM_ESP32SERVO_H
+#define NATIVE_SHIM_ESP32SERVO_H
+
+#include <Arduino.h>
+
+// Keeps the last commanded angle; the model has no servo dynamics
+class Servo {
+public:
+    int attach(int pin) { attachedPin = pin; return pin; }
+    int attach(int pin, int minUs, int maxUs) { (void)minUs; (void)maxUs; return attach(pin); }
+    void detach() { attachedPin = -1; }
+    bool attached() const { return attachedPin >= 0; }
+    void setTimerWidth(int bits) { (void)bits; }
+    void write(int degrees) { angle = degrees; }
+    void writeMicroseconds(int us) { angle = (us - 544) * 180 / (2400 - 544); }
+    int read() const { return angle; }
+    int readMicroseconds() const { return 544 + angle * (2400 - 544) / 180; }
+
+private:
+    int attachedPin = -1;
+    int angle = 0;
+};
+
+#endif // NATIVE_SHIM_ESP32SERVO_H
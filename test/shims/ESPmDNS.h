@@ -0,0 +1,6 @@
+#ifndef NATIVE_SHIM_ESPMDNS_H
+#define NATIVE_SHIM_ESPMDNS_H
+
+#include <Arduino.h>
+
+#endif // NATIVE_SHIM_ESPMDNS_H
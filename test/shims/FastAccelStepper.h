@@ -0,0 +1,81 @@
+#ifndef NATIVE_SHIM_FAST_ACCEL_STEPPER_H
+#define NATIVE_SHIM_FAST_ACCEL_STEPPER_H
+
+#include <Arduino.h>
+
+#define SUPPORT_ESP32_PULSE_COUNTER
+
+// FastAccelStepper on the machine model: trapezoidal moves integrated on the
+// simulated clock, position as the library reports it (setCurrentPosition()
+// re-references it without moving the axis)
+class FastAccelStepper {
+public:
+    explicit FastAccelStepper(uint8_t stepPin) : stepPin(stepPin) {}
+
+    void setDirectionPin(uint8_t pin, bool dirHighCountsUp = true, uint16_t dirChangeDelayUs = 0);
+    int8_t setSpeedInHz(uint32_t speedHz);
+    int8_t setSpeedInUs(uint32_t stepUs);
+    int8_t setAcceleration(int32_t stepsPerSecond2);
+    int8_t applySpeedAcceleration() { return 0; }
+    void setForwardPlanningTimeInMs(uint8_t ms) { planningTimeMs = ms; }
+
+    int8_t moveTo(int32_t position, bool blocking = false);
+    int8_t move(int32_t steps, bool blocking = false);
+    int8_t runForward();
+    int8_t runBackward();
+    void stopMove();
+    void forceStop();
+    void forceStopAndNewPosition(int32_t position);
+
+    bool isRunning();
+    bool isStopping() { return stopping; }
+    int32_t getCurrentPosition();
+    void setCurrentPosition(int32_t position);
+    int32_t targetPos() { return target; }
+    int32_t getPositionAfterCommandsCompleted() { return target; }
+    int32_t getCurrentSpeedInMilliHz();
+    uint32_t getMaxSpeedInHz() { return maxSpeedHz; }
+    uint8_t getStepPin() { return stepPin; }
+
+    bool attachToPulseCounter(uint8_t unit, int16_t lowLimit = -16384, int16_t highLimit = 16384, uint16_t dirPin = 0);
+    int16_t readPulseCounter();
+    void clearPulseCounter();
+
+    // Machine model side (sim_machine.cpp). Physical positions are steps
+    // from the axis home switch and stop at the hard stops.
+    void simStep(double seconds);
+    double simPhysicalPosition() const { return physical; }
+    void simSetPhysicalPosition(double position) { physical = position; }
+    void simSetHardStops(double low, double high) { lowStop = low; highStop = high; }
+    uint8_t simPlanningTimeMs() const { return planningTimeMs; }
+
+private:
+    int32_t reportedPosition() const { return (int32_t)(lround(steps) + offset); }
+    void startMove(int32_t newTarget);
+
+    uint8_t stepPin;
+    uint32_t maxSpeedHz = 1000;
+    uint32_t acceleration = 1000;
+    uint8_t planningTimeMs = 20;
+    double steps = 0;           // Steps emitted since boot, signed
+    double velocity = 0;        // Steps per second, signed
+    int64_t offset = 0;         // Reported position minus the emitted steps
+    double physical = 0;
+    double lowStop = -1e9;
+    double highStop = 1e9;
+    int32_t target = 0;
+    bool running = false;
+    bool stopping = false;
+    int8_t continuous = 0;      // +1 / -1 for runForward / runBackward
+    int64_t pulseCounterBase = 0;
+    bool pulseCounterAttached = false;
+};
+
+class FastAccelStepperEngine {
+public:
+    void init() {}
+    void init(uint8_t cpuCore) { (void)cpuCore; }
+    FastAccelStepper* stepperConnectToPin(uint8_t stepPin);
+};
+
+#endif // NATIVE_SHIM_FAST_ACCEL_STEPPER_H
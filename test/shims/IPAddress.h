@@ -0,0 +1,21 @@
+#ifndef NATIVE_SHIM_IPADDRESS_H
+#define NATIVE_SHIM_IPADDRESS_H
+
+#include <Arduino.h>
+
+class IPAddress {
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+    operator String() const { return toString(); } // Serial.println(ip)
+
+private:
+    uint8_t octets[4] = {0, 0, 0, 0};
+};
+
+#endif // NATIVE_SHIM_IPADDRESS_H
@@ -0,0 +1,16 @@
+#ifndef NATIVE_SHIM_UPDATE_H
+#define NATIVE_SHIM_UPDATE_H
+
+#include <Arduino.h>
+
+#define U_FLASH 0
+#define U_SPIFFS 100
+
+class UpdateClass {
+public:
+    void abort() {}
+};
+
+extern UpdateClass Update;
+
+#endif // NATIVE_SHIM_UPDATE_H
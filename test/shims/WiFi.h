@@ -0,0 +1,18 @@
+#ifndef NATIVE_SHIM_WIFI_H
+#define NATIVE_SHIM_WIFI_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+// The native build has no network; WiFi never connects
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4, WL_DISCONNECTED = 6 } wl_status_t;
+
+class WiFiClass {
+public:
+    wl_status_t status() { return WL_DISCONNECTED; }
+    IPAddress localIP() { return IPAddress(); }
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_SHIM_WIFI_H
@@ -0,0 +1,6 @@
+#ifndef NATIVE_SHIM_WIFIUDP_H
+#define NATIVE_SHIM_WIFIUDP_H
+
+#include <IPAddress.h>
+
+#endif // NATIVE_SHIM_WIFIUDP_H
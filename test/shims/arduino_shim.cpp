@@ -0,0 +1,220 @@
+#include <Arduino.h>
+#include <Bounce2.h>
+#include <Preferences.h>
+#include "sim_machine.h"
+#include "sim_internal.h"
+#include <map>
+#include <vector>
+
+//* ************************************************************************
+//* ************************ NATIVE ARDUINO SHIM ***************************
+//* ************************************************************************
+
+HardwareSerial Serial;
+EspClass ESP;
+
+String::String(double number, unsigned int decimals) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, number);
+    value = text;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= value.size()) return String();
+    return String(value.substr(from, to - from));
+}
+
+int String::indexOf(char c) const {
+    size_t at = value.find(c);
+    return at == std::string::npos ? -1 : (int)at;
+}
+
+void String::trim() {
+    size_t first = value.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        value.clear();
+        return;
+    }
+    size_t last = value.find_last_not_of(" \t\r\n");
+    value = value.substr(first, last - first + 1);
+}
+
+size_t Print::write(const uint8_t* data, size_t size) {
+    size_t written = 0;
+    while (size--) written += write(*data++);
+    return written;
+}
+
+size_t Print::print(const char* text) {
+    return write((const uint8_t*)text, strlen(text));
+}
+
+size_t Print::print(long number, int base) {
+    if (base == 10) return printf("%ld", number);
+    if (number < 0) return print('-') + print((unsigned long)-number, base);
+    return print((unsigned long)number, base);
+}
+
+size_t Print::print(unsigned long number, int base) {
+    if (base == 16) return printf("%lX", number);
+    if (base == 8) return printf("%lo", number);
+    if (base != 2) return printf("%lu", number);
+    char digits[sizeof(number) * 8 + 1];
+    size_t at = sizeof(digits) - 1;
+    digits[at] = '\0';
+    do {
+        digits[--at] = (char)('0' + (number & 1));
+        number >>= 1;
+    } while (number);
+    return print(&digits[at]);
+}
+
+size_t Print::print(double number, int decimals) {
+    return printf("%.*f", decimals, number);
+}
+
+size_t Print::printf(const char* format, ...) {
+    char text[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return write((const uint8_t*)text, std::min((size_t)length, sizeof(text) - 1));
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (simSerialEcho()) fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t size) {
+    if (simSerialEcho()) fwrite(data, 1, size, stdout);
+    return size;
+}
+
+void EspClass::restart() {
+    throw SimRestart{"ESP.restart()"};
+}
+
+uint32_t EspClass::getFreeHeap() {
+    return simFreeHeap();
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return simLargestFreeBlock();
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    return simFreeHeap();
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(simMicros() * 240);
+}
+
+//* ************************************************************************
+//* ***************************** BOUNCE2 **********************************
+//* ************************************************************************
+
+void Bounce::attach(int pin) {
+    this->pin = pin;
+    debouncedState = unstableState = digitalRead((uint8_t)pin);
+    previousMillis = stateChangeLastTime = millis();
+}
+
+void Bounce::attach(int pin, int mode) {
+    pinMode((uint8_t)pin, (uint8_t)mode);
+    attach(pin);
+}
+
+// Bounce2's default stable-interval algorithm
+bool Bounce::update() {
+    changedState = false;
+    bool reading = digitalRead((uint8_t)pin);
+    unsigned long now = millis();
+    if (reading != unstableState) {
+        previousMillis = now;
+        unstableState = reading;
+    }
+    if (now - previousMillis >= intervalMillis && reading != debouncedState) {
+        previousMillis = now;
+        debouncedState = reading;
+        changedState = true;
+        durationOfPreviousState = now - stateChangeLastTime;
+        stateChangeLastTime = now;
+    }
+    return changedState;
+}
+
+//* ************************************************************************
+//* *************************** PREFERENCES ********************************
+//* ************************************************************************
+
+typedef std::map<std::string, std::vector<uint8_t>> NvsNamespace;
+static std::map<std::string, NvsNamespace> nvs;
+
+void simClearNvs() {
+    nvs.clear();
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (!name || strlen(name) > 15) return false;
+    this->name = name;
+    this->readOnly = readOnly;
+    open = true;
+    return true;
+}
+
+bool Preferences::clear() {
+    if (!open || readOnly) return false;
+    nvs[name].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!open || readOnly) return false;
+    return nvs[name].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return open && nvs[name].count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!open || readOnly || !key || strlen(key) > 15) return 0;
+    const uint8_t* bytes = (const uint8_t*)value;
+    nvs[name][key].assign(bytes, bytes + length);
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!open) return 0;
+    NvsNamespace& entries = nvs[name];
+    auto entry = entries.find(key);
+    return entry == entries.end() ? 0 : entry->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t length) {
+    size_t stored = getBytesLength(key);
+    if (stored == 0 || stored > length) return 0;
+    memcpy(buffer, nvs[name][key].data(), stored);
+    return stored;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t stored = getBytesLength(key);
+    if (stored == 0) return defaultValue;
+    const std::vector<uint8_t>& bytes = nvs[name][key];
+    return String(std::string((const char*)bytes.data(), strnlen((const char*)bytes.data(), stored)));
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+    size_t stored = getBytesLength(key);
+    if (stored == 0 || stored > maxLength) return 0;
+    memcpy(value, nvs[name][key].data(), stored);
+    value[stored - 1] = '\0';
+    return stored;
+}
@@ -0,0 +1,9 @@
+#ifndef NATIVE_SHIM_ESP_CPU_H
+#define NATIVE_SHIM_ESP_CPU_H
+
+#include <stdint.h>
+
+// 240 MHz cycles on the simulated clock
+uint32_t esp_cpu_get_cycle_count(void);
+
+#endif // NATIVE_SHIM_ESP_CPU_H
@@ -0,0 +1,195 @@
+#include <Arduino.h>
+#include <ArduinoOTA.h>
+#include <Update.h>
+#include <WiFi.h>
+#include "esp_system.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sim_machine.h"
+#include "sim_internal.h"
+#include <vector>
+
+//* ************************************************************************
+//* *************************** NATIVE ESP-IDF SHIM ************************
+//* ************************************************************************
+
+UpdateClass Update;
+ArduinoOTAClass ArduinoOTA;
+WiFiClass WiFi;
+
+esp_reset_reason_t esp_reset_reason(void) {
+    return (esp_reset_reason_t)simResetReason();
+}
+
+void esp_restart(void) {
+    throw SimRestart{"esp_restart()"};
+}
+
+uint32_t esp_get_free_heap_size(void) {
+    return simFreeHeap();
+}
+
+//* ************************************************************************
+//* ****************************** FREERTOS ********************************
+//* ************************************************************************
+// Only the loop task exists. Other tasks are accepted and never run; the
+// machine model calls what the firmware needs of them (the watchdog pass).
+
+static int loopTask;
+static int otherTask;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* createdTask, BaseType_t core) {
+    (void)task;
+    (void)name;
+    (void)stackDepth;
+    (void)parameters;
+    (void)priority;
+    (void)core;
+    if (createdTask) *createdTask = &otherTask;
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    simAdvance((uint64_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    (void)task;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return xPortInIsrContext() ? (TaskHandle_t)&otherTask : (TaskHandle_t)&loopTask;
+}
+
+TaskHandle_t xTaskGetHandle(const char* name) {
+    (void)name;
+    return nullptr;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 4096;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(simMicros() / 1000);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    static int mutex;
+    return &mutex;
+}
+
+//* ************************************************************************
+//* ********************** PARTITIONS AND OTA DATA *************************
+//* ************************************************************************
+// partitions.csv, running from app0. Only the journal partition has content.
+
+static const uint32_t JOURNAL_SIZE = 0x40000;
+
+static const esp_partition_t partitionTable[] = {
+    {nullptr, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, 0x9000, 0x5000, 4096, "nvs", false},
+    {nullptr, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA, 0xe000, 0x2000, 4096, "otadata", false},
+    {nullptr, ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0x330000, 4096, "app0", false},
+    {nullptr, ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x340000, 0x330000, 4096, "app1", false},
+    {nullptr, ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x670000, JOURNAL_SIZE, 4096, "journal", false},
+};
+
+static const esp_partition_t* const journalPartition = &partitionTable[4];
+static const esp_partition_t* bootPartition = &partitionTable[2];
+
+// A fresh chip reads erased
+static uint8_t* journalFlash() {
+    static std::vector<uint8_t> flash(JOURNAL_SIZE, 0xFF);
+    return flash.data();
+}
+
+static bool inJournal(const esp_partition_t* partition, size_t offset, size_t size) {
+    return partition == journalPartition && offset <= JOURNAL_SIZE && size <= JOURNAL_SIZE - offset;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+    for (const esp_partition_t& partition : partitionTable) {
+        if (type != ESP_PARTITION_TYPE_ANY && partition.type != type) continue;
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && partition.subtype != subtype) continue;
+        if (label && strcmp(label, partition.label) != 0) continue;
+        return &partition;
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* destination, size_t size) {
+    if (!inJournal(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+    memcpy(destination, journalFlash() + offset, size);
+    return ESP_OK;
+}
+
+// NOR flash: a write can only clear bits
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* source, size_t size) {
+    if (!inJournal(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+    const uint8_t* bytes = (const uint8_t*)source;
+    for (size_t i = 0; i < size; i++) journalFlash()[offset + i] &= bytes[i];
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    if (!inJournal(partition, offset, size) || offset % 4096 || size % 4096) return ESP_ERR_INVALID_ARG;
+    memset(journalFlash() + offset, 0xFF, size);
+    return ESP_OK;
+}
+
+const esp_partition_t* esp_ota_get_running_partition(void) {
+    return &partitionTable[2];
+}
+
+const esp_partition_t* esp_ota_get_boot_partition(void) {
+    return bootPartition;
+}
+
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start) {
+    (void)start;
+    return &partitionTable[3];
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition) {
+    if (!partition || partition->type != ESP_PARTITION_TYPE_APP) return ESP_ERR_INVALID_ARG;
+    bootPartition = partition;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_get_state_partition(const esp_partition_t* partition, esp_ota_img_states_t* state) {
+    if (!partition || !state) return ESP_ERR_INVALID_ARG;
+    *state = ESP_OTA_IMG_VALID;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_valid_cancel_rollback(void) {
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot(void) {
+    throw SimRestart{"OTA rollback"};
+}
+
+//* ************************************************************************
+//* ***************************** NETWORK **********************************
+//* ************************************************************************
+// src/Network is not built natively: no WiFi, no network task.
+
+const char* getDeviceName() {
+    return "stage1-native";
+}
+
+void startNetworkTask() {}
+
+bool isNetworkConnected() {
+    return false;
+}
+
+uint32_t getNetworkReconnectCount() {
+    return 0;
+}
@@ -0,0 +1,7 @@
+#ifndef NATIVE_SHIM_ESP_IDF_VERSION_H
+#define NATIVE_SHIM_ESP_IDF_VERSION_H
+
+#define ESP_IDF_VERSION_MAJOR 5
+#define ESP_IDF_VERSION_MINOR 1
+
+#endif // NATIVE_SHIM_ESP_IDF_VERSION_H
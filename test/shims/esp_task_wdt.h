@@ -0,0 +1,20 @@
+#ifndef NATIVE_SHIM_ESP_TASK_WDT_H
+#define NATIVE_SHIM_ESP_TASK_WDT_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+
+// Accepted and ignored: the native harness checks loop() stalls itself
+typedef struct {
+    uint32_t timeout_ms;
+    uint32_t idle_core_mask;
+    bool trigger_panic;
+} esp_task_wdt_config_t;
+
+inline esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t* config) { (void)config; return ESP_OK; }
+inline esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t* config) { (void)config; return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(TaskHandle_t task) { (void)task; return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset(void) { return ESP_OK; }
+
+#endif // NATIVE_SHIM_ESP_TASK_WDT_H
@@ -0,0 +1,180 @@
+#include <FastAccelStepper.h>
+#include "sim_machine.h"
+#include "sim_internal.h"
+
+//* ************************************************************************
+//* ********************* FASTACCELSTEPPER ON THE MODEL ********************
+//* ************************************************************************
+// Moves ramp at the set acceleration up to the set speed and decelerate to
+// land on the target. The emitted steps drive the axis, which stops at its
+// hard stops; the pulse counter counts what was emitted.
+
+void FastAccelStepper::setDirectionPin(uint8_t pin, bool dirHighCountsUp, uint16_t dirChangeDelayUs) {
+    (void)pin;
+    (void)dirHighCountsUp;
+    (void)dirChangeDelayUs;
+}
+
+int8_t FastAccelStepper::setSpeedInHz(uint32_t speedHz) {
+    if (speedHz == 0) return -1;
+    maxSpeedHz = speedHz;
+    return 0;
+}
+
+int8_t FastAccelStepper::setSpeedInUs(uint32_t stepUs) {
+    if (stepUs == 0) return -1;
+    maxSpeedHz = 1000000UL / stepUs;
+    return 0;
+}
+
+int8_t FastAccelStepper::setAcceleration(int32_t stepsPerSecond2) {
+    if (stepsPerSecond2 <= 0) return -1;
+    acceleration = (uint32_t)stepsPerSecond2;
+    return 0;
+}
+
+void FastAccelStepper::startMove(int32_t newTarget) {
+    target = newTarget;
+    continuous = 0;
+    stopping = false;
+    if (!running && newTarget == reportedPosition()) return;
+    running = true;
+}
+
+int8_t FastAccelStepper::moveTo(int32_t position, bool blocking) {
+    simChargeCall();
+    startMove(position);
+    while (blocking && isRunning()) {}
+    return 0;
+}
+
+int8_t FastAccelStepper::move(int32_t steps, bool blocking) {
+    simChargeCall();
+    return moveTo((running ? target : reportedPosition()) + steps, blocking);
+}
+
+int8_t FastAccelStepper::runForward() {
+    simChargeCall();
+    running = true;
+    stopping = false;
+    continuous = 1;
+    return 0;
+}
+
+int8_t FastAccelStepper::runBackward() {
+    simChargeCall();
+    running = true;
+    stopping = false;
+    continuous = -1;
+    return 0;
+}
+
+void FastAccelStepper::stopMove() {
+    if (running) stopping = true;
+}
+
+void FastAccelStepper::forceStop() {
+    running = false;
+    stopping = false;
+    continuous = 0;
+    velocity = 0;
+    target = reportedPosition();
+}
+
+void FastAccelStepper::forceStopAndNewPosition(int32_t position) {
+    forceStop();
+    offset = position - lround(steps);
+    target = position;
+}
+
+bool FastAccelStepper::isRunning() {
+    simChargeCall();
+    return running;
+}
+
+int32_t FastAccelStepper::getCurrentPosition() {
+    simChargeCall();
+    return reportedPosition();
+}
+
+void FastAccelStepper::setCurrentPosition(int32_t position) {
+    // The rest of a move in flight keeps its length
+    int64_t shift = (int64_t)position - reportedPosition();
+    offset += shift;
+    target = (int32_t)(target + shift);
+}
+
+int32_t FastAccelStepper::getCurrentSpeedInMilliHz() {
+    return running ? (int32_t)lround(velocity * 1000.0) : 0;
+}
+
+bool FastAccelStepper::attachToPulseCounter(uint8_t unit, int16_t lowLimit, int16_t highLimit, uint16_t dirPin) {
+    (void)unit;
+    (void)lowLimit;
+    (void)highLimit;
+    (void)dirPin;
+    pulseCounterAttached = true;
+    clearPulseCounter();
+    return true;
+}
+
+int16_t FastAccelStepper::readPulseCounter() {
+    if (!pulseCounterAttached) return 0;
+    // The counter resets to 0 at either limit, like the PCNT unit
+    return (int16_t)((lround(steps) - pulseCounterBase) % 16384);
+}
+
+void FastAccelStepper::clearPulseCounter() {
+    pulseCounterBase = lround(steps);
+}
+
+void FastAccelStepper::simStep(double seconds) {
+    if (!running) return;
+
+    double a = (double)acceleration;
+    double position = steps + offset;
+    double direction;
+    if (stopping) {
+        direction = velocity > 0 ? -1 : 1;
+        if (fabs(velocity) <= a * seconds) {
+            forceStop();
+            return;
+        }
+        velocity += direction * a * seconds;
+    } else {
+        double remaining = continuous ? continuous * 1e12 : target - position;
+        direction = remaining >= 0 ? 1 : -1;
+        double stoppingDistance = velocity * velocity / (2 * a);
+        bool wrongWay = velocity * direction < 0;
+        if (wrongWay || stoppingDistance >= fabs(remaining)) {
+            velocity -= (velocity > 0 ? 1 : -1) * a * seconds;
+            if (wrongWay && velocity * direction > 0) velocity = 0;
+        } else {
+            velocity += direction * a * seconds;
+        }
+        double limit = (double)maxSpeedHz;
+        if (velocity > limit) velocity = limit;
+        if (velocity < -limit) velocity = -limit;
+    }
+
+    double before = steps;
+    steps += velocity * seconds;
+    if (!stopping && !continuous) {
+        // Land on the target the step it is reached or passed
+        double remainingAfter = target - (steps + offset);
+        if (remainingAfter * direction <= 0.5) {
+            steps = target - offset;
+            velocity = 0;
+            running = false;
+        }
+    }
+    physical += steps - before;
+    if (physical < lowStop) physical = lowStop;
+    if (physical > highStop) physical = highStop;
+}
+
+FastAccelStepper* FastAccelStepperEngine::stepperConnectToPin(uint8_t stepPin) {
+    FastAccelStepper* stepper = new FastAccelStepper(stepPin);
+    simAttachMotor(stepper);
+    return stepper;
+}
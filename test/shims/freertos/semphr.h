@@ -0,0 +1,13 @@
+#ifndef NATIVE_SHIM_FREERTOS_SEMPHR_H
+#define NATIVE_SHIM_FREERTOS_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+// Single task: a mutex is always free
+typedef void* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t wait) { (void)mutex; (void)wait; return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) { (void)mutex; return pdTRUE; }
+
+#endif // NATIVE_SHIM_FREERTOS_SEMPHR_H
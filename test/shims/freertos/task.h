@@ -0,0 +1,19 @@
+#ifndef NATIVE_SHIM_FREERTOS_TASK_H
+#define NATIVE_SHIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+// Only the loop task runs; other tasks are created but never scheduled
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* createdTask, BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TaskHandle_t xTaskGetHandle(const char* name);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+TickType_t xTaskGetTickCount(void);
+
+#endif // NATIVE_SHIM_FREERTOS_TASK_H
@@ -0,0 +1,21 @@
+#ifndef NATIVE_SHIM_SIM_INTERNAL_H
+#define NATIVE_SHIM_SIM_INTERNAL_H
+
+#include <FastAccelStepper.h>
+
+// Between the shims and the machine model; tests use sim_machine.h
+
+// Charge SIM_CALL_COST_US for a clock, pin or motor query
+void simChargeCall();
+
+// Register a stepper from FastAccelStepperEngine (axis picked by step pin)
+void simAttachMotor(FastAccelStepper* stepper);
+
+// Serial output enabled by simSetSerialEcho()
+bool simSerialEcho();
+
+uint32_t simFreeHeap();
+uint32_t simLargestFreeBlock();
+int simResetReason();
+
+#endif // NATIVE_SHIM_SIM_INTERNAL_H
@@ -0,0 +1,433 @@
+#include "sim_machine.h"
+#include "sim_internal.h"
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "Watchdog/watchdog_supervisor.h"
+#include <deque>
+#include <map>
+
+//* ************************************************************************
+//* ************************** MACHINE MODEL *******************************
+//* ************************************************************************
+
+extern void setup();
+extern void loop();
+extern FastAccelStepper* cutMotor;
+extern FastAccelStepper* feedMotor;
+
+static const uint64_t SIM_STEP_US = 50;                   // Integration step
+static const uint64_t SIM_CRITICAL_STALL_US = 2000000;    // Time inside one critical section
+static const uint8_t SIM_PIN_COUNT = 64;
+static const size_t SIM_TRANSITION_CAPACITY = 4096;      // Reserved at boot
+
+static const double CUT_HARD_STOP_INCHES = -0.25;
+static const double CUT_BOOT_INCHES = 0.5;
+static const double FEED_HARD_STOP_INCHES = 0.25;
+static const double FEED_BOOT_INCHES = -2.0;
+
+struct SimPin {
+    int level;
+    void (*isr)();
+    void (*isrWithArg)(void*);
+    void* arg;
+    int mode;
+};
+
+struct SimIsr {
+    uint8_t pin;
+};
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t periodUs;
+    uint64_t dueUs;
+    bool active;
+};
+
+static uint64_t nowUs = 0;
+static SimPin pins[SIM_PIN_COUNT];
+static uint32_t analogMilliVolts[SIM_PIN_COUNT];
+// Pending interrupts in the order they were raised, at most one per pin like
+// the GPIO interrupt status bits (fixed storage: the model never allocates
+// while the firmware runs, see test/test_alloc_control_loop)
+static SimIsr pendingIsrs[SIM_PIN_COUNT];
+static bool isrPending[SIM_PIN_COUNT];
+static uint8_t pendingIsrHead = 0;
+static uint8_t pendingIsrCount = 0;
+static std::deque<esp_timer*> timers;
+static std::multimap<uint64_t, std::pair<uint8_t, int>> scheduledInputs;
+static uint64_t nextWatchdogCheckUs = 0;
+static bool booted = false;
+
+static int criticalDepth = 0;
+static uint64_t criticalSinceUs = 0;
+static int callbackDepth = 0;    // Inside an ISR, timer callback or watchdog pass
+
+static bool homeSwitchStuckOpen[2];
+static bool serialEcho = false;
+static uint32_t freeHeap = 200000;
+static uint32_t largestFreeBlock = 110000;
+static int resetReason = ESP_RST_POWERON;
+
+static std::vector<SimTransition> transitions;
+static SystemState lastSeenState = STARTUP;
+static void (*stepHook)() = nullptr;
+
+// Interrupt handlers, timer callbacks and the supervisor run on "the other
+// core": simulated time stands still for them
+struct CallbackScope {
+    CallbackScope() { callbackDepth++; }
+    ~CallbackScope() { callbackDepth--; }
+};
+
+static void setPinLevel(uint8_t pin, int level) {
+    if (pin >= SIM_PIN_COUNT) return;
+    SimPin& p = pins[pin];
+    level = level ? HIGH : LOW;
+    if (p.level == level) return;
+    p.level = level;
+    if (!p.isr && !p.isrWithArg) return;
+    bool fires = p.mode == CHANGE || (p.mode == RISING && level == HIGH) || (p.mode == FALLING && level == LOW);
+    if (!fires || isrPending[pin]) return;
+    isrPending[pin] = true;
+    pendingIsrs[(pendingIsrHead + pendingIsrCount) % SIM_PIN_COUNT] = {pin};
+    pendingIsrCount++;
+}
+
+static void dispatchPending() {
+    if (criticalDepth > 0 || callbackDepth > 0) return;
+    CallbackScope scope;
+
+    while (pendingIsrCount > 0) {
+        uint8_t pin = pendingIsrs[pendingIsrHead].pin;
+        pendingIsrHead = (pendingIsrHead + 1) % SIM_PIN_COUNT;
+        pendingIsrCount--;
+        isrPending[pin] = false;
+        SimPin& p = pins[pin];
+        if (p.isrWithArg) p.isrWithArg(p.arg);
+        else if (p.isr) p.isr();
+    }
+
+    for (size_t i = 0; i < timers.size(); i++) {
+        esp_timer* timer = timers[i];
+        if (!timer->active || timer->dueUs > nowUs) continue;
+        if (timer->periodUs) timer->dueUs += timer->periodUs;
+        else timer->active = false;
+        timer->callback(timer->arg);
+    }
+
+    if (nowUs >= nextWatchdogCheckUs) {
+        nextWatchdogCheckUs = nowUs + WATCHDOG_CHECK_INTERVAL_MS * 1000ULL;
+        runWatchdogCheck();
+    }
+}
+
+static void updateHomeSwitches() {
+    if (cutMotor) {
+        bool closed = cutMotor->simPhysicalPosition() <= 0 && !homeSwitchStuckOpen[SIM_CUT_HOME_SWITCH];
+        setPinLevel(CUT_MOTOR_HOME_SWITCH, closed ? HIGH : LOW);
+    }
+    if (feedMotor) {
+        bool closed = feedMotor->simPhysicalPosition() >= 0 && !homeSwitchStuckOpen[SIM_FEED_HOME_SWITCH];
+        setPinLevel(FEED_MOTOR_HOME_SWITCH, closed ? HIGH : LOW);
+    }
+}
+
+void simAdvance(uint64_t us) {
+    if (callbackDepth > 0) return;
+    if (criticalDepth > 0 && nowUs - criticalSinceUs > SIM_CRITICAL_STALL_US) throw SimStall{nowUs};
+
+    uint64_t endUs = nowUs + us;
+    while (nowUs < endUs) {
+        uint64_t step = std::min(endUs - nowUs, SIM_STEP_US);
+        nowUs += step;
+        while (!scheduledInputs.empty() && scheduledInputs.begin()->first <= nowUs) {
+            setPinLevel(scheduledInputs.begin()->second.first, scheduledInputs.begin()->second.second);
+            scheduledInputs.erase(scheduledInputs.begin());
+        }
+        if (cutMotor) cutMotor->simStep(step / 1e6);
+        if (feedMotor) feedMotor->simStep(step / 1e6);
+        updateHomeSwitches();
+
+        if (currentState != lastSeenState) {
+            transitions.push_back({lastSeenState, currentState, nowUs});
+            lastSeenState = currentState;
+        }
+        if (stepHook) stepHook();
+        dispatchPending();
+    }
+}
+
+void simChargeCall() {
+    simAdvance(SIM_CALL_COST_US);
+}
+
+uint64_t simMicros() {
+    return nowUs;
+}
+
+void simAttachMotor(FastAccelStepper* stepper) {
+    if (stepper->getStepPin() == CUT_MOTOR_STEP_PIN) {
+        stepper->simSetHardStops(CUT_HARD_STOP_INCHES * CUT_MOTOR_STEPS_PER_INCH, 1e9);
+        stepper->simSetPhysicalPosition(CUT_BOOT_INCHES * CUT_MOTOR_STEPS_PER_INCH);
+    } else if (stepper->getStepPin() == FEED_MOTOR_STEP_PIN) {
+        stepper->simSetHardStops(-1e9, FEED_HARD_STOP_INCHES * FEED_MOTOR_STEPS_PER_INCH);
+        stepper->simSetPhysicalPosition(FEED_BOOT_INCHES * FEED_MOTOR_STEPS_PER_INCH);
+    }
+}
+
+void simBoot() {
+    if (booted) return;
+    booted = true;
+    transitions.reserve(SIM_TRANSITION_CAPACITY);
+    // A loaded machine with suction: 2x4 present (LOW), suction confirmed (HIGH)
+    pins[_2x4_PRESENT_SENSOR].level = LOW;
+    pins[WOOD_SUCTION_CONFIRM_SENSOR].level = HIGH;
+    setup();
+    updateHomeSwitches();
+}
+
+void simSetResetReason(int reason) {
+    resetReason = reason;
+}
+
+int simResetReason() {
+    return resetReason;
+}
+
+void simSetSerialEcho(bool echo) {
+    serialEcho = echo;
+}
+
+bool simSerialEcho() {
+    return serialEcho;
+}
+
+void simTick() {
+    loop();
+    simAdvance(SIM_LOOP_GAP_US);
+}
+
+void simRunFor(uint32_t ms) {
+    uint64_t endUs = nowUs + ms * 1000ULL;
+    while (nowUs < endUs) simTick();
+}
+
+bool simRunUntilState(SystemState state, uint32_t timeoutMs) {
+    uint64_t endUs = nowUs + timeoutMs * 1000ULL;
+    while (currentState != state) {
+        if (nowUs >= endUs) return false;
+        simTick();
+    }
+    return true;
+}
+
+void simSetInput(int pin, int level) {
+    if (pin < 0 || pin >= SIM_PIN_COUNT) return;
+    setPinLevel((uint8_t)pin, level);
+    dispatchPending();
+}
+
+void simScheduleInput(int pin, int level, uint64_t atUs) {
+    if (pin < 0 || pin >= SIM_PIN_COUNT) return;
+    scheduledInputs.insert({atUs, {(uint8_t)pin, level}});
+}
+
+int simGetOutput(int pin) {
+    return pin >= 0 && pin < SIM_PIN_COUNT ? pins[pin].level : LOW;
+}
+
+void simSetAnalogMilliVolts(int pin, uint32_t millivolts) {
+    if (pin >= 0 && pin < SIM_PIN_COUNT) analogMilliVolts[pin] = millivolts;
+}
+
+void simSetHomeSwitchFault(SimHomeSwitch which, bool stuckOpen) {
+    homeSwitchStuckOpen[which] = stuckOpen;
+    updateHomeSwitches();
+}
+
+double simCutInches() {
+    return cutMotor ? cutMotor->simPhysicalPosition() / CUT_MOTOR_STEPS_PER_INCH : 0;
+}
+
+double simFeedInches() {
+    return feedMotor ? feedMotor->simPhysicalPosition() / FEED_MOTOR_STEPS_PER_INCH : 0;
+}
+
+void simSetFreeHeap(uint32_t freeBytes, uint32_t largestBlock) {
+    freeHeap = freeBytes;
+    largestFreeBlock = largestBlock;
+}
+
+uint32_t simFreeHeap() {
+    return freeHeap;
+}
+
+uint32_t simLargestFreeBlock() {
+    return largestFreeBlock;
+}
+
+const std::vector<SimTransition>& simTransitions() {
+    return transitions;
+}
+
+void simClearTransitions() {
+    transitions.clear();
+}
+
+void simSetStepHook(void (*hook)()) {
+    stepHook = hook;
+}
+
+//* ************************************************************************
+//* ************************ CLOCK, PINS, INTERRUPTS ***********************
+//* ************************************************************************
+
+unsigned long millis() {
+    simChargeCall();
+    return (unsigned long)(nowUs / 1000);
+}
+
+unsigned long micros() {
+    simChargeCall();
+    return (unsigned long)nowUs;
+}
+
+void delay(unsigned long ms) {
+    simAdvance(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    simAdvance(us);
+}
+
+int64_t esp_timer_get_time(void) {
+    simChargeCall();
+    return (int64_t)nowUs;
+}
+
+uint32_t esp_cpu_get_cycle_count(void) {
+    return (uint32_t)(nowUs * 240);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    setPinLevel(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+    simChargeCall();
+    return pin < SIM_PIN_COUNT ? pins[pin].level : LOW;
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    simChargeCall();
+    return pin < SIM_PIN_COUNT ? analogMilliVolts[pin] : 0;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    if (pin >= SIM_PIN_COUNT) return;
+    pins[pin].isr = isr;
+    pins[pin].isrWithArg = nullptr;
+    pins[pin].mode = mode;
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    if (pin >= SIM_PIN_COUNT) return;
+    pins[pin].isr = nullptr;
+    pins[pin].isrWithArg = isr;
+    pins[pin].arg = arg;
+    pins[pin].mode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= SIM_PIN_COUNT) return;
+    pins[pin].isr = nullptr;
+    pins[pin].isrWithArg = nullptr;
+}
+
+void REG_WRITE(uint32_t reg, uint32_t value) {
+    bool set = reg == GPIO_OUT_W1TS_REG || reg == GPIO_OUT1_W1TS_REG;
+    uint8_t base = (reg == GPIO_OUT1_W1TS_REG || reg == GPIO_OUT1_W1TC_REG) ? 32 : 0;
+    for (uint8_t bit = 0; bit < 32; bit++) {
+        if (value & (1UL << bit)) setPinLevel(base + bit, set ? HIGH : LOW);
+    }
+}
+
+uint32_t REG_READ(uint32_t reg) {
+    uint8_t base = reg == GPIO_IN1_REG ? 32 : 0;
+    uint32_t value = 0;
+    for (uint8_t bit = 0; bit < 32; bit++) {
+        if (pins[base + bit].level) value |= 1UL << bit;
+    }
+    return value;
+}
+
+void portENTER_CRITICAL(portMUX_TYPE* mux) {
+    if (criticalDepth++ == 0) criticalSinceUs = nowUs;
+    mux->depth++;
+}
+
+void portEXIT_CRITICAL(portMUX_TYPE* mux) {
+    mux->depth--;
+    if (--criticalDepth == 0) dispatchPending();
+}
+
+BaseType_t xPortInIsrContext(void) {
+    return callbackDepth > 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xPortGetCoreID(void) {
+    return callbackDepth > 0 ? 0 : 1;
+}
+
+//* ************************************************************************
+//* ****************************** ESP TIMER *******************************
+//* ************************************************************************
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    if (!args || !args->callback || !handle) return ESP_ERR_INVALID_ARG;
+    esp_timer* timer = new esp_timer{args->callback, args->arg, 0, 0, false};
+    timers.push_back(timer);
+    *handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    if (!timer || timer->active) return ESP_ERR_INVALID_STATE;
+    timer->periodUs = periodUs;
+    timer->dueUs = nowUs + periodUs;
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    if (!timer || timer->active) return ESP_ERR_INVALID_STATE;
+    timer->periodUs = 0;
+    timer->dueUs = nowUs + timeoutUs;
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer || !timer->active) return ESP_ERR_INVALID_STATE;
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    timer->active = false; // Kept: a callback may still hold the handle
+    return ESP_OK;
+}
@@ -0,0 +1,96 @@
+#ifndef NATIVE_SHIM_SIM_MACHINE_H
+#define NATIVE_SHIM_SIM_MACHINE_H
+
+#include <Arduino.h>
+#include <vector>
+#include "StateMachine/99_GENERAL_FUNCTIONS.h"
+
+//* ************************************************************************
+//* ************************** MACHINE MODEL *******************************
+//* ************************************************************************
+// The Stage 1 table saw as the native build sees it. One simulated core runs
+// setup() and loop(); everything else happens on the simulated clock:
+//   - every clock, pin or motor query costs SIM_CALL_COST_US, so the
+//     firmware's busy-wait loops make progress; delay() and vTaskDelay()
+//     advance by the full amount
+//   - input edges run the attached interrupt handlers and esp_timer
+//     callbacks fire when due, both held off inside critical sections
+//   - the watchdog supervisor runs one pass every WATCHDOG_CHECK_INTERVAL_MS,
+//     so a blocking section that overruns its deadline gets the real safe
+//     stop; esp_restart() and ESP.restart() then throw SimRestart
+//   - both axes move trapezoidally between hard stops:
+//       cut   home switch closed at <= 0 in, hard stop at -0.25 in,
+//             powers up 0.5 in out
+//       feed  home switch closed at >= 0 in, hard stop at +0.25 in,
+//             powers up 2 in from the switch
+//     Past a hard stop the axis stays put while the library keeps counting,
+//     like a stepper losing steps.
+// The operator switches and the two wood sensors are test inputs. The home
+// switches follow the axes unless simSetHomeSwitchFault() holds one open.
+// Nothing is reset between tests: a process boots the machine once.
+
+const uint32_t SIM_CALL_COST_US = 2;     // Per clock, pin or motor query
+const uint32_t SIM_LOOP_GAP_US = 50;     // Between two loop() calls
+
+// A safe stop by the watchdog supervisor, an OTA rollback or any other restart
+struct SimRestart {
+    const char* reason;
+};
+
+// Simulated time stood still (a busy loop inside a critical section)
+struct SimStall {
+    uint64_t atUs;
+};
+
+struct SimTransition {
+    SystemState from;
+    SystemState to;
+    uint64_t atUs;
+};
+
+enum SimHomeSwitch : uint8_t {
+    SIM_CUT_HOME_SWITCH,
+    SIM_FEED_HOME_SWITCH
+};
+
+// setup() with the given reset reason (quiet serial unless echo is on)
+void simBoot();
+void simSetResetReason(int reason);   // esp_reset_reason_t for the next simBoot()
+void simSetSerialEcho(bool echo);
+
+// One loop() call plus SIM_LOOP_GAP_US
+void simTick();
+// Call loop() until the time has passed / the state is reached (false on timeout)
+void simRunFor(uint32_t ms);
+bool simRunUntilState(SystemState state, uint32_t timeoutMs);
+
+uint64_t simMicros();
+void simAdvance(uint64_t us);
+
+// Operator switches and wood sensors (pin levels as the firmware reads them)
+void simSetInput(int pin, int level);
+// Same at a later simulated time, even in the middle of a blocking call
+void simScheduleInput(int pin, int level, uint64_t atUs);
+int simGetOutput(int pin);
+void simSetAnalogMilliVolts(int pin, uint32_t millivolts);
+void simSetHomeSwitchFault(SimHomeSwitch which, bool stuckOpen);
+
+// Axis positions in inches from the home switch (cut: out is positive,
+// feed: away from the switch is negative)
+double simCutInches();
+double simFeedInches();
+
+// Heap figures ESP.getFreeHeap() / getMaxAllocHeap() report
+void simSetFreeHeap(uint32_t freeBytes, uint32_t largestBlock);
+
+// NVS contents survive simBoot(); this empties them
+void simClearNvs();
+
+// Every state change seen at a simulated step, in order
+const std::vector<SimTransition>& simTransitions();
+void simClearTransitions();
+
+// Called after every simulated step (physical checks by a fuzz target)
+void simSetStepHook(void (*hook)());
+
+#endif // NATIVE_SHIM_SIM_MACHINE_H
@@ -0,0 +1,11 @@
+#ifndef NATIVE_SHIM_GPIO_REG_H
+#define NATIVE_SHIM_GPIO_REG_H
+
+#define GPIO_OUT_W1TS_REG 0x60004008
+#define GPIO_OUT_W1TC_REG 0x6000400C
+#define GPIO_OUT1_W1TS_REG 0x60004014
+#define GPIO_OUT1_W1TC_REG 0x60004018
+#define GPIO_IN_REG 0x6000403C
+#define GPIO_IN1_REG 0x60004040
+
+#endif // NATIVE_SHIM_GPIO_REG_H
@@ -0,0 +1,10 @@
+#ifndef NATIVE_SHIM_SOC_H
+#define NATIVE_SHIM_SOC_H
+
+#include <stdint.h>
+
+// GPIO register writes land on the simulated output pins
+void REG_WRITE(uint32_t reg, uint32_t value);
+uint32_t REG_READ(uint32_t reg);
+
+#endif // NATIVE_SHIM_SOC_H
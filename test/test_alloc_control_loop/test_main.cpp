@@ -0,0 +1,114 @@
+#include <unity.h>
+#include <cstdlib>
+#include <new>
+#include "sim_machine.h"
+#include "Config/Pins_Definitions.h"
+#include "Diagnostics/memory_monitor.h"
+#include "StateMachine/StateManager.h"
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+
+//* ************************************************************************
+//* ********************** CONTROL LOOP ALLOCATIONS ************************
+//* ************************************************************************
+// Runs the firmware with MEMORY_ALLOC_TRACKING on, the same malloc wraps as
+// the board build, and checks the loop task allocates nothing after setup():
+// not while homing, not when IDLE is first reached, not over full cycles.
+//
+//   pio test -e native_alloc
+
+#if !MEMORY_ALLOC_TRACKING
+#error "Build with -DMEMORY_ALLOC_TRACKING=1 and the malloc wraps ([env:native_alloc])"
+#endif
+
+// On the board operator new is linked statically and reaches the wrapped
+// malloc; the host's libstdc++ is shared, so route it there by hand
+void* operator new(size_t size) {
+    void* block = malloc(size ? size : 1);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t size) noexcept {
+    (void)size;
+    free(block);
+}
+
+// Simulated run in which a restart or a stall fails the test; with a state,
+// stop there and report whether it was reached
+static bool run(uint32_t ms, SystemState until = STARTUP) {
+    const char* aborted = nullptr;
+    bool reached = false;
+    try {
+        if (until != STARTUP) reached = simRunUntilState(until, ms);
+        else simRunFor(ms);
+    } catch (const SimRestart& restart) {
+        aborted = restart.reason;
+    } catch (const SimStall&) {
+        aborted = "simulated time stalled inside a critical section";
+    }
+    if (aborted) TEST_FAIL_MESSAGE(aborted);
+    return reached;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_tracking_counts_loop_allocations(void) {
+    void* (*volatile allocate)(size_t) = malloc; // Not folded away by the compiler
+    uint32_t before = getControlAllocationCount();
+    free(allocate(32));
+    TEST_ASSERT_EQUAL_UINT32(before + 1, getControlAllocationCount());
+}
+
+void test_boot_to_idle_allocates_nothing(void) {
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getControlAllocationCount(), "homing or first IDLE allocated");
+}
+
+void test_cycles_allocate_nothing(void) {
+    uint32_t before = getControlAllocationCount();
+
+    // Two continuous cycles with wood
+    simSetInput(START_CYCLE_SWITCH, HIGH);
+    TEST_ASSERT_TRUE(run(1000, CUTTING));
+    TEST_ASSERT_TRUE(run(20000, RETURNING_YES_2x4));
+    TEST_ASSERT_TRUE(run(20000, CUTTING));
+    TEST_ASSERT_TRUE(run(20000, RETURNING_YES_2x4));
+    simSetInput(START_CYCLE_SWITCH, LOW);
+    TEST_ASSERT_TRUE(run(20000, IDLE));
+
+    // One cycle on the last piece
+    simSetInput(_2x4_PRESENT_SENSOR, HIGH);
+    simSetInput(START_CYCLE_SWITCH, HIGH);
+    TEST_ASSERT_TRUE(run(1000, CUTTING));
+    simSetInput(START_CYCLE_SWITCH, LOW);
+    TEST_ASSERT_TRUE(run(20000, IDLE));
+    simSetInput(_2x4_PRESENT_SENSOR, LOW);
+
+    // Reload mode in and out
+    simSetInput(RELOAD_SWITCH, HIGH);
+    run(300);
+    simSetInput(RELOAD_SWITCH, LOW);
+    run(300);
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(before, getControlAllocationCount(), "control loop allocated");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getTotalStateInvariantViolations(), "state invariant violated");
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    simBoot();
+    simRunUntilState(IDLE, 10000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_to_idle_allocates_nothing);
+    RUN_TEST(test_cycles_allocate_nothing);
+    RUN_TEST(test_tracking_counts_loop_allocations);
+    return UNITY_END();
+}
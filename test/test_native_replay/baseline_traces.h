@@ -0,0 +1,103 @@
+#ifndef BASELINE_TRACES_H
+#define BASELINE_TRACES_H
+
+#include "InputTrace/input_trace.h"
+
+//* ************************************************************************
+//* ************************ SYNTHETIC BASELINE TRACES *********************
+//* ************************************************************************
+// SYNTHETIC: these traces were captured from the firmware running on the
+// machine model (test/shims), not from a machine. They are regression
+// baselines - a replay shows the state machine still behaves as it did when
+// they were taken - and say nothing about how the real saw behaves.
+//
+// Same format as a trace downloaded from a machine (GET /inputs.bin),
+// converted with
+//   python3 tools/replay_input_trace.py inputs.bin --c-array NAME
+// Home switch edges are kept for reference; the replay takes them from the
+// machine model. Add traces captured on a machine to a separate header so the
+// two kinds are never mixed.
+
+// 9 events, frozen by MANUAL in IDLE
+const uint8_t CYCLE_WITH_WOOD_TRACE_LEVELS = 0x41; // Input levels before the first event
+const InputTraceEvent CYCLE_WITH_WOOD_TRACE[] = {
+    {0, 3, 1, 2, 0}, // START_CYCLE HIGH
+    {19954, INPUT_TRACE_STATE, 5, 2, 0}, // IDLE -> CUTTING
+    {120046, 3, 0, 5, 0}, // START_CYCLE LOW
+    {130306, 0, 0, 5, 0}, // CUT_HOME LOW
+    {6579474, INPUT_TRACE_STATE, 6, 5, 0}, // CUTTING -> RETURNING_YES_2x4
+    {7871650, 0, 1, 6, 0}, // CUT_HOME HIGH
+    {8913626, 1, 1, 6, 0}, // FEED_HOME HIGH
+    {9122304, 1, 0, 6, 0}, // FEED_HOME LOW
+    {9210816, INPUT_TRACE_STATE, 2, 6, 0}, // RETURNING_YES_2x4 -> IDLE
+};
+
+// 11 events, frozen by MANUAL in IDLE
+const uint8_t CYCLE_WITHOUT_WOOD_TRACE_LEVELS = 0x41; // Input levels before the first event
+const InputTraceEvent CYCLE_WITHOUT_WOOD_TRACE[] = {
+    {0, 5, 1, 2, 0}, // 2X4_SENSOR HIGH
+    {50012, 3, 1, 2, 0}, // START_CYCLE HIGH
+    {69966, INPUT_TRACE_STATE, 5, 2, 0}, // IDLE -> CUTTING
+    {71334, 0, 0, 5, 0}, // CUT_HOME LOW
+    {170012, 3, 0, 5, 0}, // START_CYCLE LOW
+    {6558700, INPUT_TRACE_STATE, 7, 5, 0}, // CUTTING -> RETURNING_NO_2x4
+    {7857142, 0, 1, 7, 0}, // CUT_HOME HIGH
+    {10685474, 1, 1, 7, 0}, // FEED_HOME HIGH
+    {10894046, 1, 0, 7, 0}, // FEED_HOME LOW
+    {10981806, INPUT_TRACE_STATE, 2, 7, 0}, // RETURNING_NO_2x4 -> IDLE
+    {11181914, 5, 0, 2, 0}, // 2X4_SENSOR LOW
+};
+
+// 6 events, frozen by SUCTION_ERROR_HOLD in SUCTION_ERROR_HOLD
+const uint8_t SUCTION_FAULT_TRACE_LEVELS = 0x41; // Input levels before the first event
+const InputTraceEvent SUCTION_FAULT_TRACE[] = {
+    {0, 6, 0, 2, 0}, // SUCTION_SENSOR LOW
+    {50026, 3, 1, 2, 0}, // START_CYCLE HIGH
+    {69980, INPUT_TRACE_STATE, 5, 2, 0}, // IDLE -> CUTTING
+    {114702, 0, 0, 5, 0}, // CUT_HOME LOW
+    {170026, 3, 0, 5, 0}, // START_CYCLE LOW
+    {570256, INPUT_TRACE_STATE, 11, 5, 0}, // CUTTING -> SUCTION_ERROR_HOLD
+};
+
+// 7 events, frozen by MANUAL in IDLE
+const uint8_t SUCTION_FAULT_RESET_TRACE_LEVELS = 0x40; // Input levels before the first event
+const InputTraceEvent SUCTION_FAULT_RESET_TRACE[] = {
+    {0, 3, 1, 11, 0}, // START_CYCLE HIGH
+    {19582, INPUT_TRACE_STATE, 1, 11, 0}, // SUCTION_ERROR_HOLD -> HOMING
+    {120000, 3, 0, 1, 0}, // START_CYCLE LOW
+    {843614, 0, 1, 1, 0}, // CUT_HOME HIGH
+    {942008, 1, 1, 1, 0}, // FEED_HOME HIGH
+    {1150588, 1, 0, 1, 0}, // FEED_HOME LOW
+    {1339298, INPUT_TRACE_STATE, 2, 1, 0}, // HOMING -> IDLE
+};
+
+// 4 events, frozen by MANUAL in IDLE
+const uint8_t MANUAL_FEED_TRACE_LEVELS = 0x41; // Input levels before the first event
+const InputTraceEvent MANUAL_FEED_TRACE[] = {
+    {0, 4, 1, 2, 0}, // MANUAL_FEED HIGH
+    {19198, INPUT_TRACE_STATE, 4, 2, 0}, // IDLE -> FEED_WOOD_FWD_ONE
+    {120040, 4, 0, 4, 0}, // MANUAL_FEED LOW
+    {1853734, INPUT_TRACE_STATE, 2, 4, 0}, // FEED_WOOD_FWD_ONE -> IDLE
+};
+
+// 15 events, frozen by MANUAL in IDLE
+const uint8_t CONTINUOUS_TWO_CYCLES_TRACE_LEVELS = 0x41; // Input levels before the first event
+const InputTraceEvent CONTINUOUS_TWO_CYCLES_TRACE[] = {
+    {0, 3, 1, 2, 0}, // START_CYCLE HIGH
+    {19306, INPUT_TRACE_STATE, 5, 2, 0}, // IDLE -> CUTTING
+    {129860, 0, 0, 5, 0}, // CUT_HOME LOW
+    {6579218, INPUT_TRACE_STATE, 6, 5, 0}, // CUTTING -> RETURNING_YES_2x4
+    {7871394, 0, 1, 6, 0}, // CUT_HOME HIGH
+    {8914582, 1, 1, 6, 0}, // FEED_HOME HIGH
+    {9124028, 1, 0, 6, 0}, // FEED_HOME LOW
+    {9212572, INPUT_TRACE_STATE, 5, 6, 0}, // RETURNING_YES_2x4 -> CUTTING
+    {9214044, 0, 0, 5, 0}, // CUT_HOME LOW
+    {12000026, 3, 0, 5, 0}, // START_CYCLE LOW
+    {15701168, INPUT_TRACE_STATE, 6, 5, 0}, // CUTTING -> RETURNING_YES_2x4
+    {16999608, 0, 1, 6, 0}, // CUT_HOME HIGH
+    {17942440, 1, 1, 6, 0}, // FEED_HOME HIGH
+    {18152220, 1, 0, 6, 0}, // FEED_HOME LOW
+    {18240200, INPUT_TRACE_STATE, 2, 6, 0}, // RETURNING_YES_2x4 -> IDLE
+};
+
+#endif // BASELINE_TRACES_H
@@ -0,0 +1,236 @@
+#include <unity.h>
+#include "sim_machine.h"
+#include "baseline_traces.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "InputTrace/input_trace.h"
+#include "StateMachine/StateManager.h"
+#include "StateMachine/StateTransitions.h"
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+#include "StateMachine/99_STEP_PULSE_FUNCTIONS.h"
+#include "Diagnostics/memory_monitor.h"
+#include "StatusLeds/led_pattern_engine.h"
+
+//* ************************************************************************
+//* ************************* NATIVE STATE REPLAY **************************
+//* ************************************************************************
+// Plays input traces into the real state classes running on the machine
+// model (test/shims/sim_machine.h) and checks the firmware makes the traced
+// state changes, in order and on time. Operator switch and sensor edges come
+// from the trace at their traced times; the home switches follow the
+// modelled axes. Every replay must also leave the state invariants, the
+// transition table and the step pulse check clean.
+//
+// The traces in baseline_traces.h are synthetic regression baselines taken
+// on the model itself: they catch behaviour changes, not model errors.
+//
+//   pio test -e native
+//
+// The machine boots once; each test starts where the previous one left it
+// (IDLE unless the trace says otherwise).
+
+const uint32_t REPLAY_TOLERANCE_US = 20000;   // Traced vs replayed state change
+const uint32_t REPLAY_TAIL_MS = 500;          // Run on after the last event
+
+static int tracePin(uint8_t source) {
+    switch (source) {
+        case INPUT_TRACE_RELOAD: return RELOAD_SWITCH;
+        case INPUT_TRACE_START_CYCLE: return START_CYCLE_SWITCH;
+        case INPUT_TRACE_MANUAL_FEED: return MANUAL_FEED_SWITCH;
+        case INPUT_TRACE_2X4_SENSOR: return _2x4_PRESENT_SENSOR;
+        case INPUT_TRACE_SUCTION_SENSOR: return WOOD_SUCTION_CONFIRM_SENSOR;
+        default: return -1; // Home switches follow the model
+    }
+}
+
+static void replayTrace(const InputTraceEvent* events, size_t count, uint8_t levels) {
+    char message[160];
+    TEST_ASSERT_TRUE(count > 0);
+    snprintf(message, sizeof(message), "trace starts in %s", getSystemStateName((SystemState)events[0].state));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(events[0].state, currentState, message);
+
+    uint32_t invariantsBefore = getTotalStateInvariantViolations();
+    uint32_t undeclaredBefore = getUndeclaredTransitionCount();
+    uint32_t pulseMismatchesBefore = getStepPulseMismatchCount();
+
+    for (uint8_t source = 0; source < INPUT_TRACE_INPUT_COUNT; source++) {
+        if (tracePin(source) >= 0) simSetInput(tracePin(source), (levels >> source) & 1);
+    }
+
+    uint64_t startUs = simMicros();
+    std::vector<SimTransition> expected;
+    for (size_t i = 0; i < count; i++) {
+        const InputTraceEvent& event = events[i];
+        if (event.source == INPUT_TRACE_STATE) {
+            expected.push_back({(SystemState)event.state, (SystemState)event.level, startUs + event.timeUs});
+        } else if (tracePin(event.source) >= 0) {
+            simScheduleInput(tracePin(event.source), event.level, startUs + event.timeUs);
+        }
+    }
+
+    simClearTransitions();
+    const char* aborted = nullptr;
+    try {
+        simRunFor(events[count - 1].timeUs / 1000 + REPLAY_TAIL_MS);
+    } catch (const SimRestart& restart) {
+        aborted = restart.reason;
+    } catch (const SimStall&) {
+        aborted = "simulated time stalled inside a critical section";
+    }
+    if (aborted) TEST_FAIL_MESSAGE(aborted);
+
+    const std::vector<SimTransition>& actual = simTransitions();
+    for (size_t i = 0; i < expected.size() || i < actual.size(); i++) {
+        if (i >= actual.size() || i >= expected.size() ||
+            actual[i].from != expected[i].from || actual[i].to != expected[i].to) {
+            snprintf(message, sizeof(message), "state change %u: expected %s -> %s, got %s -> %s", (unsigned)i,
+                     i < expected.size() ? getSystemStateName(expected[i].from) : "none",
+                     i < expected.size() ? getSystemStateName(expected[i].to) : "none",
+                     i < actual.size() ? getSystemStateName(actual[i].from) : "none",
+                     i < actual.size() ? getSystemStateName(actual[i].to) : "none");
+            TEST_FAIL_MESSAGE(message);
+        }
+        snprintf(message, sizeof(message), "%s -> %s at %.3f s, traced at %.3f s",
+                 getSystemStateName(actual[i].from), getSystemStateName(actual[i].to),
+                 (actual[i].atUs - startUs) / 1e6, (expected[i].atUs - startUs) / 1e6);
+        TEST_ASSERT_UINT32_WITHIN_MESSAGE(REPLAY_TOLERANCE_US, (uint32_t)(expected[i].atUs - startUs),
+                                          (uint32_t)(actual[i].atUs - startUs), message);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(invariantsBefore, getTotalStateInvariantViolations(), "state invariant violated");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(undeclaredBefore, getUndeclaredTransitionCount(), "undeclared transition");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(pulseMismatchesBefore, getStepPulseMismatchCount(), "step pulse mismatch");
+}
+
+#define REPLAY(trace) replayTrace(trace, sizeof(trace) / sizeof(trace[0]), trace##_LEVELS)
+
+// Reload mode: the start switch must not start a cycle
+const uint8_t RELOAD_MODE_IGNORES_START_TRACE_LEVELS = 0x41;
+const InputTraceEvent RELOAD_MODE_IGNORES_START_TRACE[] = {
+    {0, INPUT_TRACE_RELOAD, 1, IDLE, 0},
+    {300000, INPUT_TRACE_START_CYCLE, 1, IDLE, 0},
+    {420000, INPUT_TRACE_START_CYCLE, 0, IDLE, 0},
+    {900000, INPUT_TRACE_RELOAD, 0, IDLE, 0},
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_boot_homes_to_idle(void) {
+    const std::vector<SimTransition>& boot = simTransitions();
+    TEST_ASSERT_EQUAL_UINT32(2, boot.size());
+    TEST_ASSERT_EQUAL_INT(HOMING, boot[0].to);
+    TEST_ASSERT_EQUAL_INT(IDLE, boot[1].to);
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+}
+
+void test_cycle_with_wood(void) {
+    REPLAY(CYCLE_WITH_WOOD_TRACE);
+}
+
+void test_cycle_without_wood(void) {
+    REPLAY(CYCLE_WITHOUT_WOOD_TRACE);
+}
+
+void test_suction_fault_holds(void) {
+    REPLAY(SUCTION_FAULT_TRACE);
+}
+
+void test_suction_fault_reset_rehomes(void) {
+    REPLAY(SUCTION_FAULT_RESET_TRACE);
+}
+
+void test_manual_feed_moves_wood_forward(void) {
+    REPLAY(MANUAL_FEED_TRACE);
+}
+
+void test_start_held_runs_continuously(void) {
+    REPLAY(CONTINUOUS_TWO_CYCLES_TRACE);
+}
+
+void test_reload_mode_ignores_start(void) {
+    REPLAY(RELOAD_MODE_IGNORES_START_TRACE);
+}
+
+void test_memory_critical_refuses_start(void) {
+    simSetFreeHeap(8000, 2000);
+    simRunFor(MEMORY_MONITOR_SAMPLE_MS + 100);
+    TEST_ASSERT_EQUAL_INT(MEMORY_CRITICAL, getMemoryLevel());
+    TEST_ASSERT_EQUAL_INT(LED_NOTICE_CRITICAL, getLedNotice());
+
+    bool redFlashed = false;
+    simSetInput(START_CYCLE_SWITCH, HIGH);
+    for (int i = 0; i < 50; i++) {
+        simRunFor(50);
+        redFlashed = redFlashed || simGetOutput(STATUS_LED_RED) == HIGH;
+    }
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+    TEST_ASSERT_TRUE(redFlashed);
+
+    // Still held when memory recovers: neither the recovery nor another
+    // input edge may start the refused cycle
+    simSetFreeHeap(200000, 110000);
+    simRunFor(MEMORY_MONITOR_SAMPLE_MS + 100);
+    TEST_ASSERT_EQUAL_INT(MEMORY_OK, getMemoryLevel());
+    TEST_ASSERT_EQUAL_INT(LED_NOTICE_NONE, getLedNotice());
+    simSetInput(WOOD_SUCTION_CONFIRM_SENSOR, LOW);
+    simRunFor(200);
+    simSetInput(WOOD_SUCTION_CONFIRM_SENSOR, HIGH);
+    simRunFor(200);
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+
+    simSetInput(START_CYCLE_SWITCH, LOW);
+    simRunFor(200);
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+}
+
+void test_continuous_mode_stops_at_memory_critical(void) {
+    uint32_t invariantsBefore = getTotalStateInvariantViolations();
+    uint32_t undeclaredBefore = getUndeclaredTransitionCount();
+
+    simSetInput(START_CYCLE_SWITCH, HIGH);
+    TEST_ASSERT_TRUE(simRunUntilState(CUTTING, 1000));
+    simClearTransitions();
+    simSetFreeHeap(8000, 2000); // Sampled during the cut
+    TEST_ASSERT_TRUE(simRunUntilState(IDLE, 20000));
+    TEST_ASSERT_EQUAL_INT(MEMORY_CRITICAL, getMemoryLevel());
+    for (const SimTransition& transition : simTransitions()) {
+        TEST_ASSERT_TRUE_MESSAGE(transition.to != CUTTING, "continuous mode restarted at CRITICAL");
+    }
+
+    // Recovery with the switch still held does not resume the cycle
+    simSetFreeHeap(200000, 110000);
+    simRunFor(MEMORY_MONITOR_SAMPLE_MS + 100);
+    TEST_ASSERT_EQUAL_INT(IDLE, currentState);
+
+    // A fresh press does
+    simSetInput(START_CYCLE_SWITCH, LOW);
+    simRunFor(200);
+    simSetInput(START_CYCLE_SWITCH, HIGH);
+    TEST_ASSERT_TRUE(simRunUntilState(CUTTING, 1000));
+    simSetInput(START_CYCLE_SWITCH, LOW);
+    TEST_ASSERT_TRUE(simRunUntilState(IDLE, 20000));
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(invariantsBefore, getTotalStateInvariantViolations(), "state invariant violated");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(undeclaredBefore, getUndeclaredTransitionCount(), "undeclared transition");
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    simBoot();
+    simRunUntilState(IDLE, 10000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_homes_to_idle);
+    RUN_TEST(test_cycle_with_wood);
+    RUN_TEST(test_cycle_without_wood);
+    RUN_TEST(test_suction_fault_holds);
+    RUN_TEST(test_suction_fault_reset_rehomes);
+    RUN_TEST(test_manual_feed_moves_wood_forward);
+    RUN_TEST(test_start_held_runs_continuously);
+    RUN_TEST(test_reload_mode_ignores_start);
+    RUN_TEST(test_memory_critical_refuses_start);
+    RUN_TEST(test_continuous_mode_stops_at_memory_critical);
+    return UNITY_END();
+}
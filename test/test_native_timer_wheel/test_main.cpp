@@ -0,0 +1,239 @@
+#include <unity.h>
+#include "sim_machine.h"
+#include "Timing/timer_wheel.h"
+
+//* ************************************************************************
+//* ************************* NATIVE TIMER WHEEL ***************************
+//* ************************************************************************
+// Drives the timer wheel on the simulated clock (esp_timer_get_time), without
+// booting the machine: every service call is checked against a reference that
+// says which timers are due, across level wraps and multi-tick gaps.
+//
+//   pio test -e native
+
+const uint64_t LEVEL_1_WRAP_US = 64ULL * 64 * TIMER_WHEEL_TICK_US;
+const uint64_t LEVEL_2_WRAP_US = 64ULL * 64 * 64 * TIMER_WHEEL_TICK_US;
+const uint64_t TOP_LEVEL_SPAN_US = 64ULL * 64 * 64 * 64 * TIMER_WHEEL_TICK_US;
+
+const size_t MAX_TEST_TIMERS = 4096;
+
+struct TestTimer {
+    uint64_t deadlineUs;
+    TimerHandle handle;
+    bool pending;
+};
+
+static TestTimer timers[MAX_TEST_TIMERS];
+static size_t timerCount = 0;
+static uint32_t firedIds[MAX_TEST_TIMERS];
+static size_t firedCount = 0;
+
+static uint64_t deadlineTick(uint64_t deadlineUs) {
+    return (deadlineUs + TIMER_WHEEL_TICK_US - 1) / TIMER_WHEEL_TICK_US;
+}
+
+static void recordFiring(void* context) {
+    firedIds[firedCount++] = (uint32_t)(uintptr_t)context;
+}
+
+// Schedule a recorded timer; the wheel reads the clock once, SIM_CALL_COST_US on
+static uint32_t schedule(uint64_t delayUs, TimerCallback callback = recordFiring) {
+    uint32_t id = timerCount++;
+    timers[id].deadlineUs = simMicros() + SIM_CALL_COST_US + delayUs;
+    timers[id].handle = scheduleTimerUs(delayUs, callback, (void*)(uintptr_t)id);
+    timers[id].pending = true;
+    TEST_ASSERT_TRUE_MESSAGE(timers[id].handle != INVALID_TIMER_HANDLE, "timer pool full");
+    return id;
+}
+
+static void cancel(uint32_t id) {
+    TEST_ASSERT_TRUE(cancelTimer(timers[id].handle));
+    timers[id].pending = false;
+}
+
+// Let the time pass, service once, and check exactly the timers due at the
+// clock read fired - in deadline order, each once
+static void service(uint64_t gapUs) {
+    simAdvance(gapUs);
+    uint64_t dueTick = (simMicros() + SIM_CALL_COST_US) / TIMER_WHEEL_TICK_US;
+    size_t expected = 0;
+    for (size_t id = 0; id < timerCount; id++) {
+        if (timers[id].pending && deadlineTick(timers[id].deadlineUs) <= dueTick) expected++;
+    }
+
+    size_t before = firedCount;
+    serviceTimerWheel();
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected, firedCount - before, "timers due at this service");
+
+    uint64_t lastTick = 0;
+    for (size_t i = before; i < firedCount; i++) {
+        TestTimer& timer = timers[firedIds[i]];
+        TEST_ASSERT_TRUE_MESSAGE(timer.pending, "fired twice or after cancel");
+        TEST_ASSERT_TRUE_MESSAGE(deadlineTick(timer.deadlineUs) <= dueTick, "fired early");
+        TEST_ASSERT_TRUE_MESSAGE(deadlineTick(timer.deadlineUs) >= lastTick, "fired out of order");
+        lastTick = deadlineTick(timer.deadlineUs);
+        timer.pending = false;
+    }
+}
+
+// Service in steps of at most stepUs until the time has passed
+static void serviceFor(uint64_t us, uint64_t stepUs) {
+    while (us > 0) {
+        uint64_t gap = us < stepUs ? us : stepUs;
+        service(gap);
+        us -= gap;
+    }
+}
+
+static void advanceTo(uint64_t multipleUs, uint64_t beforeUs) {
+    uint64_t target = (simMicros() / multipleUs + 1) * multipleUs - beforeUs;
+    simAdvance(target - simMicros());
+}
+
+void setUp(void) {
+    setTimerWheelClock(nullptr); // Restart the wheel on the sim clock, nothing pending
+    timerCount = 0;
+    firedCount = 0;
+}
+
+void tearDown(void) {}
+
+void test_fires_on_its_tick_across_level_0_wraps(void) {
+    schedule(1000);
+    schedule(15900);
+    schedule(16100);
+    schedule(40000);
+    schedule(100);
+    serviceFor(50000, TIMER_WHEEL_TICK_US);
+    TEST_ASSERT_EQUAL_UINT32(5, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(0, getActiveTimerCount());
+}
+
+void test_multi_tick_gap_fires_everything_due_in_order(void) {
+    schedule(900000);
+    schedule(3000);
+    schedule(2000000);
+    schedule(7000);
+    schedule(7100);
+    schedule(20000);
+    service(7500);
+    TEST_ASSERT_EQUAL_UINT32(3, firedCount);
+    service(2500000);
+    TEST_ASSERT_EQUAL_UINT32(6, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(1, firedIds[0]);
+}
+
+void test_catch_up_crosses_level_1_and_2_wraps(void) {
+    // Start just short of a level 2 wrap so every level wraps under the timers
+    advanceTo(LEVEL_2_WRAP_US, 3000);
+    schedule(2000);
+    schedule(5000);
+    schedule(LEVEL_1_WRAP_US - 700);
+    schedule(LEVEL_1_WRAP_US + 900);
+    schedule(LEVEL_2_WRAP_US + 1234);
+    schedule(LEVEL_2_WRAP_US * 2);
+    serviceFor(LEVEL_1_WRAP_US * 2, 3700);
+    TEST_ASSERT_EQUAL_UINT32(4, firedCount);
+    serviceFor(LEVEL_2_WRAP_US * 2, 333333);
+    TEST_ASSERT_EQUAL_UINT32(6, firedCount);
+}
+
+void test_catch_up_only_cascades_occupied_slots(void) {
+    for (int i = 0; i < 4; i++) schedule(3600000000ULL + i * 1000);
+
+    // Half an hour in short and long gaps: no slot holding these is crossed
+    TimerWheelStats before = getTimerWheelStats();
+    serviceFor(10000, 1700);
+    service(1800000000ULL);
+    serviceFor(10000, 2300);
+    TEST_ASSERT_EQUAL_UINT32(before.cascaded, getTimerWheelStats().cascaded);
+    TEST_ASSERT_EQUAL_UINT32(0, firedCount);
+
+    // Past the deadlines: each timer moves down at most once per level
+    service(1900000000ULL);
+    TEST_ASSERT_EQUAL_UINT32(4, firedCount);
+    TEST_ASSERT_TRUE(getTimerWheelStats().cascaded - before.cascaded <= 4 * 3);
+}
+
+void test_deadline_beyond_top_level_is_not_early(void) {
+    uint32_t far = schedule(TOP_LEVEL_SPAN_US + TOP_LEVEL_SPAN_US / 2);
+    uint32_t near = schedule(TOP_LEVEL_SPAN_US / 3);
+    service(TOP_LEVEL_SPAN_US / 2);
+    TEST_ASSERT_FALSE(timers[near].pending);
+    service(TOP_LEVEL_SPAN_US - 3000);
+    TEST_ASSERT_TRUE(timers[far].pending);
+    serviceFor(10000, 1000);
+    TEST_ASSERT_FALSE(timers[far].pending);
+}
+
+static uint32_t cancelledId;
+static uint32_t rescheduledId;
+
+static void cancelLaterTimer(void* context) {
+    recordFiring(context);
+    cancel(cancelledId);
+}
+
+static void rescheduleFromCallback(void* context) {
+    recordFiring(context);
+    rescheduledId = schedule(1000);
+}
+
+void test_callbacks_may_schedule_and_cancel_during_catch_up(void) {
+    schedule(2000, cancelLaterTimer);
+    cancelledId = schedule(6000);
+    schedule(4000, rescheduleFromCallback);
+    schedule(8000);
+    simAdvance(9000);
+    serviceTimerWheel();
+    TEST_ASSERT_EQUAL_UINT32(3, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(0, firedIds[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, firedIds[1]);
+    TEST_ASSERT_EQUAL_UINT32(3, firedIds[2]);
+    timers[0].pending = timers[2].pending = timers[3].pending = false;
+
+    // Scheduled from the clock read, not from where the catch-up had reached
+    service(500);
+    TEST_ASSERT_TRUE(timers[rescheduledId].pending);
+    service(900);
+    TEST_ASSERT_FALSE(timers[rescheduledId].pending);
+    TEST_ASSERT_EQUAL_UINT32(0, getActiveTimerCount());
+}
+
+void test_random_schedule_matches_reference(void) {
+    static const uint64_t DELAYS_US[] = {300, 5000, 120000, 3000000, 90000000};
+    static const uint64_t GAPS_US[] = {50, 260, 1700, 40000, 5000000};
+    uint32_t seed = 12345;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) % range;
+    };
+
+    for (int round = 0; round < 1500; round++) {
+        if (getActiveTimerCount() < TIMER_WHEEL_POOL_SIZE - 4 && timerCount < MAX_TEST_TIMERS) {
+            schedule(next(DELAYS_US[next(5)]) + 1);
+        }
+        if (next(6) == 0) {
+            uint32_t id = next(timerCount);
+            if (timers[id].pending) cancel(id);
+        }
+        service(next(GAPS_US[next(5)] + 1));
+    }
+    serviceFor(100000000, 7000000);
+    TEST_ASSERT_EQUAL_UINT32(0, getActiveTimerCount());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_fires_on_its_tick_across_level_0_wraps);
+    RUN_TEST(test_multi_tick_gap_fires_everything_due_in_order);
+    RUN_TEST(test_catch_up_crosses_level_1_and_2_wraps);
+    RUN_TEST(test_catch_up_only_cascades_occupied_slots);
+    RUN_TEST(test_deadline_beyond_top_level_is_not_early);
+    RUN_TEST(test_callbacks_may_schedule_and_cancel_during_catch_up);
+    RUN_TEST(test_random_schedule_matches_reference);
+    return UNITY_END();
+}
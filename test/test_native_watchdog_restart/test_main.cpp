@@ -0,0 +1,93 @@
+#include <unity.h>
+#include "sim_machine.h"
+#include "esp_system.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/StateManager.h"
+#include "StateMachine/StateTransitions.h"
+#include "StateMachine/99_INVARIANT_FUNCTIONS.h"
+#include "Watchdog/watchdog_supervisor.h"
+
+//* ************************************************************************
+//* ********************** NATIVE WATCHDOG RESTART *************************
+//* ************************************************************************
+// Boots the machine model as if the task watchdog had just restarted it:
+// the controller must wait in ERROR for the operator instead of homing, and
+// a dead feed home switch must end homing in ERROR, not in another restart.
+//
+//   pio test -e native
+
+// Simulated run in which a restart fails the test
+static bool run(uint32_t ms, bool untilIdle = false) {
+    const char* aborted = nullptr;
+    bool idle = false;
+    try {
+        if (untilIdle) idle = simRunUntilState(IDLE, ms);
+        else simRunFor(ms);
+    } catch (const SimRestart& restart) {
+        aborted = restart.reason;
+    }
+    if (aborted) TEST_FAIL_MESSAGE(aborted);
+    return idle;
+}
+
+static void pressReload() {
+    simSetInput(RELOAD_SWITCH, HIGH);
+    run(100);
+    simSetInput(RELOAD_SWITCH, LOW);
+    run(100);
+}
+
+static bool sawTransition(SystemState from, SystemState to) {
+    for (const SimTransition& transition : simTransitions()) {
+        if (transition.from == from && transition.to == to) return true;
+    }
+    return false;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_watchdog_restart_holds_in_error(void) {
+    TEST_ASSERT_TRUE(strcmp(getLastWatchdogRestart(), "none") != 0);
+    TEST_ASSERT_EQUAL_INT(ERROR, currentState);
+    for (const SimTransition& transition : simTransitions()) {
+        TEST_ASSERT_TRUE_MESSAGE(transition.to != HOMING, "homed without an acknowledgement");
+    }
+    double cutInches = simCutInches();
+    simRunFor(3000);
+    TEST_ASSERT_EQUAL_INT(ERROR, currentState);
+    TEST_ASSERT_TRUE(simCutInches() == cutInches);
+}
+
+void test_dead_feed_home_switch_ends_in_error(void) {
+    simSetHomeSwitchFault(SIM_FEED_HOME_SWITCH, true);
+    simClearTransitions();
+    pressReload(); // Homing blocks until the feed homing timeout
+    run(3000);
+    TEST_ASSERT_TRUE_MESSAGE(sawTransition(STARTUP, HOMING), "acknowledgement did not start homing");
+    TEST_ASSERT_TRUE_MESSAGE(sawTransition(HOMING, ERROR), "homing did not give up");
+    TEST_ASSERT_EQUAL_INT(ERROR, currentState);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getTotalStateInvariantViolations(), "state invariant violated");
+}
+
+void test_acknowledged_error_homes_to_idle(void) {
+    simSetHomeSwitchFault(SIM_FEED_HOME_SWITCH, false);
+    pressReload();
+    TEST_ASSERT_TRUE(run(10000, true));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getUndeclaredTransitionCount(), "undeclared transition");
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    simSetResetReason(ESP_RST_TASK_WDT);
+    simBoot();
+    simRunFor(2000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_watchdog_restart_holds_in_error);
+    RUN_TEST(test_dead_feed_home_switch_ends_in_error);
+    RUN_TEST(test_acknowledged_error_homes_to_idle);
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Decode a cut motor flight recorder capture.
+
+Fetch the blob from the diagnostics server and decode it:
+
+    curl -o fr.bin http://<machine>/flightrecorder.bin
+    python3 tools/decode_flight_recorder.py fr.bin            # summary
+    python3 tools/decode_flight_recorder.py fr.bin --csv fr.csv
+
+The layout matches FlightRecorderHeader / FlightRecorderSample in
+include/FlightRecorder/flight_recorder.h (packed, little-endian).
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+HEADER = struct.Struct("<4sHHHBBIIIIIi")
+SAMPLE = struct.Struct("<IiiBBH")
+
+HOME_RAW = 0x01
+HOME_DEBOUNCED = 0x02
+CUT_RUNNING = 0x04
+FEED_RUNNING = 0x08
+
+TRIGGERS = [
+    "NONE", "CUTTING_HOME_CHECK", "YES_2X4_HOME_CHECK", "NO_2X4_HOME_CHECK",
+    "REAL_TIME_HOME_CHECK", "MANUAL",
+]
+
+# SystemState order from include/StateMachine/99_GENERAL_FUNCTIONS.h (8 is unused)
+STATES = [
+    "STARTUP", "HOMING", "IDLE", "FEED_FIRST_CUT", "FEED_WOOD_FWD_ONE", "CUTTING",
+    "RETURNING_YES_2x4", "RETURNING_NO_2x4", "8", "ERROR", "ERROR_RESET",
+    "SUCTION_ERROR_HOLD",
+]
+
+
+def name(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def decode(data):
+    if len(data) < HEADER.size:
+        raise ValueError("file shorter than the header")
+    (magic, version, header_size, sample_size, reason, state, count, trigger_index,
+     interval_us, trigger_us, trigger_ms, steps_per_inch) = HEADER.unpack_from(data)
+    if magic != b"FREC":
+        raise ValueError("bad magic %r" % magic)
+    if version != 1 or sample_size != SAMPLE.size:
+        raise ValueError("unsupported format version %d / sample size %d" % (version, sample_size))
+    if len(data) < header_size + count * sample_size:
+        raise ValueError("truncated capture")
+
+    header = {
+        "reason": name(TRIGGERS, reason),
+        "state": name(STATES, state),
+        "count": count,
+        "trigger_index": trigger_index,
+        "interval_us": interval_us,
+        "trigger_us": trigger_us,
+        "trigger_ms": trigger_ms,
+        "steps_per_inch": steps_per_inch,
+    }
+    samples = []
+    for i in range(count):
+        time_us, position, speed_mhz, flags, sample_state, _ = SAMPLE.unpack_from(
+            data, header_size + i * sample_size)
+        samples.append({
+            "index": i,
+            # Time relative to the trigger; 32-bit wrap handled by the signed difference
+            "t_ms": ((time_us - trigger_us + 2**31) % 2**32 - 2**31) / 1000.0,
+            "position": position,
+            "position_in": position / steps_per_inch if steps_per_inch else 0.0,
+            "speed_hz": speed_mhz / 1000.0,
+            "home_raw": int(bool(flags & HOME_RAW)),
+            "home_debounced": int(bool(flags & HOME_DEBOUNCED)),
+            "cut_running": int(bool(flags & CUT_RUNNING)),
+            "feed_running": int(bool(flags & FEED_RUNNING)),
+            "state": name(STATES, sample_state),
+        })
+    return header, samples
+
+
+def write_csv(samples, path):
+    out = sys.stdout if path == "-" else open(path, "w", newline="")
+    writer = csv.DictWriter(out, fieldnames=list(samples[0].keys()) if samples else ["index"])
+    writer.writeheader()
+    writer.writerows(samples)
+    if out is not sys.stdout:
+        out.close()
+
+
+def summarize(header, samples):
+    print("trigger    %s in %s at %d ms uptime" % (header["reason"], header["state"], header["trigger_ms"]))
+    print("samples    %d every %d us (%d before trigger)" % (
+        header["count"], header["interval_us"], header["trigger_index"]))
+    if not samples:
+        return
+
+    pre = samples[:header["trigger_index"]]
+    print("home switch edges (raw level):")
+    edges = 0
+    for previous, sample in zip(samples, samples[1:]):
+        if sample["home_raw"] != previous["home_raw"]:
+            edges += 1
+            print("  %+9.1f ms  %s  position %d (%.3f in)  speed %.0f Hz" % (
+                sample["t_ms"], "rise" if sample["home_raw"] else "fall",
+                sample["position"], sample["position_in"], sample["speed_hz"]))
+    if edges == 0:
+        print("  none - switch stayed %s" % ("HIGH" if samples[0]["home_raw"] else "LOW"))
+
+    # Where the cut motor came to rest before the trigger
+    stopped = [s for s in pre if not s["cut_running"]]
+    moving = [s for s in pre if s["cut_running"]]
+    if moving:
+        last_moving = moving[-1]
+        print("last motion before trigger at %+.1f ms, position %d (%.3f in), speed %.0f Hz" % (
+            last_moving["t_ms"], last_moving["position"], last_moving["position_in"], last_moving["speed_hz"]))
+    if stopped:
+        rest = stopped[-1]
+        print("at rest before trigger: position %d (%.3f in), raw switch %s, debounced %s" % (
+            rest["position"], rest["position_in"],
+            "HIGH" if rest["home_raw"] else "LOW", "HIGH" if rest["home_debounced"] else "LOW"))
+    chatter = sum(1 for a, b in zip(pre, pre[1:]) if a["home_raw"] != b["home_raw"])
+    if chatter > 2:
+        print("note: %d raw switch edges before the trigger - switch bounce or a sticky actuator" % chatter)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="blob from /flightrecorder.bin")
+    parser.add_argument("--csv", metavar="PATH", help="write every sample as CSV ('-' for stdout)")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        data = f.read()
+    try:
+        header, samples = decode(data)
+    except ValueError as error:
+        sys.exit("%s: %s" % (args.capture, error))
+
+    if args.csv:
+        write_csv(samples, args.csv)
+        if args.csv == "-":
+            return
+    summarize(header, samples)
+
+
+if __name__ == "__main__":
+    main()
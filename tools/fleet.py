@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""List the stage-1 controllers on the network from their status beacons.
+
+Every controller multicasts a one-line JSON status to 239.255.42.1:4210 every
+5 s (FLEET_BEACON_* in src/Config/Config.cpp). This listens for a while and
+prints one row per machine:
+
+    python3 tools/fleet.py              # listen 12 s, print a table
+    python3 tools/fleet.py --watch      # reprint every 12 s
+    python3 tools/fleet.py --json       # raw beacons, one per line
+
+Machines whose parts per hour are well below the fleet median are flagged.
+"""
+
+import argparse
+import json
+import socket
+import struct
+import sys
+import time
+
+GROUP = "239.255.42.1"
+PORT = 4210
+SLOW_FRACTION = 0.8     # Flag machines below 80% of the median parts/hour
+
+
+def open_socket(group, port):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(("", port))
+    membership = struct.pack("4s4s", socket.inet_aton(group), socket.inet_aton("0.0.0.0"))
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, membership)
+    return sock
+
+
+def collect(sock, seconds):
+    machines = {}
+    deadline = time.monotonic() + seconds
+    while True:
+        remaining = deadline - time.monotonic()
+        if remaining <= 0:
+            break
+        sock.settimeout(remaining)
+        try:
+            data, (address, _) = sock.recvfrom(1024)
+        except socket.timeout:
+            break
+        try:
+            beacon = json.loads(data.decode("utf-8"))
+        except (UnicodeDecodeError, ValueError):
+            continue
+        beacon.setdefault("ip", address)
+        beacon["seen"] = time.time()
+        machines[beacon.get("name", address)] = beacon
+    return machines
+
+
+def format_uptime(ms):
+    seconds = int(ms) // 1000
+    hours, seconds = divmod(seconds, 3600)
+    minutes, _ = divmod(seconds, 60)
+    return "%dh%02dm" % (hours, minutes)
+
+
+def print_table(machines):
+    if not machines:
+        print("no machines heard")
+        return
+    rates = sorted(m.get("cutsLastHour", 0) for m in machines.values())
+    median = rates[len(rates) // 2]
+
+    print("%-15s %-15s %-8s %-20s %8s %7s %9s %8s %5s" % (
+        "NAME", "IP", "FW", "STATE", "UPTIME", "CUTS", "PARTS/HR", "CYCLE", "RSSI"))
+    for name in sorted(machines):
+        m = machines[name]
+        rate = m.get("cutsLastHour", 0)
+        slow = len(machines) > 1 and median > 0 and rate < median * SLOW_FRACTION
+        cycle = m.get("cycleMs", 0)
+        print("%-15s %-15s %-8s %-20s %8s %7d %9d %8s %5s%s" % (
+            name, m.get("ip", "?"), m.get("fw", "?"), m.get("state", "?"),
+            format_uptime(m.get("uptimeMs", 0)), m.get("cuts", 0), rate,
+            "%.1fs" % (cycle / 1000.0) if cycle else "-", m.get("rssi", "?"),
+            "  <- slow" if slow else ""))
+    print("%d machine(s), median %d parts/hr" % (len(machines), median))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--seconds", type=float, default=12.0, help="listen time (default 12, two beacons)")
+    parser.add_argument("--watch", action="store_true", help="keep listening and reprint")
+    parser.add_argument("--json", action="store_true", help="print the raw beacons")
+    parser.add_argument("--group", default=GROUP)
+    parser.add_argument("--port", type=int, default=PORT)
+    args = parser.parse_args()
+
+    try:
+        sock = open_socket(args.group, args.port)
+    except OSError as error:
+        sys.exit("cannot join %s:%d: %s" % (args.group, args.port, error))
+
+    while True:
+        machines = collect(sock, args.seconds)
+        if args.json:
+            for name in sorted(machines):
+                print(json.dumps(machines[name]))
+        else:
+            print_table(machines)
+        if not args.watch:
+            break
+        print()
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
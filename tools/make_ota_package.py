@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Build a compressed or delta firmware package for the /update endpoint.
+
+A full package is the new image, zlib-compressed. A delta package rebuilds
+the new image from the one the machine is running (pass that image with
+--base), so only the changed parts travel over WiFi:
+
+    python3 tools/make_ota_package.py .pio/build/esp32s3/firmware.bin -o full.spkg
+    python3 tools/make_ota_package.py new.bin --base running.bin -o delta.spkg
+    curl --digest -u stage1:<ota password> -F package=@delta.spkg http://<machine>/update
+
+The machine must be in IDLE or an error hold. It checks the delta base
+against its running image and the rebuilt image against the SHA-256 in the
+header, then restarts into it on probation (see ota_health_check.h).
+
+The layout matches OtaPackageHeader in include/OTAUpdater/ota_package.h
+(packed, little-endian).
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+import zlib
+
+HEADER = struct.Struct("<4sHHBBHII32s32s")
+FORMAT_VERSION = 1
+TYPE_FULL = 0
+TYPE_DELTA = 1
+COMPRESSION_ZLIB = 1
+
+OP_COPY = 1
+OP_INSERT = 2
+
+BLOCK = 32          # Match granularity; a COPY op costs 9 bytes
+INDEX_STEP = 16     # Base offsets indexed (every offset would need too much memory)
+
+
+def extend_match(base, new, base_pos, new_pos):
+    """Length of the common run starting at base_pos / new_pos."""
+    length = 0
+    limit = min(len(base) - base_pos, len(new) - new_pos)
+    step = 256
+    while length + step <= limit and base[base_pos + length:base_pos + length + step] == \
+            new[new_pos + length:new_pos + length + step]:
+        length += step
+    while length < limit and base[base_pos + length] == new[new_pos + length]:
+        length += 1
+    return length
+
+
+def make_delta_ops(base, new):
+    index = {}
+    for offset in range(0, len(base) - BLOCK + 1, INDEX_STEP):
+        index.setdefault(base[offset:offset + BLOCK], offset)
+
+    ops = bytearray()
+    literal_start = 0
+    pos = 0
+    copied = 0
+
+    def flush_literal(end):
+        if end > literal_start:
+            ops.extend(struct.pack("<BI", OP_INSERT, end - literal_start))
+            ops.extend(new[literal_start:end])
+
+    while pos + BLOCK <= len(new):
+        base_pos = index.get(new[pos:pos + BLOCK])
+        if base_pos is None:
+            pos += 1
+            continue
+        length = extend_match(base, new, base_pos, pos)
+        # Grow backwards into the pending literal
+        while pos > literal_start and base_pos > 0 and base[base_pos - 1] == new[pos - 1]:
+            pos -= 1
+            base_pos -= 1
+            length += 1
+        flush_literal(pos)
+        ops.extend(struct.pack("<BII", OP_COPY, base_pos, length))
+        copied += length
+        pos += length
+        literal_start = pos
+    flush_literal(len(new))
+    return bytes(ops), copied
+
+
+def apply_delta_ops(base, ops):
+    """Rebuild the image the way the firmware does (used to self-check)."""
+    out = bytearray()
+    pos = 0
+    while pos < len(ops):
+        op = ops[pos]
+        if op == OP_COPY:
+            offset, length = struct.unpack_from("<II", ops, pos + 1)
+            out.extend(base[offset:offset + length])
+            pos += 9
+        elif op == OP_INSERT:
+            (length,) = struct.unpack_from("<I", ops, pos + 1)
+            out.extend(ops[pos + 5:pos + 5 + length])
+            pos += 5 + length
+        else:
+            raise ValueError("unknown op %d at %d" % (op, pos))
+    return bytes(out)
+
+
+def build(new, base=None):
+    if base is None:
+        payload = new
+        package_type = TYPE_FULL
+        base_size = 0
+        base_sha = bytes(32)
+    else:
+        payload, copied = make_delta_ops(base, new)
+        if apply_delta_ops(base, payload) != new:
+            raise RuntimeError("delta self-check failed")
+        package_type = TYPE_DELTA
+        base_size = len(base)
+        base_sha = hashlib.sha256(base).digest()
+        print("delta: %d of %d bytes copied from the base image" % (copied, len(new)))
+
+    header = HEADER.pack(b"SPKG", FORMAT_VERSION, HEADER.size, package_type, COMPRESSION_ZLIB, 0,
+                         len(new), base_size, hashlib.sha256(new).digest(), base_sha)
+    return header + zlib.compress(payload, 9)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", help="new firmware.bin")
+    parser.add_argument("--base", metavar="BIN", help="firmware.bin the machine is running (builds a delta)")
+    parser.add_argument("-o", "--output", required=True, help="package to write")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        new = f.read()
+    base = None
+    if args.base:
+        with open(args.base, "rb") as f:
+            base = f.read()
+
+    try:
+        package = build(new, base)
+    except (RuntimeError, ValueError) as error:
+        sys.exit("%s: %s" % (args.image, error))
+
+    with open(args.output, "wb") as f:
+        f.write(package)
+    print("%s: %d bytes (%.1f%% of the %d byte image)" % (
+        args.output, len(package), 100.0 * len(package) / len(new), len(new)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/bin/sh
+# Line coverage of the firmware under the native replay tests and the state
+# machine fuzz target, with g++ --coverage and gcov. Builds the same sources
+# as [env:native] in platformio.ini; needs no board and no PlatformIO.
+#
+#   tools/native_coverage.sh            # replay tests + 200 random fuzz runs
+#   FUZZ_RUNS=2000 tools/native_coverage.sh
+#   tools/native_coverage.sh test/fuzz/corpus/*   # fuzz on these files instead
+#
+# Prints per-file line coverage for src/ and leaves the annotated *.gcov files
+# in .native_coverage/. The libFuzzer build (pio run -e native_fuzz) gives the
+# same with clang: add -fprofile-instr-generate -fcoverage-mapping, run the
+# corpus, then llvm-profdata merge and llvm-cov report.
+
+set -e
+cd "$(dirname "$0")/.."
+ROOT=$(pwd)
+
+CXX=${CXX:-g++}
+FUZZ_RUNS=${FUZZ_RUNS:-200}
+OUT=.native_coverage
+FLAGS="-std=gnu++17 -O0 -g --coverage -DMEMORY_ALLOC_TRACKING=0 -DOTA_PASSWORD=\"native\" -I$ROOT/test/shims -I$ROOT/include"
+
+rm -rf "$OUT"
+mkdir -p "$OUT/replay" "$OUT/fuzz"
+
+SOURCES=$(find src test/shims -name '*.cpp' | grep -v -e '^src/Network/' \
+    -e '^src/Diagnostics/diagnostics_server.cpp' -e '^src/OTAUpdater/ota_package.cpp' | sort)
+
+# The replay tests need the Unity that pio test -e native installs
+UNITY=$(find .pio/libdeps/native "$HOME/.platformio/packages" -name unity.h -path '*Unity*' 2>/dev/null | head -n 1)
+if [ -z "$UNITY" ]; then
+    echo "Unity not found (run pio test -e native once): coverage from the fuzz target only"
+fi
+
+build() {
+    dir=$1
+    shift
+    for source in $SOURCES "$@"; do
+        object="$dir/$(echo "$source" | tr '/' '_').o"
+        case "$source" in /*) ;; *) source="$ROOT/$source" ;; esac
+        # Absolute paths so gcov finds the sources from the build directory
+        case "$source" in
+            *.c) ${CC:-gcc} -O0 -g --coverage $EXTRA -c "$source" -o "$object" ;;
+            *) $CXX $FLAGS $EXTRA -c "$source" -o "$object" ;;
+        esac
+    done
+    $CXX --coverage "$dir"/*.o -o "$dir/program"
+}
+
+if [ -n "$UNITY" ]; then
+    UNITY_DIR=$(dirname "$UNITY")
+    EXTRA="-I$UNITY_DIR" build "$OUT/replay" test/test_native_replay/test_main.cpp "$UNITY_DIR/unity.c"
+    "$OUT/replay/program"
+fi
+
+EXTRA="-DFUZZ_STANDALONE_MAIN=1" build "$OUT/fuzz" test/fuzz/fuzz_state_machine.cpp
+if [ $# -gt 0 ]; then
+    "$OUT/fuzz/program" "$@"
+else
+    "$OUT/fuzz/program" "$FUZZ_RUNS"
+fi
+
+# gcov per build, then the src/ totals across both
+for dir in "$OUT"/replay "$OUT"/fuzz; do
+    [ -f "$dir/program" ] || continue
+    (cd "$dir" && gcov -p -o . ./*.gcda > gcov.txt 2>&1 || true)
+done
+cat "$OUT"/*/*.gcov 2>/dev/null | awk -v root="$ROOT/" '
+    /^ *-: *0:Source:/ { split($0, parts, "Source:"); file = substr(parts[2], length(root) + 1); next }
+    index(parts[2], root "src/") != 1 { next }
+    {
+        split($0, fields, ":")
+        count = fields[1]; line = fields[2] + 0
+        gsub(/ /, "", count)
+        if (count == "-" || line == 0) next
+        key = file SUBSEP line
+        if (!(key in seen)) { seen[key] = 1; total[file]++ }
+        if (count != "#####" && count != "=====" && !(key in hit)) { hit[key] = 1; covered[file]++ }
+    }
+    END {
+        for (file in total) {
+            printf "%6.1f%%  %5d/%-5d  %s\n", 100 * covered[file] / total[file], covered[file], total[file], file | "sort -b -k3"
+            allCovered += covered[file]; allTotal += total[file]
+        }
+        close("sort -b -k3")
+        printf "%6.1f%%  %5d/%-5d  TOTAL\n", 100 * allCovered / allTotal, allCovered, allTotal
+    }'
@@ -0,0 +1,330 @@
+#!/usr/bin/env python3
+"""Replay an input edge trace to find sensor chatter and check state timing.
+
+Fetch the frozen trace from the diagnostics server and replay it:
+
+    curl -o inputs.bin http://<machine>/inputs.bin
+    python3 tools/replay_input_trace.py inputs.bin                  # summary
+    python3 tools/replay_input_trace.py inputs.bin --timeline       # every edge and state change
+    python3 tools/replay_input_trace.py inputs.bin --csv inputs.csv
+    python3 tools/replay_input_trace.py inputs.bin --expect CUTTING,SUCTION_ERROR_HOLD --max-latency-ms 50
+
+The replay runs the raw edges through the same debounce the firmware uses
+(Bounce2 stable-interval, intervals from setup() in src/main.cpp) on a
+clock taken from the trace, so it shows which edges the states could have
+seen. Each recorded state change is paired with the last input edge before
+it to give the reaction time. --expect and --max-latency-ms turn the replay
+into a check: the exit status is 1 if the recorded transitions do not
+contain the expected ones in order or a reaction took too long.
+
+--c-array NAME prints the trace as InputTraceEvent initialisers for the
+native replay tests (test/test_native_replay), which play the operator and
+sensor edges into the real state classes on a machine model and check the
+firmware makes the same state changes:
+
+    python3 tools/replay_input_trace.py inputs.bin --c-array SUCTION_FAULT_TRACE
+
+The layout matches InputTraceHeader / InputTraceEvent in
+include/InputTrace/input_trace.h (packed, little-endian).
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+HEADER = struct.Struct("<4sHHHBBIIIIB3x")
+EVENT = struct.Struct("<IBBBx")
+
+STATE_EVENT = 0x80
+
+# InputTraceSource order, with the debounce interval the firmware uses (0 = read raw)
+INPUTS = [
+    ("CUT_HOME", 3),
+    ("FEED_HOME", 5),
+    ("RELOAD", 10),
+    ("START_CYCLE", 20),
+    ("MANUAL_FEED", 20),
+    ("2X4_SENSOR", 0),
+    ("SUCTION_SENSOR", 0),
+]
+
+FREEZE_REASONS = ["NONE", "ERROR", "SUCTION_ERROR_HOLD", "MANUAL"]
+
+# SystemState order from include/StateMachine/99_GENERAL_FUNCTIONS.h (8 is unused)
+STATES = [
+    "STARTUP", "HOMING", "IDLE", "FEED_FIRST_CUT", "FEED_WOOD_FWD_ONE", "CUTTING",
+    "RETURNING_YES_2x4", "RETURNING_NO_2x4", "8", "ERROR", "ERROR_RESET",
+    "SUCTION_ERROR_HOLD",
+]
+
+
+def name(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def decode(data):
+    if len(data) < HEADER.size:
+        raise ValueError("file shorter than the header")
+    (magic, version, header_size, event_size, reason, state, count, lost,
+     freeze_us, freeze_ms, levels) = HEADER.unpack_from(data)
+    if magic != b"ITRC":
+        raise ValueError("bad magic %r" % magic)
+    if version != 1 or event_size != EVENT.size:
+        raise ValueError("unsupported format version %d / event size %d" % (version, event_size))
+    if len(data) < header_size + count * event_size:
+        raise ValueError("truncated trace")
+
+    header = {
+        "reason": name(FREEZE_REASONS, reason),
+        "state": name(STATES, state),
+        "count": count,
+        "lost": lost,
+        "freeze_us": freeze_us,
+        "freeze_ms": freeze_ms,
+        "levels": levels,
+    }
+    events = []
+    for i in range(count):
+        time_us, source, level, event_state = EVENT.unpack_from(data, header_size + i * event_size)
+        events.append({
+            # Time relative to the freeze; 32-bit wrap handled by the signed difference
+            "t_us": (time_us - freeze_us + 2**31) % 2**32 - 2**31,
+            "source": source,
+            "level": level,
+            "state": event_state,
+        })
+    return header, events
+
+
+def initial_levels(header, events):
+    """Bit per input: level before its first edge in the trace, else the level at freeze."""
+    levels = header["levels"]
+    seen = set()
+    for event in events:
+        source = event["source"]
+        if source < len(INPUTS) and source not in seen:
+            seen.add(source)
+            levels = (levels & ~(1 << source)) | ((1 - event["level"]) << source)
+    return levels
+
+
+class Debouncer:
+    """Bounce2 stable-interval debounce, updated continuously."""
+
+    def __init__(self, interval_ms, level):
+        self.interval_us = interval_ms * 1000
+        self.raw = level
+        self.raw_since = None
+        self.debounced = level
+
+    def edge(self, t_us, level):
+        """Raw edge at t_us; returns a debounced change that became due first, if any."""
+        change = self.advance(t_us)
+        if level != self.raw:
+            self.raw = level
+            self.raw_since = t_us
+        if self.interval_us == 0:
+            self.debounced = level
+            return (t_us, level)
+        return change
+
+    def advance(self, t_us):
+        if self.raw != self.debounced and self.raw_since is not None and \
+                t_us - self.raw_since >= self.interval_us:
+            self.debounced = self.raw
+            return (self.raw_since + self.interval_us, self.raw)
+        return None
+
+
+def replay(header, events, glitch_us):
+    """Returns (per-input stats, timeline) where the timeline holds raw, debounced and state entries."""
+    levels = initial_levels(header, events)
+    initial = [(levels >> i) & 1 for i in range(len(INPUTS))]
+
+    debouncers = [Debouncer(interval, initial[i]) for i, (_, interval) in enumerate(INPUTS)]
+    stats = [{"edges": 0, "glitches": 0, "shortest_us": None, "last_edge_us": None} for _ in INPUTS]
+    timeline = []
+
+    for event in events:
+        t_us = event["t_us"]
+        # Debounced changes that came due before this event
+        for i, debouncer in enumerate(debouncers):
+            change = debouncer.advance(t_us)
+            if change and debouncer.interval_us:
+                timeline.append(("debounced", change[0], i, change[1], event["state"]))
+
+        source = event["source"]
+        if source == STATE_EVENT:
+            timeline.append(("state", t_us, event["state"], event["level"], None))
+            continue
+        if source >= len(INPUTS):
+            continue
+
+        stat = stats[source]
+        stat["edges"] += 1
+        if stat["last_edge_us"] is not None:
+            width = t_us - stat["last_edge_us"]
+            if stat["shortest_us"] is None or width < stat["shortest_us"]:
+                stat["shortest_us"] = width
+            if width < max(INPUTS[source][1] * 1000, glitch_us):
+                stat["glitches"] += 1
+        stat["last_edge_us"] = t_us
+        timeline.append(("raw", t_us, source, event["level"], event["state"]))
+        change = debouncers[source].edge(t_us, event["level"])
+        if change and debouncers[source].interval_us:
+            timeline.append(("debounced", change[0], source, change[1], event["state"]))
+
+    for i, debouncer in enumerate(debouncers):
+        change = debouncer.advance(0)
+        if change and debouncer.interval_us:
+            timeline.append(("debounced", change[0], i, change[1], None))
+
+    timeline.sort(key=lambda entry: entry[1])
+    return stats, timeline
+
+
+def state_changes(timeline):
+    """(t_us, from, to, cause, latency_us) for each state change, cause = last input edge the states could see."""
+    changes = []
+    last_edge = None
+    for kind, t_us, a, b, _ in timeline:
+        if kind == "state":
+            cause = None
+            latency = None
+            if last_edge is not None:
+                cause = "%s %s" % (INPUTS[last_edge[1]][0], "HIGH" if last_edge[2] else "LOW")
+                latency = t_us - last_edge[0]
+            changes.append((t_us, name(STATES, a), name(STATES, b), cause, latency))
+        elif kind == "debounced" or (kind == "raw" and INPUTS[a][1] == 0):
+            last_edge = (t_us, a, b)
+    return changes
+
+
+def print_summary(header, stats, changes):
+    print("frozen by %s in %s at %d ms uptime, %d events (%d older lost)" % (
+        header["reason"], header["state"], header["freeze_ms"], header["count"], header["lost"]))
+    print()
+    print("%-15s %6s %9s %12s %9s" % ("INPUT", "EDGES", "GLITCHES", "SHORTEST", "DEBOUNCE"))
+    for i, (input_name, interval) in enumerate(INPUTS):
+        stat = stats[i]
+        shortest = "%.3f ms" % (stat["shortest_us"] / 1000.0) if stat["shortest_us"] is not None else "-"
+        print("%-15s %6d %9d %12s %9s" % (input_name, stat["edges"], stat["glitches"], shortest,
+                                          "%d ms" % interval if interval else "raw"))
+    print()
+    print("state changes (time before freeze, last visible input edge, reaction):")
+    for t_us, old, new, cause, latency in changes:
+        print("  %10.3f ms  %-18s -> %-18s  %s" % (
+            t_us / 1000.0, old, new,
+            "%s, %.3f ms" % (cause, latency / 1000.0) if cause else "no input edge in the trace"))
+
+
+def print_timeline(timeline):
+    for kind, t_us, a, b, state in timeline:
+        if kind == "state":
+            print("%12.3f ms  state      %s -> %s" % (t_us / 1000.0, name(STATES, a), name(STATES, b)))
+        else:
+            print("%12.3f ms  %-10s %-15s %-4s (%s)" % (
+                t_us / 1000.0, kind, INPUTS[a][0], "HIGH" if b else "LOW",
+                name(STATES, state) if state is not None else "-"))
+
+
+def write_csv(path, timeline):
+    with open(path, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["t_ms", "kind", "input_or_from", "level_or_to", "state"])
+        for kind, t_us, a, b, state in timeline:
+            if kind == "state":
+                writer.writerow(["%.3f" % (t_us / 1000.0), kind, name(STATES, a), name(STATES, b), ""])
+            else:
+                writer.writerow(["%.3f" % (t_us / 1000.0), kind, INPUTS[a][0], b,
+                                 name(STATES, state) if state is not None else ""])
+
+
+def print_c_array(array_name, header, events):
+    """InputTraceEvent initialisers, times from the first event."""
+    start_us = events[0]["t_us"] if events else 0
+    print("// %d events, frozen by %s in %s" % (len(events), header["reason"], header["state"]))
+    print("const uint8_t %s_LEVELS = 0x%02x; // Input levels before the first event" % (
+        array_name, initial_levels(header, events)))
+    print("const InputTraceEvent %s[] = {" % array_name)
+    for event in events:
+        source = event["source"]
+        if source == STATE_EVENT:
+            comment = "%s -> %s" % (name(STATES, event["state"]), name(STATES, event["level"]))
+            source_text = "INPUT_TRACE_STATE"
+        else:
+            comment = "%s %s" % (INPUTS[source][0] if source < len(INPUTS) else source,
+                                 "HIGH" if event["level"] else "LOW")
+            source_text = str(source)
+        print("    {%u, %s, %u, %u, 0}, // %s" % (
+            event["t_us"] - start_us, source_text, event["level"], event["state"], comment))
+    print("};")
+
+
+def check(changes, expect, max_latency_ms):
+    failures = []
+    if expect:
+        wanted = [state.strip() for state in expect.split(",") if state.strip()]
+        entered = [new for _, _, new, _, _ in changes]
+        position = 0
+        for state in entered:
+            if position < len(wanted) and state == wanted[position]:
+                position += 1
+        if position < len(wanted):
+            failures.append("expected transitions %s, got %s (missing from %s)" % (
+                " -> ".join(wanted), " -> ".join(entered) or "none", wanted[position]))
+    if max_latency_ms is not None:
+        for t_us, old, new, cause, latency in changes:
+            if latency is not None and latency > max_latency_ms * 1000:
+                failures.append("%s -> %s took %.3f ms after %s (limit %.3f ms)" % (
+                    old, new, latency / 1000.0, cause, max_latency_ms))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", help="inputs.bin from the diagnostics server")
+    parser.add_argument("--timeline", action="store_true", help="print every edge and state change")
+    parser.add_argument("--csv", metavar="FILE", help="write the replayed timeline as CSV")
+    parser.add_argument("--glitch-ms", type=float, default=5.0,
+                        help="pulses shorter than this (or the debounce interval) count as glitches (default 5)")
+    parser.add_argument("--expect", metavar="STATE,...", help="states that must be entered, in this order")
+    parser.add_argument("--max-latency-ms", type=float, help="longest allowed reaction to an input edge")
+    parser.add_argument("--c-array", metavar="NAME", help="print the trace as a C array for the native replay tests")
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as f:
+        data = f.read()
+    try:
+        header, events = decode(data)
+    except ValueError as error:
+        sys.exit("%s: %s" % (args.trace, error))
+
+    if args.c_array:
+        print_c_array(args.c_array, header, events)
+        return
+
+    stats, timeline = replay(header, events, int(args.glitch_ms * 1000))
+    changes = state_changes(timeline)
+    print_summary(header, stats, changes)
+    if args.timeline:
+        print()
+        print_timeline(timeline)
+    if args.csv:
+        write_csv(args.csv, timeline)
+        print("wrote %s" % args.csv)
+
+    failures = check(changes, args.expect, args.max_latency_ms)
+    if failures:
+        print()
+        for failure in failures:
+            print("FAIL: %s" % failure)
+        sys.exit(1)
+    if args.expect or args.max_latency_ms is not None:
+        print()
+        print("PASS")
+
+
+if __name__ == "__main__":
+    main()
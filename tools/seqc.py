@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""Compile a feed sequence for the /sequence endpoint, or disassemble one.
+
+The feed states (FEED_FIRST_CUT, FEED_WOOD_FWD_ONE) run small bytecode
+programs (include/StateMachine/99_SEQUENCE_FUNCTIONS.h). The built-in ones
+are in tools/sequences/; edit a copy, compile it and upload it:
+
+    python3 tools/seqc.py tools/sequences/feed_first_cut.seq -o first_cut.seqb
+    curl --digest -u stage1:<ota password> -F sequence=@first_cut.seqb "http://<machine>/sequence?name=feed_first_cut"
+    python3 tools/seqc.py --disassemble first_cut.seqb
+
+Uploads need the write credential and are refused unless the machine is in
+IDLE. The machine checks the program again before storing it and uses it from
+the next start of the sequence. POST /sequence/reset with name=... (same
+credential) restores the built-in.
+
+Syntax, one instruction per line, '#' starts a comment:
+
+    extend <output>            retract <output>
+    move_feed <position> [+/-inches]   or   move_feed <inches>
+    wait_feed [timeout_ms]     wait <ms>
+    wait_input <input> <high|low> [timeout_ms]
+    if <input> <high|low> goto <label>
+    goto <label>               end <idle|cut>
+    <label>:
+
+A wait with a timeout fails the sequence (the state goes to ERROR) if it runs
+out. A program must end with 'end' or 'goto'.
+"""
+
+import argparse
+import struct
+import sys
+
+OPS = ["end", "move_feed", "wait_feed", "set_output", "wait", "wait_input", "if", "goto"]
+OP = {name: index for index, name in enumerate(OPS)}
+POSITIONS = ["zero", "travel", "push1", "push2", "park", "regrip"]
+OUTPUTS = ["feed_clamp", "secure_clamp", "rotation_clamp"]
+INPUTS = ["start_switch", "2x4_sensor", "suction_sensor", "feed_home", "cut_home"]
+EXITS = ["idle", "cut"]
+LEVELS = ["low", "high"]
+
+INSTRUCTION = struct.Struct("<BBhH")
+MAGIC = b"SEQ1"
+MAX_INSTRUCTIONS = 64
+
+
+class SeqError(Exception):
+    pass
+
+
+def lookup(table, word, what):
+    if word not in table:
+        raise SeqError("unknown %s '%s' (one of: %s)" % (what, word, ", ".join(table)))
+    return table.index(word)
+
+
+def number(word, what, low, high):
+    try:
+        value = int(word)
+    except ValueError:
+        raise SeqError("%s must be a whole number, got '%s'" % (what, word))
+    if not low <= value <= high:
+        raise SeqError("%s must be %d-%d" % (what, low, high))
+    return value
+
+
+def hundredths(word):
+    try:
+        value = round(float(word) * 100)
+    except ValueError:
+        raise SeqError("bad inches '%s'" % word)
+    if not -32768 <= value <= 32767:
+        raise SeqError("offset out of range")
+    return value
+
+
+def parse_line(words):
+    """(op, a, b, c, label or None) for one instruction."""
+    name, args = words[0], words[1:]
+
+    def expect(low, high=None):
+        high = low if high is None else high
+        if not low <= len(args) <= high:
+            raise SeqError("'%s' takes %s argument(s)" % (name, low if low == high else "%d-%d" % (low, high)))
+
+    if name in ("extend", "retract"):
+        expect(1)
+        return OP["set_output"], lookup(OUTPUTS, args[0], "output"), int(name == "extend"), 0, None
+    if name == "move_feed":
+        expect(1, 2)
+        if args[0] in POSITIONS:
+            offset = hundredths(args[1]) if len(args) == 2 else 0
+            return OP["move_feed"], POSITIONS.index(args[0]), offset, 0, None
+        if len(args) != 1:
+            raise SeqError("unknown position '%s'" % args[0])
+        return OP["move_feed"], 0, hundredths(args[0]), 0, None
+    if name == "wait_feed":
+        expect(0, 1)
+        return OP["wait_feed"], 0, 0, number(args[0], "timeout", 1, 65535) if args else 0, None
+    if name == "wait":
+        expect(1)
+        return OP["wait"], 0, 0, number(args[0], "wait", 0, 65535), None
+    if name == "wait_input":
+        expect(2, 3)
+        timeout = number(args[2], "timeout", 1, 65535) if len(args) == 3 else 0
+        return OP["wait_input"], lookup(INPUTS, args[0], "input"), lookup(LEVELS, args[1], "level"), timeout, None
+    if name == "if":
+        expect(4)
+        if args[2] != "goto":
+            raise SeqError("expected 'if <input> <level> goto <label>'")
+        return OP["if"], lookup(INPUTS, args[0], "input"), lookup(LEVELS, args[1], "level"), 0, args[3]
+    if name == "goto":
+        expect(1)
+        return OP["goto"], 0, 0, 0, args[0]
+    if name == "end":
+        expect(1)
+        return OP["end"], lookup(EXITS, args[0], "exit"), 0, 0, None
+    raise SeqError("unknown instruction '%s'" % name)
+
+
+def compile_source(text):
+    code = []
+    labels = {}
+    fixups = []
+    for line_number, line in enumerate(text.splitlines(), 1):
+        words = line.split("#", 1)[0].split()
+        if not words:
+            continue
+        try:
+            if len(words) == 1 and words[0].endswith(":"):
+                label = words[0][:-1]
+                if label in labels:
+                    raise SeqError("label '%s' defined twice" % label)
+                labels[label] = len(code)
+                continue
+            op, a, b, c, label = parse_line(words)
+        except SeqError as error:
+            raise SeqError("line %d: %s" % (line_number, error))
+        if label is not None:
+            fixups.append((len(code), label, line_number))
+        code.append([op, a, b, c])
+
+    for index, label, line_number in fixups:
+        if label not in labels:
+            raise SeqError("line %d: no label '%s'" % (line_number, label))
+        code[index][3] = labels[label]
+
+    if not code:
+        raise SeqError("empty program")
+    if len(code) > MAX_INSTRUCTIONS:
+        raise SeqError("%d instructions, the limit is %d" % (len(code), MAX_INSTRUCTIONS))
+    if not any(op == OP["end"] for op, _, _, _ in code):
+        raise SeqError("no 'end'")
+    if code[-1][0] not in (OP["end"], OP["goto"]):
+        raise SeqError("the last instruction must be 'end' or 'goto'")
+    for _, _, _, target in (i for i in code if i[0] in (OP["if"], OP["goto"])):
+        if target >= len(code):
+            raise SeqError("a label points past the last instruction")
+
+    return MAGIC + struct.pack("<H", len(code)) + b"".join(INSTRUCTION.pack(*i) for i in code)
+
+
+def disassemble(blob):
+    if blob[:4] != MAGIC or len(blob) < 6:
+        raise SeqError("not a compiled sequence")
+    (count,) = struct.unpack_from("<H", blob, 4)
+    if len(blob) != 6 + count * INSTRUCTION.size:
+        raise SeqError("length does not match the instruction count")
+    code = [INSTRUCTION.unpack_from(blob, 6 + i * INSTRUCTION.size) for i in range(count)]
+    targets = {c for op, _, _, c in code if op in (OP["if"], OP["goto"])}
+
+    lines = []
+    for index, (op, a, b, c) in enumerate(code):
+        if index in targets:
+            lines.append("L%d:" % index)
+        name = OPS[op] if op < len(OPS) else None
+        if name == "end":
+            text = "end %s" % EXITS[a]
+        elif name == "move_feed":
+            text = "move_feed %s" % POSITIONS[a] + (" %+.2f" % (b / 100.0) if b else "")
+        elif name == "wait_feed":
+            text = "wait_feed" + (" %d" % c if c else "")
+        elif name == "set_output":
+            text = "%s %s" % ("extend" if b else "retract", OUTPUTS[a])
+        elif name == "wait":
+            text = "wait %d" % c
+        elif name == "wait_input":
+            text = "wait_input %s %s" % (INPUTS[a], LEVELS[b]) + (" %d" % c if c else "")
+        elif name == "if":
+            text = "if %s %s goto L%d" % (INPUTS[a], LEVELS[b], c)
+        elif name == "goto":
+            text = "goto L%d" % c
+        else:
+            text = "# unknown op %d" % op
+        lines.append("    " + text)
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help=".seq source (or a compiled blob with --disassemble)")
+    parser.add_argument("-o", "--output", help="compiled blob to write")
+    parser.add_argument("--disassemble", action="store_true", help="print a compiled blob as source")
+    args = parser.parse_args()
+
+    try:
+        if args.disassemble:
+            with open(args.input, "rb") as f:
+                sys.stdout.write(disassemble(f.read()))
+            return
+        with open(args.input) as f:
+            blob = compile_source(f.read())
+    except SeqError as error:
+        sys.exit("%s: %s" % (args.input, error))
+
+    if not args.output:
+        parser.error("-o is required when compiling")
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("%s: %d instructions, %d bytes" % (args.output, (len(blob) - 6) // INSTRUCTION.size, len(blob)))
+
+
+if __name__ == "__main__":
+    main()